@@ -0,0 +1,157 @@
+//
+//  BenchmarkAllocationCounter.c
+//  SwiftAdditionsBenchmarks
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+#include "BenchmarkAllocationCounter.h"
+#include <errno.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+static _Atomic(uint64_t) allocationCount;
+
+static inline void countAllocation(void) {
+	atomic_fetch_add_explicit(&allocationCount, 1, memory_order_relaxed);
+}
+
+#if defined(__APPLE__)
+
+// Not in the SDK headers; libmalloc exports it for malloc stack logging.
+typedef void (malloc_logger_t)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip);
+extern malloc_logger_t *malloc_logger __attribute__((weak_import));
+
+enum {
+	// `MALLOC_LOG_TYPE_ALLOCATE` in libmalloc. A `realloc` is logged once, with this and
+	// the deallocate flag.
+	mallocLogTypeAllocate = 2,
+};
+
+static malloc_logger_t *previousLogger;
+
+static void countingLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip) {
+	if (type & mallocLogTypeAllocate) {
+		countAllocation();
+	}
+	if (previousLogger) {
+		previousLogger(type, arg1, arg2, arg3, result, numHotFramesToSkip + 1);
+	}
+}
+
+bool BACAllocationCountingIsAvailable(void) {
+	return &malloc_logger != NULL;
+}
+
+void BACAllocationCountingStart(void) {
+	if (!BACAllocationCountingIsAvailable()) {
+		return;
+	}
+	atomic_store_explicit(&allocationCount, 0, memory_order_relaxed);
+	previousLogger = malloc_logger;
+	malloc_logger = countingLogger;
+}
+
+uint64_t BACAllocationCountingStop(void) {
+	if (BACAllocationCountingIsAvailable() && malloc_logger == countingLogger) {
+		malloc_logger = previousLogger;
+	}
+	return atomic_load_explicit(&allocationCount, memory_order_relaxed);
+}
+
+#elif defined(__GLIBC__)
+
+// glibc's own entry points, which stay callable when the executable replaces `malloc`.
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void *__libc_valloc(size_t size);
+extern void *__libc_pvalloc(size_t size);
+
+static atomic_bool counting;
+
+static inline void countIfCounting(void) {
+	if (atomic_load_explicit(&counting, memory_order_relaxed)) {
+		countAllocation();
+	}
+}
+
+void *malloc(size_t size) {
+	countIfCounting();
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+	countIfCounting();
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+	countIfCounting();
+	return __libc_realloc(pointer, size);
+}
+
+void *memalign(size_t alignment, size_t size) {
+	countIfCounting();
+	return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+	countIfCounting();
+	return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **result, size_t alignment, size_t size) {
+	if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0) {
+		return EINVAL;
+	}
+	countIfCounting();
+	void *pointer = __libc_memalign(alignment, size);
+	if (pointer == NULL) {
+		return ENOMEM;
+	}
+	*result = pointer;
+	return 0;
+}
+
+void *valloc(size_t size) {
+	countIfCounting();
+	return __libc_valloc(size);
+}
+
+void *pvalloc(size_t size) {
+	countIfCounting();
+	return __libc_pvalloc(size);
+}
+
+bool BACAllocationCountingIsAvailable(void) {
+	return true;
+}
+
+void BACAllocationCountingStart(void) {
+	atomic_store_explicit(&allocationCount, 0, memory_order_relaxed);
+	atomic_store_explicit(&counting, true, memory_order_relaxed);
+}
+
+uint64_t BACAllocationCountingStop(void) {
+	atomic_store_explicit(&counting, false, memory_order_relaxed);
+	return atomic_load_explicit(&allocationCount, memory_order_relaxed);
+}
+
+#else
+
+bool BACAllocationCountingIsAvailable(void) {
+	return false;
+}
+
+void BACAllocationCountingStart(void) {
+}
+
+uint64_t BACAllocationCountingStop(void) {
+	return 0;
+}
+
+#endif
@@ -0,0 +1,34 @@
+//
+//  BenchmarkAllocationCounter.h
+//  SwiftAdditionsBenchmarks
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+#ifndef BenchmarkAllocationCounter_h
+#define BenchmarkAllocationCounter_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Counts every heap allocation the process makes, including the ones freed again right
+// away, which the allocator's in-use totals can't show.
+//
+// On Darwin this installs a `malloc_logger`, which libmalloc calls for every allocation
+// in every zone, only while counting. With glibc, the executable defines `malloc` and its
+// relatives, which take the place of the C library's and pass the calls on to the
+// `__libc_` functions; while not counting, they only check a flag.
+
+//! `true` if allocations can be counted on this system.
+bool BACAllocationCountingIsAvailable(void);
+
+//! Sets the count to zero and starts counting.
+void BACAllocationCountingStart(void);
+
+//! Stops counting.
+//! @return The number of allocations since `BACAllocationCountingStart` was called. A
+//! `realloc` counts as one.
+uint64_t BACAllocationCountingStop(void);
+
+#endif /* BenchmarkAllocationCounter_h */
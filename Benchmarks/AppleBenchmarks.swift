@@ -0,0 +1,180 @@
+//
+//  AppleBenchmarks.swift
+//  SwiftAdditionsBenchmarks
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+import FoundationAdditions
+#if canImport(SwiftAdditions)
+import SwiftAdditions
+#endif
+#if canImport(SwiftAudioAdditions)
+import AudioToolbox
+import SwiftAudioAdditions
+#endif
+
+/// The benchmarks for the modules and CoreFoundation types that only exist on Apple platforms.
+/// Empty everywhere else.
+func appleBenchmarks() -> [Benchmark] {
+	var benchmarks = [Benchmark]()
+#if canImport(SwiftAdditions)
+	benchmarks += macTypesBenchmarks()
+	benchmarks += asciiCharacterBenchmarks()
+#endif
+#if canImport(Darwin)
+	benchmarks += coreFoundationBenchmarks()
+#endif
+#if canImport(SwiftAudioAdditions)
+	benchmarks += audioFormatBenchmarks()
+#endif
+	return benchmarks
+}
+
+#if canImport(SwiftAdditions)
+// MARK: - MacTypes
+
+private func macTypesBenchmarks() -> [Benchmark] {
+	let recordCount = 1024
+	let records = makePascalRecords(count: recordCount, highCharacters: 20)
+	let codes = makeTypeCodes(count: 4096)
+	let strings = codes.compactMap { OSTypeToString($0) }
+
+	return [
+		Benchmark(name: "String.init(pascalString:) Str255", itemsPerIteration: recordCount) {
+			var total = 0
+			records.withUnsafeBytes { (records) in
+				for record in 0 ..< recordCount {
+					let pStr = records.load(fromByteOffset: record * 256, as: Str255.self)
+					total &+= String(pascalString: pStr)?.utf8.count ?? 0
+				}
+			}
+			blackHole(total)
+		},
+		Benchmark(name: "String.init(pascalString:) pointer", itemsPerIteration: recordCount) {
+			var total = 0
+			records.withUnsafeBufferPointer { (records) in
+				for record in 0 ..< recordCount {
+					total &+= String(pascalString: records.baseAddress! + record * 256)?.utf8.count ?? 0
+				}
+			}
+			blackHole(total)
+		},
+		Benchmark(name: "OSTypeToString(_:)", itemsPerIteration: codes.count) {
+			var total = 0
+			for code in codes {
+				total &+= OSTypeToString(code)?.utf8.count ?? 0
+			}
+			blackHole(total)
+		},
+		Benchmark(name: "toOSType(_:)", itemsPerIteration: strings.count) {
+			var total: OSType = 0
+			for string in strings {
+				total ^= toOSType(string)
+			}
+			blackHole(total)
+		},
+	]
+}
+
+// MARK: - ASCII characters
+
+private func asciiCharacterBenchmarks() -> [Benchmark] {
+	let text = String(repeating: "The quick brown fox jumps over the lazy dog. 0123456789\n", count: 64)
+	let characters = text.toASCIICharacters()!
+	let swiftCharacters = Array(text)
+
+	return [
+		Benchmark(name: "String.toASCIICharacters()", itemsPerIteration: text.utf8.count, bytesPerIteration: text.utf8.count) {
+			blackHole(text.toASCIICharacters())
+		},
+		Benchmark(name: "String.init(asciiCharacters:)", itemsPerIteration: characters.count, bytesPerIteration: characters.count) {
+			blackHole(String(asciiCharacters: characters))
+		},
+		Benchmark(name: "ASCIICharacter.init(swiftCharacter:)", itemsPerIteration: swiftCharacters.count) {
+			var total = 0
+			for character in swiftCharacters {
+				total &+= Int(ASCIICharacter(swiftCharacter: character)?.rawValue ?? 0)
+			}
+			blackHole(total)
+		},
+	]
+}
+#endif
+
+#if canImport(Darwin)
+// MARK: - CoreFoundation
+
+private func coreFoundationBenchmarks() -> [Benchmark] {
+	var random = BenchmarkRandom(seed: 6)
+
+	let bitCount = 1 << 16
+	let bitVector = makeBenchmarkBits(count: bitCount).mutableCFBitVector()
+
+	let heapValues = (0 ..< 4096).map { _ in 1 + random.next(below: 1 << 30) }
+	var callBacks = CFBinaryHeapCallBacks(version: 0, retain: nil, release: nil, copyDescription: nil) { (lhs, rhs, _) -> CFComparisonResult in
+		let left = Int(bitPattern: lhs)
+		let right = Int(bitPattern: rhs)
+		return left < right ? .compareLessThan : (left > right ? .compareGreaterThan : .compareEqualTo)
+	}
+
+	return [
+		// Compare with "BitVector per-bit iteration" and "BitVector.setBitIndexes".
+		Benchmark(name: "CFBitVector iteration", itemsPerIteration: bitCount) {
+			var total = 0
+			for (index, bit) in bitVector.enumerated() where bit == 1 {
+				total &+= index
+			}
+			blackHole(total)
+		},
+		// Compare with "BitVector.count(of:)".
+		Benchmark(name: "CFBitVector.countOfBit(in:_:)", itemsPerIteration: bitCount) {
+			blackHole(bitVector.countOfBit(in: CFRange(location: 0, length: bitCount), 1))
+		},
+		Benchmark(name: "CFBitVector.bitVector.setBitIndexes", itemsPerIteration: bitCount) {
+			var total = 0
+			for index in bitVector.bitVector.setBitIndexes {
+				total &+= index
+			}
+			blackHole(total)
+		},
+		// Compare with "Heap insert and popMin".
+		Benchmark(name: "CFBinaryHeap insert and removeMinimum", itemsPerIteration: heapValues.count) {
+			let heap = CFBinaryHeapCreate(kCFAllocatorDefault, heapValues.count, &callBacks, nil)!
+			for value in heapValues {
+				CFBinaryHeapAddValue(heap, UnsafeRawPointer(bitPattern: value))
+			}
+			var total = 0
+			while let minimum = heap.minimum {
+				total &+= Int(bitPattern: minimum)
+				heap.removeMinimum()
+			}
+			blackHole(total)
+		},
+	]
+}
+#endif
+
+#if canImport(SwiftAudioAdditions)
+// MARK: - Audio formats
+
+private func audioFormatBenchmarks() -> [Benchmark] {
+	let descriptions = ["LEF32@44100", "BEI16@48000,2", "-LEUI8@8000", "aac@44100,2", "alac@96000#4096,6", "LEI24@192000/0x8,2"]
+
+	return [
+		Benchmark(name: "AudioStreamBasicDescription.init(fromText:)", itemsPerIteration: descriptions.count * 64) {
+			var total = 0
+			for _ in 0 ..< 64 {
+				for description in descriptions {
+					if let format = try? AudioStreamBasicDescription(fromText: description) {
+						total &+= Int(format.mChannelsPerFrame)
+					}
+				}
+			}
+			blackHole(total)
+		},
+	]
+}
+#endif
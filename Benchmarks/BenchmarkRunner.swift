@@ -0,0 +1,425 @@
+//
+//  BenchmarkRunner.swift
+//  SwiftAdditionsBenchmarks
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+import Dispatch
+import FoundationAdditions
+import BenchmarkAllocationCounter
+#if canImport(Darwin)
+import Darwin
+#elseif canImport(Glibc)
+import Glibc
+#endif
+
+/// One benchmark. Every iteration calls `body` once, and `body` does
+/// `itemsPerIteration` operations, so that the timer's own cost doesn't matter.
+struct Benchmark {
+	/// The name results are reported and compared under.
+	var name: String
+	/// How many operations one call to `body` does.
+	var itemsPerIteration: Int
+	/// How many bytes of input one call to `body` goes through, if that's meaningful.
+	var bytesPerIteration: Int? = nil
+	var body: () -> Void
+}
+
+/// Keeps the optimizer from throwing away a value that's never used.
+@inline(never) @_optimize(none)
+func blackHole<T>(_ value: T) {
+}
+
+// MARK: - Options
+
+enum OutputFormat: String {
+	case text
+	case json
+	case csv
+}
+
+struct BenchmarkOptions {
+	/// Only run benchmarks whose names contain one of these. Runs everything if empty.
+	var filters = [String]()
+	var warmUpIterations = 3
+	var minimumIterations = 10
+	var maximumIterations = 10_000
+	/// Keep measuring a benchmark until this many seconds have passed, within the iteration limits.
+	var minimumTime = 0.5
+	var format = OutputFormat.text
+	/// Where to write the report. Standard output if `nil`.
+	var outputPath: String?
+	/// A JSON report from an earlier run to compare against.
+	var baselinePath: String?
+	var listOnly = false
+
+	static let usage = """
+		Usage: SwiftAdditionsBenchmarks [options] [filter ...]
+
+		Runs every benchmark whose name contains one of the filters, or all of them.
+
+		Options:
+		  --format text|json|csv   The report format. Default is text.
+		  --output <path>          Write the report to a file instead of standard output.
+		  --baseline <path>        Compare medians against a JSON report from an earlier run.
+		  --warm-up <count>        Untimed iterations before measuring. Default is 3.
+		  --min-iterations <count> Default is 10.
+		  --max-iterations <count> Default is 10000.
+		  --min-time <seconds>     Measure each benchmark for at least this long. Default is 0.5.
+		  --list                   Print the benchmark names and exit.
+
+		Build with -Xswiftc -DSWIFTADDITIONS_HOT_PATH_COUNTERS to add the hot path counters and
+		allocation counts to the report.
+		"""
+
+	struct InvalidArgument: Error, CustomStringConvertible {
+		var description: String
+	}
+
+	init() {
+	}
+
+	init(arguments: [String]) throws {
+		var iterator = arguments.makeIterator()
+		func value(for option: String) throws -> String {
+			guard let value = iterator.next() else {
+				throw InvalidArgument(description: "\(option) needs a value")
+			}
+			return value
+		}
+		func count(for option: String) throws -> Int {
+			guard let count = Int(try value(for: option)), count >= 0 else {
+				throw InvalidArgument(description: "\(option) needs a non-negative integer")
+			}
+			return count
+		}
+		while let argument = iterator.next() {
+			switch argument {
+			case "--format":
+				guard let format = OutputFormat(rawValue: try value(for: argument)) else {
+					throw InvalidArgument(description: "--format must be text, json or csv")
+				}
+				self.format = format
+			case "--output":
+				outputPath = try value(for: argument)
+			case "--baseline":
+				baselinePath = try value(for: argument)
+			case "--warm-up":
+				warmUpIterations = try count(for: argument)
+			case "--min-iterations":
+				minimumIterations = Swift.max(1, try count(for: argument))
+			case "--max-iterations":
+				maximumIterations = Swift.max(1, try count(for: argument))
+			case "--min-time":
+				guard let seconds = Double(try value(for: argument)), seconds >= 0 else {
+					throw InvalidArgument(description: "--min-time needs a non-negative number")
+				}
+				minimumTime = seconds
+			case "--list":
+				listOnly = true
+			case "-h", "--help":
+				throw InvalidArgument(description: "")
+			default:
+				guard !argument.hasPrefix("-") else {
+					throw InvalidArgument(description: "Unknown option \(argument)")
+				}
+				filters.append(argument)
+			}
+		}
+		maximumIterations = Swift.max(maximumIterations, minimumIterations)
+	}
+
+	func shouldRun(_ benchmark: Benchmark) -> Bool {
+		return filters.isEmpty || filters.contains { benchmark.name.localizedCaseInsensitiveContains($0) }
+	}
+}
+
+// MARK: - Results
+
+/// Timings of one iteration, in nanoseconds.
+struct Percentiles: Codable, Hashable {
+	var minimum: Double
+	var p25: Double
+	var median: Double
+	var p75: Double
+	var p90: Double
+	var p99: Double
+	var maximum: Double
+	var mean: Double
+	var standardDeviation: Double
+
+	init(_ samples: [UInt64]) {
+		precondition(!samples.isEmpty, "There must be at least one sample")
+		let sorted = samples.sorted().map { Double($0) }
+		/// Linear interpolation between the closest ranks.
+		func percentile(_ fraction: Double) -> Double {
+			let rank = fraction * Double(sorted.count - 1)
+			let lower = Int(rank.rounded(.down))
+			let upper = Swift.min(lower + 1, sorted.count - 1)
+			return sorted[lower] + (sorted[upper] - sorted[lower]) * (rank - Double(lower))
+		}
+		minimum = sorted[0]
+		p25 = percentile(0.25)
+		median = percentile(0.5)
+		p75 = percentile(0.75)
+		p90 = percentile(0.9)
+		p99 = percentile(0.99)
+		maximum = sorted[sorted.count - 1]
+		let mean = sorted.reduce(0, +) / Double(sorted.count)
+		self.mean = mean
+		let variance = sorted.reduce(0) { $0 + ($1 - mean) * ($1 - mean) } / Double(sorted.count)
+		standardDeviation = variance.squareRoot()
+	}
+}
+
+struct BenchmarkResult: Codable {
+	var name: String
+	var iterations: Int
+	var itemsPerIteration: Int
+	var nanosecondsPerIteration: Percentiles
+	/// Based on the median iteration.
+	var itemsPerSecond: Double
+	var bytesPerSecond: Double?
+	/// How much the heap grew per iteration, counting what the benchmark kept or leaked.
+	var heapBytesPerIteration: Double?
+	/// How many more heap blocks were in use per iteration, where the allocator reports it.
+	var heapBlocksPerIteration: Double?
+	/// How many allocations one iteration made, including the ones it freed again. Only
+	/// counted in builds with the hot path counters, where the system allows it.
+	var allocationsPerIteration: Double?
+	/// The hot path counters recorded while measuring, if the package was built with them.
+	var hotPathCounters: [String: HotPathCounters.Counts]?
+	/// The median compared to the baseline's, if there was one: below *1* is faster.
+	var baselineRatio: Double?
+}
+
+struct BenchmarkReport: Codable {
+	struct System: Codable {
+		var operatingSystem: String
+		var processorCount: Int
+		var physicalMemory: UInt64
+		var hotPathCounters: Bool
+	}
+
+	var date: Date
+	var system: System
+	var results: [BenchmarkResult]
+}
+
+// MARK: - Heap statistics
+
+/// The allocator's totals for memory in use.
+///
+/// These are net numbers: they show what a benchmark keeps or leaks, not how many
+/// allocations it makes and frees again. ``BenchmarkResult/allocationsPerIteration``
+/// counts those.
+struct HeapUsage {
+	var bytes: Int
+	var blocks: Int?
+	/// `bytes` is only the low 32 bits of the total.
+	var is32Bit = false
+
+	static func current() -> HeapUsage? {
+#if canImport(Darwin)
+		var statistics = malloc_statistics_t()
+		malloc_zone_statistics(nil, &statistics)
+		return HeapUsage(bytes: Int(statistics.size_in_use), blocks: Int(statistics.blocks_in_use))
+#elseif canImport(Glibc)
+		// mallinfo2 needs glibc 2.33, so use mallinfo, whose fields are 32 bits.
+		let info = mallinfo()
+		return HeapUsage(bytes: Int(UInt32(bitPattern: info.uordblks) &+ UInt32(bitPattern: info.hblkhd)), blocks: nil, is32Bit: true)
+#else
+		return nil
+#endif
+	}
+
+	/// How many bytes the heap grew by since `earlier`. With 32-bit totals, this is right
+	/// as long as it grew or shrank by less than 2GiB.
+	func bytes(since earlier: HeapUsage) -> Int {
+		if is32Bit || earlier.is32Bit {
+			return Int(Int32(truncatingIfNeeded: bytes &- earlier.bytes))
+		}
+		return bytes - earlier.bytes
+	}
+}
+
+// MARK: - Running
+
+struct BenchmarkRunner {
+	var options: BenchmarkOptions
+
+	/// How many extra iterations count allocations, at most.
+	static let allocationCountingIterations = 10
+
+	func run(_ benchmarks: [Benchmark], progress: (String) -> Void) -> [BenchmarkResult] {
+		return benchmarks.filter(options.shouldRun).map { (benchmark) in
+			progress(benchmark.name)
+			return measure(benchmark)
+		}
+	}
+
+	func measure(_ benchmark: Benchmark) -> BenchmarkResult {
+		for _ in 0 ..< options.warmUpIterations {
+			benchmark.body()
+		}
+
+		HotPathCounters.reset()
+		let heapBefore = HeapUsage.current()
+		var samples = [UInt64]()
+		// Reserve everything up front so the samples themselves don't show up as heap growth.
+		samples.reserveCapacity(options.maximumIterations)
+		let minimumNanoseconds = UInt64(options.minimumTime * 1e9)
+		var elapsed: UInt64 = 0
+		while samples.count < options.minimumIterations || (elapsed < minimumNanoseconds && samples.count < options.maximumIterations) {
+			let start = DispatchTime.now().uptimeNanoseconds
+			benchmark.body()
+			let time = DispatchTime.now().uptimeNanoseconds - start
+			samples.append(time)
+			elapsed += time
+		}
+		let heapAfter = HeapUsage.current()
+		let counters = HotPathCounters.isEnabled ? HotPathCounters.snapshot() : nil
+
+		let timings = Percentiles(samples)
+		let seconds = Swift.max(timings.median, 1) / 1e9
+		var result = BenchmarkResult(name: benchmark.name, iterations: samples.count, itemsPerIteration: benchmark.itemsPerIteration,
+									 nanosecondsPerIteration: timings, itemsPerSecond: Double(benchmark.itemsPerIteration) / seconds)
+		result.bytesPerSecond = benchmark.bytesPerIteration.map { Double($0) / seconds }
+		if let heapBefore, let heapAfter {
+			result.heapBytesPerIteration = Double(heapAfter.bytes(since: heapBefore)) / Double(samples.count)
+			if let before = heapBefore.blocks, let after = heapAfter.blocks {
+				result.heapBlocksPerIteration = Double(after - before) / Double(samples.count)
+			}
+		}
+		result.hotPathCounters = counters
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+		if BACAllocationCountingIsAvailable() {
+			// Count in untimed iterations of their own, so counting doesn't add to the timings.
+			let iterations = Swift.min(samples.count, BenchmarkRunner.allocationCountingIterations)
+			BACAllocationCountingStart()
+			for _ in 0 ..< iterations {
+				benchmark.body()
+			}
+			result.allocationsPerIteration = Double(BACAllocationCountingStop()) / Double(iterations)
+		}
+#endif
+		return result
+	}
+}
+
+// MARK: - Reports
+
+extension BenchmarkReport {
+	init(results: [BenchmarkResult]) {
+		date = Date()
+		system = System(operatingSystem: ProcessInfo.processInfo.operatingSystemVersionString,
+						processorCount: ProcessInfo.processInfo.activeProcessorCount,
+						physicalMemory: ProcessInfo.processInfo.physicalMemory,
+						hotPathCounters: HotPathCounters.isEnabled)
+		self.results = results
+	}
+
+	static func load(from path: String) throws -> BenchmarkReport {
+		let decoder = JSONDecoder()
+		decoder.dateDecodingStrategy = .iso8601
+		return try decoder.decode(BenchmarkReport.self, from: Data(contentsOf: URL(fileURLWithPath: path)))
+	}
+
+	/// Sets the ``BenchmarkResult/baselineRatio`` of every result that `baseline` also has.
+	mutating func compare(to baseline: BenchmarkReport) {
+		var medians = [String: Double]()
+		for result in baseline.results {
+			medians[result.name] = result.nanosecondsPerIteration.median
+		}
+		for i in results.indices {
+			if let median = medians[results[i].name], median > 0 {
+				results[i].baselineRatio = results[i].nanosecondsPerIteration.median / median
+			}
+		}
+	}
+
+	func formatted(as format: OutputFormat) throws -> Data {
+		switch format {
+		case .json:
+			let encoder = JSONEncoder()
+			encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+			encoder.dateEncodingStrategy = .iso8601
+			var data = try encoder.encode(self)
+			data.append(0x0A)
+			return data
+
+		case .csv:
+			var text = "name,iterations,items_per_iteration,min_ns,p25_ns,median_ns,p75_ns,p90_ns,p99_ns,max_ns,mean_ns,stddev_ns,items_per_second,bytes_per_second,heap_bytes_per_iteration,heap_blocks_per_iteration,allocations_per_iteration,baseline_ratio\n"
+			for result in results {
+				let timings = result.nanosecondsPerIteration
+				let fields: [String] = [
+					"\"\(result.name.replacingOccurrences(of: "\"", with: "\"\""))\"",
+					String(result.iterations), String(result.itemsPerIteration),
+					String(timings.minimum), String(timings.p25), String(timings.median), String(timings.p75),
+					String(timings.p90), String(timings.p99), String(timings.maximum), String(timings.mean), String(timings.standardDeviation),
+					String(result.itemsPerSecond), result.bytesPerSecond.map { String($0) } ?? "",
+					result.heapBytesPerIteration.map { String($0) } ?? "", result.heapBlocksPerIteration.map { String($0) } ?? "",
+					result.allocationsPerIteration.map { String($0) } ?? "",
+					result.baselineRatio.map { String($0) } ?? "",
+				]
+				text += fields.joined(separator: ",") + "\n"
+			}
+			return Data(text.utf8)
+
+		case .text:
+			let nameWidth = Swift.max(9, results.map { $0.name.count }.max() ?? 0)
+			func padded(_ string: String, _ width: Int, left: Bool = false) -> String {
+				let padding = String(repeating: " ", count: Swift.max(0, width - string.count))
+				return left ? string + padding : padding + string
+			}
+			var text = padded("Benchmark", nameWidth, left: true) + "  " + padded("median", 11) + "  " + padded("p90", 11) + "  " + padded("p99", 11)
+				+ "  " + padded("items/s", 10) + "  " + padded("heap B/it", 10) + "  " + padded("allocs/it", 10) + "  " + padded("vs base", 8) + "\n"
+			for result in results {
+				let timings = result.nanosecondsPerIteration
+				text += padded(result.name, nameWidth, left: true)
+				text += "  " + padded(BenchmarkReport.duration(timings.median), 11)
+				text += "  " + padded(BenchmarkReport.duration(timings.p90), 11)
+				text += "  " + padded(BenchmarkReport.duration(timings.p99), 11)
+				text += "  " + padded(BenchmarkReport.magnitude(result.itemsPerSecond), 10)
+				text += "  " + padded(result.heapBytesPerIteration.map { String(format: "%.0f", $0) } ?? "-", 10)
+				text += "  " + padded(result.allocationsPerIteration.map { String(format: "%.1f", $0) } ?? "-", 10)
+				text += "  " + padded(result.baselineRatio.map { String(format: "%.2fx", $0) } ?? "-", 8) + "\n"
+				if let counters = result.hotPathCounters {
+					for (name, counts) in counters.sorted(by: { $0.key < $1.key }) {
+						text += "    \(name): \(counts.calls) calls, \(counts.items) items, \(BenchmarkReport.duration(Double(counts.nanoseconds))) total\n"
+					}
+				}
+			}
+			return Data(text.utf8)
+		}
+	}
+
+	private static func duration(_ nanoseconds: Double) -> String {
+		switch nanoseconds {
+		case ..<1e3:
+			return String(format: "%.0f ns", nanoseconds)
+		case ..<1e6:
+			return String(format: "%.2f µs", nanoseconds / 1e3)
+		case ..<1e9:
+			return String(format: "%.2f ms", nanoseconds / 1e6)
+		default:
+			return String(format: "%.2f s", nanoseconds / 1e9)
+		}
+	}
+
+	private static func magnitude(_ value: Double) -> String {
+		switch value {
+		case ..<1e3:
+			return String(format: "%.1f", value)
+		case ..<1e6:
+			return String(format: "%.1fK", value / 1e3)
+		case ..<1e9:
+			return String(format: "%.1fM", value / 1e6)
+		default:
+			return String(format: "%.1fG", value / 1e9)
+		}
+	}
+}
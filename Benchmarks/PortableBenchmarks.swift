@@ -0,0 +1,325 @@
+//
+//  PortableBenchmarks.swift
+//  SwiftAdditionsBenchmarks
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+import FoundationAdditions
+import SIMDAdditions
+import UTTypeOSTypes
+
+/// A fixed pseudo-random sequence, so every run measures the same input.
+struct BenchmarkRandom {
+	private var state: UInt64
+
+	init(seed: UInt64) {
+		state = seed
+	}
+
+	/// SplitMix64.
+	mutating func next() -> UInt64 {
+		state &+= 0x9e3779b97f4a7c15
+		var z = state
+		z = (z ^ (z >> 30)) &* 0xbf58476d1ce4e5b9
+		z = (z ^ (z >> 27)) &* 0x94d049bb133111eb
+		return z ^ (z >> 31)
+	}
+
+	/// A number in `0 ..< bound`.
+	mutating func next(below bound: Int) -> Int {
+		return Int(next() % UInt64(bound))
+	}
+
+	/// A byte in `range`.
+	mutating func byte(in range: ClosedRange<UInt8>) -> UInt8 {
+		return range.lowerBound + UInt8(next(below: Int(range.upperBound - range.lowerBound) + 1))
+	}
+}
+
+/// The benchmarks for the modules that build everywhere.
+func portableBenchmarks() -> [Benchmark] {
+	return fourCharacterCodeBenchmarks() + pascalStringBenchmarks() + truncationBenchmarks()
+		+ collectionBenchmarks() + osTypeTableBenchmarks() + simdBenchmarks()
+}
+
+// MARK: - OSType codecs
+
+/// `count` codes: mostly printable ASCII, some with Mac OS Roman characters above *0x7F*,
+/// and some with control characters that can't be decoded.
+func makeTypeCodes(count: Int) -> [UInt32] {
+	var random = BenchmarkRandom(seed: 1)
+	return (0 ..< count).map { (i) -> UInt32 in
+		var code: UInt32 = 0
+		for position in 0 ..< 4 {
+			let byte: UInt8
+			switch (i % 8, position) {
+			case (6, 2):
+				byte = random.byte(in: 0x80 ... 0xFF)
+			case (7, 3):
+				byte = random.byte(in: 0x00 ... 0x1F)
+			default:
+				byte = random.byte(in: 0x20 ... 0x7E)
+			}
+			code = code << 8 | UInt32(byte)
+		}
+		return code
+	}
+}
+
+private func fourCharacterCodeBenchmarks() -> [Benchmark] {
+	let codes = makeTypeCodes(count: 4096)
+	let strings = codes.compactMap { FourCharacterCode(rawValue: $0).stringValue }
+	let printable = codes.filter { FourCharacterCode(rawValue: $0).isPrintable }
+	var output = [UInt8](repeating: 0, count: codes.count * FourCharacterCode.maximumUTF8Length)
+	var lengths = [Int](repeating: 0, count: codes.count)
+
+	return [
+		Benchmark(name: "FourCharacterCode.stringValue", itemsPerIteration: codes.count) {
+			var total = 0
+			for code in codes {
+				total &+= FourCharacterCode(rawValue: code).stringValue?.utf8.count ?? 0
+			}
+			blackHole(total)
+		},
+		Benchmark(name: "FourCharacterCode.description", itemsPerIteration: codes.count) {
+			var total = 0
+			for code in codes {
+				total &+= FourCharacterCode(rawValue: code).description.utf8.count
+			}
+			blackHole(total)
+		},
+		Benchmark(name: "FourCharacterCode.init(_:)", itemsPerIteration: strings.count) {
+			var total: UInt32 = 0
+			for string in strings {
+				total ^= FourCharacterCode(string).rawValue
+			}
+			blackHole(total)
+		},
+		Benchmark(name: "FourCharacterCode.init(_:detectHex:)", itemsPerIteration: 1024) {
+			var total: UInt32 = 0
+			for i in 0 ..< 1024 {
+				total ^= FourCharacterCode(i % 2 == 0 ? "0x54455854" : "0X4150504C", detectHex: true).rawValue
+			}
+			blackHole(total)
+		},
+		Benchmark(name: "FourCharacterCode.decode(_:into:lengths:)", itemsPerIteration: codes.count, bytesPerIteration: codes.count * 4) {
+			let written = codes.withUnsafeBufferPointer { (codes) in
+				output.withUnsafeMutableBufferPointer { (output) in
+					lengths.withUnsafeMutableBufferPointer { (lengths) in
+						FourCharacterCode.decode(codes, into: output, lengths: lengths)
+					}
+				}
+			}
+			blackHole(written)
+		},
+		Benchmark(name: "FourCharacterCode.allPrintable(_:)", itemsPerIteration: printable.count, bytesPerIteration: printable.count * 4) {
+			blackHole(printable.withUnsafeBufferPointer { FourCharacterCode.allPrintable($0) })
+		},
+	]
+}
+
+// MARK: - Pascal strings
+
+/// `count` records of `Str255`'s size, each a Pascal string of 8 to 64 characters.
+/// - parameter highCharacters: How often, out of 100, a character is above *0x7F*.
+func makePascalRecords(count: Int, highCharacters: Int) -> [UInt8] {
+	var random = BenchmarkRandom(seed: 2)
+	var records = [UInt8](repeating: 0, count: count * 256)
+	for record in 0 ..< count {
+		let length = 8 + random.next(below: 57)
+		records[record * 256] = UInt8(length)
+		for i in 1 ... length {
+			records[record * 256 + i] = random.next(below: 100) < highCharacters ? random.byte(in: 0x80 ... 0xFF) : random.byte(in: 0x20 ... 0x7E)
+		}
+	}
+	return records
+}
+
+private func pascalStringBenchmarks() -> [Benchmark] {
+	let recordCount = 1024
+	let ascii = makePascalRecords(count: recordCount, highCharacters: 0)
+	let roman = makePascalRecords(count: recordCount, highCharacters: 20)
+	func decodeEach(_ records: [UInt8], encoding: ClassicMacEncoding) {
+		var total = 0
+		records.withUnsafeBytes { (records) in
+			for record in 0 ..< recordCount {
+				let bytes = UnsafeRawBufferPointer(rebasing: records[(record * 256) ..< (record * 256 + 256)])
+				total &+= PascalString.decode(bytes, encoding: encoding)?.utf8.count ?? 0
+			}
+		}
+		blackHole(total)
+	}
+
+	return [
+		Benchmark(name: "PascalString.decode(_:) ASCII", itemsPerIteration: recordCount) {
+			decodeEach(ascii, encoding: .macOSRoman)
+		},
+		Benchmark(name: "PascalString.decode(_:) Mac OS Roman", itemsPerIteration: recordCount) {
+			decodeEach(roman, encoding: .macOSRoman)
+		},
+		Benchmark(name: "PascalString.decode(records:stride:)", itemsPerIteration: recordCount) {
+			let strings = roman.withUnsafeBytes { PascalString.decode(records: $0, stride: 256) }
+			blackHole(strings)
+		},
+	]
+}
+
+// MARK: - String truncation
+
+private func truncationBenchmarks() -> [Benchmark] {
+	var random = BenchmarkRandom(seed: 3)
+	let pieces = ["Hello, world! ", "naïve café ", "👨‍👩‍👧‍👦 ", "日本語のテキスト ", "e\u{301}le\u{300}ve ", "0123456789 "]
+	let strings = (0 ..< 256).map { _ in
+		(0 ..< 4 + random.next(below: 8)).map { _ in pieces[random.next(below: pieces.count)] }.joined()
+	}
+	let bytes = strings.reduce(0) { $0 + $1.utf8.count }
+
+	return [
+		Benchmark(name: "String.substringWithLength(utf8:)", itemsPerIteration: strings.count, bytesPerIteration: bytes) {
+			var total = 0
+			for string in strings {
+				total &+= string.substringWithLength(utf8: 37).utf8.count
+			}
+			blackHole(total)
+		},
+		Benchmark(name: "String.substringWithLength(utf16:)", itemsPerIteration: strings.count, bytesPerIteration: bytes) {
+			var total = 0
+			for string in strings {
+				total &+= string.substringWithLength(utf16: 37).utf8.count
+			}
+			blackHole(total)
+		},
+	]
+}
+
+// MARK: - Collections
+
+/// The bits the bit vector benchmarks scan, about one in eight set. The CFBitVector
+/// benchmarks use the same bits.
+func makeBenchmarkBits(count: Int) -> BitVector {
+	var random = BenchmarkRandom(seed: 6)
+	return BitVector((0 ..< count).map { _ in random.next(below: 8) == 0 })
+}
+
+private func collectionBenchmarks() -> [Benchmark] {
+	var random = BenchmarkRandom(seed: 4)
+
+	let bitCount = 1 << 16
+	let bits = makeBenchmarkBits(count: bitCount)
+
+	let heapValues = (0 ..< 4096).map { _ in random.next(below: 1 << 30) }
+
+	var left = [String: Int]()
+	var right = [String: Int]()
+	for i in 0 ..< 1000 {
+		left["key \(i)"] = i
+		right["key \(i + 500)"] = -i
+	}
+
+	let array = Array(0 ..< 100_000)
+	var indexes = IndexSet()
+	for i in Swift.stride(from: 0, to: array.count, by: 3) {
+		indexes.insert(i)
+	}
+	for _ in 0 ..< 50 {
+		let start = random.next(below: array.count - 500)
+		indexes.insert(integersIn: start ..< start + random.next(below: 500))
+	}
+
+	return [
+		// One subscript call per bit, the way the CFBitVector Collection conformance walks.
+		// This is the baseline for setBitIndexes where CFBitVector isn't available.
+		Benchmark(name: "BitVector per-bit iteration", itemsPerIteration: bitCount) {
+			var total = 0
+			for index in 0 ..< bits.count where bits[index] {
+				total &+= index
+			}
+			blackHole(total)
+		},
+		Benchmark(name: "BitVector.setBitIndexes", itemsPerIteration: bitCount) {
+			var total = 0
+			for index in bits.setBitIndexes {
+				total &+= index
+			}
+			blackHole(total)
+		},
+		Benchmark(name: "BitVector.count(of:)", itemsPerIteration: bitCount) {
+			blackHole(bits.count(of: true))
+		},
+		Benchmark(name: "Heap insert and popMin", itemsPerIteration: heapValues.count) {
+			var heap = Heap<Int>()
+			heap.reserveCapacity(heapValues.count)
+			for value in heapValues {
+				heap.insert(value)
+			}
+			var total = 0
+			while let value = heap.popMin() {
+				total &+= value
+			}
+			blackHole(total)
+		},
+		Benchmark(name: "Dictionary +", itemsPerIteration: left.count + right.count) {
+			blackHole((left + right).count)
+		},
+		Benchmark(name: "Dictionary +=", itemsPerIteration: right.count) {
+			var merged = left
+			merged += right
+			blackHole(merged.count)
+		},
+		// Each iteration copies the array first, which is part of the time.
+		Benchmark(name: "Array.remove(indexes:) IndexSet", itemsPerIteration: indexes.count) {
+			var copy = array
+			copy.remove(indexes: indexes)
+			blackHole(copy.count)
+		},
+	]
+}
+
+// MARK: - Type code table
+
+private func osTypeTableBenchmarks() -> [Benchmark] {
+	let known = OSTypeTable.standard.entries.map { $0.osTypeString }
+	let unknown = ["ttro", "8BPS", "XLS8", "W8BN"]
+	// About three quarters of a file scan's type codes are common ones.
+	let codes = (0 ..< 4096).map { $0 % 4 == 3 ? unknown[($0 / 4) % unknown.count] : known[$0 % known.count] }
+	let identifiers = OSTypeTable.standard.entries.map { $0.identifier }
+
+	return [
+		Benchmark(name: "OSTypeTable.entry(forOSTypeString:)", itemsPerIteration: codes.count) {
+			var found = 0
+			for code in codes where OSTypeTable.standard.entry(forOSTypeString: code) != nil {
+				found += 1
+			}
+			blackHole(found)
+		},
+		Benchmark(name: "OSTypeTable.entry(forIdentifier:)", itemsPerIteration: identifiers.count * 64) {
+			var found = 0
+			for _ in 0 ..< 64 {
+				for identifier in identifiers where OSTypeTable.standard.entry(forIdentifier: identifier) != nil {
+					found += 1
+				}
+			}
+			blackHole(found)
+		},
+	]
+}
+
+// MARK: - SIMD kernels
+
+private func simdBenchmarks() -> [Benchmark] {
+	var random = BenchmarkRandom(seed: 5)
+	let values = (0 ..< 1 << 16).map { _ in Float(random.next(below: 2000)) - 1000 }
+	let points = (0 ..< 1 << 16).map { _ in SIMD3<Float>(Float(random.next(below: 2000)), Float(random.next(below: 2000)), Float(random.next(below: 2000))) }
+
+	return [
+		Benchmark(name: "clamp(values:minimum:maximum:) Float", itemsPerIteration: values.count, bytesPerIteration: values.count * MemoryLayout<Float>.stride) {
+			blackHole(clamp(values: values, minimum: -500, maximum: 500))
+		},
+		Benchmark(name: "[SIMD3<Float>].boundingBox()", itemsPerIteration: points.count, bytesPerIteration: points.count * MemoryLayout<SIMD3<Float>>.stride) {
+			blackHole(points.boundingBox())
+		},
+	]
+}
@@ -0,0 +1,56 @@
+//
+//  main.swift
+//  SwiftAdditionsBenchmarks
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+func printError(_ message: String) {
+	FileHandle.standardError.write(Data((message + "\n").utf8))
+}
+
+let options: BenchmarkOptions
+do {
+	options = try BenchmarkOptions(arguments: Array(CommandLine.arguments.dropFirst()))
+} catch let error as BenchmarkOptions.InvalidArgument {
+	if error.description.isEmpty {
+		print(BenchmarkOptions.usage)
+		exit(0)
+	}
+	printError(error.description)
+	printError(BenchmarkOptions.usage)
+	exit(64)
+}
+
+let benchmarks = (portableBenchmarks() + appleBenchmarks()).filter(options.shouldRun)
+guard !benchmarks.isEmpty else {
+	printError("No benchmarks match \(options.filters.joined(separator: ", "))")
+	exit(1)
+}
+
+if options.listOnly {
+	for benchmark in benchmarks {
+		print(benchmark.name)
+	}
+	exit(0)
+}
+
+do {
+	let runner = BenchmarkRunner(options: options)
+	var report = BenchmarkReport(results: runner.run(benchmarks, progress: printError))
+	if let baselinePath = options.baselinePath {
+		report.compare(to: try BenchmarkReport.load(from: baselinePath))
+	}
+	let data = try report.formatted(as: options.format)
+	if let outputPath = options.outputPath {
+		try data.write(to: URL(fileURLWithPath: outputPath))
+	} else {
+		FileHandle.standardOutput.write(data)
+	}
+} catch {
+	printError("\(error)")
+	exit(1)
+}
@@ -8,6 +8,7 @@
 
 import Foundation
 @preconcurrency import ColorSync
+import FoundationAdditions
 
 /// A class that references a ColorSync transform.
 ///
@@ -180,3 +181,34 @@ public final class CSTransform: CustomDebugStringConvertible, CustomStringConver
 		}
 	}
 }
+
+@available(macOS 10.4, tvOS 16.0, iOS 16.0, macCatalyst 16.0, *)
+public extension ICCTransform {
+	/// Creates a portable transform between two matrix/TRC profiles.
+	///
+	/// Unlike `CSTransform`, the conversion runs without ColorSync, split into row tiles
+	/// across cores.
+	/// - throws: An ``ICCProfileError`` if either profile isn't a matrix/TRC RGB or gray profile.
+	convenience init(from: CSProfile, to: CSProfile) throws {
+		try self.init(from: ICCMatrixProfile(data: from.rawData()), to: ICCMatrixProfile(data: to.rawData()))
+	}
+
+	/// Transform the data from the source color space to the destination, with the same
+	/// depths and layouts `CSTransform` takes.
+	/// - parameter width: Width of the image in pixels
+	/// - parameter height: Height of the image in pixels
+	/// - parameter destination: Information about the destination data, including a pointer to the destination where the results will be written.
+	/// - parameter source: Information about the data to be converted.
+	/// - returns: `true` if conversion was successful, or `false` if either depth isn't
+	/// 8- or 16-bit integer or 32-bit float.
+	func transform(width: Int, height: Int, destination: (data: UnsafeMutableRawPointer, depth: CSTransform.Depth, layout: CSTransform.Layout, bytesPerRow: Int), source: (data: UnsafeRawPointer, depth: CSTransform.Depth, layout: CSTransform.Layout, bytesPerRow: Int)) -> Bool {
+		guard let destinationDepth = ICCPixelFormat.Depth(rawValue: destination.depth.rawValue),
+			  let sourceDepth = ICCPixelFormat.Depth(rawValue: source.depth.rawValue) else {
+			return false
+		}
+		let destinationFormat = ICCPixelFormat(depth: destinationDepth, layout: ICCPixelFormat.Layout(rawValue: destination.layout.rawValue))
+		let sourceFormat = ICCPixelFormat(depth: sourceDepth, layout: ICCPixelFormat.Layout(rawValue: source.layout.rawValue))
+		transform(width: width, height: height, destination: (destination.data, destinationFormat, destination.bytesPerRow), source: (source.data, sourceFormat, source.bytesPerRow))
+		return true
+	}
+}
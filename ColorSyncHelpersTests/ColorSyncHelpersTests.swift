@@ -8,6 +8,7 @@
 
 import XCTest
 @testable import ColorSyncHelpers
+import FoundationAdditions
 
 
 class ColorSyncHelpersTests: XCTestCase {
@@ -323,6 +324,116 @@ class ColorSyncHelpersTests: XCTestCase {
 		}
 	}
 	
+	/// Converts random RGBA pixels from sRGB to the linear test profile with both ColorSync and
+	/// `ICCTransform`.
+	private func compareWithColorSync(depth: CSTransform.Depth, componentSize: Int) throws -> (colorSync: Data, portable: Data) {
+		guard let sRGB = CSProfile(named: kColorSyncSRGBProfile.takeUnretainedValue() as String) else {
+			throw XCTSkip("No sRGB profile")
+		}
+		let linear = try CSProfile(data: validICCNSData)
+		let colorSync = try XCTUnwrap(CSTransform(from: sRGB, to: linear))
+		let portable = try ICCTransform(from: sRGB, to: linear)
+		
+		var layout = CSTransform.Layout()
+		layout.alphaInfo = .last
+		if componentSize > 1 {
+			layout.insert(componentSize == 2 ? .byteOrder16Little : .byteOrder32Little)
+		}
+		let (width, height) = (64, 64)
+		let bytesPerRow = width * 4 * componentSize
+		var source = Data(count: bytesPerRow * height)
+		source.withUnsafeMutableBytes { (bytes) in
+			var generator = SystemRandomNumberGenerator()
+			for index in 0 ..< width * height * 4 {
+				let value = Float.random(in: 0 ... 1, using: &generator)
+				switch componentSize {
+				case 1:
+					bytes[index] = UInt8(value * 255)
+				case 2:
+					bytes.storeBytes(of: UInt16(value * 65535).littleEndian, toByteOffset: index * 2, as: UInt16.self)
+				default:
+					bytes.storeBytes(of: value.bitPattern.littleEndian, toByteOffset: index * 4, as: UInt32.self)
+				}
+			}
+		}
+		var expected = Data(count: source.count)
+		var result = Data(count: source.count)
+		try source.withUnsafeBytes { (source) in
+			try expected.withUnsafeMutableBytes { (expected) in
+				XCTAssertTrue(colorSync.transform(width: width, height: height, dst: expected.baseAddress!, dstDepth: depth, dstLayout: layout, dstBytesPerRow: bytesPerRow, src: source.baseAddress!, srcDepth: depth, srcLayout: layout, srcBytesPerRow: bytesPerRow))
+				try result.withUnsafeMutableBytes { (result) in
+					let converted = portable.transform(width: width, height: height, destination: (result.baseAddress!, depth, layout, bytesPerRow), source: (source.baseAddress!, depth, layout, bytesPerRow))
+					try XCTSkipUnless(converted, "Unsupported depth")
+				}
+			}
+		}
+		return (expected, result)
+	}
+	
+	func testICCTransformMatchesColorSync() throws {
+		let eight = try compareWithColorSync(depth: .colorSync8BitInteger, componentSize: 1)
+		for (expected, result) in zip(eight.colorSync, eight.portable) {
+			XCTAssertLessThanOrEqual(abs(Int(expected) - Int(result)), Int((ICCTransform.tolerance * 255).rounded()))
+		}
+		
+		let sixteen = try compareWithColorSync(depth: .colorSync16BitInteger, componentSize: 2)
+		sixteen.colorSync.withUnsafeBytes { (expected) in
+			sixteen.portable.withUnsafeBytes { (result) in
+				for index in stride(from: 0, to: expected.count, by: 2) {
+					let difference = abs(Int(UInt16(littleEndian: expected.loadUnaligned(fromByteOffset: index, as: UInt16.self))) - Int(UInt16(littleEndian: result.loadUnaligned(fromByteOffset: index, as: UInt16.self))))
+					XCTAssertLessThanOrEqual(Float(difference) / 65535, ICCTransform.tolerance)
+				}
+			}
+		}
+		
+		let float = try compareWithColorSync(depth: .colorSync32BitFloat, componentSize: 4)
+		float.colorSync.withUnsafeBytes { (expected) in
+			float.portable.withUnsafeBytes { (result) in
+				for index in stride(from: 0, to: expected.count, by: 4) {
+					let expectedValue = Float(bitPattern: UInt32(littleEndian: expected.loadUnaligned(fromByteOffset: index, as: UInt32.self)))
+					let value = Float(bitPattern: UInt32(littleEndian: result.loadUnaligned(fromByteOffset: index, as: UInt32.self)))
+					// ColorSync doesn't clip float output; ICCTransform does.
+					XCTAssertEqual(value, Swift.min(Swift.max(expectedValue, 0), 1), accuracy: ICCTransform.tolerance)
+				}
+			}
+		}
+	}
+	
+	private func measureTransform(_ body: (_ width: Int, _ height: Int, _ destination: UnsafeMutableRawPointer, _ source: UnsafeRawPointer, _ layout: CSTransform.Layout) -> Void) {
+		var layout = CSTransform.Layout()
+		layout.alphaInfo = .premultipliedLast
+		let (width, height) = (4096, 1024)
+		let source = [UInt8](repeating: 0x80, count: width * height * 4)
+		var destination = [UInt8](repeating: 0, count: width * height * 4)
+		measure {
+			source.withUnsafeBytes { (source) in
+				destination.withUnsafeMutableBytes { (destination) in
+					body(width, height, destination.baseAddress!, source.baseAddress!, layout)
+				}
+			}
+		}
+	}
+	
+	func testColorSyncTransformPerformance() throws {
+		guard let sRGB = CSProfile(named: kColorSyncSRGBProfile.takeUnretainedValue() as String) else {
+			throw XCTSkip("No sRGB profile")
+		}
+		let transform = try XCTUnwrap(CSTransform(from: sRGB, to: CSProfile(data: validICCNSData)))
+		measureTransform { (width, height, destination, source, layout) in
+			_ = transform.transform(width: width, height: height, dst: destination, dstDepth: .colorSync8BitInteger, dstLayout: layout, dstBytesPerRow: width * 4, src: source, srcDepth: .colorSync8BitInteger, srcLayout: layout, srcBytesPerRow: width * 4)
+		}
+	}
+	
+	func testICCTransformPerformance() throws {
+		guard let sRGB = CSProfile(named: kColorSyncSRGBProfile.takeUnretainedValue() as String) else {
+			throw XCTSkip("No sRGB profile")
+		}
+		let transform = try ICCTransform(from: sRGB, to: CSProfile(data: validICCNSData))
+		measureTransform { (width, height, destination, source, layout) in
+			_ = transform.transform(width: width, height: height, destination: (destination, .colorSync8BitInteger, layout, width * 4), source: (source, .colorSync8BitInteger, layout, width * 4))
+		}
+	}
+	
 	func testDevices() {
 		let devInfo = CSDevice.deviceInfos()
 		for di in devInfo {
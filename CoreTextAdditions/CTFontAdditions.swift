@@ -1012,6 +1012,30 @@ public extension CTFont {
 	func data(for table: TableTag, options: TableOptions = []) -> Data? {
 		return CTFontCopyTable(self, table, options) as Data?
 	}
+
+	/// Returns an ``SFNTFont`` over the font's tables.
+	///
+	/// Each table is copied out of the font once; the `SFNTFont` reads the copies in place.
+	/// Use it to map characters to glyphs or look up advances in bulk, without going through
+	/// CoreText for each array.
+	/// - parameter options: The options used when copying font tables.<br>
+	/// Default is no options.
+	/// - returns: The font's tables, or `nil` if the font has none.
+	func sfntFont(options: TableOptions = []) -> SFNTFont? {
+		guard let tags = availableTables(options: options), !tags.isEmpty else {
+			return nil
+		}
+		var tables = [CFData]()
+		var contents = [(tag: FourCharacterCode, bytes: UnsafeRawBufferPointer)]()
+		for tag in tags {
+			guard let table = CTFontCopyTable(self, tag, options) else {
+				continue
+			}
+			tables.append(table)
+			contents.append((FourCharacterCode(tag), UnsafeRawBufferPointer(start: CFDataGetBytePtr(table), count: CFDataGetLength(table))))
+		}
+		return SFNTFont(tables: contents, owner: tables as NSArray)
+	}
 	
 	/// Renders the given glyphs from the CTFont at the given positions in the CGContext.
 	///
@@ -8,6 +8,7 @@
 
 import XCTest
 import SwiftAdditions
+import FoundationAdditions
 @testable import CoreTextAdditions
 @testable import CoreTextAdditions.CTAFontManagerErrors
 
@@ -99,6 +100,44 @@ class CoreTextAdditionsTests: XCTestCase {
 		print(tables)
 	}
 	
+	func testSFNTFontMatchesCoreText() throws {
+		let aFont = CTFont("Times New Roman" as NSString, size: 12)
+		let sfnt = try XCTUnwrap(aFont.sfntFont())
+		let characterMap = try sfnt.characterMap()
+		let characters = Array("Hello, wörld — ﬁ € 😀 \u{3042}".utf16)
+		let expected = aFont.glyphs(forCharacters: characters)
+		let mapped = characterMap.glyphs(forCharacters: characters)
+		XCTAssertEqual(mapped.glyphs, expected.glyphs)
+		XCTAssertEqual(mapped.allMapped, expected.allMapped)
+		
+		let advances = try sfnt.advances()
+		let glyphs = expected.glyphs.filter({ $0 != 0 })
+		let expectedAdvances = aFont.advances(forGlyphs: glyphs, orientation: .horizontal)
+		let scale = aFont.size / CGFloat(advances.unitsPerEm)
+		let perGlyph = advances.advances(forGlyphs: glyphs)
+		for (advance, size) in zip(perGlyph.perGlyph, expectedAdvances.perGlyph) {
+			XCTAssertEqual(CGFloat(advance) * scale, size.width, accuracy: 0.0001)
+		}
+		XCTAssertEqual(CGFloat(perGlyph.all) * scale, expectedAdvances.all, accuracy: 0.001)
+	}
+	
+	func testCoreTextGlyphMappingPerformance() {
+		let aFont = CTFont("Times New Roman" as NSString, size: 12)
+		let characters = Array(String(repeating: "The quick brown fox jumps over the lazy dog. ", count: 20_000).utf16)
+		measure {
+			_ = aFont.glyphs(forCharacters: characters)
+		}
+	}
+	
+	func testSFNTGlyphMappingPerformance() throws {
+		let aFont = CTFont("Times New Roman" as NSString, size: 12)
+		let characterMap = try XCTUnwrap(aFont.sfntFont()).characterMap()
+		let characters = Array(String(repeating: "The quick brown fox jumps over the lazy dog. ", count: 20_000).utf16)
+		measure {
+			_ = characterMap.glyphs(forCharacters: characters)
+		}
+	}
+	
 	/// This tests "PostCrypt", a PostScript Type 1 outline font.
 	///
 	/// As there's no reliable way to store an old, Mac-style PostScript outlines on git,
@@ -35,6 +35,58 @@ import Foundation
 	})
 }
 
+/// Clamp variables between `minimum` and `maximum`.
+/// - parameter values: The values to clamp.
+/// - parameter minimum: The minimum value to clamp the elements in `values` to.
+/// - parameter maximum: The maximum value to clamp the elements in `values` to.
+/// - returns: a new array with the values clamped between `minimum` and `maximum`.
+///
+/// Arrays of SIMD scalars are clamped eight elements at a time by the in-place
+/// `clamp(_:minimum:maximum:)` that takes a buffer.
+///
+/// If `minimum` is greater than `maximum`, a fatal error occurs.
+@inlinable public func clamp<X: SIMDScalar & Comparable>(values: [X], minimum: X, maximum: X) -> [X] {
+	var result = values
+	result.withUnsafeMutableBufferPointer { buffer in
+		clamp(buffer, minimum: minimum, maximum: maximum)
+	}
+	return result
+}
+
+/// Clamps the values in `values` between `minimum` and `maximum` in place.
+/// - parameter values: The values to clamp.
+/// - parameter minimum: The minimum value to clamp the elements in `values` to.
+/// - parameter maximum: The maximum value to clamp the elements in `values` to.
+///
+/// Works eight elements at a time with lane-wise comparisons, so it vectorizes even when
+/// the compiler can't see through `min`/`max`. NaN stays NaN, as with the scalar
+/// `clamp(_:minimum:maximum:)`.
+///
+/// If `minimum` is greater than `maximum`, a fatal error occurs.
+@inlinable public func clamp<X: SIMDScalar & Comparable>(_ values: UnsafeMutableBufferPointer<X>, minimum: X, maximum: X) {
+	precondition(minimum <= maximum, "Minimum (\(minimum)) is greater than maximum (\(maximum))!")
+	guard let base = values.baseAddress else {
+		return
+	}
+	let lower = SIMD8<X>(repeating: minimum)
+	let upper = SIMD8<X>(repeating: maximum)
+	let raw = UnsafeMutableRawPointer(base)
+	let count = values.count
+	var index = 0
+	while index + 8 <= count {
+		let offset = index * MemoryLayout<X>.stride
+		var vector = raw.loadUnaligned(fromByteOffset: offset, as: SIMD8<X>.self)
+		vector.replace(with: upper, where: vector .> upper)
+		vector.replace(with: lower, where: vector .< lower)
+		raw.storeBytes(of: vector, toByteOffset: offset, as: SIMD8<X>.self)
+		index += 8
+	}
+	while index < count {
+		base[index] = max(min(base[index], maximum), minimum)
+		index += 1
+	}
+}
+
 /// Errors encountered when attempting to create an array by reflecting into
 /// the data type.
 public enum ReflectError: Error {
@@ -47,6 +99,10 @@ public enum ReflectError: Error {
 /// Best used for tuples of the same type, which Swift converts fixed-sized C arrays into.
 /// Will throw if any type in the mirror doesn't match `X`.
 ///
+/// Every element is boxed while reflecting, so this is slow for large tuples.
+/// If you know the tuple's element type, use ``arrayFromTuple(_:of:appendLastObject:)``
+/// or ``withUnsafeElements(of:as:_:)`` instead.
+///
 /// - parameter obj: The base object to get the data from.
 /// - parameter lastObj: Appends the element at the end of the array.<br>
 /// Best used for a fixed-size C array that expects to be NULL-terminated, like a C string.
@@ -70,6 +126,102 @@ public enum ReflectError: Error {
 	return anArray
 }
 
+/// Checks that `Tuple` can be viewed as a contiguous buffer of `Element`.
+///
+/// The values are all from `MemoryLayout`, so the check is folded away once
+/// the caller is specialized.
+///
+/// A tuple has no padding after its last element, so its size is only a multiple of the
+/// element's stride when the element's size and stride are the same.
+@inlinable @inline(__always)
+internal func tupleElementCount<Tuple, Element>(_ tuple: Tuple.Type, of element: Element.Type) -> Int {
+	if MemoryLayout<Tuple>.size == 0 {
+		return 0
+	}
+	precondition(MemoryLayout<Element>.stride > 0 &&
+				 MemoryLayout<Tuple>.size >= MemoryLayout<Element>.size &&
+				 (MemoryLayout<Tuple>.size - MemoryLayout<Element>.size) % MemoryLayout<Element>.stride == 0 &&
+				 MemoryLayout<Tuple>.stride % MemoryLayout<Element>.stride == 0 &&
+				 MemoryLayout<Tuple>.alignment == MemoryLayout<Element>.alignment,
+				 "\(Tuple.self) is not a homogeneous tuple of \(Element.self)")
+	return (MemoryLayout<Tuple>.size - MemoryLayout<Element>.size) / MemoryLayout<Element>.stride + 1
+}
+
+/// Calls `body` with a buffer over the elements of a homogeneous tuple, without copying them
+/// into an array or boxing them.
+///
+/// Best used for tuples of the same type, which Swift converts fixed-sized C arrays into.
+/// If the tuple's layout doesn't match a contiguous array of `Element`, a fatal error occurs.
+/// - parameter tuple: The tuple to view.
+/// - parameter element: The type of the tuple's elements.
+/// - parameter body: A closure that takes a buffer over the tuple's elements.
+/// The buffer is only valid for the duration of the closure.
+/// - returns: The return value of `body`.
+@inlinable public func withUnsafeElements<Tuple, Element, Result>(of tuple: Tuple, as element: Element.Type, _ body: (_ buffer: UnsafeBufferPointer<Element>) throws -> Result) rethrows -> Result {
+	let count = tupleElementCount(Tuple.self, of: Element.self)
+	var tuple = tuple
+	return try withUnsafeMutablePointer(to: &tuple) { (ptr) throws -> Result in
+		return try ptr.withMemoryRebound(to: Element.self, capacity: count) { (elements) throws -> Result in
+			return try body(UnsafeBufferPointer(start: elements, count: count))
+		}
+	}
+}
+
+/// Calls `body` with a mutable buffer over the elements of a homogeneous tuple, in place.
+///
+/// If the tuple's layout doesn't match a contiguous array of `Element`, a fatal error occurs.
+/// - parameter tuple: The tuple to view and modify.
+/// - parameter element: The type of the tuple's elements.
+/// - parameter body: A closure that takes a mutable buffer over the tuple's elements.
+/// The buffer is only valid for the duration of the closure.
+/// - returns: The return value of `body`.
+@inlinable public func withUnsafeMutableElements<Tuple, Element, Result>(of tuple: inout Tuple, as element: Element.Type, _ body: (_ buffer: UnsafeMutableBufferPointer<Element>) throws -> Result) rethrows -> Result {
+	let count = tupleElementCount(Tuple.self, of: Element.self)
+	return try withUnsafeMutablePointer(to: &tuple) { (ptr) throws -> Result in
+		return try ptr.withMemoryRebound(to: Element.self, capacity: count) { (elements) throws -> Result in
+			return try body(UnsafeMutableBufferPointer(start: elements, count: count))
+		}
+	}
+}
+
+/// Calls `body` with a buffer over the elements of a homogeneous tuple, up to, but not including,
+/// the first element that `sentinelChecker` returns `true` for.
+///
+/// Useful for fixed-sized C arrays that might be terminated early, like a C string.
+/// If there is no sentinel, the buffer covers the whole tuple.
+/// - parameter tuple: The tuple to view.
+/// - parameter element: The type of the tuple's elements.
+/// - parameter sentinelChecker: Returns `true` if the element is the sentinel.
+/// - parameter body: A closure that takes a buffer over the tuple's elements before the sentinel.
+/// - returns: The return value of `body`.
+@inlinable public func withUnsafeElements<Tuple, Element, Result>(of tuple: Tuple, as element: Element.Type, sentinel sentinelChecker: (_ toCheck: Element) -> Bool, _ body: (_ buffer: UnsafeBufferPointer<Element>) throws -> Result) rethrows -> Result {
+	return try withUnsafeElements(of: tuple, as: Element.self) { (buffer) throws -> Result in
+		let end = buffer.firstIndex(where: sentinelChecker) ?? buffer.endIndex
+		return try body(UnsafeBufferPointer(rebasing: buffer[..<end]))
+	}
+}
+
+/// Creates an array of type `Element` from a homogeneous tuple with a single copy.
+///
+/// Unlike ``arrayFromObject(reflecting:appendLastObject:)``, the element type is known
+/// statically, so nothing is boxed and there is nothing to throw.
+/// - parameter tuple: The tuple to copy the elements from.
+/// - parameter element: The type of the tuple's elements.
+/// - parameter lastObj: Appends the element at the end of the array.
+/// If passed `nil`, no object will be put on the end of the array. Default is `nil`.
+/// - returns: an array of `Element` objects.
+@inlinable public func arrayFromTuple<Tuple, Element>(_ tuple: Tuple, of element: Element.Type, appendLastObject lastObj: Element? = nil) -> [Element] {
+	return withUnsafeElements(of: tuple, as: Element.self) { (buffer) -> [Element] in
+		var anArray = [Element]()
+		anArray.reserveCapacity(buffer.count + 1)
+		anArray.append(contentsOf: buffer)
+		if let lastObj {
+			anArray.append(lastObj)
+		}
+		return anArray
+	}
+}
+
 /// Runs the closure on the main thread immediately if ran from the main thread,
 /// or puts it on the main dispatch queue and waits for it to complete.
 ///
@@ -141,6 +293,105 @@ public extension Dictionary {
 
 // MARK: - Array additions
 
+/// Moves `count` elements from `source` to `destination` inside of `buffer`.
+/// `destination` must not be after `source`.
+///
+/// Trivial types are moved with a single `memmove`.
+@inline(__always)
+private func moveBlock<T>(_ buffer: UnsafeMutableBufferPointer<T>, from source: Int, count: Int, to destination: Int) {
+	guard count > 0, source != destination else {
+		return
+	}
+	if _isPOD(T.self) {
+		let base = buffer.baseAddress!
+		UnsafeMutableRawPointer(base + destination).copyMemory(from: base + source, byteCount: count * MemoryLayout<T>.stride)
+	} else {
+		for k in 0 ..< count {
+			buffer[destination + k] = buffer[source + k]
+		}
+	}
+}
+
+/// Moves the elements in `bounds` that aren't in any of the sorted, non-overlapping
+/// `ranges` to the front of `bounds`, by contiguous block.
+/// - returns: The end of the kept elements.
+private func compact<T, R: Sequence>(_ buffer: UnsafeMutableBufferPointer<T>, removing ranges: R, in bounds: Range<Int>) -> Int where R.Element == Range<Int> {
+	var write = bounds.lowerBound
+	var read = bounds.lowerBound
+	for range in ranges {
+		let range = range.clamped(to: bounds)
+		guard !range.isEmpty, range.lowerBound >= read else {
+			continue
+		}
+		moveBlock(buffer, from: read, count: range.lowerBound - read, to: write)
+		write += range.lowerBound - read
+		read = range.upperBound
+	}
+	moveBlock(buffer, from: read, count: bounds.upperBound - read, to: write)
+	return write + (bounds.upperBound - read)
+}
+
+/// Returns the index of the next bit at or after `start` that is `value` in `words`.
+@inline(__always)
+private func nextBit(in words: UnsafeBufferPointer<UInt64>, from start: Int, equalTo value: Bool, limit: Int) -> Int? {
+	var wordIdx = start >> 6
+	guard wordIdx < words.count, start < limit else {
+		return nil
+	}
+	var word = (value ? words[wordIdx] : ~words[wordIdx]) & (UInt64.max << UInt64(start & 63))
+	while word == 0 {
+		wordIdx += 1
+		guard wordIdx < words.count else {
+			return nil
+		}
+		word = value ? words[wordIdx] : ~words[wordIdx]
+	}
+	let found = wordIdx << 6 + word.trailingZeroBitCount
+	return found < limit ? found : nil
+}
+
+/// The runs of set bits in `words`, as ranges, found with trailing zero counts
+/// instead of testing every bit.
+private func setBitRanges(in words: UnsafeBufferPointer<UInt64>, limit: Int) -> UnfoldSequence<Range<Int>, Int> {
+	return sequence(state: 0) { (position) -> Range<Int>? in
+		guard let start = nextBit(in: words, from: position, equalTo: true, limit: limit) else {
+			return nil
+		}
+		let end = nextBit(in: words, from: start, equalTo: false, limit: limit) ?? limit
+		position = end
+		return start ..< end
+	}
+}
+
+/// The runs of consecutive values in a sorted sequence of integers, as ranges.
+private func consecutiveRanges<C: Sequence>(in sortedIndexes: C) -> UnfoldSequence<Range<Int>, (C.Iterator, Int?)> where C.Element == Int {
+	var iter = sortedIndexes.makeIterator()
+	let first = iter.next()
+	return sequence(state: (iter, first)) { (state) -> Range<Int>? in
+		guard let start = state.1 else {
+			return nil
+		}
+		var end = start + 1
+		while true {
+			guard let next = state.0.next() else {
+				state.1 = nil
+				break
+			}
+			precondition(next >= end - 1, "Indexes are not sorted")
+			if next > end {
+				state.1 = next
+				break
+			} else if next == end {
+				end += 1
+			}
+		}
+		return start ..< end
+	}
+}
+
+/// Removing in parallel only pays off past this many elements.
+private let concurrentRemovalThreshold = 1 << 20
+
 public extension RangeReplaceableCollection where Index == Int, Self: MutableCollection {
 	/// Removes objects at indexes that are in the specified `NSIndexSet`.
 	/// - parameter indexes: the index set containing the indexes of objects that will be removed
@@ -148,35 +399,190 @@ public extension RangeReplaceableCollection where Index == Int, Self: MutableCol
 		self.remove(indexes: indexes as IndexSet)
 	}
 	
-	// Code taken from https://stackoverflow.com/a/50835467/1975001
 	/// Removes objects at indexes that are in the specified `IndexSet`.
+	///
+	/// The surviving elements are moved by contiguous block, walking the ranges of `indexes`
+	/// directly. Indexes that are out of bounds are ignored.
 	/// - parameter indexes: the index set containing the indexes of objects that will be removed
 	mutating func remove(indexes: IndexSet) {
-		guard var i = indexes.first, i < count else {
-			return
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+		let signpost = HotPathCounters.begin()
+		defer {
+			HotPathCounters.Slot.removeIndexes.end(since: signpost, items: indexes.count)
 		}
-		var j = index(after: i)
-		var k = indexes.integerGreaterThan(i) ?? endIndex
-		while j != endIndex {
-			if k != j {
-				swapAt(i, j)
-				formIndex(after: &i)
-			} else {
-				k = indexes.integerGreaterThan(k) ?? endIndex
+#endif
+		removeRanges(indexes.rangeView)
+	}
+	
+	/// Removes objects at indexes that are in the specified `IndexSet`.
+	/// - parameter indexes: the index set containing the indexes of objects that will be removed
+	/// - parameter concurrently: If `true` and the collection is large and has contiguous storage,
+	/// the collection is split into chunks that are compacted on multiple cores.
+	mutating func remove(indexes: IndexSet, concurrently: Bool) {
+		if concurrently {
+			let chunked = removeConcurrently { (chunk) -> IndexSet.RangeView in
+				return indexes.rangeView(of: chunk)
+			}
+			if chunked {
+				return
 			}
-			formIndex(after: &j)
 		}
-		removeSubrange(i...)
+		removeRanges(indexes.rangeView)
 	}
 	
 	/// Removes objects at indexes that are in the specified integer sequence.
 	///
-	/// Internally creates an `IndexSet` so the items are in order.
+	/// Internally sorts the indexes if they aren't already sorted, so the items are in order.
 	/// - parameter ixs: the integer sequence containing the indexes of objects that will be removed
-	@inlinable mutating func remove<B: Sequence>(indexes ixs: B) where B.Iterator.Element == Int {
-		let idxSet = IndexSet(ixs)
-		remove(indexes: idxSet)
+	mutating func remove<B: Sequence>(indexes ixs: B) where B.Iterator.Element == Int {
+		var sorted = Array(ixs)
+		if zip(sorted, sorted.dropFirst()).contains(where: { $0 > $1 }) {
+			sorted.sort()
+		}
+		remove(sortedIndexes: sorted)
+	}
+	
+	/// Removes objects at the specified indexes, which must be sorted in ascending order.
+	///
+	/// Duplicate and out-of-bounds indexes are ignored. If the indexes aren't sorted,
+	/// a fatal error occurs; use `remove(indexes:)` for unsorted indexes.
+	/// - parameter sortedIndexes: the sorted indexes of objects that will be removed
+	mutating func remove<C: Collection>(sortedIndexes: C) where C.Element == Int {
+		removeRanges(consecutiveRanges(in: sortedIndexes))
+	}
+	
+	/// Removes objects whose bit is set in `mask`.
+	///
+	/// Bit `i % 64` of `mask[i / 64]` corresponds to index `startIndex + i`.
+	/// Runs of set bits are found a word at a time.
+	/// - parameter mask: the bit mask of the objects that will be removed
+	/// - parameter concurrently: If `true` and the collection is large and has contiguous storage,
+	/// the collection is split into chunks that are compacted on multiple cores.
+	/// Default is `false`.
+	mutating func remove(mask: [UInt64], concurrently: Bool = false) {
+		mask.withUnsafeBufferPointer { (words) in
+			let limit = count
+			if concurrently {
+				let chunked = removeConcurrently { (chunk) -> UnfoldSequence<Range<Int>, Int> in
+					// Chunks are aligned to whole words.
+					let firstWord = min(words.count, chunk.lowerBound >> 6)
+					let chunkWords = UnsafeBufferPointer(rebasing: words[firstWord ..< max(firstWord, min(words.count, (chunk.upperBound + 63) >> 6))])
+					return setBitRanges(in: chunkWords, limit: chunk.count)
+				} offset: { (chunk) -> Int in
+					return chunk.lowerBound
+				}
+				if chunked {
+					return
+				}
+			}
+			let base = startIndex
+			removeRanges(setBitRanges(in: words, limit: limit).lazy.map { (base + $0.lowerBound) ..< (base + $0.upperBound) })
+		}
+	}
+	
+	/// Removes objects whose index passes `shouldRemove`.
+	/// - parameter shouldRemove: Returns `true` if the object at the index should be removed.
+	mutating func remove(indexesWhere shouldRemove: (Int) throws -> Bool) rethrows {
+		var toRemove = [Range<Int>]()
+		var runStart: Int? = nil
+		for i in startIndex ..< endIndex {
+			if try shouldRemove(i) {
+				if runStart == nil {
+					runStart = i
+				}
+			} else if let start = runStart {
+				toRemove.append(start ..< i)
+				runStart = nil
+			}
+		}
+		if let start = runStart {
+			toRemove.append(start ..< endIndex)
+		}
+		removeRanges(toRemove)
+	}
+	
+	/// Compacts the collection by removing the sorted, non-overlapping `ranges`.
+	private mutating func removeRanges<R: Sequence>(_ ranges: R) where R.Element == Range<Int> {
+		let bounds = startIndex ..< endIndex
+		if let newEnd = withContiguousMutableStorageIfAvailable({ (buffer) -> Int in
+			// The buffer is zero-based, even if the collection isn't.
+			let offsetRanges = ranges.lazy.map { ($0.lowerBound - bounds.lowerBound) ..< ($0.upperBound - bounds.lowerBound) }
+			return compact(buffer, removing: offsetRanges, in: 0 ..< buffer.count) + bounds.lowerBound
+		}) {
+			removeSubrange(newEnd ..< endIndex)
+			return
+		}
+		var write = bounds.lowerBound
+		var read = bounds.lowerBound
+		func moveKept(upTo end: Int) {
+			while read < end {
+				if write != read {
+					self[write] = self[read]
+				}
+				write += 1
+				read += 1
+			}
+		}
+		for range in ranges {
+			let range = range.clamped(to: bounds)
+			guard !range.isEmpty, range.lowerBound >= read else {
+				continue
+			}
+			moveKept(upTo: range.lowerBound)
+			read = range.upperBound
+		}
+		moveKept(upTo: bounds.upperBound)
+		removeSubrange(write ..< endIndex)
 	}
+	
+	/// Compacts chunks of the collection in parallel, then joins them.
+	/// - parameter rangesInChunk: Returns the removal ranges that intersect a chunk.
+	/// - parameter offset: Returns the amount to add to the ranges returned by `rangesInChunk`.
+	/// - returns: `false` if the collection is too small or doesn't have contiguous storage,
+	/// in which case nothing is changed.
+	private mutating func removeConcurrently<R: Sequence>(rangesInChunk: (Range<Int>) -> R, offset: (Range<Int>) -> Int = { _ in 0 }) -> Bool where R.Element == Range<Int> {
+		let cores = ProcessInfo.processInfo.activeProcessorCount
+		guard cores > 1, count >= concurrentRemovalThreshold, startIndex == 0 else {
+			return false
+		}
+		// Word-aligned chunk sizes keep bit mask chunks from sharing a word.
+		let chunkCount = min(cores * 4, count / (concurrentRemovalThreshold / 8))
+		let chunkSize = ((count + chunkCount - 1) / chunkCount + 63) & ~63
+		let total = count
+		let newEnd = withContiguousMutableStorageIfAvailable { (buffer) -> Int in
+			var kept = [Int](repeating: 0, count: chunkCount)
+			kept.withUnsafeMutableBufferPointer { (kept) in
+				DispatchQueue.concurrentPerform(iterations: chunkCount) { (chunkIdx) in
+					let chunk = min(chunkIdx * chunkSize, total) ..< min((chunkIdx + 1) * chunkSize, total)
+					let shift = offset(chunk)
+					let ranges = rangesInChunk(chunk).lazy.map { ($0.lowerBound + shift) ..< ($0.upperBound + shift) }
+					kept[chunkIdx] = compact(buffer, removing: ranges, in: chunk) - chunk.lowerBound
+				}
+			}
+			var write = kept[0]
+			for chunkIdx in 1 ..< chunkCount {
+				let chunkStart = min(chunkIdx * chunkSize, total)
+				moveBlock(buffer, from: chunkStart, count: kept[chunkIdx], to: write)
+				write += kept[chunkIdx]
+			}
+			return write
+		}
+		guard let newEnd else {
+			return false
+		}
+		removeSubrange(newEnd ..< endIndex)
+		return true
+	}
+}
+
+/// Sorts `array` with native sort keys if its elements are `providing`, and every descriptor
+/// resolves to a sort key.
+private func sortedNatively<Provider: SortKeyProviding, Element>(_ array: [Element], as providing: Provider.Type, using descriptors: [NSSortDescriptor]) -> [Element]? {
+	guard let typed = array as? [Provider],
+		  let sorted = typed.sortedNatively(using: descriptors) else {
+		return nil
+	}
+	return sorted as? [Element]
 }
 
 public extension Array where Element: AnyObject {
@@ -184,8 +590,14 @@ public extension Array where Element: AnyObject {
 	/// - parameter descriptors: The `NSSortDescriptor`s to sort the array with.
 	/// - returns: This array, sorted by `descriptors`.
 	///
-	/// This *may* be expensive, in both memory and computation!
+	/// If `Element` conforms to ``SortKeyProviding`` and provides a sort key for every
+	/// descriptor, the keys are read once per element and sorted natively. Otherwise, this
+	/// *may* be expensive, in both memory and computation!
 	func sorted(using descriptors: [NSSortDescriptor]) -> [Element] {
+		if let providing = Element.self as? any SortKeyProviding.Type,
+		   let sorted = sortedNatively(self, as: providing, using: descriptors) {
+			return sorted
+		}
 		let sortedArray = (self as NSArray).sortedArray(using: descriptors)
 		
 		return sortedArray as! [Element]
@@ -194,7 +606,7 @@ public extension Array where Element: AnyObject {
 	/// Sorts the current array by using `NSSortDescriptor`s.
 	/// - parameter descriptors: The `NSSortDescriptor`s to sort the array with.
 	///
-	/// This *may* be expensive, in both memory and computation!
+	/// See ``sorted(using:)`` for when this can avoid key-value coding.
 	mutating func sort(using descriptors: [NSSortDescriptor]) {
 		self = sorted(using: descriptors)
 	}
@@ -207,46 +619,26 @@ public extension String {
 	/// up to `len` UTF-8 characters long, truncating incomplete
 	/// Swift characters at the end.
 	func substringWithLength(utf8 len: Int) -> String {
-		let ourUTF = utf8
-		guard ourUTF.count > len else {
-			return self
-		}
-		var pref = ourUTF.prefix(len)
-		var toRet = String(pref)
-		var len2 = len
-		while len2 > 0 {
-			if let toRet {
-				return toRet
-			}
-			len2 -= 1
-			pref = ourUTF.prefix(len2)
-			toRet = String(pref)
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+		let signpost = HotPathCounters.begin()
+		defer {
+			HotPathCounters.Slot.substringWithLengthUTF8.end(since: signpost, items: len)
 		}
-		
-		return ""
+#endif
+		return String(self[..<truncationIndex(utf8: len)])
 	}
 
 	/// Creates a new `String` with the contents of `self`
 	/// up to `len` UTF-16 characters long, truncating incomplete
 	/// Swift characters at the end.
 	func substringWithLength(utf16 len: Int) -> String {
-		let ourUTF = utf16
-		guard ourUTF.count > len else {
-			return self
-		}
-		var pref = ourUTF.prefix(len)
-		var toRet = String(pref)
-		var len2 = len
-		while len2 > 0 {
-			if let toRet {
-				return toRet
-			}
-			len2 -= 1
-			pref = ourUTF.prefix(len2)
-			toRet = String(pref)
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+		let signpost = HotPathCounters.begin()
+		defer {
+			HotPathCounters.Slot.substringWithLengthUTF16.end(since: signpost, items: len)
 		}
-		
-		return ""
+#endif
+		return String(self[..<truncationIndex(utf16: len)])
 	}
 }
 
@@ -344,6 +736,7 @@ public extension UnsafeMutableBufferPointer {
 	}
 }
 
+#if canImport(Darwin)
 /// Protocol where Swift classes/structs where the `RawValue` is a `CFString`, making it so that `description`
 /// is the same as the `rawValue`; and `init?(_:)` is the same as converting the `String` to `CFString`
 /// and passing it to `init?(rawValue:)`.
@@ -359,3 +752,12 @@ public extension RawLosslessStringConvertibleCFString {
 		return rawValue as String
 	}
 }
+#endif
+
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+private extension HotPathCounters.Slot {
+	static let removeIndexes = HotPathCounters.Slot("RangeReplaceableCollection.remove(indexes:)")
+	static let substringWithLengthUTF8 = HotPathCounters.Slot("String.substringWithLength(utf8:)")
+	static let substringWithLengthUTF16 = HotPathCounters.Slot("String.substringWithLength(utf16:)")
+}
+#endif
@@ -0,0 +1,496 @@
+//
+//  BitVector.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// A bit vector stored as 64-bit words, without any CoreFoundation calls.
+///
+/// Counting, searching, and bitwise operations work a word at a time, and the set bits
+/// can be iterated without visiting every bit. Use `BitVector(_:)` with a `CFBitVector`
+/// and ``cfBitVector(allocator:)`` to convert to and from CoreFoundation.
+///
+/// Bit *i* is stored in bit `i % 64` of word `i / 64`. Bits past ``count`` in the last
+/// word are always zero.
+public struct BitVector: Hashable, Sendable {
+	@usableFromInline
+	internal var words: ContiguousArray<UInt64>
+
+	/// The number of bit values.
+	public private(set) var count: Int
+
+	/// Creates an empty bit vector.
+	@inlinable public init() {
+		words = []
+		count = 0
+	}
+
+	/// Creates a bit vector with `count` bits, all set to `value`.
+	public init(count: Int, repeating value: Bool = false) {
+		precondition(count >= 0, "Count must not be negative")
+		words = ContiguousArray(repeating: value ? ~0 : 0, count: BitVector.wordCount(for: count))
+		self.count = count
+		clearTail()
+	}
+
+	/// Creates a bit vector from a sequence of `Bool`s.
+	public init<S: Sequence>(_ bits: S) where S.Element == Bool {
+		self.init()
+		words.reserveCapacity(BitVector.wordCount(for: bits.underestimatedCount))
+		for bit in bits {
+			append(bit)
+		}
+	}
+
+	/// Creates a bit vector from 64-bit words.
+	/// - parameter words: The words, with bit *i* of the vector in bit `i % 64` of word `i / 64`.
+	/// - parameter count: The number of bits. Must not be more than `words.count * 64`.
+	/// Default is every bit in `words`.
+	public init<C: Collection>(words: C, count: Int? = nil) where C.Element == UInt64 {
+		let count = count ?? words.count * 64
+		precondition(count >= 0 && count <= words.count * 64, "Count is out of bounds")
+		self.words = ContiguousArray(words.prefix(BitVector.wordCount(for: count)))
+		self.count = count
+		clearTail()
+	}
+
+	@inlinable @inline(__always)
+	static func wordCount(for bitCount: Int) -> Int {
+		return (bitCount + 63) >> 6
+	}
+
+	/// Zeroes the bits past `count` in the last word.
+	@inline(__always)
+	private mutating func clearTail() {
+		let used = count & 63
+		if used != 0 {
+			words[words.count - 1] &= ~0 >> UInt64(64 - used)
+		}
+	}
+
+	/// Calls `body` with the mask of bits inside `range` for each word that `range` touches.
+	@inline(__always)
+	private static func forEachWord(in range: Range<Int>, _ body: (_ wordIndex: Int, _ mask: UInt64) throws -> Void) rethrows {
+		guard !range.isEmpty else {
+			return
+		}
+		let firstWord = range.lowerBound >> 6
+		let lastWord = (range.upperBound - 1) >> 6
+		let firstMask: UInt64 = ~0 << UInt64(range.lowerBound & 63)
+		let lastMask: UInt64 = ~0 >> UInt64(63 - ((range.upperBound - 1) & 63))
+		if firstWord == lastWord {
+			try body(firstWord, firstMask & lastMask)
+			return
+		}
+		try body(firstWord, firstMask)
+		for word in (firstWord + 1) ..< lastWord {
+			try body(word, ~0)
+		}
+		try body(lastWord, lastMask)
+	}
+
+	@inline(__always)
+	private func checkRange(_ range: Range<Int>) {
+		precondition(range.lowerBound >= 0 && range.upperBound <= count, "Range is out of bounds")
+	}
+
+	/// Calls `body` with the words of the bit vector.
+	@inlinable public func withUnsafeWords<R>(_ body: (UnsafeBufferPointer<UInt64>) throws -> R) rethrows -> R {
+		return try words.withUnsafeBufferPointer(body)
+	}
+
+	/// Adds a bit to the end of the vector.
+	public mutating func append(_ bit: Bool) {
+		if count & 63 == 0 {
+			words.append(0)
+		}
+		if bit {
+			words[count >> 6] |= 1 << UInt64(count & 63)
+		}
+		count += 1
+	}
+
+	/// Changes the size of the vector.
+	/// - parameter count: The new size. If greater than the current size,
+	/// the additional bit values are set to `false`.
+	public mutating func setCount(_ count: Int) {
+		precondition(count >= 0, "Count must not be negative")
+		let newWordCount = BitVector.wordCount(for: count)
+		if newWordCount < words.count {
+			words.removeLast(words.count - newWordCount)
+		} else if newWordCount > words.count {
+			words.append(contentsOf: repeatElement(0, count: newWordCount - words.count))
+		}
+		self.count = count
+		clearTail()
+	}
+}
+
+// MARK: - Counting and searching
+
+public extension BitVector {
+	/// Counts the number of times a bit value occurs within a range of bits,
+	/// using the population count of each word.
+	/// - parameter value: The bit value to count.
+	/// - parameter range: The range of bits to search.
+	/// - returns: The number of occurrences of `value` in `range`.
+	func count(of value: Bool, in range: Range<Int>) -> Int {
+		checkRange(range)
+		var ones = 0
+		words.withUnsafeBufferPointer { (words) in
+			BitVector.forEachWord(in: range) { (word, mask) in
+				ones += (words[word] & mask).nonzeroBitCount
+			}
+		}
+		return value ? ones : range.count - ones
+	}
+
+	/// Counts the number of times a bit value occurs in the vector.
+	@inlinable func count(of value: Bool) -> Int {
+		return count(of: value, in: 0 ..< self.count)
+	}
+
+	/// The number of bits set to `true`.
+	var nonzeroBitCount: Int {
+		return words.reduce(0) { $0 + $1.nonzeroBitCount }
+	}
+
+	/// Returns whether a range of bits contains a particular bit value.
+	/// - parameter value: The bit value for which to search.
+	/// - parameter range: The range of bits to search.
+	@inlinable func contains(_ value: Bool, in range: Range<Int>) -> Bool {
+		return firstIndex(of: value, in: range) != nil
+	}
+
+	/// Returns whether the vector contains a particular bit value, checking a word at a time.
+	@inlinable func contains(_ value: Bool) -> Bool {
+		return firstIndex(of: value, in: 0 ..< self.count) != nil
+	}
+
+	/// Locates the first occurrence of a bit value, checking a word at a time.
+	@inlinable func firstIndex(of value: Bool) -> Int? {
+		return firstIndex(of: value, in: 0 ..< self.count)
+	}
+
+	/// Locates the last occurrence of a bit value, checking a word at a time.
+	@inlinable func lastIndex(of value: Bool) -> Int? {
+		return lastIndex(of: value, in: 0 ..< self.count)
+	}
+
+	/// Locates the first occurrence of a bit value within a range of bits,
+	/// using the trailing zero count of each word.
+	/// - parameter value: The bit value for which to search.
+	/// - parameter range: The range of bits to search.
+	/// - returns: The index of the first occurrence of `value` in `range`,
+	/// or `nil` if `value` is not present.
+	func firstIndex(of value: Bool, in range: Range<Int>) -> Int? {
+		checkRange(range)
+		guard !range.isEmpty else {
+			return nil
+		}
+		return words.withUnsafeBufferPointer { (words) -> Int? in
+			let firstWord = range.lowerBound >> 6
+			let lastWord = (range.upperBound - 1) >> 6
+			var mask: UInt64 = ~0 << UInt64(range.lowerBound & 63)
+			for word in firstWord ... lastWord {
+				if word == lastWord {
+					mask &= ~0 >> UInt64(63 - ((range.upperBound - 1) & 63))
+				}
+				let bits = (value ? words[word] : ~words[word]) & mask
+				if bits != 0 {
+					return word << 6 + bits.trailingZeroBitCount
+				}
+				mask = ~0
+			}
+			return nil
+		}
+	}
+
+	/// Locates the last occurrence of a bit value within a range of bits,
+	/// using the leading zero count of each word.
+	/// - parameter value: The bit value for which to search.
+	/// - parameter range: The range of bits to search.
+	/// - returns: The index of the last occurrence of `value` in `range`,
+	/// or `nil` if `value` is not present.
+	func lastIndex(of value: Bool, in range: Range<Int>) -> Int? {
+		checkRange(range)
+		guard !range.isEmpty else {
+			return nil
+		}
+		return words.withUnsafeBufferPointer { (words) -> Int? in
+			let firstWord = range.lowerBound >> 6
+			let lastWord = (range.upperBound - 1) >> 6
+			var mask: UInt64 = ~0 >> UInt64(63 - ((range.upperBound - 1) & 63))
+			for word in (firstWord ... lastWord).reversed() {
+				if word == firstWord {
+					mask &= ~0 << UInt64(range.lowerBound & 63)
+				}
+				let bits = (value ? words[word] : ~words[word]) & mask
+				if bits != 0 {
+					return word << 6 + 63 - bits.leadingZeroBitCount
+				}
+				mask = ~0
+			}
+			return nil
+		}
+	}
+
+	/// The indexes of the bits that are set to `true`, in ascending order.
+	///
+	/// Each word is only visited once, and only the set bits inside of it.
+	var setBitIndexes: SetBitIndexes {
+		return SetBitIndexes(words: words)
+	}
+
+	/// A sequence of the indexes of the set bits in a ``BitVector``.
+	struct SetBitIndexes: Sequence, IteratorProtocol, Sendable {
+		private let words: ContiguousArray<UInt64>
+		private var wordIndex = 0
+		private var current: UInt64
+
+		fileprivate init(words: ContiguousArray<UInt64>) {
+			self.words = words
+			current = words.first ?? 0
+		}
+
+		public mutating func next() -> Int? {
+			while current == 0 {
+				wordIndex += 1
+				guard wordIndex < words.count else {
+					return nil
+				}
+				current = words[wordIndex]
+			}
+			let bit = current.trailingZeroBitCount
+			// Clear the lowest set bit.
+			current &= current &- 1
+			return wordIndex << 6 + bit
+		}
+	}
+}
+
+// MARK: - Bitwise operations
+
+public extension BitVector {
+	/// Sets a range of bits to a particular value.
+	/// - parameter range: The range of bits to set.
+	/// - parameter value: The bit value to which to set the range of bits.
+	mutating func setBits(in range: Range<Int>, to value: Bool) {
+		checkRange(range)
+		words.withUnsafeMutableBufferPointer { (words) in
+			BitVector.forEachWord(in: range) { (word, mask) in
+				if value {
+					words[word] |= mask
+				} else {
+					words[word] &= ~mask
+				}
+			}
+		}
+	}
+
+	/// Sets all bits to a particular value.
+	@inlinable mutating func setAllBits(to value: Bool) {
+		setBits(in: 0 ..< count, to: value)
+	}
+
+	/// Flips a range of bit values.
+	/// - parameter range: The range of bits to flip. Default is the whole vector.
+	mutating func flipBits(in range: Range<Int>? = nil) {
+		let range = range ?? 0 ..< self.count
+		checkRange(range)
+		words.withUnsafeMutableBufferPointer { (words) in
+			BitVector.forEachWord(in: range) { (word, mask) in
+				words[word] ^= mask
+			}
+		}
+	}
+
+	/// Combines the bits in `range` with the same bits of `other`, a word at a time.
+	@inline(__always)
+	private mutating func combine(with other: BitVector, in range: Range<Int>?, _ operation: (UInt64, UInt64) -> UInt64) {
+		let range = range ?? 0 ..< self.count
+		checkRange(range)
+		precondition(range.upperBound <= other.count, "Range is out of bounds of the other bit vector")
+		words.withUnsafeMutableBufferPointer { (words) in
+			other.words.withUnsafeBufferPointer { (otherWords) in
+				BitVector.forEachWord(in: range) { (word, mask) in
+					words[word] = (words[word] & ~mask) | (operation(words[word], otherWords[word]) & mask)
+				}
+			}
+		}
+	}
+
+	/// Sets each bit in `range` to the logical AND of it and the same bit in `other`.
+	/// - parameter range: The range of bits to combine. Default is the whole vector.
+	mutating func formIntersection(_ other: BitVector, in range: Range<Int>? = nil) {
+		combine(with: other, in: range, &)
+	}
+
+	/// Sets each bit in `range` to the logical OR of it and the same bit in `other`.
+	/// - parameter range: The range of bits to combine. Default is the whole vector.
+	mutating func formUnion(_ other: BitVector, in range: Range<Int>? = nil) {
+		combine(with: other, in: range, |)
+	}
+
+	/// Sets each bit in `range` to the logical XOR of it and the same bit in `other`.
+	/// - parameter range: The range of bits to combine. Default is the whole vector.
+	mutating func formSymmetricDifference(_ other: BitVector, in range: Range<Int>? = nil) {
+		combine(with: other, in: range, ^)
+	}
+
+	static func &(lhs: BitVector, rhs: BitVector) -> BitVector {
+		precondition(lhs.count == rhs.count, "Bit vectors must be the same size")
+		var result = lhs
+		result.formIntersection(rhs)
+		return result
+	}
+
+	static func |(lhs: BitVector, rhs: BitVector) -> BitVector {
+		precondition(lhs.count == rhs.count, "Bit vectors must be the same size")
+		var result = lhs
+		result.formUnion(rhs)
+		return result
+	}
+
+	static func ^(lhs: BitVector, rhs: BitVector) -> BitVector {
+		precondition(lhs.count == rhs.count, "Bit vectors must be the same size")
+		var result = lhs
+		result.formSymmetricDifference(rhs)
+		return result
+	}
+
+	static prefix func ~(bits: BitVector) -> BitVector {
+		var result = bits
+		result.flipBits()
+		return result
+	}
+}
+
+// MARK: - Collection
+
+extension BitVector: RandomAccessCollection, MutableCollection {
+	public typealias Element = Bool
+	public typealias Index = Int
+	public typealias Indices = Range<Int>
+
+	@inlinable public var startIndex: Int {
+		return 0
+	}
+
+	@inlinable public var endIndex: Int {
+		return count
+	}
+
+	@inlinable public subscript(position: Int) -> Bool {
+		get {
+			precondition(position >= 0 && position < count, "Index out of range")
+			return words[position >> 6] & (1 << UInt64(position & 63)) != 0
+		}
+		set {
+			precondition(position >= 0 && position < count, "Index out of range")
+			let bit: UInt64 = 1 << UInt64(position & 63)
+			if newValue {
+				words[position >> 6] |= bit
+			} else {
+				words[position >> 6] &= ~bit
+			}
+		}
+	}
+}
+
+extension BitVector: ExpressibleByArrayLiteral {
+	public init(arrayLiteral elements: Bool...) {
+		self.init(elements)
+	}
+}
+
+// MARK: - CoreFoundation bridging
+
+#if canImport(Darwin)
+public extension BitVector {
+	/// Reverses the order of the bits in each byte of `word`.
+	///
+	/// `CFBitVector` stores the first bit in the most-significant bit of each byte.
+	@inline(__always)
+	private static func reverseBitsInBytes(_ word: UInt64) -> UInt64 {
+		var x = word
+		x = ((x >> 1) & 0x5555_5555_5555_5555) | ((x & 0x5555_5555_5555_5555) << 1)
+		x = ((x >> 2) & 0x3333_3333_3333_3333) | ((x & 0x3333_3333_3333_3333) << 2)
+		x = ((x >> 4) & 0x0F0F_0F0F_0F0F_0F0F) | ((x & 0x0F0F_0F0F_0F0F_0F0F) << 4)
+		return x
+	}
+
+	/// Creates a bit vector with the same bits as a `CFBitVector`.
+	///
+	/// The bits are copied with one call to `CFBitVectorGetBits`.
+	init(_ cfBitVector: CFBitVector) {
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+		let signpost = HotPathCounters.begin()
+		defer {
+			HotPathCounters.Slot.bitVectorFromCFBitVector.end(since: signpost, items: CFBitVectorGetCount(cfBitVector))
+		}
+#endif
+		let count = CFBitVectorGetCount(cfBitVector)
+		let wordCount = BitVector.wordCount(for: count)
+		var words = ContiguousArray<UInt64>(repeating: 0, count: wordCount)
+		if count > 0 {
+			words.withUnsafeMutableBytes { (bytes) in
+				CFBitVectorGetBits(cfBitVector, CFRange(location: 0, length: count), bytes.baseAddress!.assumingMemoryBound(to: UInt8.self))
+			}
+			for i in 0 ..< wordCount {
+				words[i] = BitVector.reverseBitsInBytes(UInt64(littleEndian: words[i]))
+			}
+		}
+		self.words = words
+		self.count = count
+		clearTail()
+	}
+
+	/// Calls `body` with the bits in the byte layout that `CFBitVector` uses, first bit
+	/// in the most-significant bit of the first byte.
+	private func withCFBytes<R>(_ body: (UnsafePointer<UInt8>) throws -> R) rethrows -> R {
+		var cfWords = ContiguousArray<UInt64>(repeating: 0, count: Swift.max(words.count, 1))
+		for i in 0 ..< words.count {
+			cfWords[i] = BitVector.reverseBitsInBytes(words[i]).littleEndian
+		}
+		return try cfWords.withUnsafeBytes { (bytes) -> R in
+			return try body(bytes.baseAddress!.assumingMemoryBound(to: UInt8.self))
+		}
+	}
+
+	/// Creates an immutable `CFBitVector` with the same bits.
+	/// - parameter allocator: The allocator to use to allocate memory for the new bit vector. Pass `nil` or kCFAllocatorDefault to use the current default allocator.
+	func cfBitVector(allocator: CFAllocator? = kCFAllocatorDefault) -> CFBitVector {
+		return withCFBytes { (bytes) -> CFBitVector in
+			return CFBitVectorCreate(allocator, bytes, count)
+		}
+	}
+
+	/// Creates a `CFMutableBitVector` with the same bits.
+	/// - parameter allocator: The allocator to use to allocate memory for the new bit vector. Pass `nil` or kCFAllocatorDefault to use the current default allocator.
+	/// - parameter capacity: The maximum number of values that can be contained by the new bit vector.
+	/// Pass `0` to specify that the maximum capacity is not limited.
+	func mutableCFBitVector(allocator: CFAllocator? = kCFAllocatorDefault, capacity: Int = 0) -> CFMutableBitVector {
+		return CFBitVectorCreateMutableCopy(allocator, capacity, cfBitVector(allocator: allocator))
+	}
+}
+
+public extension CFBitVector {
+	/// The bits of the bit vector, copied to a native ``BitVector``.
+	///
+	/// Use this instead of iterating over the bit vector, which calls into CoreFoundation for every bit.
+	@inlinable var bitVector: BitVector {
+		return BitVector(self)
+	}
+}
+#endif
+
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+private extension HotPathCounters.Slot {
+	static let bitVectorFromCFBitVector = HotPathCounters.Slot("BitVector.init(_:)")
+}
+#endif
@@ -0,0 +1,288 @@
+//
+//  BufferArena.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+#if SWIFT_PACKAGE
+import FoundationAdditionsAtomics
+#endif
+
+/// The layout of the buffers in a buffer list, such as an `AudioBufferList`.
+public struct BufferListLayout: Hashable, Sendable {
+	/// The alignment of every buffer, which is the size of a cache line.
+	public static let alignment = 64
+
+	/// The number of buffers.
+	public var bufferCount: Int
+
+	/// The number of bytes used in each buffer.
+	public var bytesPerBuffer: Int
+
+	public init(bufferCount: Int, bytesPerBuffer: Int) {
+		precondition(bufferCount >= 0 && bytesPerBuffer >= 0, "Buffer layout must not be negative")
+		self.bufferCount = bufferCount
+		self.bytesPerBuffer = bytesPerBuffer
+	}
+
+	/// The distance, in bytes, from the start of one buffer to the next.
+	///
+	/// Each buffer is padded to a whole number of cache lines, so no two buffers share one.
+	@inlinable public var bufferStride: Int {
+		return (bytesPerBuffer + BufferListLayout.alignment - 1) & ~(BufferListLayout.alignment - 1)
+	}
+
+	/// The total number of bytes needed for all of the buffers.
+	@inlinable public var byteCount: Int {
+		return bufferStride * bufferCount
+	}
+}
+
+/// A shared pool of cache-aligned memory blocks for buffer lists.
+///
+/// Blocks are grouped into power-of-two size classes. Checking out a block reuses a pooled
+/// one when there is one, and only allocates when the pool for its size class is empty.
+/// Checking a block back in never allocates, frees or takes a lock, so it is safe to do on
+/// a real-time thread.
+public final class BufferArena: @unchecked Sendable {
+	/// The arena used by default.
+	public static let shared = BufferArena()
+
+	/// The size of the smallest size class, in bytes.
+	public static let minimumBlockSize = 4096
+
+	/// The number of size classes, the largest holding blocks of 2 GiB.
+	private static let sizeClassCount = 20
+
+	/// A block of memory checked out of an arena.
+	public struct Allocation: @unchecked Sendable {
+		/// The start of the block, aligned to ``BufferListLayout/alignment``.
+		public let baseAddress: UnsafeMutableRawPointer
+		/// The layout the block was checked out for.
+		public let layout: BufferListLayout
+		/// The usable size of the block, which may be larger than `layout.byteCount`.
+		public let capacity: Int
+		fileprivate let sizeClass: Int
+		fileprivate let blockIndex: Int
+
+		/// The start of the buffer at `index`.
+		@inlinable public func buffer(at index: Int) -> UnsafeMutableRawPointer {
+			precondition(index >= 0 && index < layout.bufferCount, "Buffer index out of range")
+			return baseAddress + index * layout.bufferStride
+		}
+	}
+
+	/// The usage of one size class in an arena.
+	public struct Statistics: Hashable, Sendable {
+		/// The size of each block in the size class, in bytes.
+		public var blockSize: Int
+		/// The number of blocks that have been allocated for the size class.
+		public var blockCount: Int
+		/// The number of blocks currently checked out.
+		public var checkedOut: Int
+		/// The most blocks that have been checked out at the same time.
+		public var highWaterMark: Int
+
+		/// The number of blocks waiting in the pool.
+		@inlinable public var pooled: Int {
+			return blockCount - checkedOut
+		}
+	}
+
+	private let pools: [SizeClassPool]
+
+	/// Creates an arena.
+	/// - parameter maximumBlocksPerSizeClass: The most blocks that are kept for each size class.
+	/// Blocks checked out past this are allocated and freed directly. Default is *256*.
+	public init(maximumBlocksPerSizeClass: Int = 256) {
+		precondition(maximumBlocksPerSizeClass > 0, "Arena must be able to hold a block")
+		pools = (0 ..< BufferArena.sizeClassCount).map { (sizeClass) -> SizeClassPool in
+			return SizeClassPool(blockSize: BufferArena.minimumBlockSize << sizeClass, capacity: maximumBlocksPerSizeClass)
+		}
+	}
+
+	/// The size class of blocks that can hold `byteCount` bytes, or `nil` if it is too large for any.
+	private static func sizeClass(for byteCount: Int) -> Int? {
+		let size = Swift.max(byteCount, minimumBlockSize)
+		let sizeClass = (Int.bitWidth - (size - 1).leadingZeroBitCount) - minimumBlockSize.trailingZeroBitCount
+		return sizeClass < sizeClassCount ? sizeClass : nil
+	}
+
+	/// Checks out a block that can hold `layout`.
+	///
+	/// This only allocates if there are no pooled blocks in the size class. New blocks are
+	/// zero-filled when allocated, so their pages are resident; reused blocks keep whatever
+	/// was last written to them unless `zeroed` is `true`.
+	/// - parameter layout: The layout of the buffer list.
+	/// - parameter zeroed: If `true`, the used bytes of a reused block are set to zero. Default is `false`.
+	public func checkOut(_ layout: BufferListLayout, zeroed: Bool = false) -> Allocation {
+		let byteCount = Swift.max(layout.byteCount, 1)
+		if let sizeClass = BufferArena.sizeClass(for: byteCount) {
+			let pool = pools[sizeClass]
+			if let pooled = pool.checkOut() {
+				if zeroed && pooled.reused {
+					pooled.block.initializeMemory(as: UInt8.self, repeating: 0, count: layout.byteCount)
+				}
+				return Allocation(baseAddress: pooled.block, layout: layout, capacity: pool.blockSize, sizeClass: sizeClass, blockIndex: pooled.index)
+			}
+		}
+		let block = SizeClassPool.allocateBlock(byteCount)
+		return Allocation(baseAddress: block, layout: layout, capacity: byteCount, sizeClass: -1, blockIndex: -1)
+	}
+
+	/// Returns a block to the arena.
+	///
+	/// Pooled blocks are returned without freeing memory, and without locking where atomics are available.
+	/// The allocation must not be used after this.
+	public func checkIn(_ allocation: Allocation) {
+		guard allocation.blockIndex >= 0 else {
+			allocation.baseAddress.deallocate()
+			return
+		}
+		pools[allocation.sizeClass].checkIn(allocation.blockIndex)
+	}
+
+	/// The usage of each size class that has had a block allocated.
+	public var statistics: [Statistics] {
+		return pools.compactMap { (pool) -> Statistics? in
+			let stats = pool.statistics
+			return stats.blockCount > 0 ? stats : nil
+		}
+	}
+
+	/// The usage of the size class that would be used for `layout`, or `nil` if it is too large to be pooled.
+	public func statistics(for layout: BufferListLayout) -> Statistics? {
+		guard let sizeClass = BufferArena.sizeClass(for: Swift.max(layout.byteCount, 1)) else {
+			return nil
+		}
+		return pools[sizeClass].statistics
+	}
+}
+
+// MARK: - Size class pools
+
+/// The blocks of one size class, with a free list of the indexes of pooled blocks.
+private final class SizeClassPool: @unchecked Sendable {
+	let blockSize: Int
+	let capacity: Int
+	/// Every block allocated for this size class, by index. Only appended to, under `growLock`.
+	private let blocks: UnsafeMutablePointer<UnsafeMutableRawPointer?>
+	private let freeList: IndexFreeList
+	private let checkedOut = makeSharedCounter()
+	private let highWaterMark = makeSharedCounter()
+	private let growLock = NSLock()
+	private var blockCount = 0
+
+	init(blockSize: Int, capacity: Int) {
+		self.blockSize = blockSize
+		self.capacity = capacity
+		blocks = .allocate(capacity: capacity)
+		blocks.initialize(repeating: nil, count: capacity)
+		freeList = IndexFreeList(capacity: capacity)
+	}
+
+	deinit {
+		for i in 0 ..< blockCount {
+			blocks[i]?.deallocate()
+		}
+		blocks.deallocate()
+	}
+
+	static func allocateBlock(_ byteCount: Int) -> UnsafeMutableRawPointer {
+		let block = UnsafeMutableRawPointer.allocate(byteCount: byteCount, alignment: BufferListLayout.alignment)
+		// Touch every page now, instead of on the audio thread.
+		block.initializeMemory(as: UInt8.self, repeating: 0, count: byteCount)
+		return block
+	}
+
+	/// Pops a pooled block, or allocates a new one if the pool isn't full.
+	/// - returns: The block's index, address, and whether it was reused, or `nil` if the pool is full.
+	func checkOut() -> (index: Int, block: UnsafeMutableRawPointer, reused: Bool)? {
+		if let index = freeList.pop() {
+			highWaterMark.raise(to: checkedOut.add(1))
+			return (index, blocks[index]!, true)
+		}
+		growLock.lock()
+		defer {
+			growLock.unlock()
+		}
+		guard blockCount < capacity else {
+			return nil
+		}
+		let block = SizeClassPool.allocateBlock(blockSize)
+		let index = blockCount
+		blocks[index] = block
+		blockCount += 1
+		highWaterMark.raise(to: checkedOut.add(1))
+		return (index, block, false)
+	}
+
+	func checkIn(_ index: Int) {
+		checkedOut.add(-1)
+		freeList.push(index)
+	}
+
+	var statistics: BufferArena.Statistics {
+		growLock.lock()
+		let count = blockCount
+		growLock.unlock()
+		return BufferArena.Statistics(blockSize: blockSize, blockCount: count, checkedOut: checkedOut.load(), highWaterMark: highWaterMark.load())
+	}
+}
+
+/// A lock-free Treiber stack of block indexes.
+///
+/// The head holds the top index plus one in the low 32 bits, and a tag that changes on every
+/// update in the high 32 bits, which prevents the ABA problem. The links are atomic too: a
+/// `pop` can read the link of an index that another thread is pushing again, and then fails
+/// its compare-and-exchange.
+private final class IndexFreeList: @unchecked Sendable {
+	private let head: UnsafeMutablePointer<FAAtomicInt64>
+	/// The index below each index on the stack, or *-1*.
+	private let links: UnsafeMutablePointer<FAAtomicInt>
+
+	init(capacity: Int) {
+		head = .allocate(capacity: 1)
+		FAAtomicInt64Initialize(head, 0)
+		links = .allocate(capacity: capacity)
+		for i in 0 ..< capacity {
+			FAAtomicIntInitialize(links + i, -1)
+		}
+	}
+
+	deinit {
+		head.deallocate()
+		links.deallocate()
+	}
+
+	private static func head(top: Int, tag: UInt64) -> Int64 {
+		return Int64(bitPattern: (tag &+ 1) << 32 | UInt64(top))
+	}
+
+	func push(_ index: Int) {
+		var old = FAAtomicInt64Load(head)
+		while true {
+			FAAtomicIntStore(links + index, Int(old & 0xFFFF_FFFF) - 1)
+			if FAAtomicInt64CompareExchange(head, &old, IndexFreeList.head(top: index + 1, tag: UInt64(bitPattern: old) >> 32)) {
+				return
+			}
+		}
+	}
+
+	func pop() -> Int? {
+		var old = FAAtomicInt64Load(head)
+		while true {
+			let top = Int(old & 0xFFFF_FFFF)
+			guard top != 0 else {
+				return nil
+			}
+			let next = FAAtomicIntLoad(links + (top - 1))
+			if FAAtomicInt64CompareExchange(head, &old, IndexFreeList.head(top: next + 1, tag: UInt64(bitPattern: old) >> 32)) {
+				return top - 1
+			}
+		}
+	}
+}
@@ -6,8 +6,11 @@
 //  Copyright © 2021 C.W. Betts. All rights reserved.
 //
 
+#if canImport(Darwin)
+
 import Foundation
 
+/// For a priority queue of Swift values, which doesn't need callbacks, see ``Heap``.
 public extension CFBinaryHeap {
 	/// The number of values currently in the binary heap.
 	@inlinable var count: Int {
@@ -55,3 +58,5 @@ public extension CFBinaryHeap {
 		return CFBinaryHeapCreateCopy(allocator, capacity, self)
 	}
 }
+
+#endif
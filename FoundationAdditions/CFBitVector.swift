@@ -6,6 +6,8 @@
 //  Copyright © 2020 C.W. Betts. All rights reserved.
 //
 
+#if canImport(Darwin)
+
 import Foundation
 
 public extension CFBitVector {
@@ -170,3 +172,5 @@ extension CFBitVector: @retroactive Collection {
 		return CFBitVectorGetCount(self)
 	}
 }
+
+#endif
@@ -114,4 +114,113 @@ public extension CFMessagePort {
 	}
 }
 
+/// A ``SharedMemoryChannel`` over a pair of message ports: a local port this process
+/// receives frames on, and the peer's local port it sends frames to.
+///
+/// Each frame is a one-way message that wraps the caller's bytes without copying them.
+/// Pass the result to ``SharedMemoryTransport/init(channel:ringCapacity:inlineLimit:batchLimit:replyTimeout:handler:)``
+/// so that large payloads bypass the port entirely.
+public final class CFMessagePortChannel: SharedMemoryChannel, @unchecked Sendable {
+	/// The name of the port this process receives on.
+	public let localName: String
+	/// The name of the peer's port.
+	public let remoteName: String
+	/// How long sending a frame may block.
+	public let sendTimeout: TimeInterval
+
+	private let local: CFMessagePort
+	private let receiver = Receiver()
+	private let queue = DispatchQueue(label: "CFMessagePortChannel")
+	private let lock = NSLock()
+	private var remote: CFMessagePort?
+	private var closed = false
+	private var closeHandler: (@Sendable () -> Void)?
+
+	/// Holds the frame handler for the port callout, which can't capture anything.
+	private final class Receiver: @unchecked Sendable {
+		var frameHandler: (@Sendable (UnsafeRawBufferPointer) -> Void)?
+	}
+
+	/// Registers the local port. The peer's port is looked up when the first frame is sent, so
+	/// either end can be created first.
+	/// - parameter localName: The name to register this end's port under.
+	/// - parameter remoteName: The name the peer registered its port under.
+	/// - parameter sendTimeout: How long sending a frame may block.
+	/// - throws: ``SharedMemoryTransportError/invalid`` if the local port can't be created,
+	/// for example because the name is taken.
+	public init(localName: String, remoteName: String, sendTimeout: TimeInterval = 10) throws {
+		self.localName = localName
+		self.remoteName = remoteName
+		self.sendTimeout = sendTimeout
+		var context = CFMessagePortContext(version: 0, info: Unmanaged.passUnretained(receiver).toOpaque(), retain: nil, release: nil, copyDescription: nil)
+		var shouldFreeInfo: DarwinBoolean = false
+		guard let port = CFMessagePortCreateLocal(kCFAllocatorDefault, localName as CFString, { _, _, data, info in
+			guard let data, let info else {
+				return nil
+			}
+			let receiver = Unmanaged<Receiver>.fromOpaque(info).takeUnretainedValue()
+			receiver.frameHandler?(UnsafeRawBufferPointer(start: CFDataGetBytePtr(data), count: CFDataGetLength(data)))
+			return nil
+		}, &context, &shouldFreeInfo), !shouldFreeInfo.boolValue else {
+			throw SharedMemoryTransportError.invalid
+		}
+		local = port
+	}
+
+	deinit {
+		close()
+	}
+
+	public func start(receiving frameHandler: @escaping @Sendable (UnsafeRawBufferPointer) -> Void, closed closeHandler: @escaping @Sendable () -> Void) throws {
+		lock.lock()
+		guard !closed else {
+			lock.unlock()
+			throw SharedMemoryTransportError.invalid
+		}
+		self.closeHandler = closeHandler
+		lock.unlock()
+		receiver.frameHandler = frameHandler
+		local.setDispatchQueue(queue)
+	}
+
+	public func send(_ frame: UnsafeRawBufferPointer) throws {
+		lock.lock()
+		if remote == nil && !closed {
+			remote = CFMessagePort.createRemote(name: remoteName)
+		}
+		let port = closed ? nil : remote
+		lock.unlock()
+		guard let port, let base = frame.baseAddress?.assumingMemoryBound(to: UInt8.self),
+			  let data = CFDataCreateWithBytesNoCopy(kCFAllocatorDefault, base, frame.count, kCFAllocatorNull) else {
+			throw SharedMemoryTransportError.invalid
+		}
+		switch CFMessagePortSendRequest(port, 0, data, sendTimeout, 0, nil, nil) {
+		case kCFMessagePortSuccess:
+			return
+		case kCFMessagePortSendTimeout:
+			throw SharedMemoryTransportError.sendTimeout
+		default:
+			// The peer is gone.
+			close()
+			throw SharedMemoryTransportError.invalid
+		}
+	}
+
+	public func close() {
+		lock.lock()
+		guard !closed else {
+			lock.unlock()
+			return
+		}
+		closed = true
+		let handler = closeHandler
+		closeHandler = nil
+		let remote = self.remote
+		lock.unlock()
+		local.invalidate()
+		remote?.invalidate()
+		handler?()
+	}
+}
+
 #endif
@@ -6,6 +6,8 @@
 //  Copyright © 2021 C.W. Betts. All rights reserved.
 //
 
+#if canImport(Darwin)
+
 import Foundation
 
 /// For classes that are Core Foundation objects (Can be passed to `CFRetain`, `CFRelease`, etc.)
@@ -309,3 +311,5 @@ public func castCFType<A: CFTypeProtocol>(_ theType: AnyObject, to aType: A.Type
 	}
 	return (theType as! A)
 }
+
+#endif
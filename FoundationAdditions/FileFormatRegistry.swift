@@ -0,0 +1,360 @@
+//
+//  FileFormatRegistry.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// A file type that a ``FileFormatProvider`` knows about.
+public struct FileTypeRecord: Hashable, Sendable {
+	/// The four-character code of the file type.
+	public var fileTypeID: UInt32
+	/// The user-visible name of the file type.
+	public var name: String
+	/// The filename extensions of the file type, without the leading period.
+	public var extensions: [String]
+
+	public init(fileTypeID: UInt32, name: String, extensions: [String]) {
+		self.fileTypeID = fileTypeID
+		self.name = name
+		self.extensions = extensions
+	}
+}
+
+/// A data format that a file type can contain.
+public struct DataFormatRecord<Variant: Hashable & Sendable & BitwiseCopyable>: Hashable, Sendable {
+	/// The four-character code of the data format.
+	public var formatID: UInt32
+	/// The stream layouts of the data format that the file type can contain.
+	public var variants: [Variant]
+	/// `true` if the data format can be decoded.
+	public var readable: Bool
+	/// `true` if the data format can be encoded.
+	public var writable: Bool
+	/// `true` if there are both big- and little-endian PCM variants.
+	public var eitherEndianPCM: Bool
+
+	public init(formatID: UInt32, variants: [Variant] = [], readable: Bool = false, writable: Bool = false, eitherEndianPCM: Bool = false) {
+		self.formatID = formatID
+		self.variants = variants
+		self.readable = readable
+		self.writable = writable
+		self.eitherEndianPCM = eitherEndianPCM
+	}
+}
+
+/// Supplies the file types and data formats that a ``FileFormatRegistry`` indexes.
+public protocol FileFormatProvider: Sendable {
+	/// The description of a data format's stream layout.
+	associatedtype Variant: Hashable & Sendable & BitwiseCopyable
+
+	/// All of the known file types.
+	func fileTypes() -> [FileTypeRecord]
+
+	/// The data formats the file type can contain. This may be expensive; the registry calls it at
+	/// most once per file type.
+	func dataFormats(forFileType fileTypeID: UInt32) -> [DataFormatRecord<Variant>]
+}
+
+/// An index of file types and the data formats they can contain.
+///
+/// The file types and the extension and file type lookups are built up front. The data
+/// formats of each file type are loaded from the provider the first time they are needed,
+/// once per type, from any thread. The data format to file type index is built the first time
+/// it is needed.
+///
+/// The registry can be written to and read from a snapshot so later launches don't need to
+/// query the provider at all.
+public final class FileFormatRegistry<Variant: Hashable & Sendable & BitwiseCopyable>: @unchecked Sendable {
+	/// The data formats of one file type, loaded once.
+	private final class DataFormatSlot: @unchecked Sendable {
+		let lock = NSLock()
+		var formats: [DataFormatRecord<Variant>]?
+
+		init(_ formats: [DataFormatRecord<Variant>]? = nil) {
+			self.formats = formats
+		}
+	}
+
+	/// All of the file types, sorted by name.
+	public let fileTypes: [FileTypeRecord]
+
+	private let loadDataFormats: @Sendable (UInt32) -> [DataFormatRecord<Variant>]
+	private let indexByFileType: [UInt32: Int]
+	private let fileTypeByExtension: [String: UInt32]
+	private let slots: [DataFormatSlot]
+	private let dataFormatIndexLock = NSLock()
+	private var fileTypesByDataFormat: [UInt32: [UInt32]]?
+
+	/// Creates a registry of the provider's file types.
+	/// - parameter provider: The source of file types and data formats.
+	/// - parameter loadDataFormats: If `true`, the data formats of every file type are loaded
+	/// now instead of when first needed. Default is `false`.
+	public convenience init<Provider: FileFormatProvider>(provider: Provider, loadDataFormats: Bool = false) where Provider.Variant == Variant {
+		self.init(loadDataFormats: { provider.dataFormats(forFileType: $0) }, fileTypes: provider.fileTypes(), dataFormats: nil)
+		if loadDataFormats {
+			loadAllDataFormats()
+		}
+	}
+
+	private init(loadDataFormats: @escaping @Sendable (UInt32) -> [DataFormatRecord<Variant>], fileTypes unsorted: [FileTypeRecord], dataFormats: [[DataFormatRecord<Variant>]?]?) {
+		self.loadDataFormats = loadDataFormats
+		var order = Array(unsorted.indices)
+		order.sort { unsorted[$0].name.localizedCaseInsensitiveCompare(unsorted[$1].name) == .orderedAscending }
+		fileTypes = order.map { unsorted[$0] }
+		slots = order.map { DataFormatSlot(dataFormats?[$0]) }
+
+		var indexByFileType = [UInt32: Int](minimumCapacity: fileTypes.count)
+		var fileTypeByExtension = [String: UInt32](minimumCapacity: fileTypes.count * 2)
+		for (i, fileType) in fileTypes.enumerated() {
+			if indexByFileType[fileType.fileTypeID] == nil {
+				indexByFileType[fileType.fileTypeID] = i
+			}
+			// The first file type, by name, wins an extension, like a linear scan would.
+			for ext in fileType.extensions where fileTypeByExtension[ext.lowercased()] == nil {
+				fileTypeByExtension[ext.lowercased()] = fileType.fileTypeID
+			}
+		}
+		self.indexByFileType = indexByFileType
+		self.fileTypeByExtension = fileTypeByExtension
+	}
+
+	/// The file type with the identifier, or `nil` if there isn't one.
+	public func fileType(_ fileTypeID: UInt32) -> FileTypeRecord? {
+		guard let index = indexByFileType[fileTypeID] else {
+			return nil
+		}
+		return fileTypes[index]
+	}
+
+	/// The file type that uses a filename extension, or `nil` if none do.
+	/// - parameter pathExtension: The extension, without a leading period. Case is ignored.
+	public func fileTypeID(forExtension pathExtension: String) -> UInt32? {
+		return fileTypeByExtension[pathExtension.lowercased()]
+	}
+
+	/// The data formats a file type can contain, loading them from the provider if needed, or
+	/// `nil` if the file type isn't known.
+	public func dataFormats(forFileType fileTypeID: UInt32) -> [DataFormatRecord<Variant>]? {
+		guard let index = indexByFileType[fileTypeID] else {
+			return nil
+		}
+		return dataFormats(at: index)
+	}
+
+	private func dataFormats(at index: Int) -> [DataFormatRecord<Variant>] {
+		let slot = slots[index]
+		slot.lock.lock()
+		defer {
+			slot.lock.unlock()
+		}
+		if let formats = slot.formats {
+			return formats
+		}
+		let formats = loadDataFormats(fileTypes[index].fileTypeID)
+		slot.formats = formats
+		return formats
+	}
+
+	/// Loads the data formats of every file type that hasn't been loaded yet, in parallel.
+	public func loadAllDataFormats() {
+		DispatchQueue.concurrentPerform(iterations: slots.count) { (index) in
+			_ = dataFormats(at: index)
+		}
+	}
+
+	/// The file types that can contain a data format, in the order of ``fileTypes``.
+	///
+	/// The first call loads the data formats of every file type.
+	public func fileTypeIDs(forDataFormat formatID: UInt32) -> [UInt32] {
+		dataFormatIndexLock.lock()
+		defer {
+			dataFormatIndexLock.unlock()
+		}
+		if fileTypesByDataFormat == nil {
+			loadAllDataFormats()
+			var index = [UInt32: [UInt32]]()
+			for (i, fileType) in fileTypes.enumerated() {
+				for format in dataFormats(at: i) where index[format.formatID]?.last != fileType.fileTypeID {
+					index[format.formatID, default: []].append(fileType.fileTypeID)
+				}
+			}
+			fileTypesByDataFormat = index
+		}
+		return fileTypesByDataFormat![formatID] ?? []
+	}
+
+	// MARK: Snapshots
+
+	private static var snapshotMagic: UInt32 { return 0x46465253 } // 'FFRS'
+	private static var snapshotVersion: UInt32 { return 1 }
+
+	/// Creates a registry from a snapshot made by ``snapshot()``.
+	///
+	/// File types whose data formats weren't loaded when the snapshot was made load them from
+	/// `provider` when needed.
+	/// - parameter provider: The source of data formats missing from the snapshot.
+	/// - parameter snapshot: The snapshot data.
+	/// - throws: `CocoaError.fileReadCorruptFile` if the data isn't a snapshot made on a machine
+	/// with the same variant layout.
+	public convenience init<Provider: FileFormatProvider>(provider: Provider, snapshot: Data) throws where Provider.Variant == Variant {
+		var reader = SnapshotReader(data: snapshot)
+		guard try reader.read(UInt32.self) == FileFormatRegistry.snapshotMagic,
+			  try reader.read(UInt32.self) == FileFormatRegistry.snapshotVersion,
+			  try reader.read(UInt32.self) == UInt32(MemoryLayout<Variant>.stride) else {
+			throw CocoaError(.fileReadCorruptFile)
+		}
+		// Each file type takes at least its ID, name length, extension count and format count.
+		let typeCount = try reader.readCount(minimumRecordSize: 16)
+		var fileTypes = [FileTypeRecord]()
+		var dataFormats = [[DataFormatRecord<Variant>]?]()
+		fileTypes.reserveCapacity(typeCount)
+		dataFormats.reserveCapacity(typeCount)
+		for _ in 0 ..< typeCount {
+			let fileTypeID = try reader.read(UInt32.self)
+			let name = try reader.readString()
+			let extensionCount = try reader.readCount(minimumRecordSize: 4)
+			var extensions = [String]()
+			extensions.reserveCapacity(extensionCount)
+			for _ in 0 ..< extensionCount {
+				extensions.append(try reader.readString())
+			}
+			fileTypes.append(FileTypeRecord(fileTypeID: fileTypeID, name: name, extensions: extensions))
+
+			let formatCount = try reader.read(Int32.self)
+			guard formatCount >= 0 else {
+				dataFormats.append(nil)
+				continue
+			}
+			// Each data format takes at least its ID, flags and variant count.
+			try reader.checkCount(Int(formatCount), minimumRecordSize: 9)
+			var formats = [DataFormatRecord<Variant>]()
+			formats.reserveCapacity(Int(formatCount))
+			for _ in 0 ..< formatCount {
+				let formatID = try reader.read(UInt32.self)
+				let flags = try reader.read(UInt8.self)
+				let variantCount = Int(try reader.read(UInt32.self))
+				let variants = try reader.readArray(of: Variant.self, count: variantCount)
+				formats.append(DataFormatRecord(formatID: formatID, variants: variants, readable: flags & 1 != 0, writable: flags & 2 != 0, eitherEndianPCM: flags & 4 != 0))
+			}
+			dataFormats.append(formats)
+		}
+		guard reader.isAtEnd else {
+			throw CocoaError(.fileReadCorruptFile)
+		}
+		self.init(loadDataFormats: { provider.dataFormats(forFileType: $0) }, fileTypes: fileTypes, dataFormats: dataFormats)
+	}
+
+	/// A compact binary snapshot of the registry, including every data format loaded so far.
+	///
+	/// Snapshots store variants in the machine's memory layout, so they are meant as a cache on
+	/// the machine that made them.
+	public func snapshot() -> Data {
+		var data = Data()
+		func append<T: BitwiseCopyable>(_ value: T) {
+			withUnsafeBytes(of: value) { data.append(contentsOf: $0) }
+		}
+		func append(_ string: String) {
+			var utf8 = string.utf8CString
+			utf8.removeLast()
+			append(UInt32(utf8.count))
+			utf8.withUnsafeBytes { data.append(contentsOf: $0) }
+		}
+		append(FileFormatRegistry.snapshotMagic)
+		append(FileFormatRegistry.snapshotVersion)
+		append(UInt32(MemoryLayout<Variant>.stride))
+		append(UInt32(fileTypes.count))
+		for (fileType, slot) in zip(fileTypes, slots) {
+			append(fileType.fileTypeID)
+			append(fileType.name)
+			append(UInt32(fileType.extensions.count))
+			for ext in fileType.extensions {
+				append(ext)
+			}
+			slot.lock.lock()
+			let formats = slot.formats
+			slot.lock.unlock()
+			guard let formats else {
+				append(Int32(-1))
+				continue
+			}
+			append(Int32(formats.count))
+			for format in formats {
+				append(format.formatID)
+				append(UInt8((format.readable ? 1 : 0) | (format.writable ? 2 : 0) | (format.eitherEndianPCM ? 4 : 0)))
+				append(UInt32(format.variants.count))
+				format.variants.withUnsafeBytes { data.append(contentsOf: $0) }
+			}
+		}
+		return data
+	}
+}
+
+/// Reads native-endian values from snapshot data.
+private struct SnapshotReader {
+	let data: Data
+	var offset: Int
+
+	init(data: Data) {
+		self.data = data
+		offset = data.startIndex
+	}
+
+	var isAtEnd: Bool {
+		return offset == data.endIndex
+	}
+
+	mutating func take(_ byteCount: Int) throws -> Range<Int> {
+		guard byteCount >= 0, data.endIndex - offset >= byteCount else {
+			throw CocoaError(.fileReadCorruptFile)
+		}
+		defer {
+			offset += byteCount
+		}
+		return offset ..< offset + byteCount
+	}
+
+	mutating func read<T: BitwiseCopyable>(_ type: T.Type) throws -> T {
+		let range = try take(MemoryLayout<T>.size)
+		return data[range].withUnsafeBytes { $0.loadUnaligned(as: T.self) }
+	}
+
+	/// Throws if `count` records of at least `minimumRecordSize` bytes can't fit in the rest of the data,
+	/// so a corrupt count can't be used to reserve memory.
+	func checkCount(_ count: Int, minimumRecordSize: Int) throws {
+		guard count <= (data.endIndex - offset) / minimumRecordSize else {
+			throw CocoaError(.fileReadCorruptFile)
+		}
+	}
+
+	/// Reads a record count, checking it with ``checkCount(_:minimumRecordSize:)``.
+	mutating func readCount(minimumRecordSize: Int) throws -> Int {
+		let count = Int(try read(UInt32.self))
+		try checkCount(count, minimumRecordSize: minimumRecordSize)
+		return count
+	}
+
+	mutating func readString() throws -> String {
+		let range = try take(Int(try read(UInt32.self)))
+		guard let string = String(bytes: data[range], encoding: .utf8) else {
+			throw CocoaError(.fileReadCorruptFile)
+		}
+		return string
+	}
+
+	mutating func readArray<T: BitwiseCopyable>(of type: T.Type, count: Int) throws -> [T] {
+		guard count <= (data.endIndex - offset) / Swift.max(MemoryLayout<T>.stride, 1) else {
+			throw CocoaError(.fileReadCorruptFile)
+		}
+		let range = try take(count * MemoryLayout<T>.stride)
+		return [T](unsafeUninitializedCapacity: count) { (buffer, initializedCount) in
+			data[range].withUnsafeBytes { (bytes) in
+				UnsafeMutableRawBufferPointer(buffer).copyMemory(from: bytes)
+			}
+			initializedCount = count
+		}
+	}
+}
@@ -16,4 +16,4 @@ FOUNDATION_EXPORT const unsigned char FoundationAdditionsVersionString[];
 
 // In this header, you should import all the public headers of your framework using statements like #import <FoundationAdditions/PublicHeader.h>
 
-
+#import <FoundationAdditions/FoundationAdditionsAtomics.h>
@@ -6,6 +6,8 @@
 //  Copyright (c) 2014 C.W. Betts. All rights reserved.
 //
 
+#if canImport(Darwin)
+
 import Foundation
 #if !os(OSX)
 	import UIKit
@@ -535,3 +537,5 @@ public extension Bundle {
 		self.init(url: cfURL as URL)!
 	}
 }
+
+#endif
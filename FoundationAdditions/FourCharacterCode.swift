@@ -0,0 +1,314 @@
+//
+//  FourCharacterCode.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// A four-character code, such as an `OSType`, that can be converted to and from
+/// a *Mac OS Roman* string without any intermediate allocations.
+///
+/// This is a value type wrapped around the raw `UInt32`, and is usable on platforms
+/// that don't have the `MacTypes` header.
+/// The conversions agree with `OSTypeToString(_:)` and `toOSType(_:detectHex:)`.
+public struct FourCharacterCode: RawRepresentable, Hashable, Comparable, Sendable {
+	/// The code, with the first character in the most-significant byte.
+	public var rawValue: UInt32
+
+	@inlinable public init(rawValue: UInt32) {
+		self.rawValue = rawValue
+	}
+
+	@inlinable public init(_ rawValue: UInt32) {
+		self.rawValue = rawValue
+	}
+
+	/// Creates a four-character code from four bytes, first character first.
+	@inlinable public init(bytes: (UInt8, UInt8, UInt8, UInt8)) {
+		rawValue = UInt32(bytes.0) << 24 | UInt32(bytes.1) << 16 | UInt32(bytes.2) << 8 | UInt32(bytes.3)
+	}
+
+	/// The four bytes of the code, first character first.
+	@inlinable public var bytes: (UInt8, UInt8, UInt8, UInt8) {
+		return (UInt8(truncatingIfNeeded: rawValue >> 24), UInt8(truncatingIfNeeded: rawValue >> 16),
+				UInt8(truncatingIfNeeded: rawValue >> 8), UInt8(truncatingIfNeeded: rawValue))
+	}
+
+	@inlinable public static func <(lhs: FourCharacterCode, rhs: FourCharacterCode) -> Bool {
+		return lhs.rawValue < rhs.rawValue
+	}
+
+	/// `true` if none of the characters are control characters (*0x00*..*0x1F*),
+	/// meaning the code can be represented as a string.
+	@inlinable public var isPrintable: Bool {
+		return !FourCharacterCode.containsControlByte(rawValue)
+	}
+
+	/// Checks if any of the bytes in `value` are less than *0x20*.
+	///
+	/// Uses the "has less than" bit trick, which is exact for a threshold of *0x20*.
+	@inlinable @inline(__always)
+	static func containsControlByte(_ value: UInt32) -> Bool {
+		return (value &- 0x20202020) & ~value & 0x80808080 != 0
+	}
+
+	/// The Mac OS Roman string representation of the code, or `nil` if
+	/// any of the characters are control characters.
+	public var stringValue: String? {
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+		let signpost = HotPathCounters.begin()
+		defer {
+			HotPathCounters.Slot.fourCharacterCodeStringValue.end(since: signpost)
+		}
+#endif
+		guard isPrintable else {
+			return nil
+		}
+		// At most twelve UTF-8 code units, which fits in a small string.
+		return String(unsafeUninitializedCapacity: FourCharacterCode.maximumUTF8Length) { (buffer) -> Int in
+			return MacOSRoman.utf8Table.withUnsafeBufferPointer { (table) -> Int in
+				return FourCharacterCode.decodeUTF8(rawValue, to: buffer.baseAddress!, table: table)
+			}
+		}
+	}
+
+	/// The code as a hexadecimal string, formatted like `"0x%08X"`.
+	public var hexadecimalString: String {
+		return String(unsafeUninitializedCapacity: 10) { (buffer) -> Int in
+			let digits: StaticString = "0123456789ABCDEF"
+			buffer[0] = UInt8(ascii: "0")
+			buffer[1] = UInt8(ascii: "x")
+			for i in 0 ..< 8 {
+				let nibble = Int((rawValue >> UInt32(28 - i * 4)) & 0xF)
+				buffer[i + 2] = digits.utf8Start[nibble]
+			}
+			return 10
+		}
+	}
+
+	/// Writes the UTF-8 representation of `value` to `output`, which must have room
+	/// for ``maximumUTF8Length`` code units.
+	@inline(__always)
+	static func decodeUTF8(_ value: UInt32, to output: UnsafeMutablePointer<UInt8>, table: UnsafeBufferPointer<UInt32>) -> Int {
+		var written = MacOSRoman.decode(UInt8(truncatingIfNeeded: value >> 24), to: output, table: table)
+		written += MacOSRoman.decode(UInt8(truncatingIfNeeded: value >> 16), to: output + written, table: table)
+		written += MacOSRoman.decode(UInt8(truncatingIfNeeded: value >> 8), to: output + written, table: table)
+		written += MacOSRoman.decode(UInt8(truncatingIfNeeded: value), to: output + written, table: table)
+		return written
+	}
+}
+
+extension FourCharacterCode: CustomStringConvertible {
+	/// The string representation of the code, or the hexadecimal representation
+	/// if the code contains control characters.
+	public var description: String {
+		return stringValue ?? hexadecimalString
+	}
+}
+
+// MARK: - Encoding
+
+public extension FourCharacterCode {
+	/// Converts a `String` value to a four-character code, truncating to the first four characters.
+	///
+	/// If `string` is shorter than four characters, the missing character spots are filled in with zeros.
+	/// - parameter string: The `String` to get the code from.
+	/// - parameter detectHex: If `true`, attempts to detect if the string is formatted as a hexadecimal value.
+	/// The hexadecimal value is only used if the string is longer than four characters.
+	///
+	/// If the string can't be represented in the Mac OS Roman string encoding, or is empty,
+	/// the code is *0*.
+	init(_ string: String, detectHex: Bool = false) {
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+		let signpost = HotPathCounters.begin()
+		defer {
+			HotPathCounters.Slot.fourCharacterCodeFromString.end(since: signpost)
+		}
+#endif
+		if detectHex && string.utf8.count > 4 && string.count > 4,
+		   let hexVal = FourCharacterCode.scanHex(string.unicodeScalars) {
+			self.init(rawValue: hexVal)
+			return
+		}
+		if let value = FourCharacterCode.encodeMacOSRoman(string.unicodeScalars) {
+			self.init(rawValue: value)
+			return
+		}
+		// CoreFoundation's converter composes decomposed Latin characters,
+		// so try again with the precomposed form.
+		let precomposed = string.precomposedStringWithCanonicalMapping
+		if precomposed != string,
+		   let value = FourCharacterCode.encodeMacOSRoman(precomposed.unicodeScalars) {
+			self.init(rawValue: value)
+			return
+		}
+		self.init(rawValue: 0)
+	}
+
+	/// Encodes the first four scalars, but validates that the whole string can be
+	/// represented in Mac OS Roman.
+	private static func encodeMacOSRoman(_ scalars: String.UnicodeScalarView) -> UInt32? {
+		var value: UInt32 = 0
+		var count = 0
+		for scalar in scalars {
+			guard let byte = MacOSRoman.encode(scalar) else {
+				return nil
+			}
+			if count < 4 {
+				value |= UInt32(byte) << UInt32(24 - count * 8)
+			}
+			count += 1
+		}
+		return value
+	}
+
+	/// Parses a hexadecimal number the same way `Scanner.scanHexInt64(_:)` does:
+	/// leading whitespace is skipped, a `0x` prefix is optional, and scanning stops at
+	/// the first non-hexadecimal character.
+	///
+	/// Returns `nil` if there are no digits, or the value doesn't fit in a `UInt32`.
+	private static func scanHex(_ scalars: String.UnicodeScalarView) -> UInt32? {
+		var iter = scalars.makeIterator()
+		var current = iter.next()
+		while let scalar = current, scalar.properties.isWhitespace {
+			current = iter.next()
+		}
+		var value: UInt64 = 0
+		var digitCount = 0
+		func hexValue(_ scalar: Unicode.Scalar?) -> UInt64? {
+			guard let scalar else {
+				return nil
+			}
+			switch scalar {
+			case "0"..."9":
+				return UInt64(scalar.value - 0x30)
+			case "a"..."f":
+				return UInt64(scalar.value - 0x61 + 10)
+			case "A"..."F":
+				return UInt64(scalar.value - 0x41 + 10)
+			default:
+				return nil
+			}
+		}
+		if current == "0" {
+			// Either a lone zero digit or the start of a `0x` prefix.
+			current = iter.next()
+			if current == "x" || current == "X" {
+				current = iter.next()
+			} else {
+				digitCount = 1
+			}
+		}
+		while let digit = hexValue(current) {
+			guard value <= UInt64(UInt32.max) else {
+				return nil
+			}
+			value = value << 4 | digit
+			digitCount += 1
+			current = iter.next()
+		}
+		guard digitCount > 0, value <= UInt64(UInt32.max) else {
+			return nil
+		}
+		return UInt32(value)
+	}
+}
+
+// MARK: - Bulk operations
+
+public extension FourCharacterCode {
+	/// The most UTF-8 code units that a single code can decode to.
+	static let maximumUTF8Length = 4 * MacOSRoman.maximumUTF8Length
+
+	/// Finds the first code in `codes` that contains a control character,
+	/// and therefore can't be converted to a string.
+	///
+	/// Eight codes are checked at a time using SIMD vectors.
+	/// - returns: The index of the first invalid code, or `nil` if all of the codes are printable.
+	static func firstInvalidIndex(in codes: UnsafeBufferPointer<UInt32>) -> Int? {
+		guard let base = codes.baseAddress else {
+			return nil
+		}
+		let lanes = SIMD8<UInt32>.scalarCount
+		let threshold = SIMD8<UInt32>(repeating: 0x20202020)
+		let highBits = SIMD8<UInt32>(repeating: 0x80808080)
+		var i = 0
+		while i + lanes <= codes.count {
+			let vector = UnsafeRawPointer(base + i).loadUnaligned(as: SIMD8<UInt32>.self)
+			let hits = (vector &- threshold) & ~vector & highBits
+			if any(hits .!= 0) {
+				break
+			}
+			i += lanes
+		}
+		while i < codes.count {
+			if containsControlByte(base[i]) {
+				return i
+			}
+			i += 1
+		}
+		return nil
+	}
+
+	/// Returns `true` if every code in `codes` can be converted to a string.
+	@inlinable static func allPrintable(_ codes: UnsafeBufferPointer<UInt32>) -> Bool {
+		return firstInvalidIndex(in: codes) == nil
+	}
+
+	/// Decodes a buffer of codes into a contiguous UTF-8 byte stream.
+	/// - parameter codes: The codes to decode.
+	/// - parameter output: The buffer to write the UTF-8 code units to. Must hold at least
+	/// `codes.count * FourCharacterCode.maximumUTF8Length` bytes.
+	/// - parameter lengths: On return, the number of UTF-8 code units written for each code,
+	/// or *0* if the code contains control characters. Must hold at least `codes.count` elements.
+	/// - returns: The total number of code units written to `output`.
+	static func decode(_ codes: UnsafeBufferPointer<UInt32>, into output: UnsafeMutableBufferPointer<UInt8>, lengths: UnsafeMutableBufferPointer<Int>) -> Int {
+		precondition(output.count >= codes.count * maximumUTF8Length, "Output buffer is too small")
+		precondition(lengths.count >= codes.count, "Lengths buffer is too small")
+		guard let outBase = output.baseAddress else {
+			return 0
+		}
+		return MacOSRoman.utf8Table.withUnsafeBufferPointer { (table) -> Int in
+			var written = 0
+			for (i, code) in codes.enumerated() {
+				if containsControlByte(code) {
+					lengths[i] = 0
+					continue
+				}
+				let len = decodeUTF8(code, to: outBase + written, table: table)
+				lengths[i] = len
+				written += len
+			}
+			return written
+		}
+	}
+
+	/// Encodes strings to codes, using the same rules as ``init(_:detectHex:)``.
+	/// - parameter strings: The strings to encode.
+	/// - parameter detectHex: If `true`, attempts to detect if the strings are formatted as
+	/// hexadecimal values.
+	/// - parameter codes: The buffer to write the codes to.
+	/// - returns: The number of codes written, which is the smaller of the number of strings
+	/// and `codes.count`.
+	static func encode<S: Sequence>(_ strings: S, detectHex: Bool = false, into codes: UnsafeMutableBufferPointer<UInt32>) -> Int where S.Element == String {
+		var i = 0
+		for string in strings {
+			guard i < codes.count else {
+				break
+			}
+			codes[i] = FourCharacterCode(string, detectHex: detectHex).rawValue
+			i += 1
+		}
+		return i
+	}
+}
+
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+private extension HotPathCounters.Slot {
+	static let fourCharacterCodeStringValue = HotPathCounters.Slot("FourCharacterCode.stringValue")
+	static let fourCharacterCodeFromString = HotPathCounters.Slot("FourCharacterCode.init(_:detectHex:)")
+}
+#endif
@@ -0,0 +1,667 @@
+//
+//  FrameStreaming.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// Something frames can be read from, such as an audio file.
+public protocol FrameSource: AnyObject {
+	/// The layout of the frames that ``read(frames:into:)`` produces.
+	///
+	/// Throws if the source's frames can't be described as a ``PCMFormat``.
+	var frameFormat: PCMFormat { get throws }
+
+	/// Moves the read position.
+	func seek(toFrame frame: Int64) throws
+
+	/// Reads the next frames.
+	/// - parameter frames: On input, the number of frames to read. On output, the number of
+	/// frames actually read, which is *0* at the end.
+	/// - parameter buffers: Returns the destination buffer at an index, from *0* to
+	/// `frameFormat.bufferCount - 1`.
+	func read(frames: inout Int, into buffers: (Int) -> UnsafeMutableRawPointer) throws
+}
+
+/// Something frames can be written to, such as an audio file.
+public protocol FrameSink: AnyObject {
+	/// The layout of the frames that ``write(frames:from:)`` takes.
+	///
+	/// Throws if the sink's frames can't be described as a ``PCMFormat``.
+	var frameFormat: PCMFormat { get throws }
+
+	/// Writes frames.
+	/// - parameter frames: The number of frames to write.
+	/// - parameter buffers: Returns the source buffer at an index, from *0* to
+	/// `frameFormat.bufferCount - 1`.
+	func write(frames: Int, from buffers: (Int) -> UnsafeRawPointer) throws
+}
+
+extension MappedAudioFile: FrameSource {
+	public var frameFormat: PCMFormat {
+		return clientFormat
+	}
+}
+
+/// Counters for a ``StreamingFrameReader`` or ``StreamingFrameWriter``.
+public struct FrameStreamStatistics: Hashable, Sendable {
+	/// The number of reads that got fewer frames than they asked for before the end of the source.
+	public var underruns: Int
+	/// The number of silent frames that padded out underruns.
+	public var underrunFrames: Int
+	/// The number of writes that didn't fit in the ring.
+	public var overruns: Int
+	/// The number of frames dropped by overruns.
+	public var droppedFrames: Int
+	/// The longest a single read from the source or write to the sink took, in seconds.
+	public var maximumIOLatency: Double
+}
+
+// MARK: - Ring buffer
+
+/// A lock-free single-producer, single-consumer ring of frames.
+///
+/// One thread may write and one other thread may read at the same time. The capacity is
+/// rounded up to a power of two. Each buffer of the format has its own plane, so
+/// non-interleaved frames stay non-interleaved.
+public final class FrameRingBuffer: @unchecked Sendable {
+	/// The layout of the frames.
+	public let format: PCMFormat
+	/// The number of frames the ring holds.
+	public let capacity: Int
+
+	private let mask: Int
+	private let bytesPerFrame: Int
+	private let planes: UnsafeMutableRawPointer
+	private let planeStride: Int
+	/// The total number of frames ever written. Only the producer stores it.
+	private let writeCursor = makeSharedCounter()
+	/// The total number of frames ever read. Only the consumer stores it.
+	private let readCursor = makeSharedCounter()
+
+	/// - parameter format: The layout of the frames.
+	/// - parameter capacity: The minimum number of frames the ring holds.
+	public init(format: PCMFormat, capacity: Int) {
+		precondition(capacity > 0, "A ring needs room for at least one frame")
+		self.format = format
+		var size = 1
+		while size < capacity {
+			size <<= 1
+		}
+		self.capacity = size
+		mask = size - 1
+		bytesPerFrame = format.bytesPerFrame
+		planeStride = (size * bytesPerFrame + BufferListLayout.alignment - 1) & ~(BufferListLayout.alignment - 1)
+		planes = .allocate(byteCount: planeStride * format.bufferCount, alignment: BufferListLayout.alignment)
+	}
+
+	deinit {
+		planes.deallocate()
+	}
+
+	/// The number of frames that can be read now.
+	public var availableToRead: Int {
+		return writeCursor.load() - readCursor.load()
+	}
+
+	/// The number of frames that can be written now.
+	public var availableToWrite: Int {
+		return capacity - availableToRead
+	}
+
+	/// The total number of frames ever written.
+	public var totalWritten: Int {
+		return writeCursor.load()
+	}
+
+	/// The total number of frames ever read.
+	public var totalRead: Int {
+		return readCursor.load()
+	}
+
+	/// The start of a buffer's plane.
+	@inline(__always)
+	private func plane(_ index: Int) -> UnsafeMutableRawPointer {
+		return planes + index * planeStride
+	}
+
+	// MARK: Producer
+
+	/// The free frames at the write position that are contiguous in memory. Producer only.
+	/// - returns: The ring offset of the region, for ``buffer(_:at:)``, and its frame count.
+	public func writableRegion() -> (offset: Int, count: Int) {
+		let written = writeCursor.load()
+		let free = capacity - (written - readCursor.load())
+		let offset = written & mask
+		return (offset, Swift.min(free, capacity - offset))
+	}
+
+	/// The memory of a buffer at a frame offset in the ring.
+	@inline(__always)
+	public func buffer(_ index: Int, at offset: Int) -> UnsafeMutableRawPointer {
+		return plane(index) + offset * bytesPerFrame
+	}
+
+	/// Makes frames written into ``writableRegion()`` available to the consumer. Producer only.
+	public func commitWrite(_ frames: Int) {
+		writeCursor.store(writeCursor.load() + frames)
+	}
+
+	/// Copies frames into the ring. Producer only.
+	/// - returns: The number of frames copied, which is less than `frames` if the ring is full.
+	@discardableResult
+	public func write(frames: Int, from buffers: (Int) -> UnsafeRawPointer) -> Int {
+		var done = 0
+		while done < frames {
+			let region = writableRegion()
+			let count = Swift.min(region.count, frames - done)
+			guard count > 0 else {
+				break
+			}
+			for i in 0 ..< format.bufferCount {
+				buffer(i, at: region.offset).copyMemory(from: buffers(i) + done * bytesPerFrame, byteCount: count * bytesPerFrame)
+			}
+			commitWrite(count)
+			done += count
+		}
+		return done
+	}
+
+	// MARK: Consumer
+
+	/// The filled frames at the read position that are contiguous in memory. Consumer only.
+	public func readableRegion() -> (offset: Int, count: Int) {
+		let read = readCursor.load()
+		let filled = writeCursor.load() - read
+		let offset = read & mask
+		return (offset, Swift.min(filled, capacity - offset))
+	}
+
+	/// Frees frames read from ``readableRegion()`` for the producer. Consumer only.
+	public func commitRead(_ frames: Int) {
+		readCursor.store(readCursor.load() + frames)
+	}
+
+	/// Discards every frame before a total written count. Consumer only.
+	func skip(toTotal total: Int) {
+		if readCursor.load() < total {
+			readCursor.store(total)
+		}
+	}
+
+	/// Copies frames out of the ring. Consumer only.
+	/// - returns: The number of frames copied, which is less than `frames` if the ring runs dry.
+	@discardableResult
+	public func read(frames: Int, into buffers: (Int) -> UnsafeMutableRawPointer) -> Int {
+		var done = 0
+		while done < frames {
+			let region = readableRegion()
+			let count = Swift.min(region.count, frames - done)
+			guard count > 0 else {
+				break
+			}
+			for i in 0 ..< format.bufferCount {
+				(buffers(i) + done * bytesPerFrame).copyMemory(from: buffer(i, at: region.offset), byteCount: count * bytesPerFrame)
+			}
+			commitRead(count)
+			done += count
+		}
+		return done
+	}
+}
+
+// MARK: - Reader
+
+/// Reads frames from a source on a background I/O thread, ahead of a real-time consumer.
+///
+/// The I/O thread keeps a ``FrameRingBuffer`` filled from the source. ``read(frames:into:)``
+/// only copies out of the ring, so it never blocks on the source; if the ring runs dry, the
+/// rest of the request is filled with silence and counted as an underrun. Seeking is
+/// asynchronous: the I/O thread seeks the source, drops the stale frames, and prefetches
+/// from the new position.
+///
+/// The consumer side shares state with the I/O thread only through the package's atomic
+/// shared counters, so it never takes a lock.
+public final class StreamingFrameReader: @unchecked Sendable {
+	/// The layout of the frames.
+	public let format: PCMFormat
+	/// The ring between the I/O thread and the consumer.
+	public let ring: FrameRingBuffer
+	/// The most frames the I/O thread reads from the source at once.
+	public let chunkFrames: Int
+
+	private let source: FrameSource
+	private let worker: IOWorker
+	private let counters = StreamCounters()
+
+	private let seekLock = NSLock()
+	private var seekTarget: Int64 = 0
+	private let seekRequests = makeSharedCounter()
+	private var seeksHandled = 0
+
+	/// Published by the I/O thread when it has handled a seek. `flushGeneration` is odd
+	/// while the cursor and position are being written, like a sequence lock.
+	private let flushCursor = makeSharedCounter()
+	private let flushPosition = makeSharedCounter()
+	private let flushGeneration = makeSharedCounter()
+	private var flushesSeen = 0
+	/// The total written count at the end of the source, or `Int.max`.
+	private let endCursor = makeSharedCounter(Int.max)
+
+	private var consumerPosition: Int64 = 0
+	private var consumerBase = 0
+	private let errorLock = NSLock()
+	private var sourceError: Error?
+
+	/// - parameter source: Where to read frames from. Only the I/O thread uses it after ``start()``.
+	/// - parameter readAheadFrames: The most frames to read ahead. Default is *65536*.
+	/// - parameter chunkFrames: The most frames to read from the source at once. Default is *4096*.
+	/// - throws: The error from the source's ``FrameSource/frameFormat``.
+	public init(source: FrameSource, readAheadFrames: Int = 65536, chunkFrames: Int = 4096) throws {
+		self.source = source
+		format = try source.frameFormat
+		ring = FrameRingBuffer(format: format, capacity: readAheadFrames)
+		self.chunkFrames = Swift.min(chunkFrames, ring.capacity)
+		worker = IOWorker(name: "StreamingFrameReader")
+	}
+
+	deinit {
+		worker.cancel()
+	}
+
+	/// Starts the I/O thread.
+	public func start() {
+		worker.start { [weak self] in
+			self?.service()
+		}
+	}
+
+	/// Stops the I/O thread, waiting for it to finish its current read.
+	public func stop() {
+		worker.stop()
+	}
+
+	/// Statistics about the stream so far.
+	public var statistics: FrameStreamStatistics {
+		return counters.snapshot
+	}
+
+	/// The error that stopped the I/O thread from reading the source, if any.
+	public var error: Error? {
+		errorLock.lock()
+		defer {
+			errorLock.unlock()
+		}
+		return sourceError
+	}
+
+	/// Asks the I/O thread to seek the source and prefetch from there.
+	///
+	/// Frames already in the ring are dropped once the I/O thread has seeked; until then,
+	/// ``read(frames:into:)`` may still return frames from before the seek.
+	public func seek(toFrame frame: Int64) {
+		seekLock.lock()
+		seekTarget = frame
+		seekLock.unlock()
+		seekRequests.add(1)
+		worker.wake()
+	}
+
+	/// The source frame that ``read(frames:into:)`` will return next. Consumer only.
+	public func tell() -> Int64 {
+		applyFlush()
+		return consumerPosition + Int64(ring.totalRead - consumerBase)
+	}
+
+	/// `true` if every frame of the source has been read. Consumer only.
+	public var isAtEnd: Bool {
+		applyFlush()
+		return ring.totalRead >= endCursor.load()
+	}
+
+	/// Waits for the I/O thread to fill the ring or reach the end of the source. Not for
+	/// real-time threads.
+	/// - parameter minimumFrames: The number of frames to wait for. Default is the ring's capacity.
+	/// - parameter timeout: The longest to wait, in seconds.
+	/// - returns: `true` if the frames are there or the source ended, `false` if it timed out.
+	@discardableResult
+	public func waitForPrefetch(minimumFrames: Int? = nil, timeout: TimeInterval) -> Bool {
+		let deadline = Date(timeIntervalSinceNow: timeout)
+		let wanted = Swift.min(minimumFrames ?? ring.capacity, ring.capacity)
+		while true {
+			applyFlush()
+			if seekRequests.load() == seeksHandledSnapshot && (ring.availableToRead >= wanted || ring.totalWritten >= endCursor.load()) {
+				return true
+			}
+			guard worker.waitForProgress(until: deadline) else {
+				return false
+			}
+		}
+	}
+
+	private var seeksHandledSnapshot: Int {
+		seekLock.lock()
+		defer {
+			seekLock.unlock()
+		}
+		return seeksHandled
+	}
+
+	/// Copies frames out of the ring. It never blocks on the source, and doesn't take a lock.
+	/// - parameter frames: On input, the number of frames wanted. On output, the number of
+	/// frames put in the buffers. If the ring ran dry before the end of the source, the rest
+	/// of the buffers are filled with silence, an underrun is counted, and this is still the
+	/// number wanted; the silence doesn't move ``tell()``. At the end of the source it can be
+	/// fewer, and *0* means every frame has been read.
+	/// - parameter buffers: Returns the destination buffer at an index, from *0* to
+	/// `format.bufferCount - 1`.
+	public func read(frames: inout Int, into buffers: (Int) -> UnsafeMutableRawPointer) {
+		applyFlush()
+		let wanted = frames
+		let copied = ring.read(frames: wanted, into: buffers)
+		frames = copied
+		if copied < wanted && ring.totalRead < endCursor.load() {
+			let bytesPerFrame = format.bytesPerFrame
+			for i in 0 ..< format.bufferCount {
+				(buffers(i) + copied * bytesPerFrame).initializeMemory(as: UInt8.self, repeating: 0, count: (wanted - copied) * bytesPerFrame)
+			}
+			counters.underruns.add(1)
+			counters.underrunFrames.add(wanted - copied)
+			frames = wanted
+		}
+		if ring.availableToWrite >= chunkFrames {
+			worker.wake()
+		}
+	}
+
+	/// Drops frames the I/O thread flushed for a seek.
+	///
+	/// If the I/O thread is in the middle of publishing a flush, this does nothing, and the
+	/// next call picks it up.
+	private func applyFlush() {
+		let generation = flushGeneration.load()
+		guard generation != flushesSeen, generation & 1 == 0 else {
+			return
+		}
+		let cursor = flushCursor.load()
+		let position = Int64(flushPosition.load())
+		guard flushGeneration.load() == generation else {
+			return
+		}
+		ring.skip(toTotal: cursor)
+		consumerBase = cursor
+		consumerPosition = position
+		flushesSeen = generation
+	}
+
+	/// One pass of the I/O thread.
+	private func service() {
+		let requests = seekRequests.load()
+		seekLock.lock()
+		let pendingSeek = requests != seeksHandled ? seekTarget : nil
+		seekLock.unlock()
+		if let pendingSeek {
+			do {
+				try source.seek(toFrame: pendingSeek)
+			} catch {
+				fail(error)
+			}
+			endCursor.store(Int.max)
+			flushGeneration.add(1)
+			flushCursor.store(ring.totalWritten)
+			flushPosition.store(Int(pendingSeek))
+			flushGeneration.add(1)
+			seekLock.lock()
+			seeksHandled = requests
+			seekLock.unlock()
+		}
+
+		guard endCursor.load() == Int.max else {
+			worker.progress()
+			return
+		}
+		while seekRequests.load() == requests {
+			let region = ring.writableRegion()
+			guard region.count > 0 else {
+				break
+			}
+			var count = Swift.min(region.count, chunkFrames)
+			let start = DispatchTime.now().uptimeNanoseconds
+			do {
+				try source.read(frames: &count, into: { ring.buffer($0, at: region.offset) })
+			} catch {
+				fail(error)
+				count = 0
+			}
+			counters.maximumIOLatency.raise(to: Int(DispatchTime.now().uptimeNanoseconds - start))
+			if count == 0 {
+				endCursor.store(ring.totalWritten)
+				break
+			}
+			ring.commitWrite(count)
+			worker.progress()
+		}
+		worker.progress()
+	}
+
+	private func fail(_ error: Error) {
+		errorLock.lock()
+		sourceError = error
+		errorLock.unlock()
+	}
+}
+
+// MARK: - Writer
+
+/// Writes frames to a sink on a background I/O thread, behind a real-time producer.
+///
+/// ``write(frames:from:)`` only copies into a ``FrameRingBuffer``, so it never blocks on the
+/// sink; frames that don't fit are dropped and counted as an overrun. The I/O thread drains
+/// the ring to the sink.
+public final class StreamingFrameWriter: @unchecked Sendable {
+	/// The layout of the frames.
+	public let format: PCMFormat
+	/// The ring between the producer and the I/O thread.
+	public let ring: FrameRingBuffer
+	/// The most frames the I/O thread writes to the sink at once.
+	public let chunkFrames: Int
+
+	private let sink: FrameSink
+	private let worker: IOWorker
+	private let counters = StreamCounters()
+	private let errorLock = NSLock()
+	private var sinkError: Error?
+
+	/// - parameter sink: Where to write frames to. Only the I/O thread uses it after ``start()``.
+	/// - parameter writeBehindFrames: The most frames to hold before writing. Default is *65536*.
+	/// - parameter chunkFrames: The most frames to write to the sink at once. Default is *4096*.
+	/// - throws: The error from the sink's ``FrameSink/frameFormat``.
+	public init(sink: FrameSink, writeBehindFrames: Int = 65536, chunkFrames: Int = 4096) throws {
+		self.sink = sink
+		format = try sink.frameFormat
+		ring = FrameRingBuffer(format: format, capacity: writeBehindFrames)
+		self.chunkFrames = Swift.min(chunkFrames, ring.capacity)
+		worker = IOWorker(name: "StreamingFrameWriter")
+	}
+
+	deinit {
+		worker.cancel()
+	}
+
+	/// Starts the I/O thread.
+	public func start() {
+		worker.start { [weak self] in
+			self?.service()
+		}
+	}
+
+	/// Writes everything in the ring, then stops the I/O thread.
+	public func stop() {
+		flush()
+		worker.stop()
+	}
+
+	/// Statistics about the stream so far.
+	public var statistics: FrameStreamStatistics {
+		return counters.snapshot
+	}
+
+	/// The error that stopped the I/O thread from writing to the sink, if any.
+	public var error: Error? {
+		errorLock.lock()
+		defer {
+			errorLock.unlock()
+		}
+		return sinkError
+	}
+
+	/// Copies frames into the ring. It never blocks on the sink, and doesn't take a lock.
+	/// - returns: The number of frames accepted. The rest are dropped and counted as an overrun.
+	@discardableResult
+	public func write(frames: Int, from buffers: (Int) -> UnsafeRawPointer) -> Int {
+		let written = ring.write(frames: frames, from: buffers)
+		if written < frames {
+			counters.overruns.add(1)
+			counters.droppedFrames.add(frames - written)
+		}
+		worker.wake()
+		return written
+	}
+
+	/// Waits until the I/O thread has written every frame in the ring. Not for real-time threads.
+	public func flush() {
+		guard worker.isRunning else {
+			service()
+			return
+		}
+		while ring.availableToRead > 0 && error == nil {
+			worker.wake()
+			_ = worker.waitForProgress(until: Date(timeIntervalSinceNow: 0.05))
+		}
+	}
+
+	/// One pass of the I/O thread.
+	private func service() {
+		while error == nil {
+			let region = ring.readableRegion()
+			guard region.count > 0 else {
+				break
+			}
+			let count = Swift.min(region.count, chunkFrames)
+			let start = DispatchTime.now().uptimeNanoseconds
+			do {
+				try sink.write(frames: count, from: { UnsafeRawPointer(ring.buffer($0, at: region.offset)) })
+			} catch {
+				errorLock.lock()
+				sinkError = error
+				errorLock.unlock()
+			}
+			counters.maximumIOLatency.raise(to: Int(DispatchTime.now().uptimeNanoseconds - start))
+			ring.commitRead(count)
+			worker.progress()
+		}
+		worker.progress()
+	}
+}
+
+// MARK: - Internals
+
+/// The shared counters of a stream.
+private final class StreamCounters: Sendable {
+	let underruns = makeSharedCounter()
+	let underrunFrames = makeSharedCounter()
+	let overruns = makeSharedCounter()
+	let droppedFrames = makeSharedCounter()
+	/// In nanoseconds.
+	let maximumIOLatency = makeSharedCounter()
+
+	var snapshot: FrameStreamStatistics {
+		return FrameStreamStatistics(underruns: underruns.load(), underrunFrames: underrunFrames.load(), overruns: overruns.load(), droppedFrames: droppedFrames.load(), maximumIOLatency: Double(maximumIOLatency.load()) / 1_000_000_000)
+	}
+}
+
+/// A background thread that runs a service closure whenever it's woken, or every few
+/// milliseconds.
+private final class IOWorker: @unchecked Sendable {
+	let name: String
+	private let wakeSemaphore = DispatchSemaphore(value: 0)
+	private let exited = DispatchSemaphore(value: 0)
+	private let progressCondition = NSCondition()
+	private var progressCount = 0
+	private let stopping = makeSharedCounter()
+	private let running = makeSharedCounter()
+
+	init(name: String) {
+		self.name = name
+	}
+
+	var isRunning: Bool {
+		return running.load() != 0
+	}
+
+	func start(_ service: @escaping @Sendable () -> Void) {
+		guard running.load() == 0 else {
+			return
+		}
+		running.store(1)
+		stopping.store(0)
+		let thread = Thread { [wakeSemaphore, exited, stopping] in
+			while stopping.load() == 0 {
+				service()
+				_ = wakeSemaphore.wait(timeout: .now() + .milliseconds(10))
+			}
+			exited.signal()
+		}
+		thread.name = name
+		thread.qualityOfService = .userInitiated
+		thread.start()
+	}
+
+	func stop() {
+		guard running.load() != 0 else {
+			return
+		}
+		stopping.store(1)
+		wakeSemaphore.signal()
+		exited.wait()
+		running.store(0)
+	}
+
+	/// Tells the thread to exit without waiting for it, which is safe from the thread itself.
+	func cancel() {
+		stopping.store(1)
+		wakeSemaphore.signal()
+	}
+
+	/// Wakes the thread. Safe on real-time threads on platforms where a semaphore signal is.
+	func wake() {
+		wakeSemaphore.signal()
+	}
+
+	/// Tells waiters the thread did something.
+	func progress() {
+		progressCondition.lock()
+		progressCount &+= 1
+		progressCondition.broadcast()
+		progressCondition.unlock()
+	}
+
+	/// Waits for ``progress()`` or a deadline.
+	/// - returns: `false` if the deadline passed.
+	func waitForProgress(until deadline: Date) -> Bool {
+		progressCondition.lock()
+		defer {
+			progressCondition.unlock()
+		}
+		let start = progressCount
+		while progressCount == start {
+			if !progressCondition.wait(until: deadline) {
+				return false
+			}
+		}
+		return true
+	}
+}
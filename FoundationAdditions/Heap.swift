@@ -0,0 +1,575 @@
+//
+//  Heap.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// A priority queue stored as a d-ary heap, holding its elements inline.
+///
+/// The minimum element, as determined by the ordering the heap was created with,
+/// is always available in O(1). Insertion and removal of the minimum are
+/// O(log *n*), and creating a heap from a sequence is O(*n*).
+///
+/// Unlike `CFBinaryHeap`, the elements are Swift values that don't need retain or release
+/// callbacks. A min-heap of `Comparable` elements compares with `<` directly, so the
+/// comparisons can be inlined. An ordering passed to `init(arity:by:)` is stored as a
+/// closure, and each comparison is an indirect call.
+public struct Heap<Element> {
+	/// The number of children each node has by default.
+	///
+	/// Four children per node halves the height of the tree compared to a binary heap,
+	/// and the children of a node usually share a cache line.
+	public static var defaultArity: Int {
+		return 4
+	}
+
+	@usableFromInline
+	internal var storage: ContiguousArray<Element>
+
+	/// The number of children each node has.
+	public let arity: Int
+
+	/// Returns `true` if the first argument should be closer to the top of the heap.
+	@usableFromInline
+	internal let areInIncreasingOrder: (Element, Element) -> Bool
+
+	/// `true` if `areInIncreasingOrder` is `Element`'s `<`, so the `Comparable` methods can
+	/// call `<` instead.
+	@usableFromInline
+	internal let usesLessThan: Bool
+
+	/// Creates an empty heap.
+	/// - parameter arity: The number of children each node has. Must be at least *2*.
+	/// Default is ``Heap/defaultArity``.
+	/// - parameter areInIncreasingOrder: A predicate that returns `true` if its first argument
+	/// should be removed from the heap before its second argument.
+	public init(arity: Int = Heap<Element>.defaultArity, by areInIncreasingOrder: @escaping (Element, Element) -> Bool) {
+		self.init(arity: arity, by: areInIncreasingOrder, usesLessThan: false)
+	}
+
+	@usableFromInline
+	internal init(arity: Int, by areInIncreasingOrder: @escaping (Element, Element) -> Bool, usesLessThan: Bool) {
+		precondition(arity >= 2, "Heap arity must be at least two")
+		self.storage = []
+		self.arity = arity
+		self.areInIncreasingOrder = areInIncreasingOrder
+		self.usesLessThan = usesLessThan
+	}
+
+	/// Creates a heap from a sequence of elements in O(*n*) time.
+	/// - parameter elements: The elements to put in the heap.
+	/// - parameter arity: The number of children each node has. Must be at least *2*.
+	/// Default is ``Heap/defaultArity``.
+	/// - parameter areInIncreasingOrder: A predicate that returns `true` if its first argument
+	/// should be removed from the heap before its second argument.
+	public init<S: Sequence>(_ elements: S, arity: Int = Heap<Element>.defaultArity, by areInIncreasingOrder: @escaping (Element, Element) -> Bool) where S.Element == Element {
+		self.init(arity: arity, by: areInIncreasingOrder)
+		storage = ContiguousArray(elements)
+		heapify(by: areInIncreasingOrder)
+	}
+
+	/// The number of elements in the heap.
+	@inlinable public var count: Int {
+		return storage.count
+	}
+
+	/// `true` if the heap has no elements.
+	@inlinable public var isEmpty: Bool {
+		return storage.isEmpty
+	}
+
+	/// The minimum element, or `nil` if the heap is empty.
+	///
+	/// If the heap contains several equal minimum values, any one may be returned.
+	@inlinable public var min: Element? {
+		return storage.first
+	}
+
+	/// The elements of the heap, in the order they are stored.
+	@inlinable public var unorderedElements: ContiguousArray<Element> {
+		return storage
+	}
+
+	/// Reserves enough space to store the specified number of elements.
+	@inlinable public mutating func reserveCapacity(_ minimumCapacity: Int) {
+		storage.reserveCapacity(minimumCapacity)
+	}
+
+	/// Inserts an element into the heap.
+	public mutating func insert(_ element: Element) {
+		insert(element, by: areInIncreasingOrder)
+	}
+
+	/// Inserts the elements of a sequence into the heap.
+	///
+	/// If the new elements outnumber the current ones, the whole heap is rebuilt in
+	/// linear time instead of inserting them one at a time.
+	public mutating func insert<S: Sequence>(contentsOf elements: S) where S.Element == Element {
+		insert(contentsOf: elements, by: areInIncreasingOrder)
+	}
+
+	/// Removes and returns the minimum element, or returns `nil` if the heap is empty.
+	public mutating func popMin() -> Element? {
+		guard !storage.isEmpty else {
+			return nil
+		}
+		return removeMin()
+	}
+
+	/// Removes and returns the minimum element. The heap must not be empty.
+	@discardableResult
+	public mutating func removeMin() -> Element {
+		return removeMin(by: areInIncreasingOrder)
+	}
+
+	/// Replaces the minimum element with `element`, and returns the old minimum.
+	///
+	/// Cheaper than removing the minimum then inserting. The heap must not be empty.
+	@discardableResult
+	public mutating func replaceMin(with element: Element) -> Element {
+		return replaceMin(with: element, by: areInIncreasingOrder)
+	}
+
+	/// Removes all the elements from the heap.
+	@inlinable public mutating func removeAll(keepingCapacity keepCapacity: Bool = false) {
+		storage.removeAll(keepingCapacity: keepCapacity)
+	}
+
+	/// Adds all the elements of `other` to this heap.
+	///
+	/// The heaps must have been created with the same ordering.
+	public mutating func merge(_ other: Heap<Element>) {
+		insert(contentsOf: other.storage)
+	}
+
+	/// Returns a heap with the elements of both heaps, using this heap's ordering and arity.
+	public func merging(_ other: Heap<Element>) -> Heap<Element> {
+		var result = self
+		result.merge(other)
+		return result
+	}
+
+	// MARK: Operations with an explicit ordering
+
+	// The public methods pass the stored closure to these, and the `Comparable` ones pass `<`.
+	// Inlining them lets the compiler see which one it got.
+
+	@inlinable @inline(__always)
+	internal mutating func insert(_ element: Element, by less: (Element, Element) -> Bool) {
+		storage.append(element)
+		let last = storage.count - 1
+		let arity = self.arity
+		storage.withUnsafeMutableBufferPointer { (buffer) in
+			Heap.siftUp(buffer, from: last, arity: arity, by: less)
+		}
+	}
+
+	@inlinable @inline(__always)
+	internal mutating func insert<S: Sequence>(contentsOf elements: S, by less: (Element, Element) -> Bool) where S.Element == Element {
+		let oldCount = storage.count
+		storage.append(contentsOf: elements)
+		if storage.count - oldCount > oldCount {
+			heapify(by: less)
+			return
+		}
+		let arity = self.arity
+		storage.withUnsafeMutableBufferPointer { (buffer) in
+			for i in oldCount ..< buffer.count {
+				Heap.siftUp(buffer, from: i, arity: arity, by: less)
+			}
+		}
+	}
+
+	@inlinable @inline(__always)
+	internal mutating func removeMin(by less: (Element, Element) -> Bool) -> Element {
+		precondition(!storage.isEmpty, "Can't remove from an empty heap")
+		let last = storage.removeLast()
+		guard !storage.isEmpty else {
+			return last
+		}
+		return replaceMin(with: last, by: less)
+	}
+
+	@inlinable @inline(__always)
+	internal mutating func replaceMin(with element: Element, by less: (Element, Element) -> Bool) -> Element {
+		precondition(!storage.isEmpty, "Can't replace in an empty heap")
+		let arity = self.arity
+		return storage.withUnsafeMutableBufferPointer { (buffer) -> Element in
+			let oldMin = buffer[0]
+			buffer[0] = element
+			Heap.siftDown(buffer, from: 0, arity: arity, by: less)
+			return oldMin
+		}
+	}
+
+	/// Rebuilds the heap property over all of the storage, bottom-up (Floyd's method).
+	@inlinable
+	internal mutating func heapify(by less: (Element, Element) -> Bool) {
+		let arity = self.arity
+		storage.withUnsafeMutableBufferPointer { (buffer) in
+			guard buffer.count > 1 else {
+				return
+			}
+			var i = (buffer.count - 2) / arity
+			while i >= 0 {
+				Heap.siftDown(buffer, from: i, arity: arity, by: less)
+				i -= 1
+			}
+		}
+	}
+
+	/// Moves the element at `index` up until its parent isn't larger than it,
+	/// shifting parents down into the hole instead of swapping.
+	@inlinable @inline(__always)
+	internal static func siftUp(_ buffer: UnsafeMutableBufferPointer<Element>, from index: Int, arity: Int, by less: (Element, Element) -> Bool) {
+		var i = index
+		let moving = buffer[i]
+		while i > 0 {
+			let parent = (i - 1) / arity
+			guard less(moving, buffer[parent]) else {
+				break
+			}
+			buffer[i] = buffer[parent]
+			i = parent
+		}
+		buffer[i] = moving
+	}
+
+	/// Moves the element at `index` down until none of its children are smaller than it,
+	/// shifting children up into the hole instead of swapping.
+	@inlinable @inline(__always)
+	internal static func siftDown(_ buffer: UnsafeMutableBufferPointer<Element>, from index: Int, arity: Int, by less: (Element, Element) -> Bool) {
+		let count = buffer.count
+		var i = index
+		let moving = buffer[i]
+		while true {
+			let firstChild = i * arity + 1
+			guard firstChild < count else {
+				break
+			}
+			let endChild = Swift.min(firstChild + arity, count)
+			var best = firstChild
+			var child = firstChild + 1
+			while child < endChild {
+				if less(buffer[child], buffer[best]) {
+					best = child
+				}
+				child += 1
+			}
+			guard less(buffer[best], moving) else {
+				break
+			}
+			buffer[i] = buffer[best]
+			i = best
+		}
+		buffer[i] = moving
+	}
+}
+
+/// These shadow the unconstrained methods. When the heap uses `<`, they call it directly
+/// instead of through the stored closure.
+public extension Heap where Element: Comparable {
+	/// Creates an empty min-heap.
+	/// - parameter arity: The number of children each node has. Must be at least *2*.
+	/// Default is ``Heap/defaultArity``.
+	@inlinable
+	init(arity: Int = Heap<Element>.defaultArity) {
+		self.init(arity: arity, by: <, usesLessThan: true)
+	}
+
+	/// Creates a min-heap from a sequence of elements in O(*n*) time.
+	/// - parameter elements: The elements to put in the heap.
+	/// - parameter arity: The number of children each node has. Must be at least *2*.
+	/// Default is ``Heap/defaultArity``.
+	@inlinable
+	init<S: Sequence>(_ elements: S, arity: Int = Heap<Element>.defaultArity) where S.Element == Element {
+		self.init(arity: arity)
+		storage = ContiguousArray(elements)
+		heapify(by: <)
+	}
+
+	/// Inserts an element into the heap.
+	@inlinable
+	mutating func insert(_ element: Element) {
+		if usesLessThan {
+			insert(element, by: <)
+		} else {
+			insert(element, by: areInIncreasingOrder)
+		}
+	}
+
+	/// Inserts the elements of a sequence into the heap.
+	///
+	/// If the new elements outnumber the current ones, the whole heap is rebuilt in
+	/// linear time instead of inserting them one at a time.
+	@inlinable
+	mutating func insert<S: Sequence>(contentsOf elements: S) where S.Element == Element {
+		if usesLessThan {
+			insert(contentsOf: elements, by: <)
+		} else {
+			insert(contentsOf: elements, by: areInIncreasingOrder)
+		}
+	}
+
+	/// Removes and returns the minimum element, or returns `nil` if the heap is empty.
+	@inlinable
+	mutating func popMin() -> Element? {
+		guard !storage.isEmpty else {
+			return nil
+		}
+		return removeMin()
+	}
+
+	/// Removes and returns the minimum element. The heap must not be empty.
+	@inlinable @discardableResult
+	mutating func removeMin() -> Element {
+		if usesLessThan {
+			return removeMin(by: <)
+		}
+		return removeMin(by: areInIncreasingOrder)
+	}
+
+	/// Replaces the minimum element with `element`, and returns the old minimum.
+	///
+	/// Cheaper than removing the minimum then inserting. The heap must not be empty.
+	@inlinable @discardableResult
+	mutating func replaceMin(with element: Element) -> Element {
+		if usesLessThan {
+			return replaceMin(with: element, by: <)
+		}
+		return replaceMin(with: element, by: areInIncreasingOrder)
+	}
+
+	/// Adds all the elements of `other` to this heap.
+	///
+	/// The heaps must have been created with the same ordering.
+	@inlinable
+	mutating func merge(_ other: Heap<Element>) {
+		insert(contentsOf: other.storage)
+	}
+}
+
+extension Heap: CustomStringConvertible {
+	public var description: String {
+		return "Heap(count: \(count), min: \(min.map { String(describing: $0) } ?? "nil"))"
+	}
+}
+
+// MARK: - Indexed heap
+
+/// A d-ary heap whose elements can be changed or removed after insertion, through
+/// the handle returned when they were inserted.
+///
+/// Changing the priority of an element (such as decrease-key) and removing an arbitrary
+/// element are both O(log *n*).
+public struct IndexedHeap<Element> {
+	/// Identifies an element in an ``IndexedHeap``.
+	///
+	/// A handle is only valid until its element is removed from the heap; after that,
+	/// it may be reused for another element.
+	public struct Handle: Hashable, Sendable {
+		@usableFromInline
+		internal let rawValue: Int
+
+		@usableFromInline
+		internal init(rawValue: Int) {
+			self.rawValue = rawValue
+		}
+	}
+
+	@usableFromInline
+	internal struct Entry {
+		@usableFromInline var element: Element
+		@usableFromInline var handle: Int
+	}
+
+	@usableFromInline
+	internal var storage: ContiguousArray<Entry> = []
+
+	/// The position in `storage` of each handle, or *-1* if the handle isn't in use.
+	@usableFromInline
+	internal var positions: ContiguousArray<Int> = []
+
+	private var freeHandles: [Int] = []
+
+	/// The number of children each node has.
+	public let arity: Int
+
+	private let areInIncreasingOrder: (Element, Element) -> Bool
+
+	/// Creates an empty indexed heap.
+	/// - parameter arity: The number of children each node has. Must be at least *2*.
+	/// Default is ``Heap/defaultArity``.
+	/// - parameter areInIncreasingOrder: A predicate that returns `true` if its first argument
+	/// should be removed from the heap before its second argument.
+	public init(arity: Int = Heap<Element>.defaultArity, by areInIncreasingOrder: @escaping (Element, Element) -> Bool) {
+		precondition(arity >= 2, "Heap arity must be at least two")
+		self.arity = arity
+		self.areInIncreasingOrder = areInIncreasingOrder
+	}
+
+	/// The number of elements in the heap.
+	@inlinable public var count: Int {
+		return storage.count
+	}
+
+	/// `true` if the heap has no elements.
+	@inlinable public var isEmpty: Bool {
+		return storage.isEmpty
+	}
+
+	/// The minimum element and its handle, or `nil` if the heap is empty.
+	@inlinable public var min: (element: Element, handle: Handle)? {
+		guard let first = storage.first else {
+			return nil
+		}
+		return (first.element, Handle(rawValue: first.handle))
+	}
+
+	/// Returns `true` if `handle` refers to an element in the heap.
+	@inlinable public func contains(_ handle: Handle) -> Bool {
+		return handle.rawValue < positions.count && positions[handle.rawValue] >= 0
+	}
+
+	/// The element for `handle`, or `nil` if the handle isn't in the heap.
+	@inlinable public subscript(handle: Handle) -> Element? {
+		guard contains(handle) else {
+			return nil
+		}
+		return storage[positions[handle.rawValue]].element
+	}
+
+	/// Inserts an element into the heap.
+	/// - returns: A handle that can be used to update or remove the element.
+	@discardableResult
+	public mutating func insert(_ element: Element) -> Handle {
+		let handle: Int
+		if let reused = freeHandles.popLast() {
+			handle = reused
+		} else {
+			handle = positions.count
+			positions.append(-1)
+		}
+		storage.append(Entry(element: element, handle: handle))
+		positions[handle] = storage.count - 1
+		siftUp(from: storage.count - 1)
+		return Handle(rawValue: handle)
+	}
+
+	/// Changes the element for `handle`, moving it up or down the heap as needed.
+	///
+	/// Lowering the priority of an element is the decrease-key operation.
+	public mutating func update(_ handle: Handle, to element: Element) {
+		precondition(contains(handle), "Handle isn't in the heap")
+		let index = positions[handle.rawValue]
+		let old = storage[index].element
+		storage[index].element = element
+		if areInIncreasingOrder(element, old) {
+			siftUp(from: index)
+		} else {
+			siftDown(from: index)
+		}
+	}
+
+	/// Removes the element for `handle` from the heap.
+	/// - returns: The removed element, or `nil` if the handle isn't in the heap.
+	@discardableResult
+	public mutating func remove(_ handle: Handle) -> Element? {
+		guard contains(handle) else {
+			return nil
+		}
+		return removeEntry(at: positions[handle.rawValue])
+	}
+
+	/// Removes and returns the minimum element and its now-invalid handle,
+	/// or returns `nil` if the heap is empty.
+	public mutating func popMin() -> (element: Element, handle: Handle)? {
+		guard let first = storage.first else {
+			return nil
+		}
+		_ = removeEntry(at: 0)
+		return (first.element, Handle(rawValue: first.handle))
+	}
+
+	/// Removes all the elements from the heap, invalidating all handles.
+	public mutating func removeAll(keepingCapacity keepCapacity: Bool = false) {
+		storage.removeAll(keepingCapacity: keepCapacity)
+		positions.removeAll(keepingCapacity: keepCapacity)
+		freeHandles.removeAll(keepingCapacity: keepCapacity)
+	}
+
+	private mutating func removeEntry(at index: Int) -> Element {
+		let removed = storage[index]
+		positions[removed.handle] = -1
+		freeHandles.append(removed.handle)
+		let last = storage.removeLast()
+		if index < storage.count {
+			storage[index] = last
+			positions[last.handle] = index
+			if index > 0 && areInIncreasingOrder(last.element, storage[(index - 1) / arity].element) {
+				siftUp(from: index)
+			} else {
+				siftDown(from: index)
+			}
+		}
+		return removed.element
+	}
+
+	private mutating func siftUp(from index: Int) {
+		var i = index
+		let moving = storage[i]
+		while i > 0 {
+			let parent = (i - 1) / arity
+			guard areInIncreasingOrder(moving.element, storage[parent].element) else {
+				break
+			}
+			storage[i] = storage[parent]
+			positions[storage[i].handle] = i
+			i = parent
+		}
+		storage[i] = moving
+		positions[moving.handle] = i
+	}
+
+	private mutating func siftDown(from index: Int) {
+		let count = storage.count
+		var i = index
+		let moving = storage[i]
+		while true {
+			let firstChild = i * arity + 1
+			guard firstChild < count else {
+				break
+			}
+			let endChild = Swift.min(firstChild + arity, count)
+			var best = firstChild
+			var child = firstChild + 1
+			while child < endChild {
+				if areInIncreasingOrder(storage[child].element, storage[best].element) {
+					best = child
+				}
+				child += 1
+			}
+			guard areInIncreasingOrder(storage[best].element, moving.element) else {
+				break
+			}
+			storage[i] = storage[best]
+			positions[storage[i].handle] = i
+			i = best
+		}
+		storage[i] = moving
+		positions[moving.handle] = i
+	}
+}
+
+public extension IndexedHeap where Element: Comparable {
+	/// Creates an empty indexed min-heap.
+	/// - parameter arity: The number of children each node has. Must be at least *2*.
+	/// Default is ``Heap/defaultArity``.
+	init(arity: Int = Heap<Element>.defaultArity) {
+		self.init(arity: arity, by: <)
+	}
+}
@@ -0,0 +1,147 @@
+//
+//  HotPathCounters.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// Signpost-style call counters for the package's hot paths.
+///
+/// The instrumented functions only record anything when the package is built with the
+/// `SWIFTADDITIONS_HOT_PATH_COUNTERS` compilation condition, for example
+/// `swift build -c release -Xswiftc -DSWIFTADDITIONS_HOT_PATH_COUNTERS`. Otherwise the
+/// calls are compiled out and cost nothing.
+///
+/// Each instrumented function has a static ``Slot`` named after it, and brackets its work
+/// with ``begin()`` and ``Slot/end(since:items:)``, which add up the calls, the items
+/// processed, and the time taken. Recording only touches the slot's own atomic counters.
+public enum HotPathCounters {
+	/// The totals for one name.
+	public struct Counts: Hashable, Sendable, Codable {
+		/// The number of intervals that ended.
+		public var calls: Int
+		/// The sum of the `items` passed to ``HotPathCounters/Slot/end(since:items:)``.
+		public var items: Int
+		/// The time spent between ``HotPathCounters/begin()`` and ``HotPathCounters/Slot/end(since:items:)``.
+		public var nanoseconds: UInt64
+
+		public init(calls: Int = 0, items: Int = 0, nanoseconds: UInt64 = 0) {
+			self.calls = calls
+			self.items = items
+			self.nanoseconds = nanoseconds
+		}
+	}
+
+	/// The counters for one instrumented function.
+	///
+	/// Keep each slot in a `static let`, so it is made once, the first time the function
+	/// runs, and a call only has to update its counters.
+	public final class Slot: Sendable {
+		/// The name the totals are reported under.
+		public let name: String
+		private let calls = makeSharedCounter()
+		private let items = makeSharedCounter()
+		private let nanoseconds = makeSharedCounter()
+
+		/// Creates a slot and adds it to the ones ``HotPathCounters/snapshot()`` reports.
+		/// - parameter name: The name of the instrumented function.
+		public init(_ name: String) {
+			self.name = name
+			hotPathRegistry.register(self)
+		}
+
+		/// Marks the end of an interval, adding it to the totals.
+		/// - parameter start: The token that ``HotPathCounters/begin()`` returned.
+		/// - parameter items: How many elements, bytes or characters the call processed.
+		public func end(since start: UInt64, items: Int = 1) {
+			let elapsed = DispatchTime.now().uptimeNanoseconds &- start
+			calls.add(1)
+			self.items.add(items)
+			nanoseconds.add(Int(truncatingIfNeeded: elapsed))
+		}
+
+		fileprivate var counts: Counts {
+			return Counts(calls: calls.load(), items: items.load(), nanoseconds: UInt64(truncatingIfNeeded: nanoseconds.load()))
+		}
+
+		fileprivate func reset() {
+			calls.store(0)
+			items.store(0)
+			nanoseconds.store(0)
+		}
+	}
+
+	/// Is `true` if this build of the package records counts.
+	public static var isEnabled: Bool {
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+		return true
+#else
+		return false
+#endif
+	}
+
+	/// Marks the start of an interval.
+	/// - returns: A token to pass to ``Slot/end(since:items:)``.
+	@inline(__always)
+	public static func begin() -> UInt64 {
+		return DispatchTime.now().uptimeNanoseconds
+	}
+
+	/// The totals recorded since the process started or ``reset()`` was last called, for
+	/// every name with at least one call.
+	public static func snapshot() -> [String: Counts] {
+		return hotPathRegistry.snapshot()
+	}
+
+	/// Sets every total back to zero.
+	public static func reset() {
+		hotPathRegistry.reset()
+	}
+}
+
+private let hotPathRegistry = HotPathRegistry()
+
+/// Every slot made so far. Only making a slot, ``HotPathCounters/snapshot()`` and
+/// ``HotPathCounters/reset()`` take the lock; recording doesn't.
+private final class HotPathRegistry: @unchecked Sendable {
+	private let lock = NSLock()
+	private var slots = [HotPathCounters.Slot]()
+
+	func register(_ slot: HotPathCounters.Slot) {
+		lock.lock()
+		slots.append(slot)
+		lock.unlock()
+	}
+
+	func snapshot() -> [String: HotPathCounters.Counts] {
+		lock.lock()
+		let slots = self.slots
+		lock.unlock()
+		var result = [String: HotPathCounters.Counts]()
+		// More than one slot can have the same name.
+		for slot in slots {
+			let counts = slot.counts
+			guard counts.calls > 0 else {
+				continue
+			}
+			var total = result[slot.name] ?? HotPathCounters.Counts()
+			total.calls += counts.calls
+			total.items += counts.items
+			total.nanoseconds += counts.nanoseconds
+			result[slot.name] = total
+		}
+		return result
+	}
+
+	func reset() {
+		lock.lock()
+		let slots = self.slots
+		lock.unlock()
+		for slot in slots {
+			slot.reset()
+		}
+	}
+}
@@ -0,0 +1,135 @@
+//
+//  MacOSRoman.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+/// Table-driven Mac OS Roman codec that doesn't depend on CoreFoundation's
+/// string encoding converters.
+///
+/// The mapping matches the one used by `String.Encoding.macOSRoman`, including
+/// *0xDB* being the euro sign and *0xF0* being the Apple logo in the private use area.
+enum MacOSRoman {
+	/// The Unicode values of the bytes *0x80* through *0xFF*.
+	static let upperHalf: [UInt16] = [
+		0x00C4, 0x00C5, 0x00C7, 0x00C9, 0x00D1, 0x00D6, 0x00DC, 0x00E1,
+		0x00E0, 0x00E2, 0x00E4, 0x00E3, 0x00E5, 0x00E7, 0x00E9, 0x00E8,
+		0x00EA, 0x00EB, 0x00ED, 0x00EC, 0x00EE, 0x00EF, 0x00F1, 0x00F3,
+		0x00F2, 0x00F4, 0x00F6, 0x00F5, 0x00FA, 0x00F9, 0x00FB, 0x00FC,
+		0x2020, 0x00B0, 0x00A2, 0x00A3, 0x00A7, 0x2022, 0x00B6, 0x00DF,
+		0x00AE, 0x00A9, 0x2122, 0x00B4, 0x00A8, 0x2260, 0x00C6, 0x00D8,
+		0x221E, 0x00B1, 0x2264, 0x2265, 0x00A5, 0x00B5, 0x2202, 0x2211,
+		0x220F, 0x03C0, 0x222B, 0x00AA, 0x00BA, 0x03A9, 0x00E6, 0x00F8,
+		0x00BF, 0x00A1, 0x00AC, 0x221A, 0x0192, 0x2248, 0x2206, 0x00AB,
+		0x00BB, 0x2026, 0x00A0, 0x00C0, 0x00C3, 0x00D5, 0x0152, 0x0153,
+		0x2013, 0x2014, 0x201C, 0x201D, 0x2018, 0x2019, 0x00F7, 0x25CA,
+		0x00FF, 0x0178, 0x2044, 0x20AC, 0x2039, 0x203A, 0xFB01, 0xFB02,
+		0x2021, 0x00B7, 0x201A, 0x201E, 0x2030, 0x00C2, 0x00CA, 0x00C1,
+		0x00CB, 0x00C8, 0x00CD, 0x00CE, 0x00CF, 0x00CC, 0x00D3, 0x00D4,
+		0xF8FF, 0x00D2, 0x00DA, 0x00DB, 0x00D9, 0x0131, 0x02C6, 0x02DC,
+		0x00AF, 0x02D8, 0x02D9, 0x02DA, 0x00B8, 0x02DD, 0x02DB, 0x02C7]
+
+	/// The Unicode values of the bytes *0x80* through *0xFF* in *Mac OS Icelandic*,
+	/// which only differs from Mac OS Roman by six characters.
+	static let icelandicUpperHalf: [UInt16] = {
+		var table = upperHalf
+		table[0xA0 - 0x80] = 0x00DD
+		table[0xDC - 0x80] = 0x00D0
+		table[0xDD - 0x80] = 0x00F0
+		table[0xDE - 0x80] = 0x00DE
+		table[0xDF - 0x80] = 0x00FE
+		table[0xE0 - 0x80] = 0x00FD
+		return table
+	}()
+
+	/// The UTF-8 representation of every Mac OS Roman byte value.
+	///
+	/// The low three bytes hold the UTF-8 code units, first code unit in the lowest
+	/// byte; the high byte holds how many code units are used.
+	static let utf8Table = makeUTF8Table(upperHalf: upperHalf)
+
+	/// The UTF-8 representation of every Mac OS Icelandic byte value.
+	static let icelandicUTF8Table = makeUTF8Table(upperHalf: icelandicUpperHalf)
+
+	/// Builds a byte to UTF-8 table for an ASCII-compatible single-byte encoding.
+	static func makeUTF8Table(upperHalf: [UInt16]) -> [UInt32] {
+		var table = [UInt32](repeating: 0, count: 256)
+		for byte in 0 ..< 128 {
+			table[byte] = 1 << 24 | UInt32(byte)
+		}
+		for (i, scalar) in upperHalf.enumerated() {
+			let value = UInt32(scalar)
+			if value < 0x80 {
+				table[i + 128] = 1 << 24 | value
+			} else if value < 0x800 {
+				table[i + 128] = 2 << 24
+					| (0xC0 | value >> 6)
+					| (0x80 | value & 0x3F) << 8
+			} else {
+				table[i + 128] = 3 << 24
+					| (0xE0 | value >> 12)
+					| (0x80 | (value >> 6) & 0x3F) << 8
+					| (0x80 | value & 0x3F) << 16
+			}
+		}
+		return table
+	}
+
+	/// The upper half of the table, sorted by Unicode value, for encoding.
+	/// The high byte holds the Mac OS Roman value, the low two bytes the Unicode value.
+	static let reverseTable: [UInt32] = {
+		return upperHalf.enumerated().map({ (i, scalar) -> UInt32 in
+			return UInt32(i + 128) << 24 | UInt32(scalar)
+		}).sorted(by: { ($0 & 0xFFFF) < ($1 & 0xFFFF) })
+	}()
+
+	/// The most UTF-8 code units a single Mac OS Roman byte can decode to.
+	static let maximumUTF8Length = 3
+
+	/// Returns the Mac OS Roman byte for `scalar`, or `nil` if it has no
+	/// representation.
+	@inline(__always)
+	static func encode(_ scalar: Unicode.Scalar) -> UInt8? {
+		let value = scalar.value
+		if value < 0x80 {
+			return UInt8(truncatingIfNeeded: value)
+		}
+		guard value <= 0xFFFF else {
+			return nil
+		}
+		return reverseTable.withUnsafeBufferPointer { (table) -> UInt8? in
+			var low = 0
+			var high = table.count
+			while low < high {
+				let mid = (low + high) / 2
+				let entry = table[mid] & 0xFFFF
+				if entry == value {
+					return UInt8(truncatingIfNeeded: table[mid] >> 24)
+				} else if entry < value {
+					low = mid + 1
+				} else {
+					high = mid
+				}
+			}
+			return nil
+		}
+	}
+
+	/// Writes the UTF-8 representation of `byte` to `output`.
+	/// - returns: The number of code units written, between *1* and *3*.
+	@inline(__always)
+	static func decode(_ byte: UInt8, to output: UnsafeMutablePointer<UInt8>, table: UnsafeBufferPointer<UInt32>) -> Int {
+		let entry = table[Int(byte)]
+		let length = Int(entry >> 24)
+		output[0] = UInt8(truncatingIfNeeded: entry)
+		if length > 1 {
+			output[1] = UInt8(truncatingIfNeeded: entry >> 8)
+			if length > 2 {
+				output[2] = UInt8(truncatingIfNeeded: entry >> 16)
+			}
+		}
+		return length
+	}
+}
@@ -0,0 +1,543 @@
+//
+//  MappedAudioFile.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// Errors from opening or reading a ``MappedAudioFile``.
+public enum MappedAudioFileError: Error, Hashable, Sendable {
+	/// The file isn't a WAVE, AIFF, AIFF-C, or CAF file.
+	case unknownContainer
+	/// A chunk the format needs is missing.
+	case missingChunk(FourCharacterCode)
+	/// A chunk is shorter than its contents, or runs past the end of the file.
+	case truncated(FourCharacterCode)
+	/// The samples aren't a linear PCM layout ``PCMFormat`` supports.
+	case unsupportedFormat
+	/// The frame to seek to is past the end of the file.
+	case invalidSeek(Int64)
+}
+
+/// Reads uncompressed WAVE, AIFF, AIFF-C, and CAF files by mapping them into memory.
+///
+/// When the client format is the same as the file format, ``readMapped(frames:)`` returns
+/// the samples in place, with no copying. Otherwise ``read(frames:into:)`` converts them with
+/// a ``PCMConverter``.
+///
+/// CAF and AIFF files can start their samples at any offset. If the samples aren't aligned
+/// to their size in memory, ``readMapped(frames:)`` isn't available, and
+/// ``read(frames:into:)`` copies them instead.
+///
+/// The read and seek methods follow `ExtAudioFile`'s, so callers can switch between them. Like
+/// `ExtAudioFile`, a file should only be read from one thread at a time.
+public final class MappedAudioFile {
+	/// The kind of file.
+	public enum Container: Hashable, Sendable {
+		case wave
+		case aiff
+		case aifc
+		case caf
+	}
+
+	/// The kind of file.
+	public let container: Container
+	/// The layout of the samples in the file. Always interleaved.
+	public let fileFormat: PCMFormat
+	/// The number of frames per second.
+	public let sampleRate: Double
+	/// The number of frames in the file.
+	public let fileLengthFrames: Int64
+
+	/// The layout that ``read(frames:into:)`` produces. Default is ``fileFormat``.
+	public var clientFormat: PCMFormat {
+		didSet {
+			if clientFormat != oldValue {
+				converter = nil
+			}
+		}
+	}
+
+	private let mapping: MappedRegion
+	private let samples: UnsafeRawPointer
+	private let samplesAreAligned: Bool
+	private var position: Int64 = 0
+	private var converter: PCMConverter?
+
+	/// Maps a file into memory and parses it.
+	/// - parameter url: The file URL to open.
+	/// - throws: A `CocoaError` if the file can't be opened or mapped, or a
+	/// ``MappedAudioFileError`` if the file can't be parsed.
+	public convenience init(open url: URL) throws {
+		try self.init(mapping: MappedRegion(url: url))
+	}
+
+	/// Parses a file already in memory. The bytes are copied.
+	/// - parameter data: The contents of the file.
+	public convenience init(data: Data) throws {
+		try self.init(mapping: MappedRegion(data: data))
+	}
+
+	private init(mapping: MappedRegion) throws {
+		self.mapping = mapping
+		let layout = try ContainerParser(UnsafeRawBufferPointer(start: mapping.baseAddress, count: mapping.count)).parse()
+		container = layout.container
+		fileFormat = layout.format
+		clientFormat = layout.format
+		sampleRate = layout.sampleRate
+		fileLengthFrames = Int64(layout.dataByteCount / layout.format.bytesPerFrame)
+		samples = mapping.baseAddress! + layout.dataOffset
+		samplesAreAligned = Int(bitPattern: samples) % MappedAudioFile.alignment(of: layout.format.sampleType) == 0
+	}
+
+	/// The alignment of a sample in memory. 24-bit samples are only ever read byte by byte.
+	private static func alignment(of sampleType: PCMFormat.SampleType) -> Int {
+		switch sampleType {
+		case .int24:
+			return 1
+		default:
+			return sampleType.bytesPerSample
+		}
+	}
+
+	/// Moves the read position.
+	/// - parameter frame: The frame to read next, from *0* to ``fileLengthFrames``.
+	public func seek(toFrame frame: Int64) throws {
+		guard frame >= 0 && frame <= fileLengthFrames else {
+			throw MappedAudioFileError.invalidSeek(frame)
+		}
+		position = frame
+	}
+
+	/// The frame that will be read next.
+	public func tell() -> Int64 {
+		return position
+	}
+
+	/// `true` if ``readMapped(frames:)`` can return the samples without converting them:
+	/// the client format is the file format, and the samples are aligned in memory.
+	public var canReadMapped: Bool {
+		return clientFormat == fileFormat && samplesAreAligned
+	}
+
+	/// Returns the next frames in place and advances the read position.
+	///
+	/// The pointer is valid as long as the file is.
+	/// - parameter frames: On input, the number of frames to read. On output, the number of
+	/// frames actually read, which is *0* at the end of the file.
+	/// - returns: The start of the frames, laid out as ``fileFormat`` and aligned to the sample
+	/// size, or `nil` if ``canReadMapped`` is `false`.
+	public func readMapped(frames: inout Int) -> UnsafeRawPointer? {
+		guard canReadMapped else {
+			return nil
+		}
+		frames = Int(Swift.min(Int64(Swift.max(frames, 0)), fileLengthFrames - position))
+		let start = samples + Int(position) * fileFormat.bytesPerFrame
+		position += Int64(frames)
+		return start
+	}
+
+	/// Reads the next frames, converted to ``clientFormat``, and advances the read position.
+	/// - parameter frames: On input, the number of frames to read. On output, the number of
+	/// frames actually read, which is *0* at the end of the file.
+	/// - parameter buffers: Returns the destination buffer at an index, from *0* to
+	/// `clientFormat.bufferCount - 1`. Each must have room for `frames` frames.
+	public func read(frames: inout Int, into buffers: (Int) -> UnsafeMutableRawPointer) {
+		frames = Int(Swift.min(Int64(Swift.max(frames, 0)), fileLengthFrames - position))
+		guard frames > 0 else {
+			return
+		}
+		let start = samples + Int(position) * fileFormat.bytesPerFrame
+		if clientFormat == fileFormat {
+			buffers(0).copyMemory(from: start, byteCount: frames * fileFormat.bytesPerFrame)
+		} else {
+			if converter == nil {
+				converter = PCMConverter(from: fileFormat, to: clientFormat)
+			}
+			converter!.convert(frameCount: frames, source: { _ in start }, destination: buffers)
+		}
+		position += Int64(frames)
+	}
+
+	/// Reads the next frames, converted to ``clientFormat``, into buffers.
+	public func read(frames: inout Int, into buffers: [UnsafeMutableRawPointer]) {
+		precondition(buffers.count >= clientFormat.bufferCount, "Not enough buffers")
+		read(frames: &frames, into: { buffers[$0] })
+	}
+}
+
+// MARK: - Mapping
+
+/// Read-only memory holding a whole file.
+final class MappedRegion {
+	let baseAddress: UnsafeRawPointer?
+	let count: Int
+	private let isMapped: Bool
+
+	init(url: URL) throws {
+		let fd = open(url.path, O_RDONLY)
+		guard fd >= 0 else {
+			throw MappedRegion.openError(errno, url: url)
+		}
+		defer {
+			close(fd)
+		}
+		var info = stat()
+		guard fstat(fd, &info) == 0 else {
+			throw CocoaError(.fileReadUnknown, userInfo: [NSURLErrorKey: url])
+		}
+		count = Int(info.st_size)
+		isMapped = count > 0
+		guard count > 0 else {
+			baseAddress = nil
+			return
+		}
+		// MAP_FAILED isn't imported on every platform.
+		guard let address = mmap(nil, count, PROT_READ, MAP_PRIVATE, fd, 0), address != UnsafeMutableRawPointer(bitPattern: -1) else {
+			throw CocoaError(.fileReadUnknown, userInfo: [NSURLErrorKey: url])
+		}
+		baseAddress = UnsafeRawPointer(address)
+	}
+
+	/// The `CocoaError` for an `open` that failed with `code`.
+	private static func openError(_ code: Int32, url: URL) -> CocoaError {
+		let cocoaCode: CocoaError.Code
+		switch code {
+		case ENOENT, ENOTDIR:
+			cocoaCode = .fileReadNoSuchFile
+		case EACCES, EPERM:
+			cocoaCode = .fileReadNoPermission
+		case ENAMETOOLONG:
+			cocoaCode = .fileReadInvalidFileName
+		case EFBIG, EOVERFLOW:
+			cocoaCode = .fileReadTooLarge
+		default:
+			cocoaCode = .fileReadUnknown
+		}
+		return CocoaError(cocoaCode, userInfo: [NSURLErrorKey: url, NSUnderlyingErrorKey: POSIXError(POSIXErrorCode(rawValue: code) ?? .EIO)])
+	}
+
+	init(data: Data) {
+		count = data.count
+		isMapped = false
+		let copy = UnsafeMutableRawPointer.allocate(byteCount: Swift.max(count, 1), alignment: 16)
+		data.copyBytes(to: copy.assumingMemoryBound(to: UInt8.self), count: count)
+		baseAddress = UnsafeRawPointer(copy)
+	}
+
+	deinit {
+		if isMapped {
+			munmap(UnsafeMutableRawPointer(mutating: baseAddress), count)
+		} else {
+			baseAddress?.deallocate()
+		}
+	}
+}
+
+// MARK: - Parsing
+
+private struct ContainerLayout {
+	var container: MappedAudioFile.Container
+	var format: PCMFormat
+	var sampleRate: Double
+	var dataOffset: Int
+	var dataByteCount: Int
+}
+
+/// Walks the chunks of a file.
+private struct ContainerParser {
+	let bytes: UnsafeRawBufferPointer
+
+	init(_ bytes: UnsafeRawBufferPointer) {
+		self.bytes = bytes
+	}
+
+	// Chunk identifiers.
+	static let riff: UInt32 = 0x52494646 // 'RIFF'
+	static let rifx: UInt32 = 0x52494658 // 'RIFX'
+	static let wave: UInt32 = 0x57415645 // 'WAVE'
+	static let fmt: UInt32 = 0x666D7420 // 'fmt '
+	static let data: UInt32 = 0x64617461 // 'data'
+	static let form: UInt32 = 0x464F524D // 'FORM'
+	static let aiff: UInt32 = 0x41494646 // 'AIFF'
+	static let aifc: UInt32 = 0x41494643 // 'AIFC'
+	static let comm: UInt32 = 0x434F4D4D // 'COMM'
+	static let ssnd: UInt32 = 0x53534E44 // 'SSND'
+	static let caff: UInt32 = 0x63616666 // 'caff'
+	static let desc: UInt32 = 0x64657363 // 'desc'
+	static let lpcm: UInt32 = 0x6C70636D // 'lpcm'
+
+	func uint16(at offset: Int, bigEndian: Bool) -> UInt16 {
+		let value = bytes.loadUnaligned(fromByteOffset: offset, as: UInt16.self)
+		return bigEndian ? UInt16(bigEndian: value) : UInt16(littleEndian: value)
+	}
+
+	func uint32(at offset: Int, bigEndian: Bool) -> UInt32 {
+		let value = bytes.loadUnaligned(fromByteOffset: offset, as: UInt32.self)
+		return bigEndian ? UInt32(bigEndian: value) : UInt32(littleEndian: value)
+	}
+
+	func uint64(at offset: Int) -> UInt64 {
+		return UInt64(bigEndian: bytes.loadUnaligned(fromByteOffset: offset, as: UInt64.self))
+	}
+
+	func identifier(at offset: Int) -> UInt32 {
+		return uint32(at: offset, bigEndian: true)
+	}
+
+	/// Throws if `count` bytes at `offset` aren't all in the file.
+	func check(_ offset: Int, _ count: Int, chunk: UInt32) throws {
+		guard offset >= 0, count >= 0, offset <= bytes.count, count <= bytes.count - offset else {
+			throw MappedAudioFileError.truncated(FourCharacterCode(chunk))
+		}
+	}
+
+	func parse() throws -> ContainerLayout {
+		guard bytes.count >= 12 else {
+			throw MappedAudioFileError.unknownContainer
+		}
+		switch (identifier(at: 0), identifier(at: 8)) {
+		case (ContainerParser.riff, ContainerParser.wave):
+			return try parseWave(bigEndian: false)
+		case (ContainerParser.rifx, ContainerParser.wave):
+			return try parseWave(bigEndian: true)
+		case (ContainerParser.form, ContainerParser.aiff):
+			return try parseAIFF(isAIFC: false)
+		case (ContainerParser.form, ContainerParser.aifc):
+			return try parseAIFF(isAIFC: true)
+		case (ContainerParser.caff, _):
+			return try parseCAF()
+		default:
+			throw MappedAudioFileError.unknownContainer
+		}
+	}
+
+	/// Calls `body` with the identifier, body offset, and body size of each chunk of a RIFF or
+	/// IFF file, which are padded to an even size. Stops when `body` returns `false`.
+	func forEachChunk(from start: Int, bigEndian: Bool, _ body: (UInt32, Int, Int) throws -> Bool) throws {
+		var offset = start
+		while bytes.count - offset >= 8 {
+			let id = identifier(at: offset)
+			let size = Int(uint32(at: offset + 4, bigEndian: bigEndian))
+			// The data chunk may be cut short by an interrupted recording; use what's there.
+			let available = Swift.min(size, bytes.count - offset - 8)
+			guard try body(id, offset + 8, available) else {
+				return
+			}
+			offset += 8 + size + (size & 1)
+		}
+	}
+
+	func parseWave(bigEndian: Bool) throws -> ContainerLayout {
+		var format: (type: PCMFormat.SampleType, channels: Int, sampleRate: Double)?
+		var data: (offset: Int, count: Int)?
+		try forEachChunk(from: 12, bigEndian: bigEndian) { (id, offset, size) in
+			switch id {
+			case ContainerParser.fmt:
+				try check(offset, 16, chunk: id)
+				guard size >= 16 else {
+					throw MappedAudioFileError.truncated(FourCharacterCode(id))
+				}
+				var formatTag = uint16(at: offset, bigEndian: bigEndian)
+				let channels = Int(uint16(at: offset + 2, bigEndian: bigEndian))
+				let sampleRate = Double(uint32(at: offset + 4, bigEndian: bigEndian))
+				let blockAlign = Int(uint16(at: offset + 12, bigEndian: bigEndian))
+				let bits = Int(uint16(at: offset + 14, bigEndian: bigEndian))
+				if formatTag == 0xFFFE {
+					// WAVE_FORMAT_EXTENSIBLE: the real tag starts the subformat GUID.
+					guard size >= 40 else {
+						throw MappedAudioFileError.truncated(FourCharacterCode(id))
+					}
+					formatTag = uint16(at: offset + 24, bigEndian: bigEndian)
+				}
+				let type: PCMFormat.SampleType
+				switch (formatTag, bits) {
+				case (1, 16):
+					type = .int16
+				case (1, 24):
+					type = .int24
+				case (1, 32):
+					type = .int32
+				case (3, 32):
+					type = .float32
+				case (3, 64):
+					type = .float64
+				default:
+					throw MappedAudioFileError.unsupportedFormat
+				}
+				guard channels > 0, blockAlign == channels * type.bytesPerSample else {
+					throw MappedAudioFileError.unsupportedFormat
+				}
+				format = (type, channels, sampleRate)
+			case ContainerParser.data:
+				data = (offset, size)
+				return false
+			default:
+				break
+			}
+			return true
+		}
+		guard let format else {
+			throw MappedAudioFileError.missingChunk(FourCharacterCode(ContainerParser.fmt))
+		}
+		guard let data else {
+			throw MappedAudioFileError.missingChunk(FourCharacterCode(ContainerParser.data))
+		}
+		return ContainerLayout(container: .wave, format: PCMFormat(sampleType: format.type, channelCount: format.channels, isBigEndian: bigEndian), sampleRate: format.sampleRate, dataOffset: data.offset, dataByteCount: data.count)
+	}
+
+	/// Reads an 80-bit IEEE extended float, as AIFF stores its sample rate.
+	func extended(at offset: Int) -> Double {
+		let signAndExponent = uint16(at: offset, bigEndian: true)
+		let mantissa = uint64(at: offset + 2)
+		guard mantissa != 0 else {
+			return 0
+		}
+		let exponent = Int(signAndExponent & 0x7FFF) - 16383 - 63
+		let value = Double(sign: .plus, exponent: exponent, significand: Double(mantissa))
+		return signAndExponent & 0x8000 != 0 ? -value : value
+	}
+
+	func parseAIFF(isAIFC: Bool) throws -> ContainerLayout {
+		var format: (type: PCMFormat.SampleType, channels: Int, sampleRate: Double, bigEndian: Bool, frames: Int)?
+		var data: (offset: Int, count: Int)?
+		try forEachChunk(from: 12, bigEndian: true) { (id, offset, size) in
+			switch id {
+			case ContainerParser.comm:
+				let needed = isAIFC ? 22 : 18
+				try check(offset, needed, chunk: id)
+				guard size >= needed else {
+					throw MappedAudioFileError.truncated(FourCharacterCode(id))
+				}
+				let channels = Int(uint16(at: offset, bigEndian: true))
+				let frames = Int(uint32(at: offset + 2, bigEndian: true))
+				let bits = Int(uint16(at: offset + 6, bigEndian: true))
+				let sampleRate = extended(at: offset + 8)
+				let compression = isAIFC ? identifier(at: offset + 18) : 0x4E4F4E45 // 'NONE'
+				let type: PCMFormat.SampleType
+				var bigEndian = true
+				switch (compression, bits) {
+				case (0x4E4F4E45, 16), (0x74776F73, 16): // 'NONE', 'twos'
+					type = .int16
+				case (0x4E4F4E45, 24), (0x74776F73, 24):
+					type = .int24
+				case (0x4E4F4E45, 32), (0x74776F73, 32):
+					type = .int32
+				case (0x736F7774, 16): // 'sowt'
+					type = .int16
+					bigEndian = false
+				case (0x736F7774, 24):
+					type = .int24
+					bigEndian = false
+				case (0x736F7774, 32):
+					type = .int32
+					bigEndian = false
+				case (0x666C3332, _), (0x464C3332, _): // 'fl32', 'FL32'
+					type = .float32
+				case (0x666C3634, _), (0x464C3634, _): // 'fl64', 'FL64'
+					type = .float64
+				default:
+					throw MappedAudioFileError.unsupportedFormat
+				}
+				guard channels > 0 else {
+					throw MappedAudioFileError.unsupportedFormat
+				}
+				format = (type, channels, sampleRate, bigEndian, frames)
+			case ContainerParser.ssnd:
+				try check(offset, 8, chunk: id)
+				let dataOffset = Int(uint32(at: offset, bigEndian: true))
+				guard dataOffset <= size - 8 else {
+					throw MappedAudioFileError.truncated(FourCharacterCode(id))
+				}
+				data = (offset + 8 + dataOffset, size - 8 - dataOffset)
+			default:
+				break
+			}
+			return format == nil || data == nil
+		}
+		guard let format else {
+			throw MappedAudioFileError.missingChunk(FourCharacterCode(ContainerParser.comm))
+		}
+		guard let data else {
+			throw MappedAudioFileError.missingChunk(FourCharacterCode(ContainerParser.ssnd))
+		}
+		let pcmFormat = PCMFormat(sampleType: format.type, channelCount: format.channels, isBigEndian: format.bigEndian)
+		// COMM has the exact frame count; SSND may be padded.
+		let byteCount = Swift.min(data.count, format.frames * pcmFormat.bytesPerFrame)
+		return ContainerLayout(container: isAIFC ? .aifc : .aiff, format: pcmFormat, sampleRate: format.sampleRate, dataOffset: data.offset, dataByteCount: byteCount)
+	}
+
+	func parseCAF() throws -> ContainerLayout {
+		var format: (format: PCMFormat, sampleRate: Double)?
+		var data: (offset: Int, count: Int)?
+		var offset = 8
+		while bytes.count - offset >= 12 {
+			let id = identifier(at: offset)
+			let declaredSize = Int64(bitPattern: uint64(at: offset + 4))
+			let body = offset + 12
+			// A data chunk size of -1 means the rest of the file.
+			let size = declaredSize < 0 ? bytes.count - body : Int(clamping: declaredSize)
+			switch id {
+			case ContainerParser.desc:
+				try check(body, 32, chunk: id)
+				let sampleRate = Double(bitPattern: uint64(at: body))
+				let formatID = identifier(at: body + 8)
+				let flags = uint32(at: body + 12, bigEndian: true)
+				let bytesPerPacket = Int(uint32(at: body + 16, bigEndian: true))
+				let framesPerPacket = uint32(at: body + 20, bigEndian: true)
+				let channels = Int(uint32(at: body + 24, bigEndian: true))
+				let bits = Int(uint32(at: body + 28, bigEndian: true))
+				guard formatID == ContainerParser.lpcm, framesPerPacket == 1, channels > 0 else {
+					throw MappedAudioFileError.unsupportedFormat
+				}
+				let isFloat = flags & 1 != 0
+				let type: PCMFormat.SampleType
+				switch (isFloat, bits) {
+				case (false, 16):
+					type = .int16
+				case (false, 24):
+					type = .int24
+				case (false, 32):
+					type = .int32
+				case (true, 32):
+					type = .float32
+				case (true, 64):
+					type = .float64
+				default:
+					throw MappedAudioFileError.unsupportedFormat
+				}
+				let pcmFormat = PCMFormat(sampleType: type, channelCount: channels, isBigEndian: flags & 2 == 0)
+				guard bytesPerPacket == pcmFormat.bytesPerFrame else {
+					throw MappedAudioFileError.unsupportedFormat
+				}
+				format = (pcmFormat, sampleRate)
+			case ContainerParser.data:
+				// The samples follow a 4-byte edit count.
+				try check(body, 4, chunk: id)
+				guard size >= 4 else {
+					throw MappedAudioFileError.truncated(FourCharacterCode(id))
+				}
+				data = (body + 4, Swift.min(size, bytes.count - body) - 4)
+			default:
+				break
+			}
+			if (format != nil && data != nil) || declaredSize < 0 {
+				break
+			}
+			guard size <= bytes.count - body else {
+				break
+			}
+			offset = body + size
+		}
+		guard let format else {
+			throw MappedAudioFileError.missingChunk(FourCharacterCode(ContainerParser.desc))
+		}
+		guard let data else {
+			throw MappedAudioFileError.missingChunk(FourCharacterCode(ContainerParser.data))
+		}
+		return ContainerLayout(container: .caf, format: format.format, sampleRate: format.sampleRate, dataOffset: data.offset, dataByteCount: data.count)
+	}
+}
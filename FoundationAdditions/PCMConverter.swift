@@ -0,0 +1,512 @@
+//
+//  PCMConverter.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// A linear PCM sample layout that ``PCMConverter`` can read and write.
+public struct PCMFormat: Hashable, Sendable {
+	/// The type of each sample.
+	public enum SampleType: Hashable, Sendable, CaseIterable {
+		/// 16-bit signed integer.
+		case int16
+		/// 24-bit signed integer, packed in three bytes.
+		case int24
+		/// 32-bit signed integer.
+		case int32
+		/// 32-bit IEEE floating point.
+		case float32
+		/// 64-bit IEEE floating point.
+		case float64
+
+		/// The number of bytes each sample takes up.
+		@inlinable public var bytesPerSample: Int {
+			switch self {
+			case .int16:
+				return 2
+			case .int24:
+				return 3
+			case .int32, .float32:
+				return 4
+			case .float64:
+				return 8
+			}
+		}
+
+		/// `true` if the samples can't be represented exactly with 32-bit floats.
+		var needsDoublePrecision: Bool {
+			return self == .int32 || self == .float64
+		}
+	}
+
+	/// `true` if the processor is big-endian.
+	public static var nativeIsBigEndian: Bool {
+		#if _endian(big)
+			return true
+		#else
+			return false
+		#endif
+	}
+
+	/// The type of each sample.
+	public var sampleType: SampleType
+	/// The number of channels in each frame.
+	public var channelCount: Int
+	/// `true` if all channels are in one buffer, `false` if each channel has its own buffer.
+	public var isInterleaved: Bool
+	/// `true` if the samples are big-endian.
+	public var isBigEndian: Bool
+
+	/// - parameter sampleType: The type of each sample.
+	/// - parameter channelCount: The number of channels in each frame.
+	/// - parameter isInterleaved: `true` if all channels are in one buffer. Default is `true`.
+	/// - parameter isBigEndian: `true` if the samples are big-endian. Default is the processor's endianness.
+	public init(sampleType: SampleType, channelCount: Int, isInterleaved: Bool = true, isBigEndian: Bool = PCMFormat.nativeIsBigEndian) {
+		precondition(channelCount > 0, "A PCM format needs at least one channel")
+		self.sampleType = sampleType
+		self.channelCount = channelCount
+		self.isInterleaved = isInterleaved
+		self.isBigEndian = isBigEndian
+	}
+
+	/// The number of buffers that hold the samples.
+	@inlinable public var bufferCount: Int {
+		return isInterleaved ? 1 : channelCount
+	}
+
+	/// The number of bytes a frame takes up in each buffer.
+	@inlinable public var bytesPerFrame: Int {
+		return isInterleaved ? sampleType.bytesPerSample * channelCount : sampleType.bytesPerSample
+	}
+
+	/// `true` if the samples aren't in the processor's byte order.
+	var needsByteSwap: Bool {
+		return isBigEndian != PCMFormat.nativeIsBigEndian
+	}
+}
+
+/// Converts blocks of linear PCM between sample types, byte orders, interleaving,
+/// and channel counts.
+///
+/// Samples are decoded, eight at a time, to a planar floating-point block, mixed through the
+/// channel matrix if there is one, then encoded into the destination format. Doubles are
+/// used when either format has 32-bit integer or 64-bit float samples, so
+/// conversions that don't change precision are lossless. All scratch memory is allocated
+/// when the converter is created; converting doesn't allocate.
+///
+/// A converter isn't thread-safe; use one per thread.
+public final class PCMConverter {
+	/// The format of the samples to convert.
+	public let sourceFormat: PCMFormat
+	/// The format to convert the samples to.
+	public let destinationFormat: PCMFormat
+	/// The channel mix matrix, with a row for each destination channel and a column for each
+	/// source channel, or `nil` if the channels are passed through unchanged.
+	public let mixMatrix: [Float]?
+
+	/// The number of frames converted at a time.
+	public static let blockFrameCount = 4096
+
+	private let engine: any PCMConversionEngine
+
+	/// Creates a converter.
+	/// - parameter source: The format of the samples to convert.
+	/// - parameter destination: The format to convert the samples to.
+	/// - parameter mixMatrix: The gain of each source channel in each destination channel, in
+	/// row-major order with a row for each destination channel. Pass `nil` to use
+	/// ``defaultMixMatrix(from:to:)`` if the channel counts differ, or to pass the channels through
+	/// if they are the same. Default is `nil`.
+	public init(from source: PCMFormat, to destination: PCMFormat, mixMatrix: [Float]? = nil) {
+		var matrix = mixMatrix
+		if matrix == nil && source.channelCount != destination.channelCount {
+			matrix = PCMConverter.defaultMixMatrix(from: source.channelCount, to: destination.channelCount)
+		}
+		if let matrix {
+			precondition(matrix.count == source.channelCount * destination.channelCount, "Mix matrix must have a row for each destination channel and a column for each source channel")
+		}
+		sourceFormat = source
+		destinationFormat = destination
+		self.mixMatrix = matrix
+		if source.sampleType.needsDoublePrecision || destination.sampleType.needsDoublePrecision {
+			engine = ConversionEngine<Double>(from: source, to: destination, mixMatrix: matrix)
+		} else {
+			engine = ConversionEngine<Float>(from: source, to: destination, mixMatrix: matrix)
+		}
+	}
+
+	/// A mix matrix that copies a mono source to every destination channel, averages every
+	/// source channel into a mono destination, and otherwise maps each channel to the channel
+	/// with the same index, leaving extra destination channels silent.
+	public static func defaultMixMatrix(from sourceChannels: Int, to destinationChannels: Int) -> [Float] {
+		var matrix = [Float](repeating: 0, count: sourceChannels * destinationChannels)
+		if sourceChannels == 1 {
+			for dst in 0 ..< destinationChannels {
+				matrix[dst] = 1
+			}
+		} else if destinationChannels == 1 {
+			for src in 0 ..< sourceChannels {
+				matrix[src] = 1 / Float(sourceChannels)
+			}
+		} else {
+			for channel in 0 ..< Swift.min(sourceChannels, destinationChannels) {
+				matrix[channel * sourceChannels + channel] = 1
+			}
+		}
+		return matrix
+	}
+
+	/// Converts frames.
+	/// - parameter frameCount: The number of frames to convert.
+	/// - parameter source: Returns the start of the source buffer at an index, from *0* to
+	/// `sourceFormat.bufferCount - 1`.
+	/// - parameter destination: Returns the start of the destination buffer at an index, from *0*
+	/// to `destinationFormat.bufferCount - 1`.
+	public func convert(frameCount: Int, source: (Int) -> UnsafeRawPointer, destination: (Int) -> UnsafeMutableRawPointer) {
+		engine.convert(frameCount: frameCount, source: source, destination: destination)
+	}
+
+	/// Converts frames between buffers.
+	/// - parameter frameCount: The number of frames to convert.
+	/// - parameter source: The source buffers. Must have `sourceFormat.bufferCount` buffers.
+	/// - parameter destination: The destination buffers. Must have `destinationFormat.bufferCount` buffers.
+	public func convert(frameCount: Int, from source: [UnsafeRawPointer], to destination: [UnsafeMutableRawPointer]) {
+		precondition(source.count >= sourceFormat.bufferCount && destination.count >= destinationFormat.bufferCount, "Not enough buffers")
+		engine.convert(frameCount: frameCount, source: { source[$0] }, destination: { destination[$0] })
+	}
+
+	/// Converts frames between two single-buffer formats, such as interleaved buffers.
+	/// - parameter frameCount: The number of frames to convert.
+	/// - parameter source: The source buffer.
+	/// - parameter destination: The destination buffer.
+	public func convert(frameCount: Int, from source: UnsafeRawPointer, to destination: UnsafeMutableRawPointer) {
+		precondition(sourceFormat.bufferCount == 1 && destinationFormat.bufferCount == 1, "Both formats must use a single buffer")
+		engine.convert(frameCount: frameCount, source: { _ in source }, destination: { _ in destination })
+	}
+}
+
+// MARK: - Engine
+
+private protocol PCMConversionEngine: AnyObject {
+	func convert(frameCount: Int, source: (Int) -> UnsafeRawPointer, destination: (Int) -> UnsafeMutableRawPointer)
+}
+
+/// The conversion pipeline, using `F` for the intermediate samples.
+private final class ConversionEngine<F: BinaryFloatingPoint & SIMDScalar>: PCMConversionEngine {
+	let source: PCMFormat
+	let destination: PCMFormat
+	let matrix: [F]?
+	let blockFrames = PCMConverter.blockFrameCount
+	/// Interleaved samples, before deinterleaving or after interleaving.
+	let interleaved: UnsafeMutablePointer<F>
+	/// One block per source channel.
+	let planarIn: UnsafeMutablePointer<F>
+	/// One block per destination channel, if there's a mix matrix.
+	let planarOut: UnsafeMutablePointer<F>?
+
+	init(from source: PCMFormat, to destination: PCMFormat, mixMatrix: [Float]?) {
+		self.source = source
+		self.destination = destination
+		matrix = mixMatrix.map { $0.map { F($0) } }
+		interleaved = .allocate(capacity: blockFrames * Swift.max(source.channelCount, destination.channelCount))
+		planarIn = .allocate(capacity: blockFrames * source.channelCount)
+		planarOut = mixMatrix == nil ? nil : .allocate(capacity: blockFrames * destination.channelCount)
+	}
+
+	deinit {
+		interleaved.deallocate()
+		planarIn.deallocate()
+		planarOut?.deallocate()
+	}
+
+	func convert(frameCount: Int, source sourceBuffer: (Int) -> UnsafeRawPointer, destination destinationBuffer: (Int) -> UnsafeMutableRawPointer) {
+		let srcChannels = source.channelCount
+		let dstChannels = destination.channelCount
+		let srcSampleSize = source.sampleType.bytesPerSample
+		let dstSampleSize = destination.sampleType.bytesPerSample
+		var done = 0
+		while done < frameCount {
+			let frames = Swift.min(blockFrames, frameCount - done)
+
+			if source.isInterleaved && srcChannels > 1 {
+				PCMKernels.decode(sourceBuffer(0) + done * source.bytesPerFrame, count: frames * srcChannels, format: source, into: interleaved)
+				PCMKernels.deinterleave(interleaved, channels: srcChannels, frames: frames, into: planarIn, stride: blockFrames)
+			} else {
+				for channel in 0 ..< srcChannels {
+					PCMKernels.decode(sourceBuffer(channel) + done * srcSampleSize, count: frames, format: source, into: planarIn + channel * blockFrames)
+				}
+			}
+
+			let planar: UnsafeMutablePointer<F>
+			if let matrix, let planarOut {
+				PCMKernels.mix(planarIn, channels: srcChannels, matrix: matrix, frames: frames, stride: blockFrames, into: planarOut, channels: dstChannels)
+				planar = planarOut
+			} else {
+				planar = planarIn
+			}
+
+			if destination.isInterleaved && dstChannels > 1 {
+				PCMKernels.interleave(planar, channels: dstChannels, frames: frames, stride: blockFrames, into: interleaved)
+				PCMKernels.encode(interleaved, count: frames * dstChannels, format: destination, into: destinationBuffer(0) + done * destination.bytesPerFrame)
+			} else {
+				for channel in 0 ..< dstChannels {
+					PCMKernels.encode(planar + channel * blockFrames, count: frames, format: destination, into: destinationBuffer(channel) + done * dstSampleSize)
+				}
+			}
+			done += frames
+		}
+	}
+}
+
+// MARK: - Kernels
+
+/// The sample conversion kernels, working on eight samples at a time.
+enum PCMKernels {
+	@inline(__always)
+	static func byteSwapped<V: SIMD>(_ vector: V) -> V where V.Scalar: FixedWidthInteger {
+		var result = vector
+		for i in result.indices {
+			result[i] = result[i].byteSwapped
+		}
+		return result
+	}
+
+	/// `2^(bits - 1)`, the scale of a signed integer sample.
+	@inline(__always)
+	static func integerScale<F: BinaryFloatingPoint>(bits: Int) -> F {
+		return F(sign: .plus, exponent: F.Exponent(bits - 1), significand: 1)
+	}
+
+	static func decode<F: BinaryFloatingPoint & SIMDScalar>(_ source: UnsafeRawPointer, count: Int, format: PCMFormat, into destination: UnsafeMutablePointer<F>) {
+		let swap = format.needsByteSwap
+		switch format.sampleType {
+		case .int16:
+			decodeInteger(source, count: count, as: Int16.self, swap: swap, into: destination)
+		case .int24:
+			decodeInt24(source, count: count, bigEndian: format.isBigEndian, into: destination)
+		case .int32:
+			decodeInteger(source, count: count, as: Int32.self, swap: swap, into: destination)
+		case .float32:
+			decodeFloat(source, count: count, as: Float.self, bits: UInt32.self, swap: swap, into: destination)
+		case .float64:
+			decodeFloat(source, count: count, as: Double.self, bits: UInt64.self, swap: swap, into: destination)
+		}
+	}
+
+	static func encode<F: BinaryFloatingPoint & SIMDScalar>(_ source: UnsafePointer<F>, count: Int, format: PCMFormat, into destination: UnsafeMutableRawPointer) {
+		let swap = format.needsByteSwap
+		switch format.sampleType {
+		case .int16:
+			encodeInteger(source, count: count, as: Int16.self, swap: swap, into: destination)
+		case .int24:
+			encodeInt24(source, count: count, bigEndian: format.isBigEndian, into: destination)
+		case .int32:
+			encodeInteger(source, count: count, as: Int32.self, swap: swap, into: destination)
+		case .float32:
+			encodeFloat(source, count: count, as: Float.self, bits: UInt32.self, swap: swap, into: destination)
+		case .float64:
+			encodeFloat(source, count: count, as: Double.self, bits: UInt64.self, swap: swap, into: destination)
+		}
+	}
+
+	@inline(__always)
+	static func decodeInteger<I: FixedWidthInteger & SignedInteger & SIMDScalar, F: BinaryFloatingPoint & SIMDScalar>(_ source: UnsafeRawPointer, count: Int, as: I.Type, swap: Bool, into destination: UnsafeMutablePointer<F>) {
+		let scale = 1 / (integerScale(bits: I.bitWidth) as F)
+		let vectorScale = SIMD8<F>(repeating: scale)
+		let size = MemoryLayout<I>.size
+		var i = 0
+		while i + 8 <= count {
+			var raw = source.loadUnaligned(fromByteOffset: i * size, as: SIMD8<I>.self)
+			if swap {
+				raw = byteSwapped(raw)
+			}
+			UnsafeMutableRawPointer(destination + i).storeBytes(of: SIMD8<F>(raw) * vectorScale, as: SIMD8<F>.self)
+			i += 8
+		}
+		while i < count {
+			var raw = source.loadUnaligned(fromByteOffset: i * size, as: I.self)
+			if swap {
+				raw = raw.byteSwapped
+			}
+			destination[i] = F(raw) * scale
+			i += 1
+		}
+	}
+
+	@inline(__always)
+	static func encodeInteger<I: FixedWidthInteger & SignedInteger & SIMDScalar, F: BinaryFloatingPoint & SIMDScalar>(_ source: UnsafePointer<F>, count: Int, as: I.Type, swap: Bool, into destination: UnsafeMutableRawPointer) {
+		let scale: F = integerScale(bits: I.bitWidth)
+		// Rounding happens before clamping, so the upper bound is just under the scale,
+		// which truncates to the largest integer value.
+		let lower = -scale
+		let upper = scale.nextDown
+		let vectorScale = SIMD8<F>(repeating: scale)
+		let vectorLower = SIMD8<F>(repeating: lower)
+		let vectorUpper = SIMD8<F>(repeating: upper)
+		let size = MemoryLayout<I>.size
+		var i = 0
+		while i + 8 <= count {
+			let samples = UnsafeRawPointer(source + i).loadUnaligned(as: SIMD8<F>.self)
+			let scaled = (samples * vectorScale).rounded(.toNearestOrEven).clamped(lowerBound: vectorLower, upperBound: vectorUpper)
+			var raw = SIMD8<I>(scaled, rounding: .towardZero)
+			if swap {
+				raw = byteSwapped(raw)
+			}
+			destination.storeBytes(of: raw, toByteOffset: i * size, as: SIMD8<I>.self)
+			i += 8
+		}
+		while i < count {
+			let scaled = F.minimum(F.maximum((source[i] * scale).rounded(.toNearestOrEven), lower), upper)
+			var raw = I(scaled.rounded(.towardZero))
+			if swap {
+				raw = raw.byteSwapped
+			}
+			destination.storeBytes(of: raw, toByteOffset: i * size, as: I.self)
+			i += 1
+		}
+	}
+
+	static func decodeInt24<F: BinaryFloatingPoint & SIMDScalar>(_ source: UnsafeRawPointer, count: Int, bigEndian: Bool, into destination: UnsafeMutablePointer<F>) {
+		let scale = 1 / (integerScale(bits: 24) as F)
+		let bytes = source.assumingMemoryBound(to: UInt8.self)
+		for i in 0 ..< count {
+			let first = UInt32(bytes[i * 3])
+			let middle = UInt32(bytes[i * 3 + 1])
+			let last = UInt32(bytes[i * 3 + 2])
+			let packed = bigEndian ? (first << 24 | middle << 16 | last << 8) : (last << 24 | middle << 16 | first << 8)
+			// The arithmetic shift sign-extends the top byte.
+			destination[i] = F(Int32(bitPattern: packed) >> 8) * scale
+		}
+	}
+
+	static func encodeInt24<F: BinaryFloatingPoint & SIMDScalar>(_ source: UnsafePointer<F>, count: Int, bigEndian: Bool, into destination: UnsafeMutableRawPointer) {
+		let scale: F = integerScale(bits: 24)
+		let lower = -scale
+		let upper = scale - 1
+		let bytes = destination.assumingMemoryBound(to: UInt8.self)
+		for i in 0 ..< count {
+			let scaled = F.minimum(F.maximum((source[i] * scale).rounded(.toNearestOrEven), lower), upper)
+			let value = UInt32(bitPattern: Int32(scaled))
+			let low = UInt8(truncatingIfNeeded: value)
+			let middle = UInt8(truncatingIfNeeded: value >> 8)
+			let high = UInt8(truncatingIfNeeded: value >> 16)
+			bytes[i * 3] = bigEndian ? high : low
+			bytes[i * 3 + 1] = middle
+			bytes[i * 3 + 2] = bigEndian ? low : high
+		}
+	}
+
+	@inline(__always)
+	static func decodeFloat<R: BinaryFloatingPoint & SIMDScalar, Bits: FixedWidthInteger & SIMDScalar, F: BinaryFloatingPoint & SIMDScalar>(_ source: UnsafeRawPointer, count: Int, as: R.Type, bits: Bits.Type, swap: Bool, into destination: UnsafeMutablePointer<F>) {
+		let size = MemoryLayout<R>.size
+		var i = 0
+		while i + 8 <= count {
+			var raw = source.loadUnaligned(fromByteOffset: i * size, as: SIMD8<Bits>.self)
+			if swap {
+				raw = byteSwapped(raw)
+			}
+			let samples = unsafeBitCast(raw, to: SIMD8<R>.self)
+			UnsafeMutableRawPointer(destination + i).storeBytes(of: SIMD8<F>(samples), as: SIMD8<F>.self)
+			i += 8
+		}
+		while i < count {
+			var raw = source.loadUnaligned(fromByteOffset: i * size, as: Bits.self)
+			if swap {
+				raw = raw.byteSwapped
+			}
+			destination[i] = F(unsafeBitCast(raw, to: R.self))
+			i += 1
+		}
+	}
+
+	@inline(__always)
+	static func encodeFloat<R: BinaryFloatingPoint & SIMDScalar, Bits: FixedWidthInteger & SIMDScalar, F: BinaryFloatingPoint & SIMDScalar>(_ source: UnsafePointer<F>, count: Int, as: R.Type, bits: Bits.Type, swap: Bool, into destination: UnsafeMutableRawPointer) {
+		let size = MemoryLayout<R>.size
+		var i = 0
+		while i + 8 <= count {
+			let samples = SIMD8<R>(UnsafeRawPointer(source + i).loadUnaligned(as: SIMD8<F>.self))
+			var raw = unsafeBitCast(samples, to: SIMD8<Bits>.self)
+			if swap {
+				raw = byteSwapped(raw)
+			}
+			destination.storeBytes(of: raw, toByteOffset: i * size, as: SIMD8<Bits>.self)
+			i += 8
+		}
+		while i < count {
+			var raw = unsafeBitCast(R(source[i]), to: Bits.self)
+			if swap {
+				raw = raw.byteSwapped
+			}
+			destination.storeBytes(of: raw, toByteOffset: i * size, as: Bits.self)
+			i += 1
+		}
+	}
+
+	static func deinterleave<F>(_ source: UnsafePointer<F>, channels: Int, frames: Int, into destination: UnsafeMutablePointer<F>, stride: Int) {
+		if channels == 2 {
+			let left = destination
+			let right = destination + stride
+			for frame in 0 ..< frames {
+				left[frame] = source[frame * 2]
+				right[frame] = source[frame * 2 + 1]
+			}
+			return
+		}
+		for channel in 0 ..< channels {
+			let plane = destination + channel * stride
+			for frame in 0 ..< frames {
+				plane[frame] = source[frame * channels + channel]
+			}
+		}
+	}
+
+	static func interleave<F>(_ source: UnsafePointer<F>, channels: Int, frames: Int, stride: Int, into destination: UnsafeMutablePointer<F>) {
+		if channels == 2 {
+			let left = source
+			let right = source + stride
+			for frame in 0 ..< frames {
+				destination[frame * 2] = left[frame]
+				destination[frame * 2 + 1] = right[frame]
+			}
+			return
+		}
+		for channel in 0 ..< channels {
+			let plane = source + channel * stride
+			for frame in 0 ..< frames {
+				destination[frame * channels + channel] = plane[frame]
+			}
+		}
+	}
+
+	/// Each destination plane is the sum of the source planes times their gains, accumulated
+	/// eight samples at a time.
+	static func mix<F: BinaryFloatingPoint & SIMDScalar>(_ source: UnsafePointer<F>, channels sourceChannels: Int, matrix: [F], frames: Int, stride: Int, into destination: UnsafeMutablePointer<F>, channels destinationChannels: Int) {
+		matrix.withUnsafeBufferPointer { (matrix) in
+			for dst in 0 ..< destinationChannels {
+				let out = destination + dst * stride
+				out.update(repeating: 0, count: frames)
+				for src in 0 ..< sourceChannels {
+					let gain = matrix[dst * sourceChannels + src]
+					guard gain != 0 else {
+						continue
+					}
+					let input = source + src * stride
+					let vectorGain = SIMD8<F>(repeating: gain)
+					var i = 0
+					while i + 8 <= frames {
+						let sum = UnsafeRawPointer(out + i).loadUnaligned(as: SIMD8<F>.self) + UnsafeRawPointer(input + i).loadUnaligned(as: SIMD8<F>.self) * vectorGain
+						UnsafeMutableRawPointer(out + i).storeBytes(of: sum, as: SIMD8<F>.self)
+						i += 8
+					}
+					while i < frames {
+						out[i] += input[i] * gain
+						i += 1
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,153 @@
+//
+//  PascalString.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// Classic Mac OS single-byte encodings that can be decoded without CoreFoundation.
+public enum ClassicMacEncoding: UInt32, Hashable, Sendable, CaseIterable {
+	/// Mac OS Roman. The raw value matches `kCFStringEncodingMacRoman`.
+	case macOSRoman = 0
+	/// Mac OS Icelandic. The raw value matches `kCFStringEncodingMacIcelandic`.
+	case macOSIcelandic = 37
+
+	/// Creates a classic encoding from a `CFStringEncoding` value.
+	///
+	/// Returns `nil` if the encoding isn't one that can be decoded with a table.
+	@inlinable public init?(cfStringEncoding: UInt32) {
+		self.init(rawValue: cfStringEncoding)
+	}
+
+	/// The byte to UTF-8 lookup table for the encoding.
+	var utf8Table: [UInt32] {
+		switch self {
+		case .macOSRoman:
+			return MacOSRoman.utf8Table
+		case .macOSIcelandic:
+			return MacOSRoman.icelandicUTF8Table
+		}
+	}
+}
+
+/// Decodes Pascal strings, a length byte followed by the characters, in place.
+///
+/// Strings that are all ASCII are checked sixteen bytes at a time and copied straight
+/// into the new `String`. Other strings are converted with a lookup table, writing the
+/// UTF-8 directly into the `String`'s storage, so there is only the one allocation for
+/// the string itself.
+public enum PascalString {
+	/// Checks if all of the bytes are ASCII, sixteen bytes at a time.
+	@inline(__always)
+	static func isASCII(_ bytes: UnsafeRawBufferPointer) -> Bool {
+		guard let base = bytes.baseAddress else {
+			return true
+		}
+		let lanes = SIMD16<UInt8>.scalarCount
+		let highBit = SIMD16<UInt8>(repeating: 0x80)
+		var i = 0
+		var accumulated = SIMD16<UInt8>()
+		while i + lanes <= bytes.count {
+			accumulated |= base.loadUnaligned(fromByteOffset: i, as: SIMD16<UInt8>.self)
+			i += lanes
+		}
+		if any(accumulated & highBit .!= 0) {
+			return false
+		}
+		while i < bytes.count {
+			if bytes[i] >= 0x80 {
+				return false
+			}
+			i += 1
+		}
+		return true
+	}
+
+	/// Decodes the characters of a Pascal string, without the length byte.
+	static func decodeCharacters(_ chars: UnsafeRawBufferPointer, table: UnsafeBufferPointer<UInt32>) -> String {
+		if isASCII(chars) {
+			return String(decoding: chars, as: UTF8.self)
+		}
+		return String(unsafeUninitializedCapacity: chars.count * MacOSRoman.maximumUTF8Length) { (buffer) -> Int in
+			let outBase = buffer.baseAddress!
+			var written = 0
+			for byte in chars {
+				written += MacOSRoman.decode(byte, to: outBase + written, table: table)
+			}
+			return written
+		}
+	}
+
+	/// Decodes a Pascal string.
+	/// - parameter bytes: The Pascal string, starting with the length byte. The buffer
+	/// must be at least as long as the length byte plus one.
+	/// - parameter encoding: The encoding of the characters. Default is ``ClassicMacEncoding/macOSRoman``.
+	/// - parameter maximumLength: The maximum length of the Pascal string.
+	/// If the first byte contains a value higher than this, returns `nil`.
+	/// The default is *255*, the largest value a `UInt8` can hold.
+	/// - returns: The decoded string, or `nil` if the length is invalid.
+	public static func decode(_ bytes: UnsafeRawBufferPointer, encoding: ClassicMacEncoding = .macOSRoman, maximumLength: UInt8 = 255) -> String? {
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+		let signpost = HotPathCounters.begin()
+		defer {
+			HotPathCounters.Slot.pascalStringDecode.end(since: signpost, items: Int(bytes.first ?? 0))
+		}
+#endif
+		guard let length = bytes.first, length <= maximumLength, Int(length) < bytes.count else {
+			return nil
+		}
+		let chars = UnsafeRawBufferPointer(rebasing: bytes[1 ..< 1 + Int(length)])
+		return encoding.utf8Table.withUnsafeBufferPointer { (table) -> String in
+			return decodeCharacters(chars, table: table)
+		}
+	}
+
+	/// Decodes a buffer of fixed-size Pascal string records in one pass.
+	///
+	/// Useful for decoding an array of `Str255`, `Str31`, or a field in an array of structures.
+	/// - parameter records: The buffer holding the records.
+	/// - parameter stride: The distance, in bytes, from the start of one Pascal string to the next.
+	/// - parameter offset: The offset of the Pascal string's length byte inside of each record. Default is *0*.
+	/// - parameter encoding: The encoding of the characters. Default is ``ClassicMacEncoding/macOSRoman``.
+	/// - parameter maximumLength: The maximum length of each Pascal string.
+	/// Records with a length byte higher than this, or that would read past the end
+	/// of the record, decode to `nil`.
+	/// - returns: An array with a decoded string, or `nil`, for every complete record in `records`.
+	public static func decode(records: UnsafeRawBufferPointer, stride: Int, offset: Int = 0, encoding: ClassicMacEncoding = .macOSRoman, maximumLength: UInt8 = 255) -> [String?] {
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+		let signpost = HotPathCounters.begin()
+		defer {
+			HotPathCounters.Slot.pascalStringDecodeRecords.end(since: signpost, items: records.count / Swift.max(stride, 1))
+		}
+#endif
+		precondition(stride > 0, "Stride must be positive")
+		precondition(offset >= 0 && offset < stride, "Offset must be inside of the record")
+		let recordCount = records.count / stride
+		var toRet = [String?]()
+		toRet.reserveCapacity(recordCount)
+		let maxLen = min(Int(maximumLength), stride - offset - 1)
+		encoding.utf8Table.withUnsafeBufferPointer { (table) in
+			for i in 0 ..< recordCount {
+				let start = i * stride + offset
+				let length = Int(records[start])
+				guard length <= maxLen else {
+					toRet.append(nil)
+					continue
+				}
+				let chars = UnsafeRawBufferPointer(rebasing: records[(start + 1) ..< (start + 1 + length)])
+				toRet.append(decodeCharacters(chars, table: table))
+			}
+		}
+		return toRet
+	}
+}
+
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+private extension HotPathCounters.Slot {
+	static let pascalStringDecode = HotPathCounters.Slot("PascalString.decode(_:encoding:maximumLength:)")
+	static let pascalStringDecodeRecords = HotPathCounters.Slot("PascalString.decode(records:stride:offset:encoding:maximumLength:)")
+}
+#endif
@@ -0,0 +1,682 @@
+//
+//  SFNTFont.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// Errors from reading an SFNT (TrueType or OpenType) font.
+public enum SFNTError: Error, Hashable, Sendable {
+	/// The bytes aren't an SFNT font or font collection.
+	case unknownFormat
+	/// The collection doesn't have a font at the index.
+	case fontIndexOutOfRange(Int)
+	/// A table the operation needs is missing.
+	case missingTable(FourCharacterCode)
+	/// A table is shorter than its contents, or runs past the end of the font.
+	case truncated(FourCharacterCode)
+	/// The `cmap` table has no Unicode subtable in a supported format.
+	case noUnicodeCharacterMap
+	/// A table's ranges overlap, or cover more values than the format allows.
+	case overlappingRanges(FourCharacterCode)
+}
+
+/// Reads the tables of a TrueType or OpenType font in place.
+///
+/// Tables are looked up by binary search over the table directory and returned as pointers
+/// into the font's bytes, which are never copied. The bytes can come from a mapped font file,
+/// or from tables supplied one at a time, such as by `CTFont.data(for:)`.
+public final class SFNTFont: @unchecked Sendable {
+	/// The direction glyph advances are measured in.
+	public enum Orientation: Hashable, Sendable {
+		/// Advance widths, from the `hmtx` table.
+		case horizontal
+		/// Advance heights, from the `vmtx` table.
+		case vertical
+	}
+
+	/// A table directory entry.
+	private struct TableRecord {
+		var tag: UInt32
+		var bytes: UnsafeRawBufferPointer
+	}
+
+	/// Keeps the memory the table records point into alive.
+	private let owner: AnyObject
+	/// Sorted by tag.
+	private let records: [TableRecord]
+
+	// Table tags.
+	static let cmap: UInt32 = 0x636D6170 // 'cmap'
+	static let head: UInt32 = 0x68656164 // 'head'
+	static let hhea: UInt32 = 0x68686561 // 'hhea'
+	static let hmtx: UInt32 = 0x686D7478 // 'hmtx'
+	static let vhea: UInt32 = 0x76686561 // 'vhea'
+	static let vmtx: UInt32 = 0x766D7478 // 'vmtx'
+	static let maxp: UInt32 = 0x6D617870 // 'maxp'
+
+	/// Maps a font file into memory.
+	/// - parameter url: The file URL of a font or font collection.
+	/// - parameter fontIndex: The font to read from a TrueType or OpenType collection.
+	/// Ignored for single fonts.
+	/// - throws: A `CocoaError` if the file can't be opened, or an ``SFNTError`` if it
+	/// can't be parsed.
+	public convenience init(contentsOf url: URL, fontIndex: Int = 0) throws {
+		try self.init(region: MappedRegion(url: url), fontIndex: fontIndex)
+	}
+
+	/// Reads a font already in memory. The bytes are copied once.
+	/// - parameter data: The contents of a font or font collection.
+	/// - parameter fontIndex: The font to read from a collection.
+	public convenience init(data: Data, fontIndex: Int = 0) throws {
+		try self.init(region: MappedRegion(data: data), fontIndex: fontIndex)
+	}
+
+	private init(region: MappedRegion, fontIndex: Int) throws {
+		let bytes = UnsafeRawBufferPointer(start: region.baseAddress, count: region.count)
+		owner = region
+		records = try SFNTFont.readDirectory(bytes, fontIndex: fontIndex)
+	}
+
+	/// Wraps tables that are already in memory without copying them.
+	/// - parameter tables: The tag and contents of each table.
+	/// - parameter owner: An object that keeps the memory of `tables` valid for as long as
+	/// it's alive. The font holds a strong reference to it.
+	public init(tables: [(tag: FourCharacterCode, bytes: UnsafeRawBufferPointer)], owner: AnyObject) {
+		self.owner = owner
+		records = tables.map({ TableRecord(tag: $0.tag.rawValue, bytes: $0.bytes) }).sorted(by: { $0.tag < $1.tag })
+	}
+
+	/// Copies tables into a single buffer.
+	/// - parameter tables: The contents of each table, keyed by tag.
+	public convenience init(tables: [FourCharacterCode: Data]) {
+		var combined = Data()
+		var ranges = [(tag: FourCharacterCode, range: Range<Int>)]()
+		for (tag, table) in tables {
+			// Keep each table four-byte aligned, as in a font file.
+			combined.count = (combined.count + 3) & ~3
+			ranges.append((tag, combined.count ..< combined.count + table.count))
+			combined.append(table)
+		}
+		let region = MappedRegion(data: combined)
+		let base = UnsafeRawBufferPointer(start: region.baseAddress, count: region.count)
+		self.init(tables: ranges.map({ ($0.tag, UnsafeRawBufferPointer(rebasing: base[$0.range])) }), owner: region)
+	}
+
+	private static func readDirectory(_ bytes: UnsafeRawBufferPointer, fontIndex: Int) throws -> [TableRecord] {
+		let reader = SFNTReader(bytes)
+		guard bytes.count >= 12 else {
+			throw SFNTError.unknownFormat
+		}
+		var start = 0
+		if reader.uint32(at: 0) == 0x74746366 { // 'ttcf'
+			let count = Int(reader.uint32(at: 8))
+			guard fontIndex >= 0, fontIndex < count else {
+				throw SFNTError.fontIndexOutOfRange(fontIndex)
+			}
+			guard reader.contains(12 + 4 * fontIndex, 4) else {
+				throw SFNTError.unknownFormat
+			}
+			start = Int(reader.uint32(at: 12 + 4 * fontIndex))
+		}
+		guard reader.contains(start, 12) else {
+			throw SFNTError.unknownFormat
+		}
+		switch reader.uint32(at: start) {
+		case 0x00010000, 0x4F54544F, 0x74727565, 0x74797031: // 1.0, 'OTTO', 'true', 'typ1'
+			break
+		default:
+			throw SFNTError.unknownFormat
+		}
+		let tableCount = Int(reader.uint16(at: start + 4))
+		guard reader.contains(start + 12, tableCount * 16) else {
+			throw SFNTError.unknownFormat
+		}
+		var records = [TableRecord]()
+		records.reserveCapacity(tableCount)
+		for index in 0 ..< tableCount {
+			let entry = start + 12 + index * 16
+			let tag = reader.uint32(at: entry)
+			let offset = Int(reader.uint32(at: entry + 8))
+			let length = Int(reader.uint32(at: entry + 12))
+			guard reader.contains(offset, length) else {
+				throw SFNTError.truncated(FourCharacterCode(tag))
+			}
+			records.append(TableRecord(tag: tag, bytes: UnsafeRawBufferPointer(rebasing: bytes[offset ..< offset + length])))
+		}
+		// The directory should already be sorted, but not every font gets it right.
+		records.sort(by: { $0.tag < $1.tag })
+		return records
+	}
+
+	/// The tags of the font's tables, in ascending order.
+	public var tableTags: [FourCharacterCode] {
+		return records.map({ FourCharacterCode($0.tag) })
+	}
+
+	private func table(_ tag: UInt32) -> UnsafeRawBufferPointer? {
+		var low = 0
+		var high = records.count
+		while low < high {
+			let middle = (low + high) / 2
+			if records[middle].tag < tag {
+				low = middle + 1
+			} else {
+				high = middle
+			}
+		}
+		guard low < records.count, records[low].tag == tag else {
+			return nil
+		}
+		return records[low].bytes
+	}
+
+	/// Calls `body` with the contents of a table, without copying it.
+	/// - parameter tag: The table to read.
+	/// - parameter body: A closure given the table's bytes. The pointer must not escape it.
+	/// - returns: The result of `body`, or `nil` if the font doesn't have the table.
+	public func withUnsafeTable<R>(_ tag: FourCharacterCode, _ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R? {
+		guard let bytes = table(tag.rawValue) else {
+			return nil
+		}
+		return try withExtendedLifetime(owner) {
+			try body(bytes)
+		}
+	}
+
+	/// Returns `true` if the font has the table.
+	public func hasTable(_ tag: FourCharacterCode) -> Bool {
+		return table(tag.rawValue) != nil
+	}
+
+	private func requiredTable(_ tag: UInt32, minimumSize: Int) throws -> SFNTReader {
+		guard let bytes = table(tag) else {
+			throw SFNTError.missingTable(FourCharacterCode(tag))
+		}
+		guard bytes.count >= minimumSize else {
+			throw SFNTError.truncated(FourCharacterCode(tag))
+		}
+		return SFNTReader(bytes)
+	}
+
+	/// The number of font design units per em, from the `head` table.
+	public func unitsPerEm() throws -> Int {
+		return try withExtendedLifetime(owner) {
+			Int(try requiredTable(SFNTFont.head, minimumSize: 54).uint16(at: 18))
+		}
+	}
+
+	/// The number of glyphs in the font, from the `maxp` table.
+	public func glyphCount() throws -> Int {
+		return try withExtendedLifetime(owner) {
+			Int(try requiredTable(SFNTFont.maxp, minimumSize: 6).uint16(at: 4))
+		}
+	}
+
+	/// Builds the font's Unicode character map.
+	///
+	/// The best Unicode subtable is used: a format 12 subtable if there is one, otherwise a
+	/// format 4 subtable. A format 14 subtable adds Unicode variation sequences.
+	public func characterMap() throws -> SFNTCharacterMap {
+		return try withExtendedLifetime(owner) {
+			try SFNTCharacterMap(cmap: requiredTable(SFNTFont.cmap, minimumSize: 4))
+		}
+	}
+
+	/// Decodes every glyph's advance from the `hmtx` or `vmtx` table.
+	/// - parameter orientation: Which advances to decode.
+	public func advances(orientation: Orientation = .horizontal) throws -> SFNTAdvances {
+		return try withExtendedLifetime(owner) {
+			let (headerTag, metricsTag) = orientation == .horizontal ? (SFNTFont.hhea, SFNTFont.hmtx) : (SFNTFont.vhea, SFNTFont.vmtx)
+			let header = try requiredTable(headerTag, minimumSize: 36)
+			let metricCount = Int(header.uint16(at: 34))
+			let metrics = try requiredTable(metricsTag, minimumSize: metricCount * 4)
+			guard metricCount > 0 else {
+				throw SFNTError.truncated(FourCharacterCode(metricsTag))
+			}
+			let count = Swift.max(try glyphCount(), metricCount)
+			let advances = [UInt16](unsafeUninitializedCapacity: count) { (buffer, initializedCount) in
+				for glyph in 0 ..< metricCount {
+					buffer[glyph] = metrics.uint16(at: glyph * 4)
+				}
+				// Glyphs past the last long metric share its advance.
+				let last = buffer[metricCount - 1]
+				for glyph in metricCount ..< count {
+					buffer[glyph] = last
+				}
+				initializedCount = count
+			}
+			return SFNTAdvances(unitsPerEm: try unitsPerEm(), advances: advances)
+		}
+	}
+}
+
+// MARK: - Metrics
+
+/// The advance of every glyph in a font, in font design units.
+public struct SFNTAdvances: Hashable, Sendable {
+	/// The number of font design units per em.
+	public let unitsPerEm: Int
+	/// The advance of each glyph, indexed by glyph ID.
+	public let advances: [UInt16]
+
+	/// The advance of a glyph, or `0` if it's out of range.
+	@inlinable public subscript(glyph: UInt16) -> UInt16 {
+		let index = Int(glyph)
+		return index < advances.count ? advances[index] : 0
+	}
+
+	/// Looks up the advances of many glyphs.
+	/// - parameter glyphs: The glyph IDs.
+	/// - parameter results: Receives the advance of each glyph. Must be at least as long as `glyphs`.
+	/// - returns: The sum of the advances.
+	@discardableResult
+	public func advances(forGlyphs glyphs: UnsafeBufferPointer<UInt16>, into results: UnsafeMutableBufferPointer<UInt16>) -> Int {
+		precondition(results.count >= glyphs.count, "Result buffer is too small")
+		return advances.withUnsafeBufferPointer { (table) in
+			var sum = 0
+			for index in glyphs.indices {
+				let glyph = Int(glyphs[index])
+				let advance = glyph < table.count ? table[glyph] : 0
+				results[index] = advance
+				sum &+= Int(advance)
+			}
+			return sum
+		}
+	}
+
+	/// Looks up the advances of many glyphs.
+	/// - parameter glyphs: The glyph IDs.
+	/// - returns: `all`: The sum of the advances.<br/>
+	/// `perGlyph`: The advance of each glyph.
+	public func advances(forGlyphs glyphs: [UInt16]) -> (all: Int, perGlyph: [UInt16]) {
+		var sum = 0
+		let results = [UInt16](unsafeUninitializedCapacity: glyphs.count) { (buffer, initializedCount) in
+			sum = glyphs.withUnsafeBufferPointer { (glyphs) in
+				advances(forGlyphs: glyphs, into: buffer)
+			}
+			initializedCount = glyphs.count
+		}
+		return (sum, results)
+	}
+}
+
+// MARK: - Character Map
+
+/// A font's Unicode character map, flattened for constant-time lookups.
+///
+/// Code points are split into 256-entry pages. A page index table points each page at a
+/// block of glyph IDs, and every unmapped page shares an empty block, so a lookup is two
+/// array reads no matter which subtable format the font uses.
+public struct SFNTCharacterMap: Sendable {
+	static let pageCount = 0x110000 >> 8
+
+	/// The block of each page. Block 0 is all zeros.
+	private let pages: [UInt16]
+	private let blocks: [UInt16]
+	/// Non-default variation sequences, keyed by base character and selector.
+	private let variationGlyphs: [UInt64: UInt16]
+	/// Code point ranges whose default glyph is used with a variation selector, keyed by selector.
+	private let defaultVariations: [UInt32: [ClosedRange<UInt32>]]
+
+	init(cmap: SFNTReader) throws {
+		var best: (rank: Int, offset: Int)?
+		var variations: Int?
+		let count = Int(cmap.uint16(at: 2))
+		guard cmap.contains(4, count * 8) else {
+			throw SFNTError.truncated(FourCharacterCode(SFNTFont.cmap))
+		}
+		for index in 0 ..< count {
+			let record = 4 + index * 8
+			let platform = cmap.uint16(at: record)
+			let encoding = cmap.uint16(at: record + 2)
+			let offset = Int(cmap.uint32(at: record + 4))
+			guard cmap.contains(offset, 2) else {
+				throw SFNTError.truncated(FourCharacterCode(SFNTFont.cmap))
+			}
+			let format = cmap.uint16(at: offset)
+			let rank: Int
+			switch (platform, encoding, format) {
+			case (0, 5, 14):
+				variations = offset
+				continue
+			case (3, 10, 12), (0, 4, 12), (0, 6, 12):
+				rank = 3
+			case (3, 1, 4), (0, 3, 4), (0, 0, 4), (0, 1, 4):
+				rank = 2
+			default:
+				continue
+			}
+			if rank > best?.rank ?? 0 {
+				best = (rank, offset)
+			}
+		}
+		guard let best else {
+			throw SFNTError.noUnicodeCharacterMap
+		}
+
+		var builder = Builder()
+		if best.rank == 3 {
+			try builder.addFormat12(cmap, at: best.offset)
+		} else {
+			try builder.addFormat4(cmap, at: best.offset)
+		}
+		pages = builder.pages
+		blocks = builder.blocks
+
+		var variationGlyphs = [UInt64: UInt16]()
+		var defaultVariations = [UInt32: [ClosedRange<UInt32>]]()
+		if let variations {
+			try SFNTCharacterMap.readFormat14(cmap, at: variations, glyphs: &variationGlyphs, defaults: &defaultVariations)
+		}
+		self.variationGlyphs = variationGlyphs
+		self.defaultVariations = defaultVariations
+	}
+
+	static func variationKey(_ base: UInt32, _ selector: UInt32) -> UInt64 {
+		return UInt64(base) << 21 | UInt64(selector)
+	}
+
+	/// The glyph for a code point, or `0` if the font doesn't map it.
+	@inline(__always)
+	public func glyph(for codePoint: UInt32) -> UInt16 {
+		guard codePoint < 0x110000 else {
+			return 0
+		}
+		return blocks[Int(pages[Int(codePoint >> 8)]) << 8 | Int(codePoint & 0xFF)]
+	}
+
+	/// The glyph for a Unicode scalar, or `0` if the font doesn't map it.
+	public func glyph(for scalar: Unicode.Scalar) -> UInt16 {
+		return glyph(for: scalar.value)
+	}
+
+	/// The glyph for a Unicode variation sequence, from the `cmap` format 14 subtable.
+	/// - parameter base: The base character.
+	/// - parameter selector: The variation selector.
+	/// - returns: The glyph for the sequence, or `nil` if the font doesn't list it, in which
+	/// case the selector should be ignored.
+	public func glyph(for base: Unicode.Scalar, variationSelector selector: Unicode.Scalar) -> UInt16? {
+		if let glyph = variationGlyphs[SFNTCharacterMap.variationKey(base.value, selector.value)] {
+			return glyph
+		}
+		guard let ranges = defaultVariations[selector.value] else {
+			return nil
+		}
+		var low = 0
+		var high = ranges.count
+		while low < high {
+			let middle = (low + high) / 2
+			if ranges[middle].upperBound < base.value {
+				low = middle + 1
+			} else {
+				high = middle
+			}
+		}
+		guard low < ranges.count, ranges[low].contains(base.value) else {
+			return nil
+		}
+		return glyph(for: base.value)
+	}
+
+	/// Maps many code points at once.
+	/// - parameter codePoints: The code points.
+	/// - parameter glyphs: Receives the glyph of each code point. Must be at least as long as `codePoints`.
+	/// - returns: `true` if every code point was mapped.
+	@discardableResult
+	public func glyphs(forCodePoints codePoints: UnsafeBufferPointer<UInt32>, into glyphs: UnsafeMutableBufferPointer<UInt16>) -> Bool {
+		precondition(glyphs.count >= codePoints.count, "Glyph buffer is too small")
+		return pages.withUnsafeBufferPointer { (pages) in
+			blocks.withUnsafeBufferPointer { (blocks) in
+				var allMapped = true
+				for index in codePoints.indices {
+					let codePoint = codePoints[index]
+					var glyph: UInt16 = 0
+					if codePoint < 0x110000 {
+						glyph = blocks[Int(pages[Int(codePoint >> 8)]) << 8 | Int(codePoint & 0xFF)]
+					}
+					glyphs[index] = glyph
+					allMapped = allMapped && glyph != 0
+				}
+				return allMapped
+			}
+		}
+	}
+
+	/// Maps UTF-16 code units to glyphs, the way `CTFontGetGlyphsForCharacters` does.
+	///
+	/// A surrogate pair's glyph goes in the position of its first code unit, and the second
+	/// position gets `0`.
+	/// - parameter characters: UTF-16 code units.
+	/// - parameter glyphs: Receives the glyphs. Must be at least as long as `characters`.
+	/// - returns: `true` if every character was mapped.
+	@discardableResult
+	public func glyphs(forCharacters characters: UnsafeBufferPointer<UInt16>, into glyphs: UnsafeMutableBufferPointer<UInt16>) -> Bool {
+		precondition(glyphs.count >= characters.count, "Glyph buffer is too small")
+		return pages.withUnsafeBufferPointer { (pages) in
+			blocks.withUnsafeBufferPointer { (blocks) in
+				var allMapped = true
+				var index = 0
+				while index < characters.count {
+					var codePoint = UInt32(characters[index])
+					var width = 1
+					if codePoint & 0xFC00 == 0xD800, index + 1 < characters.count, characters[index + 1] & 0xFC00 == 0xDC00 {
+						codePoint = 0x10000 + ((codePoint & 0x3FF) << 10 | UInt32(characters[index + 1] & 0x3FF))
+						glyphs[index + 1] = 0
+						width = 2
+					}
+					let glyph = blocks[Int(pages[Int(codePoint >> 8)]) << 8 | Int(codePoint & 0xFF)]
+					glyphs[index] = glyph
+					allMapped = allMapped && glyph != 0
+					index += width
+				}
+				return allMapped
+			}
+		}
+	}
+
+	/// Maps UTF-16 code units to glyphs, the way `CTFont.glyphs(forCharacters:)` does.
+	/// - parameter characters: UTF-16 code units.
+	/// - returns: `glyphs`: The glyph of each character. The second half of a surrogate pair gets `0`.<br/>
+	/// `allMapped`: `true` if every character was mapped.
+	public func glyphs(forCharacters characters: [UInt16]) -> (glyphs: [UInt16], allMapped: Bool) {
+		var allMapped = false
+		let glyphs = [UInt16](unsafeUninitializedCapacity: characters.count) { (buffer, initializedCount) in
+			allMapped = characters.withUnsafeBufferPointer { (characters) in
+				self.glyphs(forCharacters: characters, into: buffer)
+			}
+			initializedCount = characters.count
+		}
+		return (glyphs, allMapped)
+	}
+
+	/// Fills in the page table one code point at a time.
+	private struct Builder {
+		var pages = [UInt16](repeating: 0, count: SFNTCharacterMap.pageCount)
+		var blocks = [UInt16](repeating: 0, count: 256)
+
+		mutating func set(_ codePoint: UInt32, _ glyph: UInt16) {
+			guard glyph != 0, codePoint < 0x110000 else {
+				return
+			}
+			let page = Int(codePoint >> 8)
+			if pages[page] == 0 {
+				pages[page] = UInt16(blocks.count >> 8)
+				blocks.append(contentsOf: repeatElement(0, count: 256))
+			}
+			blocks[Int(pages[page]) << 8 | Int(codePoint & 0xFF)] = glyph
+		}
+
+		mutating func addFormat4(_ cmap: SFNTReader, at offset: Int) throws {
+			let truncated = SFNTError.truncated(FourCharacterCode(SFNTFont.cmap))
+			guard cmap.contains(offset, 14) else {
+				throw truncated
+			}
+			let segmentCount = Int(cmap.uint16(at: offset + 6)) / 2
+			let ends = offset + 14
+			let starts = ends + segmentCount * 2 + 2
+			let deltas = starts + segmentCount * 2
+			let rangeOffsets = deltas + segmentCount * 2
+			guard cmap.contains(ends, segmentCount * 8 + 2) else {
+				throw truncated
+			}
+			// Valid segments don't overlap, so they cover at most every 16-bit code point.
+			// Checking this first bounds the work for a hostile font.
+			var total = 0
+			for segment in 0 ..< segmentCount {
+				let end = Int(cmap.uint16(at: ends + segment * 2))
+				let start = Int(cmap.uint16(at: starts + segment * 2))
+				if start <= end {
+					total += end - start + 1
+				}
+			}
+			guard total <= 0x10000 else {
+				throw SFNTError.overlappingRanges(FourCharacterCode(SFNTFont.cmap))
+			}
+			for segment in 0 ..< segmentCount {
+				let end = UInt32(cmap.uint16(at: ends + segment * 2))
+				let start = UInt32(cmap.uint16(at: starts + segment * 2))
+				let delta = cmap.uint16(at: deltas + segment * 2)
+				let rangeOffsetPosition = rangeOffsets + segment * 2
+				let rangeOffset = Int(cmap.uint16(at: rangeOffsetPosition))
+				guard start <= end else {
+					continue
+				}
+				for codePoint in start ... end where codePoint != 0xFFFF {
+					if rangeOffset == 0 {
+						set(codePoint, UInt16(truncatingIfNeeded: codePoint) &+ delta)
+					} else {
+						let address = rangeOffsetPosition + rangeOffset + Int(codePoint - start) * 2
+						guard cmap.contains(address, 2) else {
+							continue
+						}
+						let glyph = cmap.uint16(at: address)
+						if glyph != 0 {
+							set(codePoint, glyph &+ delta)
+						}
+					}
+				}
+			}
+		}
+
+		mutating func addFormat12(_ cmap: SFNTReader, at offset: Int) throws {
+			guard cmap.contains(offset, 16) else {
+				throw SFNTError.truncated(FourCharacterCode(SFNTFont.cmap))
+			}
+			let groupCount = Int(cmap.uint32(at: offset + 12))
+			guard cmap.contains(offset + 16, groupCount * 12) else {
+				throw SFNTError.truncated(FourCharacterCode(SFNTFont.cmap))
+			}
+			// Valid groups don't overlap, so they cover at most every code point.
+			// Checking this first bounds the work for a hostile font.
+			var total = 0
+			for group in 0 ..< groupCount {
+				let record = offset + 16 + group * 12
+				let start = Int(cmap.uint32(at: record))
+				let end = Swift.min(Int(cmap.uint32(at: record + 4)), 0x10FFFF)
+				if start <= end {
+					total += end - start + 1
+				}
+			}
+			guard total <= 0x110000 else {
+				throw SFNTError.overlappingRanges(FourCharacterCode(SFNTFont.cmap))
+			}
+			for group in 0 ..< groupCount {
+				let record = offset + 16 + group * 12
+				let start = cmap.uint32(at: record)
+				let end = Swift.min(cmap.uint32(at: record + 4), 0x10FFFF)
+				let startGlyph = cmap.uint32(at: record + 8)
+				guard start <= end else {
+					continue
+				}
+				for codePoint in start ... end {
+					set(codePoint, UInt16(truncatingIfNeeded: startGlyph &+ (codePoint - start)))
+				}
+			}
+		}
+	}
+
+	private static func readFormat14(_ cmap: SFNTReader, at offset: Int, glyphs: inout [UInt64: UInt16], defaults: inout [UInt32: [ClosedRange<UInt32>]]) throws {
+		let truncated = SFNTError.truncated(FourCharacterCode(SFNTFont.cmap))
+		guard cmap.contains(offset, 10) else {
+			throw truncated
+		}
+		let recordCount = Int(cmap.uint32(at: offset + 6))
+		guard cmap.contains(offset + 10, recordCount * 11) else {
+			throw truncated
+		}
+		for index in 0 ..< recordCount {
+			let record = offset + 10 + index * 11
+			let selector = cmap.uint24(at: record)
+			let defaultOffset = Int(cmap.uint32(at: record + 3))
+			let nonDefaultOffset = Int(cmap.uint32(at: record + 7))
+			if defaultOffset != 0 {
+				let table = offset + defaultOffset
+				guard cmap.contains(table, 4) else {
+					throw truncated
+				}
+				let rangeCount = Int(cmap.uint32(at: table))
+				guard cmap.contains(table + 4, rangeCount * 4) else {
+					throw truncated
+				}
+				var ranges = [ClosedRange<UInt32>]()
+				ranges.reserveCapacity(rangeCount)
+				for range in 0 ..< rangeCount {
+					let start = cmap.uint24(at: table + 4 + range * 4)
+					let additional = UInt32(cmap.uint8(at: table + 7 + range * 4))
+					ranges.append(start ... start + additional)
+				}
+				defaults[selector] = ranges.sorted(by: { $0.lowerBound < $1.lowerBound })
+			}
+			if nonDefaultOffset != 0 {
+				let table = offset + nonDefaultOffset
+				guard cmap.contains(table, 4) else {
+					throw truncated
+				}
+				let mappingCount = Int(cmap.uint32(at: table))
+				guard cmap.contains(table + 4, mappingCount * 5) else {
+					throw truncated
+				}
+				for mapping in 0 ..< mappingCount {
+					let entry = table + 4 + mapping * 5
+					glyphs[variationKey(cmap.uint24(at: entry), selector)] = cmap.uint16(at: entry + 3)
+				}
+			}
+		}
+	}
+}
+
+// MARK: - Reading
+
+/// Reads big-endian values from a table.
+struct SFNTReader {
+	let bytes: UnsafeRawBufferPointer
+
+	init(_ bytes: UnsafeRawBufferPointer) {
+		self.bytes = bytes
+	}
+
+	/// Returns `true` if `count` bytes at `offset` are all in the table.
+	func contains(_ offset: Int, _ count: Int) -> Bool {
+		return offset >= 0 && count >= 0 && offset <= bytes.count && count <= bytes.count - offset
+	}
+
+	func uint8(at offset: Int) -> UInt8 {
+		return bytes[offset]
+	}
+
+	func uint16(at offset: Int) -> UInt16 {
+		return UInt16(bigEndian: bytes.loadUnaligned(fromByteOffset: offset, as: UInt16.self))
+	}
+
+	func uint24(at offset: Int) -> UInt32 {
+		return UInt32(bytes[offset]) << 16 | UInt32(bytes[offset + 1]) << 8 | UInt32(bytes[offset + 2])
+	}
+
+	func uint32(at offset: Int) -> UInt32 {
+		return UInt32(bigEndian: bytes.loadUnaligned(fromByteOffset: offset, as: UInt32.self))
+	}
+}
@@ -0,0 +1,83 @@
+//
+//  SharedCounter.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+#if SWIFT_PACKAGE
+import FoundationAdditionsAtomics
+#endif
+
+/// An integer shared between threads. Loads acquire, and stores and updates release.
+///
+/// This is the one counter the package's thread-shared state is built on. It is a C11
+/// atomic on every deployment target, so code on a real-time thread never blocks on it.
+package protocol SharedCounter: AnyObject, Sendable {
+	func load() -> Int
+	func store(_ value: Int)
+	/// Adds `delta` and returns the new value.
+	@discardableResult
+	func add(_ delta: Int) -> Int
+	/// Sets the counter to `value` if that is higher.
+	func raise(to value: Int)
+	/// Sets the counter to `desired` if it is `expected`.
+	/// - returns: Whether the value was changed, and the value before the call.
+	func compareExchange(expected: Int, desired: Int) -> (exchanged: Bool, original: Int)
+}
+
+/// Creates a counter.
+package func makeSharedCounter(_ initialValue: Int = 0) -> any SharedCounter {
+	return AtomicSharedCounter(initialValue)
+}
+
+/// `true` if ``makeSharedCounter(_:)`` returns lock-free counters on this system.
+///
+/// C11 only promises this where the processor has the instructions, which every system
+/// the package supports does.
+package var sharedCountersAreLockFree: Bool {
+	return FAAtomicsAreLockFree()
+}
+
+private final class AtomicSharedCounter: SharedCounter, @unchecked Sendable {
+	private let value: UnsafeMutablePointer<FAAtomicInt>
+
+	init(_ initialValue: Int) {
+		value = .allocate(capacity: 1)
+		FAAtomicIntInitialize(value, initialValue)
+	}
+
+	deinit {
+		value.deallocate()
+	}
+
+	func load() -> Int {
+		return FAAtomicIntLoad(value)
+	}
+
+	func store(_ newValue: Int) {
+		FAAtomicIntStore(value, newValue)
+	}
+
+	@discardableResult
+	func add(_ delta: Int) -> Int {
+		return FAAtomicIntFetchAdd(value, delta) &+ delta
+	}
+
+	func raise(to newValue: Int) {
+		var current = FAAtomicIntLoad(value)
+		while newValue > current {
+			if FAAtomicIntCompareExchange(value, &current, newValue) {
+				break
+			}
+		}
+	}
+
+	func compareExchange(expected: Int, desired: Int) -> (exchanged: Bool, original: Int) {
+		var original = expected
+		let exchanged = FAAtomicIntCompareExchange(value, &original, desired)
+		return (exchanged, original)
+	}
+}
@@ -0,0 +1,1230 @@
+//
+//  SharedMemoryTransport.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// Errors from a ``SharedMemoryTransport``.
+public enum SharedMemoryTransportError: Error, Hashable, Sendable {
+	/// The message couldn't be sent in time, usually because the shared ring stayed full.
+	/// The counterpart of `kCFMessagePortSendTimeout`.
+	case sendTimeout
+	/// The reply didn't arrive in time. The counterpart of `kCFMessagePortReceiveTimeout`.
+	case receiveTimeout
+	/// The transport was invalidated, or its channel closed. The counterpart of
+	/// `kCFMessagePortIsInvalid`.
+	case invalid
+	/// The payload doesn't fit in the ring, and is too large for a frame on the channel.
+	case payloadTooLarge
+}
+
+/// Counters for a ``SharedMemoryTransport``.
+public struct SharedMemoryTransportStatistics: Hashable, Sendable {
+	/// The messages sent, including replies.
+	public var messagesSent: Int
+	/// The messages received, including replies.
+	public var messagesReceived: Int
+	/// The payload bytes sent.
+	public var bytesSent: Int
+	/// The payload bytes received.
+	public var bytesReceived: Int
+	/// The messages whose payload went through the shared ring instead of the channel.
+	public var ringMessagesSent: Int
+	/// The frames sent on the channel, counting a batch as one.
+	public var framesSent: Int
+	/// The frames that carried more than one message.
+	public var batchesSent: Int
+	/// The number of times a sender had to wait for the peer to free ring space.
+	public var ringStalls: Int
+	/// The replies to the peer's requests that couldn't be sent, because the transport was
+	/// invalidated or the ring stayed full for ``SharedMemoryTransport/replyTimeout``.
+	public var replyFailures: Int
+	/// The requests that got a reply.
+	public var roundTrips: Int
+	/// The mean time from sending a request to its reply arriving, in seconds.
+	public var averageRoundTripLatency: Double
+	/// The longest time from sending a request to its reply arriving, in seconds.
+	public var maximumRoundTripLatency: Double
+	/// The time since the transport was created, in seconds.
+	public var elapsed: Double
+
+	/// Payload bytes sent per second since the transport was created.
+	public var sendThroughput: Double {
+		return elapsed > 0 ? Double(bytesSent) / elapsed : 0
+	}
+
+	/// Payload bytes received per second since the transport was created.
+	public var receiveThroughput: Double {
+		return elapsed > 0 ? Double(bytesReceived) / elapsed : 0
+	}
+}
+
+/// Carries the small frames of a ``SharedMemoryTransport`` between two processes.
+///
+/// A channel only has to deliver whole frames, in order. Payloads large enough to matter
+/// travel through shared memory, so a channel can be something slow per byte, like a
+/// message port.
+public protocol SharedMemoryChannel: AnyObject, Sendable {
+	/// Starts delivering frames. Called once.
+	/// - parameter frameHandler: Called with each frame, one at a time. The buffer is only
+	/// valid for the duration of the call.
+	/// - parameter closeHandler: Called once when the channel closes from either end.
+	func start(receiving frameHandler: @escaping @Sendable (UnsafeRawBufferPointer) -> Void, closed closeHandler: @escaping @Sendable () -> Void) throws
+
+	/// Sends one frame. The transport never calls this from two threads at once.
+	/// - throws: ``SharedMemoryTransportError/payloadTooLarge`` if the frame is larger than
+	/// ``maximumFrameSize``, without sending anything.
+	func send(_ frame: UnsafeRawBufferPointer) throws
+
+	/// The largest frame ``send(_:)`` accepts. Default is `Int.max`.
+	var maximumFrameSize: Int { get }
+
+	/// Closes the channel. Calls the close handler if it hasn't been called yet.
+	func close()
+}
+
+public extension SharedMemoryChannel {
+	var maximumFrameSize: Int {
+		return Int.max
+	}
+}
+
+// MARK: - Transport
+
+/// A request/reply message transport between two processes that passes large payloads
+/// through shared memory.
+///
+/// It follows the model of `CFMessagePort`: a message has an ID and a payload, a request
+/// waits for a reply that the peer's handler returns, and incoming messages are handled on
+/// a dispatch queue set with ``setDispatchQueue(_:)``. Either end can send requests.
+///
+/// Each end maps a ring of ``ringCapacity`` bytes that the other end maps read-only. A
+/// payload of at least ``inlineLimit`` bytes is written straight into the sender's ring and
+/// only a descriptor goes over the ``SharedMemoryChannel``; the receiver's handler reads it
+/// in place. Smaller payloads go inline in the frame, and one-way messages among them are
+/// gathered into batches of up to ``batchLimit`` bytes. Ring space comes back when the
+/// receiver reports it has finished with a payload, which rides along on whatever frame it
+/// sends next, so there is no shared state to synchronize besides the channel itself.
+///
+/// The ring lives in a file under `/dev/shm` where that exists, or the temporary directory
+/// otherwise. The peer deletes the file as soon as it has mapped it. A peer only maps a file
+/// with the name this type gives its rings, in that directory, so both processes have to
+/// run as the same user.
+public final class SharedMemoryTransport: @unchecked Sendable {
+	/// Handles an incoming message.
+	///
+	/// The payload is only valid for the duration of the call. The return value is the
+	/// reply for a request, and is ignored for a one-way message.
+	public typealias Handler = @Sendable (_ messageID: Int32, _ payload: UnsafeRawBufferPointer) -> Data?
+
+	/// The size of this end's ring, in bytes.
+	public let ringCapacity: Int
+	/// Payloads at least this large go through the ring.
+	public let inlineLimit: Int
+	/// One-way messages smaller than ``inlineLimit`` are sent in batches of up to this many bytes.
+	public let batchLimit: Int
+	/// How long the handler's reply may wait for ring space.
+	public let replyTimeout: TimeInterval
+
+	private let channel: any SharedMemoryChannel
+	private let outbound: SharedMemoryRegion
+	private let handler: Handler?
+	private let created = DispatchTime.now()
+	/// Serializes frames on the channel, so batched messages keep their order.
+	private let sendLock = NSLock()
+	private let flushQueue = DispatchQueue(label: "SharedMemoryTransport.flush")
+	private let deliveryQueue = DispatchQueue(label: "SharedMemoryTransport.delivery", attributes: .initiallyInactive)
+
+	/// Guards everything below, and is signaled when replies arrive or ring space is freed.
+	private let state = NSCondition()
+	private var valid = true
+	private var dispatchQueueSet = false
+	private var deliveryActivated = false
+	private var allocator: RingAllocator
+	private var inbound: SharedMemoryRegion?
+	private var helloReceived = false
+	private var inboundTracker = RingReleaseTracker()
+	private var reportedRelease: UInt64 = 0
+	private var batch = Data()
+	private var batchCount = 0
+	private var flushScheduled = false
+	private var nextSequence: UInt64 = 1
+	/// Reserved ring positions not sent yet. They go out in this order, so the peer never
+	/// reports a later payload done before it has seen an earlier one.
+	private var unsentRingPositions = [UInt64]()
+	private var pendingReplies = [UInt64: ReplySlot]()
+	private var counters = Counters()
+
+	/// Creates a transport over a channel and tells the peer where its ring is.
+	/// - parameter channel: A connected channel to the peer. The transport starts it.
+	/// - parameter ringCapacity: The size of the ring this end writes into. Rounded up to a
+	/// multiple of 4KiB.
+	/// - parameter inlineLimit: Payloads at least this large go through the ring.
+	/// - parameter batchLimit: The most bytes of one-way messages to gather into one frame.
+	/// - parameter replyTimeout: How long the handler's reply may wait for ring space.
+	/// - parameter handler: Handles incoming messages once ``setDispatchQueue(_:)`` is
+	/// called. Pass `nil` if this end only sends.
+	/// - throws: A `CocoaError` if the ring can't be created, or the channel's error if it
+	/// can't be started.
+	public init(channel: any SharedMemoryChannel, ringCapacity: Int = 8 << 20, inlineLimit: Int = 16384, batchLimit: Int = 65536, replyTimeout: TimeInterval = 10, handler: Handler? = nil) throws {
+		precondition(ringCapacity > 0, "The ring needs some room")
+		let capacity = (ringCapacity + 4095) & ~4095
+		self.ringCapacity = capacity
+		self.inlineLimit = Swift.max(inlineLimit, 1)
+		self.batchLimit = batchLimit
+		self.replyTimeout = replyTimeout
+		self.channel = channel
+		self.handler = handler
+		outbound = try SharedMemoryRegion(creatingWithCount: capacity)
+		allocator = RingAllocator(capacity: capacity)
+		// If anything below throws, deinit invalidates, which cleans up.
+		try channel.start(receiving: { [weak self] frame in
+			self?.receive(frame)
+		}, closed: { [weak self] in
+			self?.invalidate()
+		})
+		var hello = TransportHeader(kind: .hello)
+		hello.length = UInt64(capacity)
+		try Array(outbound.path.utf8).withUnsafeBytes { path in
+			try transmit(Data(encoding: hello, payload: path))
+		}
+	}
+
+	deinit {
+		invalidate()
+	}
+
+	/// Starts handling incoming messages on `queue`. Messages that arrived earlier are
+	/// handled first. Call it once.
+	///
+	/// Messages are handled one at a time and in order, even if `queue` is concurrent.
+	/// - parameter queue: The queue the handler is called on.
+	public func setDispatchQueue(_ queue: DispatchQueue) {
+		state.lock()
+		precondition(!dispatchQueueSet, "The dispatch queue was already set")
+		dispatchQueueSet = true
+		let activate = !deliveryActivated
+		deliveryActivated = true
+		state.unlock()
+		if activate {
+			deliveryQueue.setTarget(queue: queue)
+			deliveryQueue.activate()
+		}
+	}
+
+	/// Is `true` until the transport is invalidated or its channel closes.
+	public var isValid: Bool {
+		state.lock()
+		defer {
+			state.unlock()
+		}
+		return valid
+	}
+
+	/// Stops the transport: closes the channel, fails pending requests with
+	/// ``SharedMemoryTransportError/invalid``, and deletes the ring file if the peer never
+	/// mapped it.
+	public func invalidate() {
+		state.lock()
+		guard valid else {
+			state.unlock()
+			return
+		}
+		valid = false
+		let activate = !deliveryActivated
+		deliveryActivated = true
+		state.broadcast()
+		state.unlock()
+		channel.close()
+		outbound.removeFile()
+		if activate {
+			// Releasing a dispatch queue that was never activated crashes.
+			deliveryQueue.activate()
+		}
+	}
+
+	/// The counters so far.
+	public var statistics: SharedMemoryTransportStatistics {
+		state.lock()
+		let counters = self.counters
+		state.unlock()
+		return SharedMemoryTransportStatistics(messagesSent: counters.messagesSent, messagesReceived: counters.messagesReceived, bytesSent: counters.bytesSent, bytesReceived: counters.bytesReceived, ringMessagesSent: counters.ringMessagesSent, framesSent: counters.framesSent, batchesSent: counters.batchesSent, ringStalls: counters.ringStalls, replyFailures: counters.replyFailures, roundTrips: counters.roundTrips, averageRoundTripLatency: counters.roundTrips > 0 ? Double(counters.totalRoundTripNanoseconds) / Double(counters.roundTrips) / 1_000_000_000 : 0, maximumRoundTripLatency: Double(counters.maximumRoundTripNanoseconds) / 1_000_000_000, elapsed: Double(DispatchTime.now().uptimeNanoseconds - created.uptimeNanoseconds) / 1_000_000_000)
+	}
+
+	// MARK: Sending
+
+	/// Sends a one-way message.
+	///
+	/// A small message may wait in a batch until more are sent, ``flush()`` is called, or the
+	/// transport's flush queue gets to it, whichever is first.
+	/// - parameter messageID: An identifier for the handler.
+	/// - parameter data: The payload.
+	/// - parameter sendTimeout: How long to wait for ring space.
+	public func send(messageID: Int32, data: Data, sendTimeout: TimeInterval) throws {
+		try send(messageID: messageID, byteCount: data.count, sendTimeout: sendTimeout) { buffer in
+			_ = data.copyBytes(to: buffer)
+		}
+	}
+
+	/// Sends a one-way message, writing its payload in place.
+	/// - parameter messageID: An identifier for the handler.
+	/// - parameter byteCount: The size of the payload.
+	/// - parameter sendTimeout: How long to wait for ring space.
+	/// - parameter fill: Writes the payload. For a large payload the buffer is in the shared ring,
+	/// so nothing is copied after it.
+	public func send(messageID: Int32, byteCount: Int, sendTimeout: TimeInterval, fill: (UnsafeMutableRawBufferPointer) throws -> Void) throws {
+		try sendMessage(messageID: messageID, flags: [], sequence: 0, byteCount: byteCount, timeout: sendTimeout, batchable: true, fill: fill)
+	}
+
+	/// Sends a request and waits for the reply, like `CFMessagePort.sendRequest`.
+	/// - parameter messageID: An identifier for the handler.
+	/// - parameter data: The payload.
+	/// - parameter sendTimeout: How long to wait for ring space.
+	/// - parameter receiveTimeout: How long to wait for the reply once the request is sent.
+	/// - returns: The reply, or `nil` if the peer's handler returned `nil`.
+	public func sendRequest(messageID: Int32, data: Data, sendTimeout: TimeInterval, receiveTimeout: TimeInterval) throws -> Data? {
+		return try sendRequest(messageID: messageID, byteCount: data.count, sendTimeout: sendTimeout, receiveTimeout: receiveTimeout, fill: { buffer in
+			_ = data.copyBytes(to: buffer)
+		}, reply: { buffer in
+			return buffer.map { Data($0) }
+		})
+	}
+
+	/// Sends a request and waits for the reply, writing the payload and reading the reply in place.
+	/// - parameter messageID: An identifier for the handler.
+	/// - parameter byteCount: The size of the payload.
+	/// - parameter sendTimeout: How long to wait for ring space.
+	/// - parameter receiveTimeout: How long to wait for the reply once the request is sent.
+	/// - parameter fill: Writes the payload.
+	/// - parameter reply: Reads the reply, which is `nil` if the peer's handler returned `nil`.
+	/// The buffer is only valid for the duration of the call; a large reply is read straight
+	/// out of the peer's ring.
+	/// - returns: The return value of `reply`.
+	public func sendRequest<Result>(messageID: Int32, byteCount: Int, sendTimeout: TimeInterval, receiveTimeout: TimeInterval, fill: (UnsafeMutableRawBufferPointer) throws -> Void, reply: (UnsafeRawBufferPointer?) throws -> Result) throws -> Result {
+		state.lock()
+		let sequence = nextSequence
+		nextSequence &+= 1
+		pendingReplies[sequence] = .waiting
+		state.unlock()
+
+		let start = DispatchTime.now().uptimeNanoseconds
+		do {
+			try sendMessage(messageID: messageID, flags: .expectsReply, sequence: sequence, byteCount: byteCount, timeout: sendTimeout, batchable: false, fill: fill)
+		} catch {
+			state.lock()
+			pendingReplies[sequence] = nil
+			state.unlock()
+			throw error
+		}
+
+		let deadline = Date(timeIntervalSinceNow: receiveTimeout)
+		state.lock()
+		while valid, case .waiting? = pendingReplies[sequence] {
+			if !state.wait(until: deadline) {
+				break
+			}
+		}
+		let slot = pendingReplies.removeValue(forKey: sequence)
+		let isValid = valid
+		if case .arrived? = slot {
+			let latency = DispatchTime.now().uptimeNanoseconds - start
+			counters.roundTrips += 1
+			counters.totalRoundTripNanoseconds += latency
+			counters.maximumRoundTripNanoseconds = Swift.max(counters.maximumRoundTripNanoseconds, latency)
+		}
+		state.unlock()
+
+		guard case .arrived(let payload)? = slot else {
+			throw isValid ? SharedMemoryTransportError.receiveTimeout : SharedMemoryTransportError.invalid
+		}
+		defer {
+			finish(payload)
+		}
+		return try payload.withOptionalBuffer(reply)
+	}
+
+	/// Sends any batched messages now, and tells the peer about ring space it can reuse.
+	public func flush() throws {
+		try transmit(nil)
+	}
+
+	/// Sends one message, through the ring if it's large, in the batch if it's small and
+	/// one-way, or in a frame of its own otherwise.
+	private func sendMessage(messageID: Int32, flags: TransportHeader.Flags, sequence: UInt64, byteCount: Int, timeout: TimeInterval, batchable: Bool, fill: (UnsafeMutableRawBufferPointer) throws -> Void) throws {
+		var header = TransportHeader(kind: .message)
+		header.flags = flags
+		header.messageID = messageID
+		header.sequence = sequence
+
+		if byteCount >= inlineLimit && RingAllocator.alignedLength(byteCount) <= ringCapacity {
+			let deadline = Date(timeIntervalSinceNow: timeout)
+			state.lock()
+			var position: UInt64?
+			var stalled = false
+			while valid {
+				position = allocator.reserve(byteCount)
+				if let position {
+					unsentRingPositions.append(position)
+					break
+				}
+				if !stalled {
+					stalled = true
+					counters.ringStalls += 1
+				}
+				if !state.wait(until: deadline) {
+					break
+				}
+			}
+			let isValid = valid
+			state.unlock()
+			guard isValid else {
+				throw SharedMemoryTransportError.invalid
+			}
+			guard let position else {
+				throw SharedMemoryTransportError.sendTimeout
+			}
+			defer {
+				state.lock()
+				unsentRingPositions.removeAll { $0 == position }
+				state.broadcast()
+				state.unlock()
+			}
+			// Senders fill their payloads concurrently, then take turns on the channel.
+			try fill(UnsafeMutableRawBufferPointer(start: outbound.baseAddress + Int(position % UInt64(ringCapacity)), count: byteCount))
+			state.lock()
+			while valid && unsentRingPositions.first != position {
+				state.wait()
+			}
+			state.unlock()
+			header.flags.insert(.inRing)
+			header.position = position
+			header.length = UInt64(byteCount)
+			try transmit(Data(encoding: header, payloadCount: 0, fill: { _ in }), countingMessage: byteCount, inRing: true)
+			return
+		}
+
+		// Payloads too large for the ring fall back to the channel, if it can carry them.
+		guard byteCount <= channel.maximumFrameSize - TransportHeader.size else {
+			throw SharedMemoryTransportError.payloadTooLarge
+		}
+		let frame = try Data(encoding: header, payloadCount: byteCount, fill: fill)
+		// A batch entry's size is 32 bits, and a frame can't go over the batch limit on its own.
+		guard batchable && frame.count <= Swift.min(batchLimit, Int(UInt32.max)) else {
+			try transmit(frame, countingMessage: byteCount, inRing: false)
+			return
+		}
+		state.lock()
+		guard valid else {
+			state.unlock()
+			throw SharedMemoryTransportError.invalid
+		}
+		var size = UInt32(frame.count)
+		withUnsafeBytes(of: &size) { batch.append(contentsOf: $0) }
+		batch.append(frame)
+		batchCount += 1
+		counters.messagesSent += 1
+		counters.bytesSent += byteCount
+		let isFull = batch.count >= batchLimit
+		state.unlock()
+		if isFull {
+			try transmit(nil)
+		} else {
+			scheduleFlush()
+		}
+	}
+
+	/// Sends `frame` on the channel after anything batched, stamping each frame with how far
+	/// this end has finished reading the peer's ring. With no frame and an empty batch, sends
+	/// a release frame if the peer hasn't heard about freed space yet.
+	private func transmit(_ frame: Data?, countingMessage byteCount: Int? = nil, inRing: Bool = false) throws {
+		sendLock.lock()
+		defer {
+			sendLock.unlock()
+		}
+		state.lock()
+		guard valid else {
+			state.unlock()
+			throw SharedMemoryTransportError.invalid
+		}
+		var frames = [Data]()
+		if batchCount == 1 {
+			frames.append(Data(batch.dropFirst(4)))
+		} else if batchCount > 1 {
+			var container = Data(encoding: TransportHeader(kind: .batch), payload: nil)
+			container.append(batch)
+			frames.append(container)
+			counters.batchesSent += 1
+		}
+		batch.removeAll(keepingCapacity: true)
+		batchCount = 0
+		let released = inboundTracker.released
+		if let frame {
+			frames.append(frame)
+		} else if frames.isEmpty && released > reportedRelease {
+			frames.append(Data(encoding: TransportHeader(kind: .release), payload: nil))
+		}
+		reportedRelease = released
+		if let byteCount {
+			counters.messagesSent += 1
+			counters.bytesSent += byteCount
+			if inRing {
+				counters.ringMessagesSent += 1
+			}
+		}
+		counters.framesSent += frames.count
+		state.unlock()
+
+		do {
+			for var frame in frames {
+				frame.withUnsafeMutableBytes { $0.storeBytes(of: released, toByteOffset: TransportHeader.releasedOffset, as: UInt64.self) }
+				try frame.withUnsafeBytes { try channel.send($0) }
+			}
+		} catch {
+			invalidate()
+			throw error
+		}
+	}
+
+	/// Flushes the batch and reports freed space on the flush queue, once per burst.
+	private func scheduleFlush() {
+		state.lock()
+		guard valid, !flushScheduled else {
+			state.unlock()
+			return
+		}
+		flushScheduled = true
+		state.unlock()
+		flushQueue.async { [weak self] in
+			guard let self else {
+				return
+			}
+			self.state.lock()
+			self.flushScheduled = false
+			self.state.unlock()
+			try? self.transmit(nil)
+		}
+	}
+
+	// MARK: Receiving
+
+	private func receive(_ frame: UnsafeRawBufferPointer) {
+		guard let header = TransportHeader(frame) else {
+			invalidate()
+			return
+		}
+		state.lock()
+		if allocator.release(through: header.released) {
+			state.broadcast()
+		}
+		state.unlock()
+
+		let payload = UnsafeRawBufferPointer(rebasing: frame[TransportHeader.size...])
+		switch header.kind {
+		case .hello:
+			// Only the peer's own ring, and only once.
+			state.lock()
+			let isFirst = !helloReceived
+			helloReceived = true
+			state.unlock()
+			let path = String(decoding: payload, as: UTF8.self)
+			guard isFirst, let count = Int(exactly: header.length), count > 0, count % 4096 == 0, SharedMemoryRegion.isRingPath(path),
+				  let region = try? SharedMemoryRegion(openingAt: path, count: count) else {
+				invalidate()
+				return
+			}
+			state.lock()
+			inbound = region
+			state.unlock()
+
+		case .release:
+			break
+
+		case .batch:
+			var offset = 0
+			while offset + 4 <= payload.count {
+				let size = Int(payload.loadUnaligned(fromByteOffset: offset, as: UInt32.self))
+				offset += 4
+				guard size <= payload.count - offset else {
+					invalidate()
+					return
+				}
+				let message = UnsafeRawBufferPointer(rebasing: payload[offset ..< offset + size])
+				// A batch only holds messages.
+				guard TransportHeader(message)?.kind == .message else {
+					invalidate()
+					return
+				}
+				receive(message)
+				offset += size
+			}
+
+		case .message:
+			receiveMessage(header, inline: payload)
+		}
+	}
+
+	private func receiveMessage(_ header: TransportHeader, inline: UnsafeRawBufferPointer) {
+		let received: ReceivedPayload
+		state.lock()
+		if header.flags.contains(.noData) {
+			received = .none
+		} else if header.flags.contains(.inRing) {
+			guard let inbound, header.length <= UInt64(inbound.count) else {
+				state.unlock()
+				invalidate()
+				return
+			}
+			let offset = Int(header.position % UInt64(inbound.count))
+			let length = Int(header.length)
+			let (end, overflow) = header.position.addingReportingOverflow(header.length)
+			guard !overflow, offset + length <= inbound.count else {
+				state.unlock()
+				invalidate()
+				return
+			}
+			inboundTracker.arrived(end: end)
+			received = .ring(UnsafeRawBufferPointer(start: inbound.baseAddress + offset, count: length), end: end)
+		} else {
+			received = .inline(Data(inline))
+		}
+		counters.messagesReceived += 1
+		counters.bytesReceived += received.count
+
+		if header.flags.contains(.isReply) {
+			if case .waiting? = pendingReplies[header.sequence] {
+				pendingReplies[header.sequence] = .arrived(received)
+				state.broadcast()
+				state.unlock()
+			} else {
+				// Nobody is waiting any more.
+				state.unlock()
+				finish(received)
+			}
+			return
+		}
+		state.unlock()
+		deliveryQueue.async {
+			self.deliver(header, payload: received)
+		}
+	}
+
+	private func deliver(_ header: TransportHeader, payload: ReceivedPayload) {
+		guard isValid else {
+			finish(payload)
+			return
+		}
+		let reply = payload.withBuffer { buffer in
+			handler?(header.messageID, buffer)
+		}
+		// Done with the request, so the reply can carry the release.
+		finish(payload)
+		if header.flags.contains(.expectsReply) {
+			do {
+				try sendMessage(messageID: header.messageID, flags: reply == nil ? [.isReply, .noData] : .isReply, sequence: header.sequence, byteCount: reply?.count ?? 0, timeout: replyTimeout, batchable: false) { buffer in
+					_ = reply?.copyBytes(to: buffer)
+				}
+			} catch {
+				// The peer's request times out; this end can only count it.
+				state.lock()
+				counters.replyFailures += 1
+				state.unlock()
+			}
+		}
+		scheduleFlush()
+	}
+
+	/// Marks a received payload as done with, freeing its ring space once everything before
+	/// it is done too.
+	private func finish(_ payload: ReceivedPayload) {
+		guard case .ring(_, let end) = payload else {
+			return
+		}
+		state.lock()
+		inboundTracker.finished(end: end)
+		state.unlock()
+	}
+
+	// MARK: Types
+
+	private enum ReplySlot {
+		case waiting
+		case arrived(ReceivedPayload)
+	}
+
+	/// A received payload. Ring payloads point into the peer's ring, which stays mapped as long
+	/// as the transport exists.
+	private enum ReceivedPayload: @unchecked Sendable {
+		case none
+		case inline(Data)
+		case ring(UnsafeRawBufferPointer, end: UInt64)
+
+		var count: Int {
+			switch self {
+			case .none:
+				return 0
+			case .inline(let data):
+				return data.count
+			case .ring(let buffer, _):
+				return buffer.count
+			}
+		}
+
+		func withBuffer<R>(_ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R {
+			return try withOptionalBuffer { try body($0 ?? UnsafeRawBufferPointer(start: nil, count: 0)) }
+		}
+
+		func withOptionalBuffer<R>(_ body: (UnsafeRawBufferPointer?) throws -> R) rethrows -> R {
+			switch self {
+			case .none:
+				return try body(nil)
+			case .inline(let data):
+				return try data.withUnsafeBytes { try body($0) }
+			case .ring(let buffer, _):
+				return try body(buffer)
+			}
+		}
+	}
+
+	private struct Counters {
+		var messagesSent = 0
+		var messagesReceived = 0
+		var bytesSent = 0
+		var bytesReceived = 0
+		var ringMessagesSent = 0
+		var framesSent = 0
+		var batchesSent = 0
+		var ringStalls = 0
+		var replyFailures = 0
+		var roundTrips = 0
+		var totalRoundTripNanoseconds: UInt64 = 0
+		var maximumRoundTripNanoseconds: UInt64 = 0
+	}
+}
+
+// MARK: - Protocol
+
+/// The fixed-size start of every frame on the channel. Both ends are on the same machine,
+/// so fields are in host byte order.
+struct TransportHeader: Sendable {
+	static let size = 40
+	static let releasedOffset = 16
+
+	enum Kind: UInt8, Sendable {
+		/// Carries the path of the sender's ring in the payload and its size in `length`.
+		case hello = 1
+		/// One message.
+		case message
+		/// Several messages, each a `UInt32` size followed by a message frame.
+		case batch
+		/// Nothing but the `released` cursor.
+		case release
+	}
+
+	struct Flags: OptionSet, Sendable {
+		let rawValue: UInt8
+
+		static let expectsReply = Flags(rawValue: 1 << 0)
+		static let isReply = Flags(rawValue: 1 << 1)
+		/// The payload is `length` bytes at `position` in the sender's ring.
+		static let inRing = Flags(rawValue: 1 << 2)
+		/// A reply with no data, as opposed to empty data.
+		static let noData = Flags(rawValue: 1 << 3)
+	}
+
+	var kind: Kind
+	var flags: Flags = []
+	var messageID: Int32 = 0
+	/// Matches a reply to its request.
+	var sequence: UInt64 = 0
+	/// How far the sender of this frame has finished reading the receiver's ring.
+	var released: UInt64 = 0
+	var position: UInt64 = 0
+	var length: UInt64 = 0
+
+	init(kind: Kind) {
+		self.kind = kind
+	}
+
+	init?(_ frame: UnsafeRawBufferPointer) {
+		guard frame.count >= TransportHeader.size, let kind = Kind(rawValue: frame[0]) else {
+			return nil
+		}
+		self.kind = kind
+		flags = Flags(rawValue: frame[1])
+		messageID = frame.loadUnaligned(fromByteOffset: 4, as: Int32.self)
+		sequence = frame.loadUnaligned(fromByteOffset: 8, as: UInt64.self)
+		released = frame.loadUnaligned(fromByteOffset: TransportHeader.releasedOffset, as: UInt64.self)
+		position = frame.loadUnaligned(fromByteOffset: 24, as: UInt64.self)
+		length = frame.loadUnaligned(fromByteOffset: 32, as: UInt64.self)
+	}
+
+	func write(to buffer: UnsafeMutableRawBufferPointer) {
+		buffer[0] = kind.rawValue
+		buffer[1] = flags.rawValue
+		buffer[2] = 0
+		buffer[3] = 0
+		buffer.storeBytes(of: messageID, toByteOffset: 4, as: Int32.self)
+		buffer.storeBytes(of: sequence, toByteOffset: 8, as: UInt64.self)
+		buffer.storeBytes(of: released, toByteOffset: TransportHeader.releasedOffset, as: UInt64.self)
+		buffer.storeBytes(of: position, toByteOffset: 24, as: UInt64.self)
+		buffer.storeBytes(of: length, toByteOffset: 32, as: UInt64.self)
+	}
+}
+
+extension Data {
+	/// A frame with `header` followed by `payloadCount` bytes written by `fill`.
+	fileprivate init(encoding header: TransportHeader, payloadCount: Int, fill: (UnsafeMutableRawBufferPointer) throws -> Void) rethrows {
+		self.init(count: TransportHeader.size + payloadCount)
+		try withUnsafeMutableBytes { buffer in
+			header.write(to: buffer)
+			try fill(UnsafeMutableRawBufferPointer(rebasing: buffer[TransportHeader.size...]))
+		}
+	}
+
+	/// A frame with `header` followed by a copy of `payload`.
+	fileprivate init(encoding header: TransportHeader, payload: UnsafeRawBufferPointer?) {
+		self.init(encoding: header, payloadCount: payload?.count ?? 0) { buffer in
+			if let payload, payload.count > 0 {
+				buffer.copyMemory(from: payload)
+			}
+		}
+	}
+}
+
+/// The sending end's bookkeeping for its ring.
+///
+/// Space is handed out in order, each payload contiguous and cache-line aligned, and comes
+/// back in order as the peer reports how far it has finished. Positions count bytes ever
+/// handed out, so they never wrap.
+struct RingAllocator {
+	static let alignment = 64
+
+	let capacity: Int
+	/// The end of the last payload handed out.
+	private(set) var head: UInt64 = 0
+	/// Everything before this is free again.
+	private(set) var released: UInt64 = 0
+
+	init(capacity: Int) {
+		precondition(capacity % RingAllocator.alignment == 0, "The capacity must be a multiple of \(RingAllocator.alignment)")
+		self.capacity = capacity
+	}
+
+	static func alignedLength(_ length: Int) -> Int {
+		return (Swift.max(length, 1) + alignment - 1) & ~(alignment - 1)
+	}
+
+	/// Reserves space for a payload.
+	/// - returns: The position of the payload, or `nil` if there isn't room until the peer
+	/// frees some.
+	mutating func reserve(_ length: Int) -> UInt64? {
+		let length = RingAllocator.alignedLength(length)
+		precondition(length <= capacity, "The payload is larger than the ring")
+		var start = head
+		let offset = Int(start % UInt64(capacity))
+		if offset + length > capacity {
+			// Skip the tail so the payload is contiguous.
+			start += UInt64(capacity - offset)
+		}
+		guard start + UInt64(length) - released <= UInt64(capacity) else {
+			return nil
+		}
+		head = start + UInt64(length)
+		return start
+	}
+
+	/// Frees everything before `position`.
+	/// - returns: `true` if that freed more space.
+	@discardableResult
+	mutating func release(through position: UInt64) -> Bool {
+		let aligned = (Swift.min(position, head) + UInt64(RingAllocator.alignment - 1)) & ~UInt64(RingAllocator.alignment - 1)
+		guard aligned > released else {
+			return false
+		}
+		released = Swift.min(aligned, head)
+		return true
+	}
+}
+
+/// The receiving end's bookkeeping for the peer's ring: turns payloads finished in any
+/// order into the in-order cursor the peer can free up to.
+struct RingReleaseTracker {
+	/// The end of every payload that arrived and isn't released yet, in arrival order.
+	private var outstanding = [UInt64]()
+	private var first = 0
+	private var finishedEnds = Set<UInt64>()
+	/// Everything before this in the peer's ring is done with.
+	private(set) var released: UInt64 = 0
+
+	mutating func arrived(end: UInt64) {
+		outstanding.append(end)
+	}
+
+	mutating func finished(end: UInt64) {
+		finishedEnds.insert(end)
+		while first < outstanding.count, finishedEnds.remove(outstanding[first]) != nil {
+			released = outstanding[first]
+			first += 1
+		}
+		if first > 1024 && first * 2 > outstanding.count {
+			outstanding.removeFirst(first)
+			first = 0
+		}
+	}
+}
+
+// MARK: - Shared memory
+
+/// Memory shared with another process through a mapped file.
+final class SharedMemoryRegion: @unchecked Sendable {
+	let baseAddress: UnsafeMutableRawPointer
+	let count: Int
+	let path: String
+
+	/// The start of the name of every ring file.
+	private static let namePrefix = "SharedMemoryTransport-"
+
+	/// Where ring files are made.
+	private static var directory: String {
+		return FileManager.default.fileExists(atPath: "/dev/shm") ? "/dev/shm" : NSTemporaryDirectory()
+	}
+
+	/// Whether `path` could have been made by ``init(creatingWithCount:)``: a file in the
+	/// ring directory named with the prefix, a process ID and a UUID.
+	static func isRingPath(_ path: String) -> Bool {
+		let prefix = (directory as NSString).appendingPathComponent(namePrefix)
+		guard path.hasPrefix(prefix) else {
+			return false
+		}
+		let name = path.dropFirst(prefix.count)
+		guard let dash = name.firstIndex(of: "-") else {
+			return false
+		}
+		let processID = name[..<dash]
+		return !processID.isEmpty && processID.allSatisfy({ ("0" ... "9").contains($0) }) && UUID(uuidString: String(name[name.index(after: dash)...])) != nil
+	}
+
+	/// Creates a new zero-filled file of `count` bytes and maps it read-write.
+	init(creatingWithCount count: Int) throws {
+		path = (SharedMemoryRegion.directory as NSString).appendingPathComponent("\(SharedMemoryRegion.namePrefix)\(getpid())-\(UUID().uuidString)")
+		self.count = count
+		let fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0o600)
+		guard fd >= 0 else {
+			throw CocoaError(.fileWriteNoPermission, userInfo: [NSFilePathErrorKey: path])
+		}
+		defer {
+			close(fd)
+		}
+		// MAP_FAILED isn't imported on every platform.
+		guard ftruncate(fd, off_t(count)) == 0, let address = mmap(nil, count, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0), address != UnsafeMutableRawPointer(bitPattern: -1) else {
+			unlink(path)
+			throw CocoaError(.fileWriteOutOfSpace, userInfo: [NSFilePathErrorKey: path])
+		}
+		baseAddress = address
+	}
+
+	/// Maps a file made by ``init(creatingWithCount:)`` in another process read-only, then
+	/// deletes it; the mapping keeps the memory alive. The file must be exactly `count` bytes.
+	init(openingAt path: String, count: Int) throws {
+		self.path = path
+		self.count = count
+		let fd = open(path, O_RDONLY | O_NOFOLLOW)
+		guard fd >= 0 else {
+			throw CocoaError(.fileReadNoSuchFile, userInfo: [NSFilePathErrorKey: path])
+		}
+		defer {
+			close(fd)
+		}
+		var info = stat()
+		guard count > 0, fstat(fd, &info) == 0, (info.st_mode & S_IFMT) == S_IFREG, Int(info.st_size) == count,
+			  let address = mmap(nil, count, PROT_READ, MAP_SHARED, fd, 0), address != UnsafeMutableRawPointer(bitPattern: -1) else {
+			throw CocoaError(.fileReadCorruptFile, userInfo: [NSFilePathErrorKey: path])
+		}
+		baseAddress = address
+		unlink(path)
+	}
+
+	deinit {
+		munmap(baseAddress, count)
+	}
+
+	/// Deletes the file, if it's still there. The mapping stays valid.
+	func removeFile() {
+		unlink(path)
+	}
+}
+
+// MARK: - Unix domain sockets
+
+#if os(Linux)
+private let streamSocketType = Int32(SOCK_STREAM.rawValue)
+private let sendFlags = Int32(MSG_NOSIGNAL)
+#else
+private let streamSocketType = SOCK_STREAM
+private let sendFlags: Int32 = 0
+#endif
+
+private func currentPOSIXError() -> POSIXError {
+	return POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+}
+
+private func makeUnixSocket() throws -> Int32 {
+	let fd = socket(AF_UNIX, streamSocketType, 0)
+	guard fd >= 0 else {
+		throw currentPOSIXError()
+	}
+	disableSIGPIPE(fd)
+	return fd
+}
+
+private func disableSIGPIPE(_ fd: Int32) {
+#if canImport(Darwin)
+	var on: Int32 = 1
+	setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, socklen_t(MemoryLayout<Int32>.size))
+#endif
+}
+
+/// Calls `body` with a `sockaddr_un` for `path`.
+private func withUnixAddress<R>(_ path: String, _ body: (UnsafePointer<sockaddr>, socklen_t) -> R) throws -> R {
+	var address = sockaddr_un()
+	address.sun_family = sa_family_t(AF_UNIX)
+	let bytes = Array(path.utf8)
+	guard bytes.count < MemoryLayout.size(ofValue: address.sun_path) else {
+		throw POSIXError(.ENAMETOOLONG)
+	}
+	withUnsafeMutableBytes(of: &address.sun_path) { pathBytes in
+		pathBytes.copyBytes(from: bytes)
+		pathBytes[bytes.count] = 0
+	}
+#if canImport(Darwin)
+	address.sun_len = UInt8(MemoryLayout<sockaddr_un>.size)
+#endif
+	return withUnsafePointer(to: &address) { pointer in
+		pointer.withMemoryRebound(to: sockaddr.self, capacity: 1) { body($0, socklen_t(MemoryLayout<sockaddr_un>.size)) }
+	}
+}
+
+private func closeSocket(_ fd: Int32) {
+	close(fd)
+}
+
+private func shutdownSocket(_ fd: Int32) {
+	shutdown(fd, Int32(SHUT_RDWR))
+}
+
+private func writeFully(_ fd: Int32, _ buffer: UnsafeRawBufferPointer) throws {
+	var offset = 0
+	while offset < buffer.count {
+		let written = send(fd, buffer.baseAddress! + offset, buffer.count - offset, sendFlags)
+		if written < 0 {
+			if errno == EINTR {
+				continue
+			}
+			throw currentPOSIXError()
+		}
+		offset += written
+	}
+}
+
+/// - returns: `false` at the end of the stream or on an error.
+private func readFully(_ fd: Int32, _ buffer: UnsafeMutableRawBufferPointer) -> Bool {
+	var offset = 0
+	while offset < buffer.count {
+		let count = recv(fd, buffer.baseAddress! + offset, buffer.count - offset, 0)
+		if count < 0 && errno == EINTR {
+			continue
+		}
+		guard count > 0 else {
+			return false
+		}
+		offset += count
+	}
+	return true
+}
+
+/// A ``SharedMemoryChannel`` over a Unix domain stream socket, with each frame prefixed by
+/// its size.
+///
+/// Works wherever Unix domain sockets do, which makes it a stand-in for `CFMessagePort`
+/// on Linux and in tests.
+public final class UnixSocketChannel: SharedMemoryChannel, @unchecked Sendable {
+	/// The largest frame the channel accepts: 1GiB.
+	public var maximumFrameSize: Int {
+		return 1 << 30
+	}
+
+	/// Only closed in `deinit`, so the descriptor number can't be reused while a send or the
+	/// reader thread still uses it. ``close()`` shuts the socket down instead.
+	private let socket: Int32
+	private let lock = NSLock()
+	private var started = false
+	private var closed = false
+	private var closeHandler: (@Sendable () -> Void)?
+
+	/// Creates a channel over a connected stream socket, which it takes ownership of.
+	public init(socket: Int32) {
+		self.socket = socket
+		disableSIGPIPE(socket)
+	}
+
+	/// Connects to a socket made by a ``UnixSocketListener``.
+	/// - parameter path: The path of the socket.
+	/// - throws: A `POSIXError` if the connection fails.
+	public convenience init(connectingTo path: String) throws {
+		let fd = try makeUnixSocket()
+		let result = try withUnixAddress(path) { connect(fd, $0, $1) }
+		guard result == 0 else {
+			let error = currentPOSIXError()
+			closeSocket(fd)
+			throw error
+		}
+		self.init(socket: fd)
+	}
+
+	/// Creates two channels connected to each other.
+	public static func makePair() throws -> (UnixSocketChannel, UnixSocketChannel) {
+		var fds: [Int32] = [-1, -1]
+		guard socketpair(AF_UNIX, streamSocketType, 0, &fds) == 0 else {
+			throw currentPOSIXError()
+		}
+		return (UnixSocketChannel(socket: fds[0]), UnixSocketChannel(socket: fds[1]))
+	}
+
+	deinit {
+		closeSocket(socket)
+	}
+
+	public func start(receiving frameHandler: @escaping @Sendable (UnsafeRawBufferPointer) -> Void, closed closeHandler: @escaping @Sendable () -> Void) throws {
+		lock.lock()
+		guard !started, !closed else {
+			lock.unlock()
+			throw SharedMemoryTransportError.invalid
+		}
+		started = true
+		self.closeHandler = closeHandler
+		lock.unlock()
+
+		// The reader thread keeps the channel, and so the socket, alive until the stream ends.
+		let thread = Thread { [self] in
+			var buffer = UnsafeMutableRawBufferPointer.allocate(byteCount: 65536, alignment: 16)
+			defer {
+				buffer.deallocate()
+			}
+			var size: UInt32 = 0
+			while withUnsafeMutableBytes(of: &size, { readFully(socket, $0) }) {
+				let count = Int(size)
+				guard count <= maximumFrameSize else {
+					break
+				}
+				if count > buffer.count {
+					buffer.deallocate()
+					buffer = .allocate(byteCount: count, alignment: 16)
+				}
+				let frame = UnsafeMutableRawBufferPointer(rebasing: buffer[0 ..< count])
+				guard readFully(socket, frame) else {
+					break
+				}
+				frameHandler(UnsafeRawBufferPointer(frame))
+			}
+			close()
+		}
+		thread.name = "UnixSocketChannel"
+		thread.qualityOfService = .userInitiated
+		thread.start()
+	}
+
+	public func send(_ frame: UnsafeRawBufferPointer) throws {
+		guard frame.count <= maximumFrameSize else {
+			throw SharedMemoryTransportError.payloadTooLarge
+		}
+		lock.lock()
+		let isClosed = closed
+		lock.unlock()
+		guard !isClosed else {
+			throw SharedMemoryTransportError.invalid
+		}
+		var size = UInt32(frame.count)
+		try withUnsafeBytes(of: &size) { try writeFully(socket, $0) }
+		try writeFully(socket, frame)
+	}
+
+	public func close() {
+		lock.lock()
+		guard !closed else {
+			lock.unlock()
+			return
+		}
+		closed = true
+		let handler = closeHandler
+		closeHandler = nil
+		lock.unlock()
+		// Wakes the reader thread, and fails sends in progress. The descriptor stays open
+		// until deinit.
+		shutdownSocket(socket)
+		handler?()
+	}
+}
+
+/// Listens for ``UnixSocketChannel`` connections on a path.
+public final class UnixSocketListener: @unchecked Sendable {
+	/// The path of the socket.
+	public let path: String
+	private let socket: Int32
+	private let lock = NSLock()
+	private var closed = false
+
+	/// Creates the socket at `path`, which must not exist yet.
+	/// - throws: A `POSIXError` if the socket can't be created.
+	public init(path: String, backlog: Int32 = 8) throws {
+		self.path = path
+		socket = try makeUnixSocket()
+		let fd = socket
+		let result = try withUnixAddress(path) { bind(fd, $0, $1) }
+		guard result == 0, listen(fd, backlog) == 0 else {
+			let error = currentPOSIXError()
+			closeSocket(fd)
+			throw error
+		}
+	}
+
+	deinit {
+		close()
+	}
+
+	/// Waits for a connection.
+	/// - throws: A `POSIXError` if accepting fails, including after ``close()``.
+	public func accept() throws -> UnixSocketChannel {
+		while true {
+			let fd = acceptConnection(socket)
+			if fd >= 0 {
+				return UnixSocketChannel(socket: fd)
+			}
+			if errno != EINTR {
+				throw currentPOSIXError()
+			}
+		}
+	}
+
+	/// Stops listening and deletes the socket file.
+	public func close() {
+		lock.lock()
+		defer {
+			lock.unlock()
+		}
+		guard !closed else {
+			return
+		}
+		closed = true
+		shutdownSocket(socket)
+		closeSocket(socket)
+		unlink(path)
+	}
+}
+
+private func acceptConnection(_ fd: Int32) -> Int32 {
+	return accept(fd, nil, nil)
+}
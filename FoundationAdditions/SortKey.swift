@@ -0,0 +1,318 @@
+//
+//  SortKey.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// A key to sort elements of type `Root` by, and the direction to sort in.
+///
+/// When sorting with an array of sort keys, the value of each key is read once per element
+/// into its own column, and the sort only compares the columns. Later keys are only
+/// compared when all the earlier keys are equal.
+public struct SortKey<Root> {
+	/// Reads the key of every element into a column, and returns a function that compares
+	/// the column values at two element indexes.
+	@usableFromInline
+	internal let makeComparator: (UnsafeBufferPointer<Root>) -> (Int, Int) -> ComparisonResult
+
+	/// `true` if the key sorts from the smallest value to the largest.
+	public let ascending: Bool
+
+	@usableFromInline
+	internal init(ascending: Bool, makeComparator: @escaping (UnsafeBufferPointer<Root>) -> (Int, Int) -> ComparisonResult) {
+		self.ascending = ascending
+		self.makeComparator = makeComparator
+	}
+
+	/// Creates a sort key from a function that extracts a comparable value.
+	/// - parameter key: Returns the value to sort an element by.
+	/// - parameter ascending: `true` to sort from the smallest value to the largest.
+	/// Default is `true`.
+	public init<Value: Comparable>(_ key: @escaping (Root) -> Value, ascending: Bool = true) {
+		self.init(ascending: ascending) { (elements) -> (Int, Int) -> ComparisonResult in
+			let column = ContiguousArray(elements.lazy.map(key))
+			let before: ComparisonResult = ascending ? .orderedAscending : .orderedDescending
+			let after: ComparisonResult = ascending ? .orderedDescending : .orderedAscending
+			return { (lhs, rhs) -> ComparisonResult in
+				let left = column[lhs]
+				let right = column[rhs]
+				if left < right {
+					return before
+				} else if right < left {
+					return after
+				}
+				return .orderedSame
+			}
+		}
+	}
+
+	/// Creates a sort key from a key path to a comparable property.
+	/// - parameter keyPath: The property to sort by.
+	/// - parameter ascending: `true` to sort from the smallest value to the largest.
+	/// Default is `true`.
+	public init<Value: Comparable>(_ keyPath: KeyPath<Root, Value>, ascending: Bool = true) {
+		self.init({ $0[keyPath: keyPath] }, ascending: ascending)
+	}
+
+	/// Creates a sort key from a key path to an optional comparable property.
+	///
+	/// `nil` values sort before all other values when ascending, like `NSSortDescriptor`.
+	/// - parameter keyPath: The property to sort by.
+	/// - parameter ascending: `true` to sort from the smallest value to the largest.
+	/// Default is `true`.
+	public init<Value: Comparable>(_ keyPath: KeyPath<Root, Value?>, ascending: Bool = true) {
+		self.init(keyPath, ascending: ascending) { (lhs, rhs) -> ComparisonResult in
+			switch (lhs, rhs) {
+			case (nil, nil):
+				return .orderedSame
+			case (nil, _):
+				return .orderedAscending
+			case (_, nil):
+				return .orderedDescending
+			case let (left?, right?):
+				return left < right ? .orderedAscending : (right < left ? .orderedDescending : .orderedSame)
+			}
+		}
+	}
+
+	/// Creates a sort key from a key path and a function that compares its values.
+	/// - parameter keyPath: The property to sort by.
+	/// - parameter ascending: `true` to keep the order returned by `comparator`,
+	/// `false` to reverse it. Default is `true`.
+	/// - parameter comparator: Compares two values of the property.
+	public init<Value>(_ keyPath: KeyPath<Root, Value>, ascending: Bool = true, by comparator: @escaping (Value, Value) -> ComparisonResult) {
+		self.init(ascending: ascending) { (elements) -> (Int, Int) -> ComparisonResult in
+			let column = ContiguousArray(elements.lazy.map { $0[keyPath: keyPath] })
+			return { (lhs, rhs) -> ComparisonResult in
+				let result = comparator(column[lhs], column[rhs])
+				return ascending ? result : SortKey.flipped(result)
+			}
+		}
+	}
+
+	/// Creates a sort key that compares the elements themselves.
+	/// - parameter ascending: `true` to keep the order returned by `comparator`,
+	/// `false` to reverse it. Default is `true`.
+	/// - parameter comparator: Compares two elements.
+	public init(ascending: Bool = true, by comparator: @escaping (Root, Root) -> ComparisonResult) {
+		self.init(ascending: ascending) { (elements) -> (Int, Int) -> ComparisonResult in
+			return { (lhs, rhs) -> ComparisonResult in
+				let result = comparator(elements[lhs], elements[rhs])
+				return ascending ? result : SortKey.flipped(result)
+			}
+		}
+	}
+
+	/// The same key, sorted in the opposite direction.
+	public var reversed: SortKey<Root> {
+		let make = makeComparator
+		return SortKey(ascending: !ascending) { (elements) -> (Int, Int) -> ComparisonResult in
+			let compare = make(elements)
+			return { (lhs, rhs) -> ComparisonResult in
+				return SortKey.flipped(compare(lhs, rhs))
+			}
+		}
+	}
+
+	@inline(__always)
+	private static func flipped(_ result: ComparisonResult) -> ComparisonResult {
+		switch result {
+		case .orderedAscending:
+			return .orderedDescending
+		case .orderedDescending:
+			return .orderedAscending
+		case .orderedSame:
+			return .orderedSame
+		}
+	}
+}
+
+/// A type that can provide native sort keys for `NSSortDescriptor`s, so arrays of it
+/// sorted with `sorted(using: [NSSortDescriptor])` don't go through key-value coding
+/// for every comparison.
+public protocol SortKeyProviding {
+	/// Returns a sort key that orders elements the same way as `descriptor`,
+	/// or `nil` if the descriptor's key isn't a known property.
+	static func sortKey(for descriptor: NSSortDescriptor) -> SortKey<Self>?
+}
+
+// MARK: - Sorting
+
+/// Arrays with fewer elements than this are sorted on one thread even if asked to sort concurrently.
+private let concurrentSortThreshold = 1 << 15
+
+/// Runs shorter than this are sorted with insertion sort.
+private let insertionSortCutoff = 24
+
+/// A stable merge sort of element indexes.
+private struct IndexMergeSort {
+	let compare: [(Int, Int) -> ComparisonResult]
+
+	@inline(__always)
+	func less(_ lhs: Int, _ rhs: Int) -> Bool {
+		for comparator in compare {
+			switch comparator(lhs, rhs) {
+			case .orderedAscending:
+				return true
+			case .orderedDescending:
+				return false
+			case .orderedSame:
+				continue
+			}
+		}
+		return false
+	}
+
+	func insertionSort(_ indexes: UnsafeMutableBufferPointer<Int>, _ range: Range<Int>) {
+		guard range.count > 1 else {
+			return
+		}
+		for i in (range.lowerBound + 1) ..< range.upperBound {
+			let moving = indexes[i]
+			var j = i
+			while j > range.lowerBound && less(moving, indexes[j - 1]) {
+				indexes[j] = indexes[j - 1]
+				j -= 1
+			}
+			indexes[j] = moving
+		}
+	}
+
+	/// Merges the sorted runs `lo ..< mid` and `mid ..< hi`, using `scratch` for the left run.
+	/// Ties are taken from the left run, which keeps the sort stable.
+	func merge(_ indexes: UnsafeMutableBufferPointer<Int>, _ scratch: UnsafeMutableBufferPointer<Int>, _ lo: Int, _ mid: Int, _ hi: Int) {
+		guard lo < mid, mid < hi, less(indexes[mid], indexes[mid - 1]) else {
+			return
+		}
+		(scratch.baseAddress! + lo).update(from: indexes.baseAddress! + lo, count: mid - lo)
+		var i = lo
+		var j = mid
+		var k = lo
+		while i < mid && j < hi {
+			if less(indexes[j], scratch[i]) {
+				indexes[k] = indexes[j]
+				j += 1
+			} else {
+				indexes[k] = scratch[i]
+				i += 1
+			}
+			k += 1
+		}
+		while i < mid {
+			indexes[k] = scratch[i]
+			i += 1
+			k += 1
+		}
+	}
+
+	func sort(_ indexes: UnsafeMutableBufferPointer<Int>, _ scratch: UnsafeMutableBufferPointer<Int>, _ range: Range<Int>) {
+		if range.count <= insertionSortCutoff {
+			insertionSort(indexes, range)
+			return
+		}
+		let mid = range.lowerBound + range.count / 2
+		sort(indexes, scratch, range.lowerBound ..< mid)
+		sort(indexes, scratch, mid ..< range.upperBound)
+		merge(indexes, scratch, range.lowerBound, mid, range.upperBound)
+	}
+
+	/// Sorts chunks on separate threads, then merges pairs of runs in parallel rounds.
+	func concurrentSort(_ indexes: UnsafeMutableBufferPointer<Int>, _ scratch: UnsafeMutableBufferPointer<Int>) {
+		let count = indexes.count
+		let chunkCount = Swift.min(ProcessInfo.processInfo.activeProcessorCount * 2, count / insertionSortCutoff)
+		let chunkSize = (count + chunkCount - 1) / chunkCount
+		DispatchQueue.concurrentPerform(iterations: chunkCount) { (chunk) in
+			let start = Swift.min(chunk * chunkSize, count)
+			sort(indexes, scratch, start ..< Swift.min(start + chunkSize, count))
+		}
+		var width = chunkSize
+		while width < count {
+			let pairs = (count + 2 * width - 1) / (2 * width)
+			DispatchQueue.concurrentPerform(iterations: pairs) { (pair) in
+				let lo = pair * 2 * width
+				let mid = Swift.min(lo + width, count)
+				merge(indexes, scratch, lo, mid, Swift.min(lo + 2 * width, count))
+			}
+			width *= 2
+		}
+	}
+}
+
+public extension Collection {
+	/// Returns the indexes, from `0`, of the elements in the order given by `keys`.
+	///
+	/// Each key is read once per element. The sort is stable: elements that compare equal for
+	/// every key keep their relative order.
+	/// - parameter keys: The keys to sort by, most significant first.
+	/// - parameter concurrently: If `true` and there are enough elements, the sort runs on multiple cores.
+	/// Default is `false`.
+	func sortedOffsets(using keys: [SortKey<Element>], concurrently: Bool = false) -> [Int] {
+		let elements = ContiguousArray(self)
+		return elements.withUnsafeBufferPointer { (elements) -> [Int] in
+			var indexes = Array(0 ..< elements.count)
+			guard elements.count > 1, !keys.isEmpty else {
+				return indexes
+			}
+			let sorter = IndexMergeSort(compare: keys.map { $0.makeComparator(elements) })
+			var scratch = [Int](repeating: 0, count: elements.count)
+			indexes.withUnsafeMutableBufferPointer { (indexes) in
+				scratch.withUnsafeMutableBufferPointer { (scratch) in
+					if concurrently && indexes.count >= concurrentSortThreshold && ProcessInfo.processInfo.activeProcessorCount > 1 {
+						sorter.concurrentSort(indexes, scratch)
+					} else {
+						sorter.sort(indexes, scratch, 0 ..< indexes.count)
+					}
+				}
+			}
+			return indexes
+		}
+	}
+
+	/// Returns the elements, sorted by several keys.
+	///
+	/// Each key is read once per element. The sort is stable: elements that compare equal for
+	/// every key keep their relative order.
+	/// - parameter keys: The keys to sort by, most significant first.
+	/// - parameter concurrently: If `true` and there are enough elements, the sort runs on multiple cores.
+	/// Default is `false`.
+	func sorted(using keys: [SortKey<Element>], concurrently: Bool = false) -> [Element] {
+		let elements = Array(self)
+		return sortedOffsets(using: keys, concurrently: concurrently).map { elements[$0] }
+	}
+}
+
+public extension MutableCollection where Self: RandomAccessCollection {
+	/// Sorts the collection in place by several keys.
+	///
+	/// Each key is read once per element. The sort is stable: elements that compare equal for
+	/// every key keep their relative order.
+	/// - parameter keys: The keys to sort by, most significant first.
+	/// - parameter concurrently: If `true` and there are enough elements, the sort runs on multiple cores.
+	/// Default is `false`.
+	mutating func sort(using keys: [SortKey<Element>], concurrently: Bool = false) {
+		let sortedElements = sorted(using: keys, concurrently: concurrently)
+		for (idx, element) in zip(indices, sortedElements) {
+			self[idx] = element
+		}
+	}
+}
+
+extension Array where Element: SortKeyProviding {
+	/// Sorts with native sort keys if every descriptor resolves to one.
+	/// - returns: The sorted array, or `nil` if a descriptor didn't resolve.
+	func sortedNatively(using descriptors: [NSSortDescriptor]) -> [Element]? {
+		var keys = [SortKey<Element>]()
+		keys.reserveCapacity(descriptors.count)
+		for descriptor in descriptors {
+			guard let key = Element.sortKey(for: descriptor) else {
+				return nil
+			}
+			keys.append(key)
+		}
+		return sorted(using: keys, concurrently: count >= concurrentSortThreshold)
+	}
+}
@@ -0,0 +1,454 @@
+//
+//  SoundBankIndex.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// Errors from reading a SoundFont 2 or DLS bank.
+public enum SoundBankError: Error, Hashable, Sendable {
+	/// The file isn't a SoundFont 2 or DLS bank.
+	case unknownFormat
+	/// A chunk the format needs is missing.
+	case missingChunk(FourCharacterCode)
+	/// A chunk is shorter than its contents, or runs past the end of the file.
+	case truncated(FourCharacterCode)
+}
+
+/// One instrument (DLS) or preset (SoundFont 2) in a sound bank.
+///
+/// The bank numbers are the ones the DLS synth and the Sampler Audio Unit expect, the same as
+/// AudioToolbox's `CopyInstrumentInfoFromSoundBank` returns.
+public struct SoundBankInstrument: Hashable, Codable, Sendable {
+	/// The name of the instrument.
+	public var name: String
+	/// The most-significant byte of the bank number. Melodic General MIDI banks are
+	/// 121 (`0x79`), percussion banks 120 (`0x78`). Custom banks use their literal value.
+	public var msb: UInt8
+	/// The least-significant byte of the bank number, or the bank variation for General MIDI banks.
+	public var lsb: UInt8
+	/// The program number (0-127) of the instrument within its bank.
+	public var program: UInt8
+
+	public init(name: String, msb: UInt8, lsb: UInt8, program: UInt8) {
+		self.name = name
+		self.msb = msb
+		self.lsb = lsb
+		self.program = program
+	}
+}
+
+/// The name and instruments of a sound bank.
+public struct SoundBankInfo: Hashable, Codable, Sendable {
+	/// The kind of sound bank.
+	public enum Kind: String, Hashable, Codable, Sendable {
+		/// A SoundFont 2 bank.
+		case soundFont2
+		/// A Downloadable Sounds bank.
+		case dls
+	}
+
+	/// The kind of sound bank.
+	public var kind: Kind
+	/// The name in the bank's `INFO` list, or `nil` if it doesn't have one.
+	public var name: String?
+	/// The instruments, in the order they're stored in the bank.
+	public var instruments: [SoundBankInstrument]
+
+	/// Reads a sound bank by mapping it into memory. Only the chunks holding the names and
+	/// bank numbers are touched, so the samples are never paged in.
+	/// - parameter url: The file URL of the sound bank.
+	/// - throws: A `CocoaError` if the file can't be opened, or a
+	/// ``SoundBankError`` if it can't be parsed.
+	public init(contentsOf url: URL) throws {
+		try self.init(mapping: MappedRegion(url: url))
+	}
+
+	/// Parses a sound bank already in memory.
+	/// - parameter data: The contents of the sound bank.
+	public init(data: Data) throws {
+		try self.init(mapping: MappedRegion(data: data))
+	}
+
+	private init(mapping: MappedRegion) throws {
+		let parser = SoundBankParser(UnsafeRawBufferPointer(start: mapping.baseAddress, count: mapping.count))
+		self = try withExtendedLifetime(mapping) {
+			try parser.parse()
+		}
+	}
+}
+
+// MARK: - Index
+
+/// A cache of sound bank contents, keyed by path and invalidated when a file's size or
+/// modification date changes.
+///
+/// The index can be written out and loaded again, so listing a large library only has to
+/// parse the banks that changed since the last run. It is safe to use from multiple threads.
+public final class SoundBankIndex: @unchecked Sendable {
+	/// A cached sound bank, along with the file attributes it was read with.
+	private struct Entry: Codable {
+		var size: Int64
+		var modificationDate: Date
+		var info: SoundBankInfo
+	}
+
+	private struct Archive: Codable {
+		var version: Int
+		var entries: [String: Entry]
+	}
+
+	private static let archiveVersion = 1
+
+	/// The file extensions ``scan(directory:)`` looks for, lowercased.
+	public static let fileExtensions: Set<String> = ["sf2", "dls"]
+
+	private let lock = NSLock()
+	private var entries: [String: Entry]
+
+	/// Creates an empty index.
+	public init() {
+		entries = [:]
+	}
+
+	/// Loads an index written by ``write(to:)``.
+	/// - parameter url: The file to read.
+	public init(contentsOf url: URL) throws {
+		let archive = try PropertyListDecoder().decode(Archive.self, from: Data(contentsOf: url))
+		guard archive.version == SoundBankIndex.archiveVersion else {
+			throw CocoaError(.fileReadCorruptFile, userInfo: [NSURLErrorKey: url])
+		}
+		entries = archive.entries
+	}
+
+	/// Writes the index as a binary property list.
+	/// - parameter url: The file to write.
+	public func write(to url: URL) throws {
+		let encoder = PropertyListEncoder()
+		encoder.outputFormat = .binary
+		lock.lock()
+		let archive = Archive(version: SoundBankIndex.archiveVersion, entries: entries)
+		lock.unlock()
+		try encoder.encode(archive).write(to: url, options: .atomic)
+	}
+
+	/// The number of banks in the index.
+	public var count: Int {
+		lock.lock()
+		defer {
+			lock.unlock()
+		}
+		return entries.count
+	}
+
+	/// Returns the contents of a sound bank, parsing it only if it isn't in the index or has
+	/// changed since it was added.
+	/// - parameter url: The file URL of the sound bank.
+	public func info(at url: URL) throws -> SoundBankInfo {
+		let values = try url.resourceValues(forKeys: [.fileSizeKey, .contentModificationDateKey])
+		return try info(at: url, values: values)
+	}
+
+	private func info(at url: URL, values: URLResourceValues) throws -> SoundBankInfo {
+		let key = url.standardizedFileURL.path
+		let size = Int64(values.fileSize ?? -1)
+		let modificationDate = values.contentModificationDate ?? .distantPast
+		lock.lock()
+		let cached = entries[key]
+		lock.unlock()
+		if let cached, cached.size == size, cached.modificationDate == modificationDate {
+			return cached.info
+		}
+		let info: SoundBankInfo
+		do {
+			info = try SoundBankInfo(contentsOf: url)
+		} catch {
+			lock.lock()
+			entries[key] = nil
+			lock.unlock()
+			throw error
+		}
+		lock.lock()
+		entries[key] = Entry(size: size, modificationDate: modificationDate, info: info)
+		lock.unlock()
+		return info
+	}
+
+	/// Finds every sound bank under a directory and returns their contents, reading the new
+	/// and changed ones on several threads at once.
+	///
+	/// Files that can't be parsed are left out. Banks under `directory` that no longer exist
+	/// are removed from the index.
+	/// - parameter directory: The directory to search, including its subdirectories.
+	/// - returns: The contents of each bank, keyed by file URL.
+	public func scan(directory: URL) throws -> [URL: SoundBankInfo] {
+		let keys: [URLResourceKey] = [.isRegularFileKey, .fileSizeKey, .contentModificationDateKey]
+		guard let enumerator = FileManager.default.enumerator(at: directory, includingPropertiesForKeys: keys) else {
+			throw CocoaError(.fileReadNoSuchFile, userInfo: [NSURLErrorKey: directory])
+		}
+		var found = [(url: URL, values: URLResourceValues)]()
+		for case let url as URL in enumerator where SoundBankIndex.fileExtensions.contains(url.pathExtension.lowercased()) {
+			guard let values = try? url.resourceValues(forKeys: Set(keys)), values.isRegularFile == true else {
+				continue
+			}
+			found.append((url, values))
+		}
+
+		let results = UnsafeMutableBufferPointer<SoundBankInfo?>.allocate(capacity: found.count)
+		results.initialize(repeating: nil)
+		defer {
+			results.deinitialize()
+			results.deallocate()
+		}
+		DispatchQueue.concurrentPerform(iterations: found.count) { (index) in
+			results[index] = try? info(at: found[index].url, values: found[index].values)
+		}
+
+		let prefix = directory.standardizedFileURL.path + "/"
+		let present = Set(found.map({ $0.url.standardizedFileURL.path }))
+		lock.lock()
+		entries = entries.filter { (key, _) in
+			!key.hasPrefix(prefix) || present.contains(key)
+		}
+		lock.unlock()
+
+		var banks = [URL: SoundBankInfo](minimumCapacity: found.count)
+		for (bank, result) in zip(found, results) {
+			banks[bank.url] = result
+		}
+		return banks
+	}
+
+	/// Removes every bank from the index.
+	public func removeAll() {
+		lock.lock()
+		entries.removeAll()
+		lock.unlock()
+	}
+}
+
+// MARK: - Parsing
+
+/// Walks the RIFF chunks of a SoundFont 2 or DLS bank.
+private struct SoundBankParser {
+	let bytes: UnsafeRawBufferPointer
+
+	init(_ bytes: UnsafeRawBufferPointer) {
+		self.bytes = bytes
+	}
+
+	// Chunk identifiers.
+	static let riff: UInt32 = 0x52494646 // 'RIFF'
+	static let list: UInt32 = 0x4C495354 // 'LIST'
+	static let sfbk: UInt32 = 0x7366626B // 'sfbk'
+	static let dls: UInt32 = 0x444C5320 // 'DLS '
+	static let info: UInt32 = 0x494E464F // 'INFO'
+	static let inam: UInt32 = 0x494E414D // 'INAM'
+	static let pdta: UInt32 = 0x70647461 // 'pdta'
+	static let phdr: UInt32 = 0x70686472 // 'phdr'
+	static let lins: UInt32 = 0x6C696E73 // 'lins'
+	static let ins: UInt32 = 0x696E7320 // 'ins '
+	static let insh: UInt32 = 0x696E7368 // 'insh'
+
+	// Bank numbers the DLS synth and the Sampler use for General MIDI banks.
+	static let percussionBankMSB: UInt8 = 0x78
+	static let melodicBankMSB: UInt8 = 0x79
+
+	/// The size of an SF2 preset header.
+	static let presetHeaderSize = 38
+
+	func uint16(at offset: Int) -> UInt16 {
+		return UInt16(littleEndian: bytes.loadUnaligned(fromByteOffset: offset, as: UInt16.self))
+	}
+
+	func uint32(at offset: Int) -> UInt32 {
+		return UInt32(littleEndian: bytes.loadUnaligned(fromByteOffset: offset, as: UInt32.self))
+	}
+
+	func identifier(at offset: Int) -> UInt32 {
+		return UInt32(bigEndian: bytes.loadUnaligned(fromByteOffset: offset, as: UInt32.self))
+	}
+
+	func parse() throws -> SoundBankInfo {
+		guard bytes.count >= 12, identifier(at: 0) == SoundBankParser.riff else {
+			throw SoundBankError.unknownFormat
+		}
+		// Trust the file length over the RIFF size, as AudioToolbox does.
+		let end = bytes.count
+		switch identifier(at: 8) {
+		case SoundBankParser.sfbk:
+			return try parseSoundFont(12 ..< end)
+		case SoundBankParser.dls:
+			return try parseDLS(12 ..< end)
+		default:
+			throw SoundBankError.unknownFormat
+		}
+	}
+
+	/// Calls `body` with the identifier and body range of each chunk in `range`. A `LIST`
+	/// chunk's identifier is its list type, and its range starts after the type.
+	/// The bodies of other chunks are never read.
+	func forEachChunk(in range: Range<Int>, _ body: (_ id: UInt32, _ isList: Bool, _ range: Range<Int>) throws -> Void) throws {
+		var offset = range.lowerBound
+		while range.upperBound - offset >= 8 {
+			var id = identifier(at: offset)
+			let size = Int(uint32(at: offset + 4))
+			let start = offset + 8
+			guard size <= range.upperBound - start else {
+				throw SoundBankError.truncated(FourCharacterCode(id))
+			}
+			let isList = id == SoundBankParser.list
+			if isList {
+				guard size >= 4 else {
+					throw SoundBankError.truncated(FourCharacterCode(id))
+				}
+				id = identifier(at: start)
+				try body(id, true, start + 4 ..< start + size)
+			} else {
+				try body(id, false, start ..< start + size)
+			}
+			offset = start + size + (size & 1)
+		}
+	}
+
+	/// Decodes a string padded with zeros. Names are meant to be ASCII, but banks in the wild
+	/// use UTF-8 and Latin-1 too.
+	func string(in range: Range<Int>) -> String {
+		let raw = UnsafeRawBufferPointer(rebasing: bytes[range])
+		let length = raw.firstIndex(of: 0) ?? raw.count
+		let text = UnsafeRawBufferPointer(rebasing: raw[..<length])
+		if let string = String(bytes: text, encoding: .utf8) {
+			return string
+		}
+		return String(text.lazy.map({ Character(Unicode.Scalar($0)) }))
+	}
+
+	/// Reads the `INAM` entry of an `INFO` list.
+	func infoName(in range: Range<Int>) throws -> String? {
+		var name: String?
+		try forEachChunk(in: range) { (id, isList, chunk) in
+			if !isList && id == SoundBankParser.inam && name == nil {
+				name = string(in: chunk)
+			}
+		}
+		return name
+	}
+
+	// MARK: SoundFont 2
+
+	func parseSoundFont(_ range: Range<Int>) throws -> SoundBankInfo {
+		var name: String?
+		var presets: Range<Int>?
+		try forEachChunk(in: range) { (id, isList, chunk) in
+			guard isList else {
+				return
+			}
+			switch id {
+			case SoundBankParser.info:
+				name = try infoName(in: chunk)
+			case SoundBankParser.pdta:
+				try forEachChunk(in: chunk) { (id, isList, subchunk) in
+					if !isList && id == SoundBankParser.phdr {
+						presets = subchunk
+					}
+				}
+			default:
+				// Skips the sample data without touching it.
+				break
+			}
+		}
+		guard let presets else {
+			throw SoundBankError.missingChunk(FourCharacterCode(SoundBankParser.phdr))
+		}
+
+		// The last record only marks the end of the list.
+		let count = presets.count / SoundBankParser.presetHeaderSize - 1
+		guard count >= 0 else {
+			throw SoundBankError.truncated(FourCharacterCode(SoundBankParser.phdr))
+		}
+		var instruments = [SoundBankInstrument]()
+		instruments.reserveCapacity(count)
+		for index in 0 ..< count {
+			let record = presets.lowerBound + index * SoundBankParser.presetHeaderSize
+			let program = uint16(at: record + 20)
+			let bank = uint16(at: record + 22)
+			let msb: UInt8
+			let lsb: UInt8
+			if bank == 128 {
+				msb = SoundBankParser.percussionBankMSB
+				lsb = 0
+			} else {
+				// Banks above 128 aren't in the SF2 spec; they keep their low seven bits.
+				// SwiftAudioAdditionsTests checks this against AudioToolbox.
+				msb = SoundBankParser.melodicBankMSB
+				lsb = UInt8(truncatingIfNeeded: bank) & 0x7F
+			}
+			instruments.append(SoundBankInstrument(name: string(in: record ..< record + 20), msb: msb, lsb: lsb, program: UInt8(truncatingIfNeeded: program) & 0x7F))
+		}
+		return SoundBankInfo(kind: .soundFont2, name: name, instruments: instruments)
+	}
+
+	// MARK: DLS
+
+	func parseDLS(_ range: Range<Int>) throws -> SoundBankInfo {
+		var name: String?
+		var instruments: [SoundBankInstrument]?
+		try forEachChunk(in: range) { (id, isList, chunk) in
+			guard isList else {
+				return
+			}
+			switch id {
+			case SoundBankParser.info:
+				name = try infoName(in: chunk)
+			case SoundBankParser.lins:
+				var list = [SoundBankInstrument]()
+				try forEachChunk(in: chunk) { (id, isList, instrument) in
+					if isList && id == SoundBankParser.ins {
+						try list.append(parseDLSInstrument(instrument))
+					}
+				}
+				instruments = list
+			default:
+				// Skips the wave pool without touching it.
+				break
+			}
+		}
+		guard let instruments else {
+			throw SoundBankError.missingChunk(FourCharacterCode(SoundBankParser.lins))
+		}
+		return SoundBankInfo(kind: .dls, name: name, instruments: instruments)
+	}
+
+	func parseDLSInstrument(_ range: Range<Int>) throws -> SoundBankInstrument {
+		var locale: (bank: UInt32, instrument: UInt32)?
+		var name: String?
+		try forEachChunk(in: range) { (id, isList, chunk) in
+			switch (id, isList) {
+			case (SoundBankParser.insh, false):
+				guard chunk.count >= 12 else {
+					throw SoundBankError.truncated(FourCharacterCode(id))
+				}
+				locale = (uint32(at: chunk.lowerBound + 4), uint32(at: chunk.lowerBound + 8))
+			case (SoundBankParser.info, true):
+				name = try infoName(in: chunk)
+			default:
+				break
+			}
+		}
+		guard let locale else {
+			throw SoundBankError.missingChunk(FourCharacterCode(SoundBankParser.insh))
+		}
+		// ulBank holds CC 0 in bits 8-14, CC 32 in bits 0-6, and the drum flag in bit 31.
+		let msb: UInt8
+		if locale.bank & 0x8000_0000 != 0 {
+			msb = SoundBankParser.percussionBankMSB
+		} else {
+			let bankMSB = UInt8(truncatingIfNeeded: locale.bank >> 8) & 0x7F
+			msb = bankMSB == 0 ? SoundBankParser.melodicBankMSB : bankMSB
+		}
+		return SoundBankInstrument(name: name ?? "", msb: msb, lsb: UInt8(truncatingIfNeeded: locale.bank) & 0x7F, program: UInt8(truncatingIfNeeded: locale.instrument) & 0x7F)
+	}
+}
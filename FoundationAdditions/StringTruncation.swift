@@ -0,0 +1,174 @@
+//
+//  StringTruncation.swift
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+public extension String {
+	/// Encodings that strings can be truncated to a byte budget in.
+	enum TruncationEncoding: Hashable, Sendable {
+		/// UTF-8.
+		case utf8
+		/// UTF-16, little-endian, without a byte-order mark.
+		case utf16LittleEndian
+		/// UTF-16, big-endian, without a byte-order mark.
+		case utf16BigEndian
+		/// Mac OS Roman. Characters that can't be represented are written as a question mark.
+		case macOSRoman
+	}
+
+	/// The end index of the longest prefix made up of whole `Character`s
+	/// that is no longer than `maxCount` UTF-8 code units.
+	///
+	/// Only the prefix is scanned, once, so this is linear in `maxCount`, not the string length.
+	func truncationIndex(utf8 maxCount: Int) -> String.Index {
+		let view = utf8
+		guard maxCount > 0 else {
+			return startIndex
+		}
+		guard let cut = view.index(view.startIndex, offsetBy: maxCount, limitedBy: view.endIndex), cut != view.endIndex else {
+			return endIndex
+		}
+		// Two ASCII scalars always have a grapheme boundary between them,
+		// except for a carriage return followed by a line feed.
+		let before = view[view.index(before: cut)]
+		let after = view[cut]
+		if before < 0x80 && after < 0x80 && !(before == 0x0D && after == 0x0A) {
+			return cut
+		}
+		var idx = startIndex
+		var used = 0
+		while idx < endIndex {
+			let next = index(after: idx)
+			used += view.distance(from: idx, to: next)
+			if used > maxCount {
+				break
+			}
+			idx = next
+		}
+		return idx
+	}
+
+	/// The end index of the longest prefix made up of whole `Character`s
+	/// that is no longer than `maxCount` UTF-16 code units.
+	///
+	/// Only the prefix is scanned, once, so this is linear in `maxCount`, not the string length.
+	func truncationIndex(utf16 maxCount: Int) -> String.Index {
+		let view = utf16
+		guard maxCount > 0 else {
+			return startIndex
+		}
+		var idx = startIndex
+		var used = 0
+		while idx < endIndex {
+			let next = index(after: idx)
+			used += view.distance(from: idx, to: next)
+			if used > maxCount {
+				break
+			}
+			idx = next
+		}
+		return idx
+	}
+
+	/// Returns the Mac OS Roman byte for a `Character`, or `nil` if there isn't one.
+	private static func macOSRomanByte(for character: Character) -> UInt8? {
+		let scalars = character.unicodeScalars
+		if scalars.count == 1 {
+			return MacOSRoman.encode(scalars.first!)
+		}
+		let precomposed = String(character).precomposedStringWithCanonicalMapping.unicodeScalars
+		guard precomposed.count == 1 else {
+			return nil
+		}
+		return MacOSRoman.encode(precomposed.first!)
+	}
+
+	/// Writes as many whole `Character`s as fit in `buffer`, in the specified encoding.
+	/// - parameter buffer: The buffer to write the encoded characters to.
+	/// The number of bytes in the buffer is the byte budget.
+	/// - parameter encoding: The encoding to write the characters in.
+	/// - returns: The number of bytes written. The rest of `buffer` is left untouched.
+	func writeTruncated(to buffer: UnsafeMutableRawBufferPointer, encoding: TruncationEncoding) -> Int {
+		guard let base = buffer.baseAddress else {
+			return 0
+		}
+		switch encoding {
+		case .utf8:
+			let end = truncationIndex(utf8: buffer.count)
+			let view = utf8[..<end]
+			let count = view.count
+			guard count > 0 else {
+				return 0
+			}
+			if view.withContiguousStorageIfAvailable({ base.copyMemory(from: $0.baseAddress!, byteCount: count) }) == nil {
+				_ = UnsafeMutableRawBufferPointer(start: base, count: count).copyBytes(from: view)
+			}
+			return count
+
+		case .utf16LittleEndian, .utf16BigEndian:
+			let end = truncationIndex(utf16: buffer.count / 2)
+			var written = 0
+			let isBig = encoding == .utf16BigEndian
+			for unit in utf16[..<end] {
+				let value = isBig ? unit.bigEndian : unit.littleEndian
+				buffer.storeBytes(of: value, toByteOffset: written, as: UInt16.self)
+				written += 2
+			}
+			return written
+
+		case .macOSRoman:
+			var written = 0
+			for character in self {
+				guard written < buffer.count else {
+					break
+				}
+				buffer[written] = String.macOSRomanByte(for: character) ?? UInt8(ascii: "?")
+				written += 1
+			}
+			return written
+		}
+	}
+
+	/// Writes each string into a fixed-width field of a caller-provided buffer,
+	/// truncated to whole `Character`s, as used in fixed-width record formats.
+	///
+	/// String `i` is written to the bytes starting at `i * stride`; the rest of each
+	/// field is filled with zeros.
+	/// - parameter strings: The strings to write.
+	/// - parameter fieldWidth: The byte budget of each field.
+	/// - parameter stride: The distance, in bytes, between the start of each field.
+	/// Must be at least `fieldWidth`. Pass `nil` to use `fieldWidth`.
+	/// - parameter encoding: The encoding to write the strings in.
+	/// - parameter buffer: The buffer to write the fields to.
+	/// - parameter lengths: If not `nil`, receives the number of bytes used in each field.
+	/// - returns: The number of strings written, which stops early if `buffer` or `lengths` is full.
+	static func writeTruncated<S: Sequence>(_ strings: S, fieldWidth: Int, stride: Int? = nil, encoding: TruncationEncoding, into buffer: UnsafeMutableRawBufferPointer, lengths: UnsafeMutableBufferPointer<Int>? = nil) -> Int where S.Element: StringProtocol {
+		let stride = stride ?? fieldWidth
+		precondition(fieldWidth >= 0 && stride >= fieldWidth && stride > 0, "Invalid field width or stride")
+		var i = 0
+		for string in strings {
+			let start = i * stride
+			guard start + fieldWidth <= buffer.count else {
+				break
+			}
+			if let lengths, i >= lengths.count {
+				break
+			}
+			let field = UnsafeMutableRawBufferPointer(rebasing: buffer[start ..< start + fieldWidth])
+			let written = String(string).writeTruncated(to: field, encoding: encoding)
+			if written < fieldWidth {
+				UnsafeMutableRawBufferPointer(rebasing: field[written...]).initializeMemory(as: UInt8.self, repeating: 0)
+			}
+			if let lengths {
+				lengths[i] = written
+			}
+			i += 1
+		}
+		return i
+	}
+}
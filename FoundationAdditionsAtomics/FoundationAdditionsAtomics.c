@@ -0,0 +1,10 @@
+//
+//  FoundationAdditionsAtomics.c
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+// Everything is inline in the header; Swift Package Manager needs a source file for the target.
+#include "FoundationAdditionsAtomics.h"
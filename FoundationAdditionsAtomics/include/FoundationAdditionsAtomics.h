@@ -0,0 +1,82 @@
+//
+//  FoundationAdditionsAtomics.h
+//  FoundationAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+#ifndef FoundationAdditionsAtomics_h
+#define FoundationAdditionsAtomics_h
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// C11 atomics for FoundationAdditions, which has to run on systems older than the
+// `Synchronization` module. The values are plain integers so Swift can import the
+// types; the functions treat them as `_Atomic`, which has the same size and
+// alignment for these types.
+
+#define FAA_INLINE static inline __attribute__((always_inline))
+
+//! An `intptr_t` that is only accessed through the `FAAtomicInt` functions.
+typedef struct FAAtomicInt {
+	intptr_t value;
+} FAAtomicInt;
+
+//! An `int64_t` that is only accessed through the `FAAtomicInt64` functions.
+//!
+//! 64 bits even on 32-bit systems, for values that pack two 32-bit fields.
+typedef struct FAAtomicInt64 {
+	_Alignas(8) int64_t value;
+} FAAtomicInt64;
+
+//! `true` if the atomics in this header never take a lock on this system.
+FAA_INLINE bool FAAtomicsAreLockFree(void) {
+	return ATOMIC_POINTER_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2;
+}
+
+FAA_INLINE void FAAtomicIntInitialize(FAAtomicInt *_Nonnull atomic, intptr_t value) {
+	atomic_init((_Atomic(intptr_t) *)&atomic->value, value);
+}
+
+//! Loads the value with acquire ordering.
+FAA_INLINE intptr_t FAAtomicIntLoad(FAAtomicInt *_Nonnull atomic) {
+	return atomic_load_explicit((_Atomic(intptr_t) *)&atomic->value, memory_order_acquire);
+}
+
+//! Stores the value with release ordering.
+FAA_INLINE void FAAtomicIntStore(FAAtomicInt *_Nonnull atomic, intptr_t value) {
+	atomic_store_explicit((_Atomic(intptr_t) *)&atomic->value, value, memory_order_release);
+}
+
+//! Adds `delta`, wrapping on overflow, and returns the value from before the addition.
+FAA_INLINE intptr_t FAAtomicIntFetchAdd(FAAtomicInt *_Nonnull atomic, intptr_t delta) {
+	return atomic_fetch_add_explicit((_Atomic(intptr_t) *)&atomic->value, delta, memory_order_acq_rel);
+}
+
+//! Sets the value to `desired` if it is `*expected`. Otherwise, stores the current value in
+//! `*expected`.
+//! @return Whether the value was changed.
+FAA_INLINE bool FAAtomicIntCompareExchange(FAAtomicInt *_Nonnull atomic, intptr_t *_Nonnull expected, intptr_t desired) {
+	return atomic_compare_exchange_strong_explicit((_Atomic(intptr_t) *)&atomic->value, expected, desired, memory_order_acq_rel, memory_order_acquire);
+}
+
+FAA_INLINE void FAAtomicInt64Initialize(FAAtomicInt64 *_Nonnull atomic, int64_t value) {
+	atomic_init((_Atomic(int64_t) *)&atomic->value, value);
+}
+
+//! Loads the value with acquire ordering.
+FAA_INLINE int64_t FAAtomicInt64Load(FAAtomicInt64 *_Nonnull atomic) {
+	return atomic_load_explicit((_Atomic(int64_t) *)&atomic->value, memory_order_acquire);
+}
+
+//! Sets the value to `desired` if it is `*expected`. Otherwise, stores the current value in
+//! `*expected`.
+//! @return Whether the value was changed.
+FAA_INLINE bool FAAtomicInt64CompareExchange(FAAtomicInt64 *_Nonnull atomic, int64_t *_Nonnull expected, int64_t desired) {
+	return atomic_compare_exchange_strong_explicit((_Atomic(int64_t) *)&atomic->value, expected, desired, memory_order_acq_rel, memory_order_acquire);
+}
+
+#endif /* FoundationAdditionsAtomics_h */
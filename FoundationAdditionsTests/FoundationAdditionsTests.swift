@@ -19,16 +19,2375 @@ class FoundationAdditionsTests: XCTestCase {
         // Put teardown code here. This method is called after the invocation of each test method in the class.
     }
 
-    func testExample() throws {
-        // This is an example of a functional test case.
-        // Use XCTAssert and related functions to verify your tests produce the correct results.
+    func testFourCharacterCode() throws {
+        let code = FourCharacterCode("text")
+        XCTAssertEqual(code.rawValue, 0x74657874)
+        XCTAssertEqual(code.stringValue, "text")
+        XCTAssertEqual(code.description, "text")
+        XCTAssertTrue(code.isPrintable)
+        XCTAssertEqual(FourCharacterCode(bytes: code.bytes), code)
+        
+        let invalid = FourCharacterCode(rawValue: 0x6162_0A64)
+        XCTAssertFalse(invalid.isPrintable)
+        XCTAssertNil(invalid.stringValue)
+        XCTAssertEqual(invalid.description, "0x61620A64")
+        
+        XCTAssertEqual(FourCharacterCode(rawValue: 0xF0DB_AA20).stringValue, "\u{F8FF}€™ ")
+        XCTAssertEqual(FourCharacterCode("\u{F8FF}€™ ").rawValue, 0xF0DB_AA20)
+    }
+    
+    func testFourCharacterCodeBulk() throws {
+        var codes = [UInt32](repeating: 0x6162_6364, count: 37)
+        codes[21] = 0x6162_0063
+        codes[30] = 0x0000_0000
+        codes.withUnsafeBufferPointer { (buffer) in
+            XCTAssertEqual(FourCharacterCode.firstInvalidIndex(in: buffer), 21)
+            XCTAssertFalse(FourCharacterCode.allPrintable(buffer))
+            XCTAssertEqual(FourCharacterCode.firstInvalidIndex(in: UnsafeBufferPointer(rebasing: buffer[22...])), 8)
+            XCTAssertTrue(FourCharacterCode.allPrintable(UnsafeBufferPointer(rebasing: buffer[..<21])))
+        }
+        
+        codes = [0x7465_7874, 0x0000_0001, 0x8E8F_9091]
+        var output = [UInt8](repeating: 0, count: codes.count * FourCharacterCode.maximumUTF8Length)
+        var lengths = [Int](repeating: -1, count: codes.count)
+        let written = codes.withUnsafeBufferPointer { (buffer) in
+            output.withUnsafeMutableBufferPointer { (outBuffer) in
+                lengths.withUnsafeMutableBufferPointer { (lengthBuffer) in
+                    FourCharacterCode.decode(buffer, into: outBuffer, lengths: lengthBuffer)
+                }
+            }
+        }
+        XCTAssertEqual(lengths, [4, 0, 8])
+        XCTAssertEqual(String(decoding: output[..<written], as: UTF8.self), "textéèêë")
+        
+        var encoded = [UInt32](repeating: 0, count: 4)
+        let count = encoded.withUnsafeMutableBufferPointer { (buffer) in
+            FourCharacterCode.encode(["text", "éèêë", "0x00000001", "🙃"], detectHex: true, into: buffer)
+        }
+        XCTAssertEqual(count, 4)
+        XCTAssertEqual(encoded, [0x7465_7874, 0x8E8F_9091, 0x0000_0001, 0])
+    }
+
+    func testPascalStringRecords() throws {
+        // Three Str31 records.
+        var records = [UInt8](repeating: 0, count: 32 * 3)
+        records[0] = 2
+        records[1] = 0x48
+        records[2] = 0x69
+        records[32] = 4
+        records[33 ..< 37] = [0x52, 0x8E, 0x73, 0x75]
+        records[64] = 40
+        let decoded = records.withUnsafeBytes { (buffer) in
+            PascalString.decode(records: buffer, stride: 32, maximumLength: 31)
+        }
+        XCTAssertEqual(decoded, ["Hi", "Résu", nil])
+        
+        records[64] = 1
+        records[65] = 0xDC
+        let single = records.withUnsafeBytes { (buffer) in
+            PascalString.decode(UnsafeRawBufferPointer(rebasing: buffer[64...]), encoding: .macOSIcelandic)
+        }
+        XCTAssertEqual(single, "Ð")
+        XCTAssertEqual(records.withUnsafeBytes({ PascalString.decode(UnsafeRawBufferPointer(rebasing: $0[..<0])) }), nil)
+    }
+
+    func testHotPathCounters() throws {
+        HotPathCounters.reset()
+        XCTAssertEqual(FourCharacterCode(rawValue: 0x7465_7874).stringValue, "text")
+        XCTAssertEqual(FourCharacterCode(rawValue: 0x0000_0001).stringValue, nil)
+        let counts = HotPathCounters.snapshot()
+        if HotPathCounters.isEnabled {
+            XCTAssertEqual(counts["FourCharacterCode.stringValue"]?.calls, 2)
+        } else {
+            XCTAssertEqual(counts, [:])
+        }
+
+        // Recording directly works whether or not the package's functions are instrumented.
+        let slot = HotPathCounters.Slot("testHotPathCounters")
+        XCTAssertNil(HotPathCounters.snapshot()["testHotPathCounters"])
+        slot.end(since: HotPathCounters.begin(), items: 3)
+        slot.end(since: HotPathCounters.begin(), items: 4)
+        // Slots with the same name add up.
+        HotPathCounters.Slot("testHotPathCounters").end(since: HotPathCounters.begin(), items: 5)
+        let direct = try XCTUnwrap(HotPathCounters.snapshot()["testHotPathCounters"])
+        XCTAssertEqual(direct.calls, 3)
+        XCTAssertEqual(direct.items, 12)
+        HotPathCounters.reset()
+        XCTAssertEqual(HotPathCounters.snapshot(), [:])
+    }
+
+    func testTupleViews() throws {
+        var tuple: (UInt16, UInt16, UInt16, UInt16, UInt16) = (72, 105, 33, 0, 7)
+        let reflected: [UInt16] = try arrayFromObject(reflecting: tuple, appendLastObject: 0)
+        XCTAssertEqual(arrayFromTuple(tuple, of: UInt16.self, appendLastObject: 0), reflected)
+        withUnsafeElements(of: tuple, as: UInt16.self) { (buffer) in
+            XCTAssertEqual(Array(buffer), [72, 105, 33, 0, 7])
+        }
+        withUnsafeElements(of: tuple, as: UInt16.self, sentinel: { $0 == 0 }) { (buffer) in
+            XCTAssertEqual(String(decoding: buffer, as: UTF16.self), "Hi!")
+        }
+        withUnsafeMutableElements(of: &tuple, as: UInt16.self) { (buffer) in
+            buffer[3] = 63
+        }
+        XCTAssertEqual(tuple.3, 63)
+    }
+
+    private struct Padded: Equatable {
+        var wide: Int64
+        var narrow: Int8
+    }
+
+    func testTupleViewsOfPaddedElements() throws {
+        // The tuple's size is 2 × stride + size, not a multiple of the stride.
+        let tuple = (Padded(wide: 1, narrow: 2), Padded(wide: 3, narrow: 4), Padded(wide: 5, narrow: 6))
+        XCTAssertNotEqual(MemoryLayout.size(ofValue: tuple) % MemoryLayout<Padded>.stride, 0)
+        withUnsafeElements(of: tuple, as: Padded.self) { (buffer) in
+            XCTAssertEqual(Array(buffer), [Padded(wide: 1, narrow: 2), Padded(wide: 3, narrow: 4), Padded(wide: 5, narrow: 6)])
+        }
+    }
+
+    func testTupleViewPerformance() throws {
+        let tuple: (UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64,
+                    UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64) = (1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16)
+        self.measure {
+            var total: UInt64 = 0
+            for _ in 0 ..< 100_000 {
+                total &+= withUnsafeElements(of: tuple, as: UInt64.self) { $0.reduce(0, &+) }
+            }
+            XCTAssertEqual(total, 136 * 100_000)
+        }
+    }
+
+    func testReflectingTuplePerformance() throws {
+        let tuple: (UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64,
+                    UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64) = (1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16)
+        self.measure {
+            var total: UInt64 = 0
+            for _ in 0 ..< 100_000 {
+                let values: [UInt64] = try! arrayFromObject(reflecting: tuple)
+                total &+= values.reduce(0, &+)
+            }
+            XCTAssertEqual(total, 136 * 100_000)
+        }
+    }
+
+    func testFourCharacterCodeValidationPerformance() throws {
+        let codes = [UInt32](repeating: 0x7465_7874, count: 4_000_000)
+        self.measure {
+            codes.withUnsafeBufferPointer { (buffer) in
+                XCTAssertTrue(FourCharacterCode.allPrintable(buffer))
+            }
+        }
+    }
+
+    func testClampValues() throws {
+        let floats: [Float] = [-3, -0.5, 0, 0.25, 1, 1.5, .nan, -.infinity, .infinity, 0.75, 2, -1, 0.5]
+        let clampedFloats = clamp(values: floats, minimum: 0, maximum: 1)
+        let expectedFloats = clamp(values: floats.lazy, minimum: Float(0), maximum: 1)
+        XCTAssertEqual(clampedFloats.count, expectedFloats.count)
+        for (clamped, expected) in zip(clampedFloats, expectedFloats) {
+            XCTAssertTrue(clamped == expected || (clamped.isNaN && expected.isNaN), "\(clamped) != \(expected)")
+        }
+
+        let integers = Array(-20 ... 20)
+        XCTAssertEqual(clamp(values: integers, minimum: -7, maximum: 9), integers.map { clamp($0, minimum: -7, maximum: 9) })
+
+        var bytes = [UInt8](0 ... 255)
+        bytes.withUnsafeMutableBufferPointer { (buffer) in
+            clamp(UnsafeMutableBufferPointer(rebasing: buffer[3 ..< 250]), minimum: 16, maximum: 235)
+        }
+        XCTAssertEqual(bytes[0 ..< 3], [0, 1, 2])
+        XCTAssertEqual(bytes[3 ..< 250], ArraySlice((3 ..< 250).map { UInt8(clamp($0, minimum: 16, maximum: 235)) }))
+        XCTAssertEqual(bytes[250...], [250, 251, 252, 253, 254, 255])
+    }
+
+    func testClampValuesPerformance() throws {
+        let values = (0 ..< 4_000_000).map { Float($0 % 1000) / 500 - 1 }
+        self.measure {
+            let clamped = clamp(values: values, minimum: -0.5, maximum: 0.5)
+            XCTAssertEqual(clamped.count, values.count)
+        }
+    }
+
+    func testClampSequencePerformance() throws {
+        let values = (0 ..< 4_000_000).map { Float($0 % 1000) / 500 - 1 }
+        self.measure {
+            let clamped = clamp(values: values.lazy, minimum: -0.5, maximum: 0.5)
+            XCTAssertEqual(clamped.count, values.count)
+        }
+    }
+
+    func testRemoveIndexes() throws {
+        let original = Array(0 ..< 200)
+        let toRemove = IndexSet([0, 1, 2, 10, 63, 64, 65, 128, 150, 151, 199, 500])
+        let expected = original.enumerated().filter { !toRemove.contains($0.offset) }.map { $0.element }
+
+        var viaIndexSet = original
+        viaIndexSet.remove(indexes: toRemove)
+        XCTAssertEqual(viaIndexSet, expected)
+
+        var viaConcurrent = original
+        viaConcurrent.remove(indexes: toRemove, concurrently: true)
+        XCTAssertEqual(viaConcurrent, expected)
+
+        var viaUnsorted = original
+        viaUnsorted.remove(indexes: [151, 2, 0, 500, 65, 10, 1, 128, 63, 199, 64, 150, 2])
+        XCTAssertEqual(viaUnsorted, expected)
+
+        var viaSorted = original
+        viaSorted.remove(sortedIndexes: [0, 1, 2, 2, 10, 63, 64, 65, 128, 150, 151, 199, 500])
+        XCTAssertEqual(viaSorted, expected)
+
+        var mask = [UInt64](repeating: 0, count: 4)
+        for i in toRemove where i < original.count {
+            mask[i / 64] |= 1 << UInt64(i % 64)
+        }
+        var viaMask = original
+        viaMask.remove(mask: mask)
+        XCTAssertEqual(viaMask, expected)
+
+        var viaPredicate = original
+        viaPredicate.remove(indexesWhere: { toRemove.contains($0) })
+        XCTAssertEqual(viaPredicate, expected)
+
+        // Non-trivial elements are moved by assignment.
+        var strings = original.map { String($0) }
+        strings.remove(indexes: toRemove)
+        XCTAssertEqual(strings, expected.map { String($0) })
+
+        // Collections that don't start at zero.
+        var slice = ArraySlice(original)[10 ..< 20]
+        slice.remove(indexes: IndexSet([10, 12, 19]))
+        XCTAssertEqual(Array(slice), [11, 13, 14, 15, 16, 17, 18])
+
+        // Mask bits count from the slice's start index.
+        var maskedSlice = ArraySlice(original)[10 ..< 20]
+        maskedSlice.remove(mask: [0b10_0000_0101])
+        XCTAssertEqual(Array(maskedSlice), [11, 13, 14, 15, 16, 17, 18])
+    }
+
+    func testRemoveIndexesConcurrently() throws {
+        let original = Array(0 ..< 3_000_000)
+        var mask = [UInt64](repeating: 0, count: (original.count + 63) / 64)
+        var toRemove = IndexSet()
+        for i in Swift.stride(from: 0, to: original.count, by: 7) {
+            mask[i / 64] |= 1 << UInt64(i % 64)
+            toRemove.insert(i)
+        }
+        let expected = original.filter { $0 % 7 != 0 }
+
+        var viaMask = original
+        viaMask.remove(mask: mask, concurrently: true)
+        XCTAssertEqual(viaMask, expected)
+
+        var viaIndexSet = original
+        viaIndexSet.remove(indexes: toRemove, concurrently: true)
+        XCTAssertEqual(viaIndexSet, expected)
+    }
+
+    /// Indexes of every `step`th element of a four million element array.
+    private func removalIndexes(step: Int) -> IndexSet {
+        var indexes = IndexSet()
+        for i in Swift.stride(from: 0, to: 4_000_000, by: step) {
+            indexes.insert(i)
+        }
+        return indexes
+    }
+
+    func testRemoveSparseIndexesPerformance() throws {
+        let original = [Int](repeating: 42, count: 4_000_000)
+        let indexes = removalIndexes(step: 1000)
+        self.measure {
+            var array = original
+            array.remove(indexes: indexes)
+            XCTAssertEqual(array.count, original.count - indexes.count)
+        }
+    }
+
+    func testRemoveDenseIndexesPerformance() throws {
+        let original = [Int](repeating: 42, count: 4_000_000)
+        let indexes = removalIndexes(step: 2)
+        self.measure {
+            var array = original
+            array.remove(indexes: indexes)
+            XCTAssertEqual(array.count, original.count - indexes.count)
+        }
+    }
+
+    func testRemoveRangesPerformance() throws {
+        let original = [Int](repeating: 42, count: 4_000_000)
+        var indexes = IndexSet()
+        for i in Swift.stride(from: 0, to: original.count, by: 10_000) {
+            indexes.insert(integersIn: i ..< i + 5_000)
+        }
+        self.measure {
+            var array = original
+            array.remove(indexes: indexes)
+            XCTAssertEqual(array.count, original.count - indexes.count)
+        }
+    }
+
+    func testRemoveDenseIndexesConcurrentlyPerformance() throws {
+        let original = [Int](repeating: 42, count: 4_000_000)
+        let indexes = removalIndexes(step: 2)
+        self.measure {
+            var array = original
+            array.remove(indexes: indexes, concurrently: true)
+            XCTAssertEqual(array.count, original.count - indexes.count)
+        }
+    }
+
+    func testBitVector() throws {
+        var bits = BitVector(count: 200)
+        for i in [0, 3, 63, 64, 65, 127, 150, 199] {
+            bits[i] = true
+        }
+        XCTAssertEqual(bits.count(of: true), 8)
+        XCTAssertEqual(bits.count(of: false, in: 60 ..< 70), 7)
+        XCTAssertEqual(Array(bits.setBitIndexes), [0, 3, 63, 64, 65, 127, 150, 199])
+        XCTAssertEqual(bits.firstIndex(of: true, in: 4 ..< 200), 63)
+        XCTAssertEqual(bits.lastIndex(of: true, in: 0 ..< 150), 127)
+        XCTAssertEqual(bits.firstIndex(of: false), 1)
+        XCTAssertNil(bits.firstIndex(of: true, in: 66 ..< 127))
+        XCTAssertFalse(bits.contains(true, in: 151 ..< 199))
+
+        var flipped = ~bits
+        XCTAssertEqual(flipped.count(of: true), 192)
+        XCTAssertEqual((flipped & bits).count(of: true), 0)
+        XCTAssertEqual((flipped | bits).count(of: true), 200)
+        flipped.formSymmetricDifference(bits, in: 0 ..< 64)
+        XCTAssertEqual(flipped.count(of: true, in: 0 ..< 64), 64)
+        flipped.setBits(in: 10 ..< 130, to: false)
+        XCTAssertEqual(flipped.count(of: true), 10 + 68)
+
+        var grown = bits
+        grown.setCount(300)
+        XCTAssertEqual(grown.count(of: true), 8)
+        grown.setCount(64)
+        XCTAssertEqual(Array(grown.setBitIndexes), [0, 3, 63])
+    }
+
+    func testBitVectorIterationPerformance() throws {
+        let bits = BitVector((0 ..< 2_000_000).map { $0 % 97 == 0 })
+        self.measure {
+            var found = 0
+            for i in bits.setBitIndexes {
+                found &+= i
+            }
+            XCTAssertGreaterThan(found, 0)
+        }
+    }
+
+    func testBitVectorCountPerformance() throws {
+        let bits = BitVector((0 ..< 2_000_000).map { $0 % 5 == 0 })
+        self.measure {
+            for start in Swift.stride(from: 0, to: 1_000_000, by: 10_000) {
+                _ = bits.count(of: true, in: start ..< start + 1_000_000)
+            }
+        }
+    }
+
+    #if canImport(Darwin)
+    func testBitVectorBridging() throws {
+        let native = BitVector((0 ..< 1001).map { $0 % 3 == 0 || $0 % 7 == 0 })
+        let cf = native.cfBitVector()
+        XCTAssertEqual(cf.count, native.count)
+        for i in 0 ..< native.count {
+            XCTAssertEqual(cf[i] != 0, native[i])
+        }
+        XCTAssertEqual(cf.countOfBit(in: CFRange(location: 0, length: cf.count), 1), native.count(of: true))
+        XCTAssertEqual(BitVector(cf), native)
+        let mutable = native.mutableCFBitVector()
+        mutable.flipBit(at: 1)
+        XCTAssertEqual(mutable.bitVector.count(of: true), native.count(of: true) + 1)
+    }
+
+    func testCFBitVectorIterationPerformance() throws {
+        let cf = BitVector((0 ..< 2_000_000).map { $0 % 97 == 0 }).cfBitVector()
+        self.measure {
+            var found = 0
+            for (i, bit) in cf.enumerated() where bit != 0 {
+                found &+= i
+            }
+            XCTAssertGreaterThan(found, 0)
+        }
+    }
+
+    func testCFBitVectorCountPerformance() throws {
+        let cf = BitVector((0 ..< 2_000_000).map { $0 % 5 == 0 }).cfBitVector()
+        self.measure {
+            for start in Swift.stride(from: 0, to: 1_000_000, by: 10_000) {
+                _ = cf.countOfBit(in: CFRange(location: start, length: 1_000_000), 1)
+            }
+        }
+    }
+    #endif
+
+    func testHeap() throws {
+        let values = (0 ..< 1000).map { ($0 * 7919) % 1000 }
+        for arity in [2, 3, 4, 8] {
+            var heap = Heap(values, arity: arity)
+            var popped = [Int]()
+            while let value = heap.popMin() {
+                popped.append(value)
+            }
+            XCTAssertEqual(popped, values.sorted())
+        }
+
+        var maxHeap = Heap<Int>(by: >)
+        for value in values {
+            maxHeap.insert(value)
+        }
+        XCTAssertEqual(maxHeap.min, 999)
+        XCTAssertEqual(maxHeap.replaceMin(with: -1), 999)
+        XCTAssertEqual(maxHeap.min, 998)
+
+        var evens = Heap(Swift.stride(from: 0, to: 100, by: 2))
+        evens.merge(Heap(Swift.stride(from: 1, to: 10, by: 2)))
+        XCTAssertEqual(evens.count, 55)
+        var merged = [Int]()
+        while let value = evens.popMin() {
+            merged.append(value)
+        }
+        XCTAssertEqual(merged, (Array(Swift.stride(from: 0, to: 100, by: 2)) + [1, 3, 5, 7, 9]).sorted())
+
+        // Without a Comparable constraint, a min-heap goes through its stored closure.
+        var generic = Heap(values)
+        XCTAssertEqual(drainUnconstrained(&generic), values.sorted())
+        var genericMax = Heap(values, by: >)
+        XCTAssertEqual(drainUnconstrained(&genericMax), values.sorted(by: >))
+    }
+
+    private func drainUnconstrained<T>(_ heap: inout Heap<T>) -> [T] {
+        var drained = [T]()
+        while let value = heap.popMin() {
+            drained.append(value)
+        }
+        return drained
+    }
+
+    func testIndexedHeap() throws {
+        var heap = IndexedHeap<Int>()
+        let handles = (0 ..< 100).map { heap.insert($0 * 10) }
+        XCTAssertEqual(heap.min?.element, 0)
+
+        heap.update(handles[50], to: -5)
+        XCTAssertEqual(heap.min?.element, -5)
+        XCTAssertEqual(heap.min?.handle, handles[50])
+
+        heap.update(handles[50], to: 10_000)
+        XCTAssertEqual(heap.min?.element, 0)
+
+        XCTAssertEqual(heap.remove(handles[0]), 0)
+        XCTAssertFalse(heap.contains(handles[0]))
+        XCTAssertNil(heap.remove(handles[0]))
+        XCTAssertEqual(heap.remove(handles[42]), 420)
+
+        var popped = [Int]()
+        while let entry = heap.popMin() {
+            popped.append(entry.element)
+        }
+        let expected = (1 ..< 100).filter { $0 != 42 && $0 != 50 }.map { $0 * 10 } + [10_000]
+        XCTAssertEqual(popped, expected)
+    }
+
+    private struct Event32: Comparable {
+        var time: Int
+        var payload: (Int, Int, Int) = (0, 0, 0)
+
+        static func < (lhs: Event32, rhs: Event32) -> Bool {
+            return lhs.time < rhs.time
+        }
+
+        static func == (lhs: Event32, rhs: Event32) -> Bool {
+            return lhs.time == rhs.time
+        }
+    }
+
+    private struct Event64: Comparable {
+        var time: Int
+        var payload: (Int, Int, Int, Int, Int, Int, Int) = (0, 0, 0, 0, 0, 0, 0)
+
+        static func < (lhs: Event64, rhs: Event64) -> Bool {
+            return lhs.time < rhs.time
+        }
+
+        static func == (lhs: Event64, rhs: Event64) -> Bool {
+            return lhs.time == rhs.time
+        }
+    }
+
+    private static let heapTimes = (1 ... 200_000).map { ($0 &* 2_654_435_761) % 1_000_003 + 1 }
+
+    private func measureHeap<T: Comparable>(_ make: (Int) -> T) {
+        let elements = FoundationAdditionsTests.heapTimes.map(make)
+        self.measure {
+            var heap = Heap<T>()
+            heap.reserveCapacity(elements.count)
+            for element in elements {
+                heap.insert(element)
+            }
+            while heap.popMin() != nil {}
+        }
+    }
+
+    func testHeapIntPerformance() throws {
+        measureHeap { $0 }
+    }
+
+    func testHeap32BytePerformance() throws {
+        measureHeap { Event32(time: $0) }
+    }
+
+    func testHeap64BytePerformance() throws {
+        measureHeap { Event64(time: $0) }
+    }
+
+    #if canImport(Darwin)
+    func testCFBinaryHeapPerformance() throws {
+        var callBacks = CFBinaryHeapCallBacks(version: 0, retain: nil, release: nil, copyDescription: nil) { (lhs, rhs, _) -> CFComparisonResult in
+            let left = Int(bitPattern: lhs)
+            let right = Int(bitPattern: rhs)
+            return left < right ? .compareLessThan : (left > right ? .compareGreaterThan : .compareEqualTo)
+        }
+        let times = FoundationAdditionsTests.heapTimes
+        self.measure {
+            let heap = CFBinaryHeapCreate(kCFAllocatorDefault, 0, &callBacks, nil)!
+            for time in times {
+                CFBinaryHeapAddValue(heap, UnsafeRawPointer(bitPattern: time))
+            }
+            while heap.count > 0 {
+                heap.removeMinimum()
+            }
+        }
+    }
+    #endif
+
+    private final class Track: NSObject, SortKeyProviding {
+        #if canImport(ObjectiveC)
+        @objc let artist: String
+        @objc let year: Int
+        @objc let title: String
+        #else
+        let artist: String
+        let year: Int
+        let title: String
+        #endif
+
+        init(artist: String, year: Int, title: String) {
+            self.artist = artist
+            self.year = year
+            self.title = title
+        }
+
+        static func sortKey(for descriptor: NSSortDescriptor) -> SortKey<Track>? {
+            switch descriptor.key {
+            case "artist":
+                return SortKey(\.artist, ascending: descriptor.ascending)
+            case "year":
+                return SortKey(\.year, ascending: descriptor.ascending)
+            case "title":
+                return SortKey(\.title, ascending: descriptor.ascending)
+            default:
+                return nil
+            }
+        }
+    }
+
+    private static func makeTracks(_ count: Int) -> [Track] {
+        return (0 ..< count).map { i in
+            Track(artist: "Artist \((i &* 7919) % 97)", year: 1950 + (i &* 31) % 70, title: "Title \(i)")
+        }
+    }
+
+    func testMultiKeySort() throws {
+        let pairs = (0 ..< 500).map { (key: ($0 * 37) % 11, order: $0) }
+        let sorted = pairs.sorted(using: [SortKey(\.key, ascending: false)])
+        XCTAssertEqual(sorted.map { $0.key }, pairs.map { $0.key }.sorted(by: >))
+        // Stable: equal keys keep their original order.
+        for (lhs, rhs) in zip(sorted, sorted.dropFirst()) where lhs.key == rhs.key {
+            XCTAssertLessThan(lhs.order, rhs.order)
+        }
+
+        let twoKeys = pairs.sorted(using: [SortKey(\.key), SortKey(\.order, ascending: false)])
+        XCTAssertEqual(twoKeys.map { $0.order }, pairs.sorted { $0.key != $1.key ? $0.key < $1.key : $0.order > $1.order }.map { $0.order })
+
+        let large = (0 ..< 100_000).map { (key: ($0 &* 2_654_435_761) % 1000, order: $0) }
+        let serial = large.sorted(using: [SortKey(\.key)])
+        let parallel = large.sorted(using: [SortKey(\.key)], concurrently: true)
+        XCTAssertEqual(serial.map { $0.order }, parallel.map { $0.order })
+
+        var optionals: [String?] = ["b", nil, "a"]
+        optionals.sort(using: [SortKey(\String?.self)])
+        XCTAssertEqual(optionals, [nil, "a", "b"])
+    }
+
+    // NSArray sorts with key-value coding, which needs the Objective-C runtime.
+    #if canImport(ObjectiveC)
+    func testSortDescriptorBridging() throws {
+        let tracks = FoundationAdditionsTests.makeTracks(2000)
+        let descriptors = [NSSortDescriptor(key: "artist", ascending: true), NSSortDescriptor(key: "year", ascending: false)]
+        let native = tracks.sorted(using: descriptors)
+        let viaNSArray = (tracks as NSArray).sortedArray(using: descriptors) as! [Track]
+        XCTAssertEqual(native.map { $0.title }, viaNSArray.map { $0.title })
+    }
+
+    func testSortDescriptorPerformance() throws {
+        let tracks = FoundationAdditionsTests.makeTracks(150_000)
+        let descriptors = [NSSortDescriptor(key: "artist", ascending: true), NSSortDescriptor(key: "year", ascending: false), NSSortDescriptor(key: "title", ascending: true)]
+        self.measure {
+            _ = (tracks as NSArray).sortedArray(using: descriptors)
+        }
+    }
+    #endif
+
+    func testSortKeyPerformance() throws {
+        let tracks = FoundationAdditionsTests.makeTracks(150_000)
+        let keys = [SortKey(\Track.artist), SortKey(\Track.year, ascending: false), SortKey(\Track.title)]
+        self.measure {
+            _ = tracks.sorted(using: keys)
+        }
+    }
+
+    func testConcurrentSortKeyPerformance() throws {
+        let tracks = FoundationAdditionsTests.makeTracks(150_000)
+        let keys = [SortKey(\Track.artist), SortKey(\Track.year, ascending: false), SortKey(\Track.title)]
+        self.measure {
+            _ = tracks.sorted(using: keys, concurrently: true)
+        }
+    }
+
+    func testBufferArena() throws {
+        let arena = BufferArena(maximumBlocksPerSizeClass: 2)
+        let layout = BufferListLayout(bufferCount: 3, bytesPerBuffer: 1000)
+        XCTAssertEqual(layout.bufferStride, 1024)
+        XCTAssertEqual(layout.byteCount, 3072)
+
+        let first = arena.checkOut(layout)
+        let second = arena.checkOut(layout)
+        // Past the pool's capacity, so allocated directly.
+        let third = arena.checkOut(layout)
+        for allocation in [first, second, third] {
+            for i in 0 ..< layout.bufferCount {
+                XCTAssertEqual(Int(bitPattern: allocation.buffer(at: i)) % BufferListLayout.alignment, 0)
+            }
+        }
+        XCTAssertEqual(arena.statistics(for: layout), BufferArena.Statistics(blockSize: 4096, blockCount: 2, checkedOut: 2, highWaterMark: 2))
+
+        first.buffer(at: 0).storeBytes(of: 0xFF, as: UInt8.self)
+        arena.checkIn(first)
+        arena.checkIn(third)
+        XCTAssertEqual(arena.statistics(for: layout)?.pooled, 1)
+
+        let reused = arena.checkOut(layout, zeroed: true)
+        XCTAssertEqual(reused.baseAddress, first.baseAddress)
+        XCTAssertEqual(reused.buffer(at: 0).load(as: UInt8.self), 0)
+        arena.checkIn(reused)
+        arena.checkIn(second)
+        XCTAssertEqual(arena.statistics(for: layout)?.checkedOut, 0)
+        XCTAssertEqual(arena.statistics(for: layout)?.highWaterMark, 2)
+
+        let large = arena.checkOut(BufferListLayout(bufferCount: 2, bytesPerBuffer: 10_000))
+        XCTAssertEqual(large.capacity, 32768)
+        arena.checkIn(large)
+        XCTAssertEqual(arena.statistics.count, 2)
+    }
+
+    func testBufferArenaConcurrentCheckIn() throws {
+        let arena = BufferArena(maximumBlocksPerSizeClass: 64)
+        let layout = BufferListLayout(bufferCount: 2, bytesPerBuffer: 4096)
+        DispatchQueue.concurrentPerform(iterations: 8) { _ in
+            for _ in 0 ..< 10_000 {
+                let allocation = arena.checkOut(layout)
+                allocation.buffer(at: 1).storeBytes(of: 1, as: UInt32.self)
+                arena.checkIn(allocation)
+            }
+        }
+        let stats = try XCTUnwrap(arena.statistics(for: layout))
+        XCTAssertEqual(stats.checkedOut, 0)
+        XCTAssertLessThanOrEqual(stats.blockCount, 8)
+        XCTAssertLessThanOrEqual(stats.highWaterMark, 8)
+    }
+
+    func testBufferArenaPerformance() throws {
+        let arena = BufferArena()
+        let layout = BufferListLayout(bufferCount: 8, bytesPerBuffer: 4096 * 4)
+        self.measure {
+            for _ in 0 ..< 100_000 {
+                arena.checkIn(arena.checkOut(layout))
+            }
+        }
+    }
+
+    func testMallocBufferPerformance() throws {
+        let byteCount = BufferListLayout(bufferCount: 8, bytesPerBuffer: 4096 * 4).byteCount
+        self.measure {
+            for _ in 0 ..< 100_000 {
+                let memory = malloc(byteCount)
+                memset(memory, 0, byteCount)
+                free(memory)
+            }
+        }
+    }
+
+    func testPCMConversionRoundTrip() throws {
+        let frames = 1001
+        let source = (0 ..< frames * 2).map { Int16(truncatingIfNeeded: $0 &* 977) }
+        let interleaved = PCMFormat(sampleType: .int16, channelCount: 2)
+        for type in PCMFormat.SampleType.allCases {
+            for bigEndian in [false, true] {
+                let planar = PCMFormat(sampleType: type, channelCount: 2, isInterleaved: false, isBigEndian: bigEndian)
+                let left = UnsafeMutableRawPointer.allocate(byteCount: frames * type.bytesPerSample, alignment: 16)
+                let right = UnsafeMutableRawPointer.allocate(byteCount: frames * type.bytesPerSample, alignment: 16)
+                defer {
+                    left.deallocate()
+                    right.deallocate()
+                }
+                var result = [Int16](repeating: 0, count: frames * 2)
+                source.withUnsafeBytes { (source) in
+                    PCMConverter(from: interleaved, to: planar).convert(frameCount: frames, from: [source.baseAddress!], to: [left, right])
+                }
+                result.withUnsafeMutableBytes { (result) in
+                    PCMConverter(from: planar, to: interleaved).convert(frameCount: frames, from: [UnsafeRawPointer(left), UnsafeRawPointer(right)], to: [result.baseAddress!])
+                }
+                XCTAssertEqual(result, source, "\(type), big-endian: \(bigEndian)")
+            }
+        }
+    }
+
+    func testPCMConversionSamples() throws {
+        let samples: [Float] = [0, 0.5, -1, 2, -2, .nan, 1, -0.5, 0.25]
+        let floatFormat = PCMFormat(sampleType: .float32, channelCount: 1)
+
+        var int16s = [Int16](repeating: 0, count: samples.count)
+        samples.withUnsafeBytes { (source) in
+            int16s.withUnsafeMutableBytes { (destination) in
+                PCMConverter(from: floatFormat, to: PCMFormat(sampleType: .int16, channelCount: 1)).convert(frameCount: samples.count, from: source.baseAddress!, to: destination.baseAddress!)
+            }
+        }
+        XCTAssertEqual(int16s, [0, 16384, -32768, 32767, -32768, -32768, 32767, -16384, 8192])
+
+        var int24s = [UInt8](repeating: 0, count: 6)
+        samples.withUnsafeBytes { (source) in
+            int24s.withUnsafeMutableBytes { (destination) in
+                PCMConverter(from: floatFormat, to: PCMFormat(sampleType: .int24, channelCount: 1, isBigEndian: true)).convert(frameCount: 2, from: source.baseAddress!, to: destination.baseAddress!)
+            }
+        }
+        XCTAssertEqual(int24s, [0, 0, 0, 0x40, 0, 0])
+
+        var int32s = [Int32](repeating: 0, count: samples.count)
+        samples.withUnsafeBytes { (source) in
+            int32s.withUnsafeMutableBytes { (destination) in
+                PCMConverter(from: floatFormat, to: PCMFormat(sampleType: .int32, channelCount: 1)).convert(frameCount: samples.count, from: source.baseAddress!, to: destination.baseAddress!)
+            }
+        }
+        XCTAssertEqual(int32s, [0, 1 << 30, .min, .max, .min, .min, .max, -(1 << 30), 1 << 29])
+    }
+
+    func testPCMConversionMix() throws {
+        let frames = 37
+        // Five channels, each holding its channel number.
+        let source = (0 ..< frames * 5).map { Float($0 % 5) / 8 }
+        let matrix: [Float] = [1, 0, 0.5, 0, 0,
+                               0, 1, 0.5, 0, 1]
+        let converter = PCMConverter(from: PCMFormat(sampleType: .float32, channelCount: 5), to: PCMFormat(sampleType: .float32, channelCount: 2), mixMatrix: matrix)
+        var stereo = [Float](repeating: 0, count: frames * 2)
+        source.withUnsafeBytes { (source) in
+            stereo.withUnsafeMutableBytes { (destination) in
+                converter.convert(frameCount: frames, from: source.baseAddress!, to: destination.baseAddress!)
+            }
+        }
+        for frame in 0 ..< frames {
+            XCTAssertEqual(stereo[frame * 2], 0.125)
+            XCTAssertEqual(stereo[frame * 2 + 1], 0.75)
+        }
+
+        XCTAssertEqual(PCMConverter.defaultMixMatrix(from: 1, to: 2), [1, 1])
+        XCTAssertEqual(PCMConverter.defaultMixMatrix(from: 2, to: 1), [0.5, 0.5])
+        XCTAssertEqual(PCMConverter.defaultMixMatrix(from: 2, to: 3), [1, 0, 0, 1, 0, 0])
+    }
+
+    private func measurePCMConversion(from source: PCMFormat, to destination: PCMFormat, mixMatrix: [Float]? = nil) {
+        let frames = 1 << 20
+        let converter = PCMConverter(from: source, to: destination, mixMatrix: mixMatrix)
+        let sourceBuffers = (0 ..< source.bufferCount).map { _ in UnsafeMutableRawPointer.allocate(byteCount: frames * source.bytesPerFrame, alignment: 64) }
+        let destinationBuffers = (0 ..< destination.bufferCount).map { _ in UnsafeMutableRawPointer.allocate(byteCount: frames * destination.bytesPerFrame, alignment: 64) }
+        defer {
+            sourceBuffers.forEach { $0.deallocate() }
+            destinationBuffers.forEach { $0.deallocate() }
+        }
+        for buffer in sourceBuffers {
+            buffer.initializeMemory(as: UInt8.self, repeating: 0x11, count: frames * source.bytesPerFrame)
+        }
+        let sources = sourceBuffers.map { UnsafeRawPointer($0) }
+        self.measure {
+            converter.convert(frameCount: frames, from: sources, to: destinationBuffers)
+        }
+    }
+
+    func testPCMInt16ToFloat32Performance() throws {
+        measurePCMConversion(from: PCMFormat(sampleType: .int16, channelCount: 2, isBigEndian: true), to: PCMFormat(sampleType: .float32, channelCount: 2, isInterleaved: false))
+    }
+
+    func testPCMFloat32ToInt24Performance() throws {
+        measurePCMConversion(from: PCMFormat(sampleType: .float32, channelCount: 2, isInterleaved: false), to: PCMFormat(sampleType: .int24, channelCount: 2))
+    }
+
+    func testPCMInt32ToFloat64Performance() throws {
+        measurePCMConversion(from: PCMFormat(sampleType: .int32, channelCount: 2), to: PCMFormat(sampleType: .float64, channelCount: 2))
+    }
+
+    func testPCMDownmixPerformance() throws {
+        let matrix: [Float] = [1, 0, 0.707, 0.707, 0.707, 0,
+                               0, 1, 0.707, 0.707, 0, 0.707]
+        measurePCMConversion(from: PCMFormat(sampleType: .float32, channelCount: 6), to: PCMFormat(sampleType: .int16, channelCount: 2), mixMatrix: matrix)
+    }
+
+    private struct TestStreamLayout: Hashable, Sendable, BitwiseCopyable {
+        var bitsPerChannel: UInt32
+        var isBigEndian: Bool
+    }
+
+    private final class TestFileFormatProvider: FileFormatProvider, @unchecked Sendable {
+        let types: [FileTypeRecord]
+        private let lock = NSLock()
+        private var _queries = [UInt32: Int]()
+
+        init(typeCount: Int) {
+            types = (0 ..< typeCount).map { i in
+                FileTypeRecord(fileTypeID: UInt32(0x1000 + i), name: "Type \(typeCount - i)", extensions: ["ext\(i)", "EXT\(i)b", "shared"])
+            }
+        }
+
+        var queries: [UInt32: Int] {
+            lock.lock()
+            defer { lock.unlock() }
+            return _queries
+        }
+
+        func fileTypes() -> [FileTypeRecord] {
+            return types
+        }
+
+        func dataFormats(forFileType fileTypeID: UInt32) -> [DataFormatRecord<TestStreamLayout>] {
+            lock.lock()
+            _queries[fileTypeID, default: 0] += 1
+            lock.unlock()
+            // Every type holds PCM; odd types also hold a format of their own.
+            var formats = [DataFormatRecord(formatID: 0x6C70636D, variants: [TestStreamLayout(bitsPerChannel: 16, isBigEndian: false), TestStreamLayout(bitsPerChannel: 24, isBigEndian: true)], readable: true, writable: true, eitherEndianPCM: true)]
+            if fileTypeID % 2 == 1 {
+                formats.append(DataFormatRecord(formatID: fileTypeID << 8, readable: true))
+            }
+            return formats
+        }
+    }
+
+    func testFileFormatRegistry() throws {
+        let provider = TestFileFormatProvider(typeCount: 12)
+        let registry = FileFormatRegistry(provider: provider)
+        XCTAssertEqual(registry.fileTypes.first?.name, "Type 1")
+        XCTAssertEqual(registry.fileTypeID(forExtension: "ext3"), 0x1003)
+        XCTAssertEqual(registry.fileTypeID(forExtension: "Ext3B"), 0x1003)
+        // The first type by name wins a shared extension.
+        XCTAssertEqual(registry.fileTypeID(forExtension: "SHARED"), 0x100B)
+        XCTAssertNil(registry.fileTypeID(forExtension: "nope"))
+        XCTAssertEqual(registry.fileType(0x1004)?.extensions.first, "ext4")
+        XCTAssertTrue(provider.queries.isEmpty)
+
+        DispatchQueue.concurrentPerform(iterations: 64) { _ in
+            XCTAssertEqual(registry.dataFormats(forFileType: 0x1001)?.count, 2)
+        }
+        XCTAssertEqual(provider.queries, [0x1001: 1])
+        XCTAssertNil(registry.dataFormats(forFileType: 0x2000))
+
+        XCTAssertEqual(registry.fileTypeIDs(forDataFormat: 0x100500), [0x1005])
+        XCTAssertEqual(registry.fileTypeIDs(forDataFormat: 0x6C70636D).count, 12)
+        XCTAssertEqual(registry.fileTypeIDs(forDataFormat: 0x100400), [])
+        XCTAssertEqual(provider.queries.count, 12)
+        XCTAssertTrue(provider.queries.values.allSatisfy { $0 == 1 })
+    }
+
+    func testFileFormatRegistrySnapshot() throws {
+        let provider = TestFileFormatProvider(typeCount: 5)
+        let registry = FileFormatRegistry(provider: provider)
+        let loaded = try XCTUnwrap(registry.dataFormats(forFileType: 0x1003))
+        let snapshot = registry.snapshot()
+
+        let restoredProvider = TestFileFormatProvider(typeCount: 5)
+        let restored = try FileFormatRegistry(provider: restoredProvider, snapshot: snapshot)
+        XCTAssertEqual(restored.fileTypes, registry.fileTypes)
+        XCTAssertEqual(restored.fileTypeID(forExtension: "ext2b"), 0x1002)
+        XCTAssertEqual(restored.dataFormats(forFileType: 0x1003), loaded)
+        XCTAssertTrue(restoredProvider.queries.isEmpty)
+        XCTAssertEqual(restored.dataFormats(forFileType: 0x1002)?.count, 1)
+        XCTAssertEqual(restoredProvider.queries, [0x1002: 1])
+        XCTAssertGreaterThan(restored.snapshot().count, snapshot.count)
+
+        XCTAssertThrowsError(try FileFormatRegistry(provider: restoredProvider, snapshot: snapshot.dropLast()))
+        XCTAssertThrowsError(try FileFormatRegistry(provider: restoredProvider, snapshot: Data(snapshot.dropFirst())))
+        XCTAssertThrowsError(try FileFormatRegistry(provider: restoredProvider, snapshot: Data()))
+
+        // Counts larger than the data can hold are rejected before anything is reserved.
+        var hugeTypeCount = snapshot
+        hugeTypeCount.replaceSubrange(12 ..< 16, with: [0xFF, 0xFF, 0xFF, 0xFF])
+        XCTAssertThrowsError(try FileFormatRegistry(provider: restoredProvider, snapshot: hugeTypeCount))
+        var hugeExtensionCount = snapshot
+        let extensionCountOffset = 24 + registry.fileTypes[0].name.utf8.count
+        hugeExtensionCount.replaceSubrange(extensionCountOffset ..< extensionCountOffset + 4, with: [0xFF, 0xFF, 0xFF, 0x7F])
+        XCTAssertThrowsError(try FileFormatRegistry(provider: restoredProvider, snapshot: hugeExtensionCount))
+    }
+
+    func testFileFormatRegistryLookupPerformance() throws {
+        let registry = FileFormatRegistry(provider: TestFileFormatProvider(typeCount: 64), loadDataFormats: true)
+        let extensions = (0 ..< 64).map { "EXT\($0)" }
+        self.measure {
+            var found = 0
+            for i in 0 ..< 100_000 {
+                if registry.fileTypeID(forExtension: extensions[i & 63]) != nil {
+                    found += 1
+                }
+                found += registry.fileTypeIDs(forDataFormat: UInt32(0x1000 + (i & 63)) << 8).count
+            }
+            XCTAssertEqual(found, 100_000 + 50_000)
+        }
+    }
+
+    private func appendBytes<T: FixedWidthInteger>(_ value: T, to data: inout Data) {
+        withUnsafeBytes(of: value) { data.append(contentsOf: $0) }
+    }
+
+    private func appendChunk(_ id: String, _ body: Data, bigEndian: Bool, to data: inout Data) {
+        data.append(contentsOf: Array(id.utf8))
+        appendBytes(bigEndian ? UInt32(body.count).bigEndian : UInt32(body.count).littleEndian, to: &data)
+        data.append(body)
+        if body.count % 2 == 1 {
+            data.append(0)
+        }
+    }
+
+    /// 16-bit little-endian stereo samples: left counts up, right counts down.
+    private func testSamples(frames: Int, bigEndian: Bool = false) -> Data {
+        var samples = Data()
+        for frame in 0 ..< frames {
+            let left = Int16(truncatingIfNeeded: frame)
+            let right = Int16(truncatingIfNeeded: -frame)
+            appendBytes(bigEndian ? left.bigEndian : left.littleEndian, to: &samples)
+            appendBytes(bigEndian ? right.bigEndian : right.littleEndian, to: &samples)
+        }
+        return samples
+    }
+
+    private func makeWave(frames: Int) -> Data {
+        var format = Data()
+        appendBytes(UInt16(1).littleEndian, to: &format)
+        appendBytes(UInt16(2).littleEndian, to: &format)
+        appendBytes(UInt32(48000).littleEndian, to: &format)
+        appendBytes(UInt32(48000 * 4).littleEndian, to: &format)
+        appendBytes(UInt16(4).littleEndian, to: &format)
+        appendBytes(UInt16(16).littleEndian, to: &format)
+        var chunks = Data("WAVE".utf8)
+        appendChunk("fmt ", format, bigEndian: false, to: &chunks)
+        appendChunk("LIST", Data("odd".utf8), bigEndian: false, to: &chunks)
+        appendChunk("data", testSamples(frames: frames), bigEndian: false, to: &chunks)
+        var file = Data()
+        appendChunk("RIFF", chunks, bigEndian: false, to: &file)
+        return file
+    }
+
+    private func makeAIFF(frames: Int, littleEndian: Bool, soundOffset: Int = 0) -> Data {
+        var common = Data()
+        appendBytes(UInt16(2).bigEndian, to: &common)
+        appendBytes(UInt32(frames).bigEndian, to: &common)
+        appendBytes(UInt16(16).bigEndian, to: &common)
+        // 44100 as an 80-bit extended float.
+        appendBytes(UInt16(0x400E).bigEndian, to: &common)
+        appendBytes(UInt64(0xAC44000000000000).bigEndian, to: &common)
+        if littleEndian {
+            common.append(contentsOf: Array("sowt".utf8))
+            common.append(contentsOf: [0])
+        }
+        var sound = Data()
+        appendBytes(UInt32(soundOffset).bigEndian, to: &sound)
+        appendBytes(UInt32(0), to: &sound)
+        sound.append(Data(count: soundOffset))
+        sound.append(testSamples(frames: frames, bigEndian: !littleEndian))
+        var chunks = Data((littleEndian ? "AIFC" : "AIFF").utf8)
+        appendChunk("COMM", common, bigEndian: true, to: &chunks)
+        appendChunk("SSND", sound, bigEndian: true, to: &chunks)
+        var file = Data()
+        appendChunk("FORM", chunks, bigEndian: true, to: &file)
+        return file
+    }
+
+    private func makeCAF(frames: Int) -> Data {
+        var file = Data("caff".utf8)
+        appendBytes(UInt16(1).bigEndian, to: &file)
+        appendBytes(UInt16(0).bigEndian, to: &file)
+        file.append(contentsOf: Array("desc".utf8))
+        appendBytes(UInt64(32).bigEndian, to: &file)
+        appendBytes(Double(22050).bitPattern.bigEndian, to: &file)
+        file.append(contentsOf: Array("lpcm".utf8))
+        appendBytes(UInt32(2).bigEndian, to: &file) // little-endian integer
+        appendBytes(UInt32(4).bigEndian, to: &file)
+        appendBytes(UInt32(1).bigEndian, to: &file)
+        appendBytes(UInt32(2).bigEndian, to: &file)
+        appendBytes(UInt32(16).bigEndian, to: &file)
+        file.append(contentsOf: Array("data".utf8))
+        appendBytes(UInt64.max, to: &file)
+        appendBytes(UInt32(0), to: &file)
+        file.append(testSamples(frames: frames))
+        return file
+    }
+
+    private func checkMappedAudioFile(_ file: MappedAudioFile, frames: Int) throws {
+        XCTAssertEqual(file.fileLengthFrames, Int64(frames))
+        XCTAssertEqual(file.fileFormat.channelCount, 2)
+        XCTAssertEqual(file.fileFormat.sampleType, .int16)
+        XCTAssertTrue(file.canReadMapped)
+
+        var count = 10
+        try file.seek(toFrame: 5)
+        let mapped = try XCTUnwrap(file.readMapped(frames: &count))
+        XCTAssertEqual(count, 10)
+        XCTAssertEqual(file.tell(), 15)
+        let isBigEndian = file.fileFormat.isBigEndian
+        let left = mapped.loadUnaligned(fromByteOffset: 4, as: Int16.self)
+        XCTAssertEqual(isBigEndian ? Int16(bigEndian: left) : Int16(littleEndian: left), 6)
+
+        file.clientFormat = PCMFormat(sampleType: .float32, channelCount: 2, isInterleaved: false)
+        XCTAssertFalse(file.canReadMapped)
+        XCTAssertNil(file.readMapped(frames: &count))
+        var leftSamples = [Float](repeating: 0, count: frames)
+        var rightSamples = [Float](repeating: 0, count: frames)
+        count = frames
+        leftSamples.withUnsafeMutableBytes { (leftBuffer) in
+            rightSamples.withUnsafeMutableBytes { (rightBuffer) in
+                file.read(frames: &count, into: [leftBuffer.baseAddress!, rightBuffer.baseAddress!])
+            }
+        }
+        XCTAssertEqual(count, frames - 15)
+        XCTAssertEqual(leftSamples[0], 15 / 32768)
+        XCTAssertEqual(rightSamples[1], -16 / 32768)
+        XCTAssertEqual(file.tell(), Int64(frames))
+
+        count = 4
+        file.read(frames: &count, into: [UnsafeMutableRawPointer(bitPattern: 16)!, UnsafeMutableRawPointer(bitPattern: 16)!])
+        XCTAssertEqual(count, 0)
+        XCTAssertThrowsError(try file.seek(toFrame: Int64(frames) + 1))
+    }
+
+    func testMappedAudioFile() throws {
+        let wave = try MappedAudioFile(data: makeWave(frames: 301))
+        XCTAssertEqual(wave.container, .wave)
+        XCTAssertEqual(wave.sampleRate, 48000)
+        try checkMappedAudioFile(wave, frames: 301)
+
+        let aiff = try MappedAudioFile(data: makeAIFF(frames: 77, littleEndian: false))
+        XCTAssertEqual(aiff.container, .aiff)
+        XCTAssertEqual(aiff.sampleRate, 44100)
+        XCTAssertTrue(aiff.fileFormat.isBigEndian)
+        try checkMappedAudioFile(aiff, frames: 77)
+
+        let aifc = try MappedAudioFile(data: makeAIFF(frames: 50, littleEndian: true))
+        XCTAssertEqual(aifc.container, .aifc)
+        XCTAssertFalse(aifc.fileFormat.isBigEndian)
+        try checkMappedAudioFile(aifc, frames: 50)
+
+        let caf = try MappedAudioFile(data: makeCAF(frames: 64))
+        XCTAssertEqual(caf.container, .caf)
+        XCTAssertEqual(caf.sampleRate, 22050)
+        try checkMappedAudioFile(caf, frames: 64)
+
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent("MappedAudioFileTest-\(UUID().uuidString).wav")
+        try makeWave(frames: 1000).write(to: url)
+        defer {
+            try? FileManager.default.removeItem(at: url)
+        }
+        try checkMappedAudioFile(MappedAudioFile(open: url), frames: 1000)
+    }
+
+    func testMappedAudioFileMisalignedSamples() throws {
+        // The SSND offset puts the 16-bit samples at an odd address.
+        let file = try MappedAudioFile(data: makeAIFF(frames: 40, littleEndian: false, soundOffset: 1))
+        XCTAssertFalse(file.canReadMapped)
+        var count = 40
+        XCTAssertNil(file.readMapped(frames: &count))
+        XCTAssertEqual(file.tell(), 0)
+        var samples = [Int16](repeating: 0, count: 80)
+        samples.withUnsafeMutableBytes { (buffer) in
+            file.read(frames: &count, into: [buffer.baseAddress!])
+        }
+        XCTAssertEqual(count, 40)
+        XCTAssertEqual(samples.map { Int16(bigEndian: $0) }, (0 ..< 40).flatMap { [Int16($0), Int16(-$0)] })
+    }
+
+    func testMappedAudioFileErrors() throws {
+        XCTAssertThrowsError(try MappedAudioFile(data: Data())) { error in
+            XCTAssertEqual(error as? MappedAudioFileError, .unknownContainer)
+        }
+        XCTAssertThrowsError(try MappedAudioFile(data: Data("RIFF\0\0\0\0WAVE".utf8))) { error in
+            XCTAssertEqual(error as? MappedAudioFileError, .missingChunk(FourCharacterCode("fmt ")))
+        }
+        var truncated = makeWave(frames: 10)
+        truncated.count = 30
+        XCTAssertThrowsError(try MappedAudioFile(data: truncated))
+        // A truncated data chunk still reads the frames that are there.
+        var shortData = makeWave(frames: 10)
+        shortData.count -= 6
+        XCTAssertEqual(try MappedAudioFile(data: shortData).fileLengthFrames, 8)
+
+        let missing = FileManager.default.temporaryDirectory.appendingPathComponent("MappedAudioFileTest-\(UUID().uuidString).wav")
+        XCTAssertThrowsError(try MappedAudioFile(open: missing)) { error in
+            XCTAssertEqual((error as? CocoaError)?.code, .fileReadNoSuchFile)
+        }
+    }
+
+    private func withLargeWaveFile(_ body: (URL) throws -> Void) throws {
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent("MappedAudioFilePerf-\(UUID().uuidString).wav")
+        try makeWave(frames: 1 << 22).write(to: url)
+        defer {
+            try? FileManager.default.removeItem(at: url)
+        }
+        try body(url)
+    }
+
+    func testMappedAudioFileMappedReadPerformance() throws {
+        try withLargeWaveFile { url in
+            let file = try MappedAudioFile(open: url)
+            self.measure {
+                try! file.seek(toFrame: 0)
+                var sum = 0
+                var count = 4096
+                while let frames = file.readMapped(frames: &count), count > 0 {
+                    let samples = UnsafeBufferPointer(start: frames.assumingMemoryBound(to: Int16.self), count: count * 2)
+                    sum &+= samples.reduce(0) { $0 &+ Int($1) }
+                    count = 4096
+                }
+                XCTAssertNotEqual(sum, 1)
+            }
+        }
+    }
+
+    func testMappedAudioFileConvertingReadPerformance() throws {
+        try withLargeWaveFile { url in
+            let file = try MappedAudioFile(open: url)
+            file.clientFormat = PCMFormat(sampleType: .float32, channelCount: 2, isInterleaved: false)
+            let left = UnsafeMutableRawPointer.allocate(byteCount: 4096 * 4, alignment: 64)
+            let right = UnsafeMutableRawPointer.allocate(byteCount: 4096 * 4, alignment: 64)
+            defer {
+                left.deallocate()
+                right.deallocate()
+            }
+            let buffers = [left, right]
+            self.measure {
+                try! file.seek(toFrame: 0)
+                var count = 4096
+                repeat {
+                    count = 4096
+                    file.read(frames: &count, into: buffers)
+                } while count > 0
+            }
+        }
+    }
+
+    /// A mono 32-bit source whose samples are their own frame numbers.
+    private final class CountingFrameSource: FrameSource {
+        let frameFormat = PCMFormat(sampleType: .int32, channelCount: 1)
+        let length: Int
+        let delay: TimeInterval
+        private(set) var position = 0
+
+        init(length: Int, delay: TimeInterval = 0) {
+            self.length = length
+            self.delay = delay
+        }
+
+        func seek(toFrame frame: Int64) throws {
+            position = Int(frame)
+        }
+
+        func read(frames: inout Int, into buffers: (Int) -> UnsafeMutableRawPointer) throws {
+            if delay > 0 {
+                Thread.sleep(forTimeInterval: delay)
+            }
+            frames = min(frames, length - position)
+            let samples = buffers(0).assumingMemoryBound(to: Int32.self)
+            for i in 0 ..< frames {
+                samples[i] = Int32(position + i)
+            }
+            position += frames
+        }
+    }
+
+    private final class CollectingFrameSink: FrameSink, @unchecked Sendable {
+        let frameFormat = PCMFormat(sampleType: .int32, channelCount: 1)
+        let delay: TimeInterval
+        var samples = [Int32]()
+
+        init(delay: TimeInterval = 0) {
+            self.delay = delay
+        }
+
+        func write(frames: Int, from buffers: (Int) -> UnsafeRawPointer) throws {
+            if delay > 0 {
+                Thread.sleep(forTimeInterval: delay)
+            }
+            samples.append(contentsOf: UnsafeBufferPointer(start: buffers(0).assumingMemoryBound(to: Int32.self), count: frames))
+        }
+    }
+
+    func testFrameRingBuffer() throws {
+        let ring = FrameRingBuffer(format: PCMFormat(sampleType: .int16, channelCount: 2, isInterleaved: false), capacity: 100)
+        XCTAssertEqual(ring.capacity, 128)
+        let left = (0 ..< 300).map { Int16($0) }
+        let right = (0 ..< 300).map { Int16(-$0) }
+        var outLeft = [Int16](repeating: 0, count: 300)
+        var outRight = [Int16](repeating: 0, count: 300)
+        var written = 0
+        var read = 0
+        while read < 300 {
+            left.withUnsafeBytes { l in
+                right.withUnsafeBytes { r in
+                    written += ring.write(frames: min(90, 300 - written), from: { ($0 == 0 ? l.baseAddress! : r.baseAddress!) + written * 2 })
+                }
+            }
+            XCTAssertLessThanOrEqual(ring.availableToRead, 128)
+            outLeft.withUnsafeMutableBytes { l in
+                outRight.withUnsafeMutableBytes { r in
+                    read += ring.read(frames: 70, into: { ($0 == 0 ? l.baseAddress! : r.baseAddress!) + read * 2 })
+                }
+            }
+        }
+        XCTAssertEqual(outLeft, left)
+        XCTAssertEqual(outRight, right)
+        XCTAssertEqual(ring.availableToWrite, 128)
+    }
+
+    private func readAll(_ reader: StreamingFrameReader, chunk: Int) -> [Int32] {
+        var result = [Int32]()
+        var buffer = [Int32](repeating: 0, count: chunk)
+        while true {
+            reader.waitForPrefetch(minimumFrames: chunk, timeout: 5)
+            var frames = chunk
+            buffer.withUnsafeMutableBytes { bytes in
+                reader.read(frames: &frames, into: { _ in bytes.baseAddress! })
+            }
+            if frames == 0 {
+                break
+            }
+            result.append(contentsOf: buffer[0 ..< frames])
+        }
+        return result
+    }
+
+    func testStreamingFrameReader() throws {
+        let reader = try StreamingFrameReader(source: CountingFrameSource(length: 100_000), readAheadFrames: 8192, chunkFrames: 1000)
+        reader.start()
+        defer {
+            reader.stop()
+        }
+        XCTAssertTrue(reader.waitForPrefetch(timeout: 5))
+        XCTAssertEqual(reader.ring.availableToRead, 8192)
+        XCTAssertEqual(readAll(reader, chunk: 512), (0 ..< 100_000).map { Int32($0) })
+        XCTAssertEqual(reader.tell(), 100_000)
+
+        reader.seek(toFrame: 99_000)
+        XCTAssertTrue(reader.waitForPrefetch(timeout: 5))
+        XCTAssertEqual(reader.tell(), 99_000)
+        XCTAssertFalse(reader.isAtEnd)
+        XCTAssertEqual(readAll(reader, chunk: 300), (99_000 ..< 100_000).map { Int32($0) })
+        XCTAssertTrue(reader.isAtEnd)
+        XCTAssertEqual(reader.statistics.underruns, 0)
+        XCTAssertNil(reader.error)
+    }
+
+    func testStreamingFrameReaderUnderrun() throws {
+        let reader = try StreamingFrameReader(source: CountingFrameSource(length: 10_000, delay: 0.05), readAheadFrames: 4096, chunkFrames: 256)
+        reader.start()
+        defer {
+            reader.stop()
+        }
+        var buffer = [Int32](repeating: -1, count: 1024)
+        var frames = 1024
+        buffer.withUnsafeMutableBytes { bytes in
+            reader.read(frames: &frames, into: { _ in bytes.baseAddress! })
+        }
+        XCTAssertEqual(frames, 1024)
+        XCTAssertEqual(reader.statistics.underruns, 1)
+        let copied = 1024 - reader.statistics.underrunFrames
+        XCTAssertLessThan(copied, 1024)
+        XCTAssertTrue(buffer[copied...].allSatisfy { $0 == 0 })
+        XCTAssertEqual(reader.tell(), Int64(copied))
+        XCTAssertTrue(reader.waitForPrefetch(minimumFrames: 256, timeout: 5))
+        XCTAssertGreaterThanOrEqual(reader.statistics.maximumIOLatency, 0.04)
+    }
+
+    func testStreamingFrameWriter() throws {
+        let sink = CollectingFrameSink()
+        let writer = try StreamingFrameWriter(sink: sink, writeBehindFrames: 4096, chunkFrames: 500)
+        writer.start()
+        let samples = (0 ..< 50_000).map { Int32($0) }
+        var offset = 0
+        samples.withUnsafeBytes { bytes in
+            while offset < samples.count {
+                let frames = min(333, samples.count - offset)
+                let accepted = writer.write(frames: frames, from: { _ in bytes.baseAddress! + offset * 4 })
+                offset += accepted
+                if accepted < frames {
+                    writer.flush()
+                }
+            }
+        }
+        writer.stop()
+        XCTAssertEqual(sink.samples, samples)
+        XCTAssertNil(writer.error)
+
+        let slowSink = CollectingFrameSink(delay: 0.2)
+        let slowWriter = try StreamingFrameWriter(sink: slowSink, writeBehindFrames: 1024, chunkFrames: 1024)
+        slowWriter.start()
+        samples.withUnsafeBytes { bytes in
+            for _ in 0 ..< 4 {
+                slowWriter.write(frames: 1000, from: { _ in bytes.baseAddress! })
+            }
+        }
+        XCTAssertGreaterThanOrEqual(slowWriter.statistics.overruns, 1)
+        XCTAssertGreaterThanOrEqual(slowWriter.statistics.droppedFrames, 1000)
+        slowWriter.stop()
+        XCTAssertEqual(slowSink.samples.count + slowWriter.statistics.droppedFrames, 4000)
     }
 
-    func testPerformanceExample() throws {
-        // This is an example of a performance test case.
+    func testStreamingFrameReaderPerformance() throws {
+        let length = 1 << 22
         self.measure {
-            // Put the code you want to measure the time of here.
+            guard let reader = try? StreamingFrameReader(source: CountingFrameSource(length: length), readAheadFrames: 1 << 16, chunkFrames: 4096) else {
+                XCTFail("Couldn't create the reader")
+                return
+            }
+            reader.start()
+            XCTAssertEqual(readAll(reader, chunk: 512).count, length)
+            reader.stop()
+        }
+    }
+
+
+    // MARK: Sound banks
+
+    private func appendList(_ type: String, _ chunks: Data, to data: inout Data) {
+        var body = Data(type.utf8)
+        body.append(chunks)
+        appendChunk("LIST", body, bigEndian: false, to: &data)
+    }
+
+    private func makeInfoList(name: String) -> Data {
+        var info = Data()
+        var inam = Data(name.utf8)
+        inam.append(0)
+        appendChunk("INAM", inam, bigEndian: false, to: &info)
+        var list = Data()
+        appendList("INFO", info, to: &list)
+        return list
+    }
+
+    private func makeSoundFont(presets: [(name: String, program: UInt16, bank: UInt16)], sampleBytes: Int = 1000) -> Data {
+        var chunks = Data("sfbk".utf8)
+        chunks.append(makeInfoList(name: "Test Font"))
+        var samples = Data()
+        appendChunk("smpl", Data(count: sampleBytes), bigEndian: false, to: &samples)
+        appendList("sdta", samples, to: &chunks)
+        var headers = Data()
+        for preset in presets + [("EOP", 0, 0)] {
+            var name = Data(preset.name.utf8)
+            name.count = 20
+            headers.append(name)
+            appendBytes(preset.program.littleEndian, to: &headers)
+            appendBytes(preset.bank.littleEndian, to: &headers)
+            headers.append(Data(count: 14))
+        }
+        var hydra = Data()
+        appendChunk("phdr", headers, bigEndian: false, to: &hydra)
+        appendChunk("pbag", Data(count: 4), bigEndian: false, to: &hydra)
+        appendList("pdta", hydra, to: &chunks)
+        var file = Data()
+        appendChunk("RIFF", chunks, bigEndian: false, to: &file)
+        return file
+    }
+
+    private func makeDLS(instruments: [(name: String, bank: UInt32, program: UInt32)]) -> Data {
+        var chunks = Data("DLS ".utf8)
+        appendChunk("colh", Data([UInt8(instruments.count), 0, 0, 0]), bigEndian: false, to: &chunks)
+        var list = Data()
+        for instrument in instruments {
+            var header = Data()
+            appendBytes(UInt32(1).littleEndian, to: &header)
+            appendBytes(instrument.bank.littleEndian, to: &header)
+            appendBytes(instrument.program.littleEndian, to: &header)
+            var body = Data()
+            appendChunk("insh", header, bigEndian: false, to: &body)
+            appendList("lrgn", Data(), to: &body)
+            body.append(makeInfoList(name: instrument.name))
+            appendList("ins ", body, to: &list)
+        }
+        appendList("lins", list, to: &chunks)
+        appendList("wvpl", Data(count: 64), to: &chunks)
+        chunks.append(makeInfoList(name: "Test DLS"))
+        var file = Data()
+        appendChunk("RIFF", chunks, bigEndian: false, to: &file)
+        return file
+    }
+
+    func testSoundFontInfo() throws {
+        let font = try SoundBankInfo(data: makeSoundFont(presets: [("Piano", 0, 0), ("Strings", 48, 8), ("Drums", 0, 128)]))
+        XCTAssertEqual(font.kind, .soundFont2)
+        XCTAssertEqual(font.name, "Test Font")
+        XCTAssertEqual(font.instruments, [
+            SoundBankInstrument(name: "Piano", msb: 0x79, lsb: 0, program: 0),
+            SoundBankInstrument(name: "Strings", msb: 0x79, lsb: 8, program: 48),
+            SoundBankInstrument(name: "Drums", msb: 0x78, lsb: 0, program: 0),
+        ])
+
+        XCTAssertThrowsError(try SoundBankInfo(data: Data("RIFF\0\0\0\0WAVE".utf8))) { error in
+            XCTAssertEqual(error as? SoundBankError, .unknownFormat)
+        }
+        var truncated = makeSoundFont(presets: [("Piano", 0, 0)])
+        truncated.count -= 10
+        XCTAssertThrowsError(try SoundBankInfo(data: truncated))
+    }
+
+    func testDLSInfo() throws {
+        let bank = try SoundBankInfo(data: makeDLS(instruments: [("Piano", 0, 0), ("Organ", 0x0102, 17), ("Kit", 0x8000_0000, 25)]))
+        XCTAssertEqual(bank.kind, .dls)
+        XCTAssertEqual(bank.name, "Test DLS")
+        XCTAssertEqual(bank.instruments, [
+            SoundBankInstrument(name: "Piano", msb: 0x79, lsb: 0, program: 0),
+            SoundBankInstrument(name: "Organ", msb: 1, lsb: 2, program: 17),
+            SoundBankInstrument(name: "Kit", msb: 0x78, lsb: 0, program: 25),
+        ])
+    }
+
+    func testSoundBankIndex() throws {
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent("SoundBankIndexTest-\(UUID().uuidString)")
+        try FileManager.default.createDirectory(at: directory.appendingPathComponent("Sub"), withIntermediateDirectories: true)
+        defer {
+            try? FileManager.default.removeItem(at: directory)
+        }
+        let font = directory.appendingPathComponent("Font.SF2")
+        let dls = directory.appendingPathComponent("Sub/Bank.dls")
+        try makeSoundFont(presets: [("Piano", 0, 0)]).write(to: font)
+        try makeDLS(instruments: [("Organ", 0, 17)]).write(to: dls)
+        try Data("not a bank".utf8).write(to: directory.appendingPathComponent("Broken.sf2"))
+        try Data().write(to: directory.appendingPathComponent("Readme.txt"))
+
+        let index = SoundBankIndex()
+        var banks = try index.scan(directory: directory)
+        XCTAssertEqual(banks.count, 2)
+        XCTAssertEqual(index.count, 2)
+        let byName = Dictionary(uniqueKeysWithValues: banks.map { ($0.key.lastPathComponent, $0.value) })
+        XCTAssertEqual(byName["Font.SF2"]?.instruments.first?.name, "Piano")
+        XCTAssertEqual(byName["Bank.dls"]?.instruments.first?.program, 17)
+
+        let archive = directory.appendingPathComponent("Index.plist")
+        try index.write(to: archive)
+        let loaded = try SoundBankIndex(contentsOf: archive)
+        XCTAssertEqual(loaded.count, 2)
+        XCTAssertEqual(try loaded.info(at: font), byName["Font.SF2"])
+
+        // A changed size invalidates the cached entry.
+        try makeSoundFont(presets: [("Piano", 0, 0), ("Bass", 32, 0)]).write(to: font)
+        XCTAssertEqual(try loaded.info(at: font).instruments.count, 2)
+
+        try FileManager.default.removeItem(at: dls)
+        banks = try loaded.scan(directory: directory)
+        XCTAssertEqual(banks.count, 1)
+        XCTAssertEqual(loaded.count, 1)
+    }
+
+    func testSoundBankIndexScanPerformance() throws {
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent("SoundBankIndexTest-\(UUID().uuidString)")
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        defer {
+            try? FileManager.default.removeItem(at: directory)
+        }
+        let presets = (0 ..< 128).map { ("Preset \($0)", UInt16($0), UInt16(0)) }
+        let font = makeSoundFont(presets: presets, sampleBytes: 4 << 20)
+        for index in 0 ..< 32 {
+            try font.write(to: directory.appendingPathComponent("Font \(index).sf2"))
+        }
+        measure {
+            _ = try? SoundBankIndex().scan(directory: directory)
+        }
+    }
+
+    // MARK: SFNT
+
+    private func appendBigEndian(_ values: any FixedWidthInteger..., to data: inout Data) {
+        for value in values {
+            appendBigEndianValue(value, to: &data)
+        }
+    }
+
+    private func appendBigEndianValue<T: FixedWidthInteger>(_ value: T, to data: inout Data) {
+        appendBytes(value.bigEndian, to: &data)
+    }
+
+    private func appendUInt24(_ value: UInt32, to data: inout Data) {
+        data.append(contentsOf: [UInt8(truncatingIfNeeded: value >> 16), UInt8(truncatingIfNeeded: value >> 8), UInt8(truncatingIfNeeded: value)])
+    }
+
+    private static let defaultFormat12Groups: [(start: UInt32, end: UInt32, glyph: UInt32)] = [(65, 67, 1), (97, 97, 4), (0x1F600, 0x1F601, 2)]
+
+    /// A character map with 'A'-'C' on glyphs 1-3 and 'a' on glyph 4, plus U+1F600-U+1F601
+    /// on glyphs 2-3 if `includeFormat12` is set.
+    private func makeCharacterMap(includeFormat12: Bool, format12Groups: [(start: UInt32, end: UInt32, glyph: UInt32)] = FoundationAdditionsTests.defaultFormat12Groups) -> Data {
+        var format4 = Data()
+        appendBigEndian(UInt16(4), UInt16(0), UInt16(0), UInt16(6), UInt16(0), UInt16(0), UInt16(0), to: &format4)
+        appendBigEndian(UInt16(67), UInt16(97), UInt16(0xFFFF), UInt16(0), to: &format4)
+        appendBigEndian(UInt16(65), UInt16(97), UInt16(0xFFFF), to: &format4)
+        appendBigEndian(UInt16(0xFFC0), UInt16(0), UInt16(1), to: &format4)
+        appendBigEndian(UInt16(0), UInt16(4), UInt16(0), to: &format4)
+        appendBigEndian(UInt16(4), to: &format4)
+
+        var format12 = Data()
+        appendBigEndian(UInt16(12), UInt16(0), to: &format12)
+        appendBigEndian(UInt32(16 + format12Groups.count * 12), UInt32(0), UInt32(format12Groups.count), to: &format12)
+        for group in format12Groups {
+            appendBigEndian(group.start, group.end, group.glyph, to: &format12)
+        }
+
+        // U+FE0F after 'A' keeps the default glyph; after 'a' it picks glyph 3.
+        var format14 = Data()
+        appendBigEndian(UInt16(14), to: &format14)
+        appendBigEndian(UInt32(38), UInt32(1), to: &format14)
+        appendUInt24(0xFE0F, to: &format14)
+        appendBigEndian(UInt32(21), UInt32(29), UInt32(1), to: &format14)
+        appendUInt24(65, to: &format14)
+        format14.append(0)
+        appendBigEndian(UInt32(1), to: &format14)
+        appendUInt24(97, to: &format14)
+        appendBigEndian(UInt16(3), to: &format14)
+
+        var subtables: [(platform: UInt16, encoding: UInt16, data: Data)] = [(0, 3, format4), (0, 5, format14), (3, 1, format4)]
+        if includeFormat12 {
+            subtables.append((3, 10, format12))
+        }
+        var cmap = Data()
+        appendBigEndian(UInt16(0), UInt16(subtables.count), to: &cmap)
+        var offset = 4 + subtables.count * 8
+        for subtable in subtables {
+            appendBigEndian(subtable.platform, subtable.encoding, to: &cmap)
+            appendBigEndian(UInt32(offset), to: &cmap)
+            offset += subtable.data.count
+        }
+        for subtable in subtables {
+            cmap.append(subtable.data)
+        }
+        return cmap
+    }
+
+    private func makeFont(includeFormat12: Bool = true, format12Groups: [(start: UInt32, end: UInt32, glyph: UInt32)] = FoundationAdditionsTests.defaultFormat12Groups) -> Data {
+        var head = Data(count: 54)
+        head[18] = 0x03
+        head[19] = 0xE8 // 1000 units per em
+        var hhea = Data(count: 34)
+        appendBigEndian(UInt16(3), to: &hhea)
+        var maxp = Data()
+        appendBigEndian(UInt32(0x00005000), UInt16(6), to: &maxp)
+        var hmtx = Data()
+        for advance in [UInt16(500), 600, 700] {
+            appendBigEndian(advance, UInt16(0), to: &hmtx)
+        }
+        appendBigEndian(UInt16(0), UInt16(0), UInt16(0), to: &hmtx)
+        let tables: [(String, Data)] = [("cmap", makeCharacterMap(includeFormat12: includeFormat12, format12Groups: format12Groups)), ("head", head), ("hhea", hhea), ("hmtx", hmtx), ("maxp", maxp)]
+
+        var font = Data()
+        appendBigEndian(UInt32(0x00010000), UInt16(tables.count), UInt16(0), UInt16(0), UInt16(0), to: &font)
+        var offset = 12 + tables.count * 16
+        var contents = Data()
+        for (tag, table) in tables {
+            font.append(contentsOf: Array(tag.utf8))
+            appendBigEndian(UInt32(0), UInt32(offset), UInt32(table.count), to: &font)
+            contents.append(table)
+            contents.count = (contents.count + 3) & ~3
+            offset = 12 + tables.count * 16 + contents.count
+        }
+        font.append(contents)
+        return font
+    }
+
+    func testSFNTFont() throws {
+        let font = try SFNTFont(data: makeFont())
+        XCTAssertEqual(font.tableTags.map(\.description), ["cmap", "head", "hhea", "hmtx", "maxp"])
+        XCTAssertTrue(font.hasTable(FourCharacterCode("head")))
+        XCTAssertFalse(font.hasTable(FourCharacterCode("glyf")))
+        XCTAssertEqual(font.withUnsafeTable(FourCharacterCode("maxp"), { $0.count }), 6)
+        XCTAssertEqual(try font.unitsPerEm(), 1000)
+        XCTAssertEqual(try font.glyphCount(), 6)
+        XCTAssertThrowsError(try font.advances(orientation: .vertical)) { error in
+            XCTAssertEqual(error as? SFNTError, .missingTable(FourCharacterCode("vhea")))
+        }
+
+        let characterMap = try font.characterMap()
+        XCTAssertEqual(characterMap.glyph(for: "A"), 1)
+        XCTAssertEqual(characterMap.glyph(for: "C"), 3)
+        XCTAssertEqual(characterMap.glyph(for: "D"), 0)
+        XCTAssertEqual(characterMap.glyph(for: "a"), 4)
+        XCTAssertEqual(characterMap.glyph(for: 0x1F601), 3)
+        XCTAssertEqual(characterMap.glyph(for: 0x110000), 0)
+        XCTAssertEqual(characterMap.glyph(for: "A", variationSelector: "\u{FE0F}"), 1)
+        XCTAssertEqual(characterMap.glyph(for: "a", variationSelector: "\u{FE0F}"), 3)
+        XCTAssertNil(characterMap.glyph(for: "B", variationSelector: "\u{FE0F}"))
+        XCTAssertNil(characterMap.glyph(for: "a", variationSelector: "\u{FE0E}"))
+
+        let mapped = characterMap.glyphs(forCharacters: Array("AB\u{1F600}a".utf16))
+        XCTAssertEqual(mapped.glyphs, [1, 2, 2, 0, 4])
+        XCTAssertTrue(mapped.allMapped)
+        XCTAssertFalse(characterMap.glyphs(forCharacters: [65, 90, 0xD800]).allMapped)
+
+        let advances = try font.advances()
+        XCTAssertEqual(advances.unitsPerEm, 1000)
+        XCTAssertEqual(advances.advances, [500, 600, 700, 700, 700, 700])
+        let measured = advances.advances(forGlyphs: [1, 2, 5, 9])
+        XCTAssertEqual(measured.perGlyph, [600, 700, 700, 0])
+        XCTAssertEqual(measured.all, 2000)
+    }
+
+    func testSFNTFormat4AndCollections() throws {
+        let single = makeFont(includeFormat12: false)
+        let characterMap = try SFNTFont(data: single).characterMap()
+        XCTAssertEqual(characterMap.glyph(for: "B"), 2)
+        XCTAssertEqual(characterMap.glyph(for: "a"), 4)
+        XCTAssertEqual(characterMap.glyph(for: 0x1F600), 0)
+        XCTAssertEqual(characterMap.glyph(for: 0xFFFF), 0)
+
+        // A collection of the same font twice; table offsets are from the start of the file.
+        var collection = Data("ttcf".utf8)
+        appendBigEndian(UInt32(0x00010000), UInt32(2), UInt32(20), UInt32(20), to: &collection)
+        var font = single
+        for index in 0 ..< 5 {
+            let entry = 12 + index * 16 + 8
+            let offset = font.withUnsafeBytes { UInt32(bigEndian: $0.loadUnaligned(fromByteOffset: entry, as: UInt32.self)) } + 20
+            font.replaceSubrange(entry ..< entry + 4, with: withUnsafeBytes(of: offset.bigEndian) { Data($0) })
+        }
+        collection.append(font)
+        let second = try SFNTFont(data: collection, fontIndex: 1)
+        XCTAssertEqual(try second.characterMap().glyph(for: "C"), 3)
+        XCTAssertThrowsError(try SFNTFont(data: collection, fontIndex: 2)) { error in
+            XCTAssertEqual(error as? SFNTError, .fontIndexOutOfRange(2))
+        }
+        XCTAssertThrowsError(try SFNTFont(data: Data("not a font at all".utf8))) { error in
+            XCTAssertEqual(error as? SFNTError, .unknownFormat)
+        }
+    }
+
+    func testSFNTOverlappingGroups() throws {
+        // One group can cover every code point.
+        let full = try SFNTFont(data: makeFont(format12Groups: [(0, 0x10FFFF, 1)])).characterMap()
+        XCTAssertEqual(full.glyph(for: "A"), 0x42)
+        XCTAssertEqual(full.glyph(for: 0x10FFFE), 0xFFFF)
+
+        // Many full-range groups would take ages to expand, so they're rejected up front.
+        let hostile = makeFont(format12Groups: Array(repeating: (0, 0xFFFF_FFFF, 1), count: 1000))
+        XCTAssertThrowsError(try SFNTFont(data: hostile).characterMap()) { error in
+            XCTAssertEqual(error as? SFNTError, .overlappingRanges(FourCharacterCode("cmap")))
+        }
+    }
+
+    /// Font files installed on the system, to benchmark against real character maps.
+    private func fontCorpus() -> [URL] {
+        let directories = ["/usr/share/fonts", "/usr/local/share/fonts", "/System/Library/Fonts", "/Library/Fonts"]
+        var fonts = [URL]()
+        for directory in directories {
+            guard let enumerator = FileManager.default.enumerator(at: URL(fileURLWithPath: directory), includingPropertiesForKeys: nil) else {
+                continue
+            }
+            for case let url as URL in enumerator where ["ttf", "otf", "ttc"].contains(url.pathExtension.lowercased()) {
+                fonts.append(url)
+            }
+        }
+        return fonts
+    }
+
+    func testSFNTCorpusLoadPerformance() throws {
+        let fonts = fontCorpus()
+        guard !fonts.isEmpty else {
+            throw XCTSkip("No fonts are installed")
+        }
+        measure {
+            for url in fonts {
+                _ = try? SFNTFont(contentsOf: url).characterMap()
+            }
+        }
+    }
+
+    func testSFNTCorpusGlyphMappingPerformance() throws {
+        let maps = fontCorpus().prefix(32).compactMap { try? SFNTFont(contentsOf: $0).characterMap() }
+        guard !maps.isEmpty else {
+            throw XCTSkip("No fonts are installed")
+        }
+        let characters = Array(String(repeating: "The quick brown fox jumps over the lazy dog. Ünïcödé ✓ \u{1F600} ", count: 2_000).utf16)
+        var glyphs = [UInt16](repeating: 0, count: characters.count)
+        measure {
+            characters.withUnsafeBufferPointer { (characters) in
+                glyphs.withUnsafeMutableBufferPointer { (glyphs) in
+                    for map in maps {
+                        map.glyphs(forCharacters: characters, into: glyphs)
+                    }
+                }
+            }
+        }
+    }
+
+    // MARK: ICC
+
+    /// Apple's "Linear RGB Profile": gamma 1.0 curves in a v2 matrix/TRC profile.
+    private let linearRGBProfile = Data([
+        0x00, 0x00, 0x02, 0x20, 0x61, 0x70, 0x70, 0x6C, 0x02, 0x20, 0x00, 0x00,
+        0x6D, 0x6E, 0x74, 0x72, 0x52, 0x47, 0x42, 0x20, 0x58, 0x59, 0x5A, 0x20,
+        0x07, 0xD2, 0x00, 0x05, 0x00, 0x0D, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x00,
+        0x61, 0x63, 0x73, 0x70, 0x41, 0x50, 0x50, 0x4C, 0x00, 0x00, 0x00, 0x00,
+        0x61, 0x70, 0x70, 0x6C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF6, 0xD6,
+        0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0xD3, 0x2D, 0x61, 0x70, 0x70, 0x6C,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0A,
+        0x72, 0x58, 0x59, 0x5A, 0x00, 0x00, 0x00, 0xFC, 0x00, 0x00, 0x00, 0x14,
+        0x67, 0x58, 0x59, 0x5A, 0x00, 0x00, 0x01, 0x10, 0x00, 0x00, 0x00, 0x14,
+        0x62, 0x58, 0x59, 0x5A, 0x00, 0x00, 0x01, 0x24, 0x00, 0x00, 0x00, 0x14,
+        0x77, 0x74, 0x70, 0x74, 0x00, 0x00, 0x01, 0x38, 0x00, 0x00, 0x00, 0x14,
+        0x63, 0x68, 0x61, 0x64, 0x00, 0x00, 0x01, 0x4C, 0x00, 0x00, 0x00, 0x2C,
+        0x72, 0x54, 0x52, 0x43, 0x00, 0x00, 0x01, 0x78, 0x00, 0x00, 0x00, 0x0E,
+        0x67, 0x54, 0x52, 0x43, 0x00, 0x00, 0x01, 0x78, 0x00, 0x00, 0x00, 0x0E,
+        0x62, 0x54, 0x52, 0x43, 0x00, 0x00, 0x01, 0x78, 0x00, 0x00, 0x00, 0x0E,
+        0x64, 0x65, 0x73, 0x63, 0x00, 0x00, 0x01, 0xB0, 0x00, 0x00, 0x00, 0x6D,
+        0x63, 0x70, 0x72, 0x74, 0x00, 0x00, 0x01, 0x88, 0x00, 0x00, 0x00, 0x26,
+        0x58, 0x59, 0x5A, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x74, 0x4B,
+        0x00, 0x00, 0x3E, 0x1D, 0x00, 0x00, 0x03, 0xCB, 0x58, 0x59, 0x5A, 0x20,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5A, 0x73, 0x00, 0x00, 0xAC, 0xA6,
+        0x00, 0x00, 0x17, 0x26, 0x58, 0x59, 0x5A, 0x20, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x28, 0x18, 0x00, 0x00, 0x15, 0x57, 0x00, 0x00, 0xB8, 0x33,
+        0x58, 0x59, 0x5A, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF3, 0x52,
+        0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x16, 0xCF, 0x73, 0x66, 0x33, 0x32,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x0C, 0x42, 0x00, 0x00, 0x05, 0xDE,
+        0xFF, 0xFF, 0xF3, 0x26, 0x00, 0x00, 0x07, 0x92, 0x00, 0x00, 0xFD, 0x91,
+        0xFF, 0xFF, 0xFB, 0xA2, 0xFF, 0xFF, 0xFD, 0xA3, 0x00, 0x00, 0x03, 0xDC,
+        0x00, 0x00, 0xC0, 0x6C, 0x63, 0x75, 0x72, 0x76, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x74, 0x65, 0x78, 0x74,
+        0x00, 0x00, 0x00, 0x00, 0x43, 0x6F, 0x70, 0x79, 0x72, 0x69, 0x67, 0x68,
+        0x74, 0x20, 0x41, 0x70, 0x70, 0x6C, 0x65, 0x20, 0x43, 0x6F, 0x6D, 0x70,
+        0x75, 0x74, 0x65, 0x72, 0x20, 0x49, 0x6E, 0x63, 0x2E, 0x00, 0x00, 0x00,
+        0x64, 0x65, 0x73, 0x63, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x13,
+        0x4C, 0x69, 0x6E, 0x65, 0x61, 0x72, 0x20, 0x52, 0x47, 0x42, 0x20, 0x50,
+        0x72, 0x6F, 0x66, 0x69, 0x6C, 0x65, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00
+    ])
+
+    private static let sRGBColorants = [(0.4361, 0.2225, 0.0139), (0.3851, 0.7169, 0.0971), (0.1431, 0.0606, 0.7141)]
+
+    private func s15Fixed16(_ value: Double) -> UInt32 {
+        return UInt32(bitPattern: Int32((value * 65536).rounded()))
+    }
+
+    private func gammaCurve(_ gamma: Double) -> Data {
+        var curve = Data("curv".utf8)
+        appendBigEndian(UInt32(0), UInt32(1), UInt16((gamma * 256).rounded()), to: &curve)
+        return curve
+    }
+
+    private var sRGBCurve: Data {
+        var curve = Data("para".utf8)
+        appendBigEndian(UInt32(0), UInt16(3), UInt16(0), to: &curve)
+        for parameter in [2.4, 1 / 1.055, 0.055 / 1.055, 1 / 12.92, 0.04045] {
+            appendBigEndian(s15Fixed16(parameter), to: &curve)
+        }
+        return curve
+    }
+
+    /// A matrix/TRC RGB profile, or a gray profile if `colorants` is empty.
+    private func makeICCProfile(colorants: [(Double, Double, Double)] = FoundationAdditionsTests.sRGBColorants, curve: Data, connectionSpace: String = "XYZ ") -> Data {
+        var tags = [(String, Data)]()
+        for (signature, colorant) in zip(["rXYZ", "gXYZ", "bXYZ"], colorants) {
+            var xyz = Data("XYZ ".utf8)
+            appendBigEndian(UInt32(0), s15Fixed16(colorant.0), s15Fixed16(colorant.1), s15Fixed16(colorant.2), to: &xyz)
+            tags.append((signature, xyz))
+        }
+        for signature in colorants.isEmpty ? ["kTRC"] : ["rTRC", "gTRC", "bTRC"] {
+            tags.append((signature, curve))
+        }
+
+        var body = Data()
+        var entries = Data()
+        var offset = 128 + 4 + tags.count * 12
+        for (signature, tag) in tags {
+            entries.append(contentsOf: Array(signature.utf8))
+            appendBigEndian(UInt32(offset), UInt32(tag.count), to: &entries)
+            body.append(tag)
+            body.count = (body.count + 3) & ~3
+            offset = 128 + 4 + tags.count * 12 + body.count
+        }
+        var profile = Data(count: 128)
+        profile.replaceSubrange(8 ..< 24, with: Data([0x02, 0x10, 0, 0] + Array("mntr".utf8) + Array((colorants.isEmpty ? "GRAY" : "RGB ").utf8) + Array(connectionSpace.utf8)))
+        profile.replaceSubrange(36 ..< 40, with: Data("acsp".utf8))
+        appendBigEndian(UInt32(tags.count), to: &profile)
+        profile.append(entries)
+        profile.append(body)
+        profile.replaceSubrange(0 ..< 4, with: withUnsafeBytes(of: UInt32(profile.count).bigEndian) { Data($0) })
+        return profile
+    }
+
+    private func transformPixels<T>(_ transform: ICCTransform, _ pixels: [T], width: Int, from sourceFormat: ICCPixelFormat, to destinationFormat: ICCPixelFormat, destinationComponents: Int, as _: T.Type, rowsPerTile: Int? = nil, maximumConcurrency: Int = 4) -> [T] where T: Numeric {
+        let sourceComponents = pixels.count / width
+        var output = [T](repeating: 0, count: destinationComponents * width)
+        pixels.withUnsafeBytes { (source) in
+            output.withUnsafeMutableBytes { (destination) in
+                // One pixel per row, so the rows split into tiles.
+                transform.transform(width: 1, height: width,
+                                    destination: (destination.baseAddress!, destinationFormat, destinationComponents * MemoryLayout<T>.size),
+                                    source: (source.baseAddress!, sourceFormat, sourceComponents * MemoryLayout<T>.size),
+                                    rowsPerTile: rowsPerTile, maximumConcurrency: maximumConcurrency)
+            }
+        }
+        return output
+    }
+
+    func testICCProfileParsing() throws {
+        let linear = try ICCMatrixProfile(data: linearRGBProfile)
+        XCTAssertEqual(linear.colorSpace, .rgb)
+        XCTAssertEqual(linear.curves, [.gamma(1), .gamma(1), .gamma(1)])
+        XCTAssertEqual(linear.matrix[0], Double(0x744B) / 65536, accuracy: 1e-9)
+        XCTAssertEqual(linear.matrix[3] + linear.matrix[4] + linear.matrix[5], 1, accuracy: 0.001)
+
+        let sRGB = try ICCMatrixProfile(data: makeICCProfile(curve: sRGBCurve))
+        XCTAssertEqual(sRGB.curves[0].evaluate(0.5), 0.2140, accuracy: 0.0005)
+        XCTAssertEqual(sRGB.curves[0].evaluate(0.02), 0.02 / 12.92, accuracy: 0.0001)
+        XCTAssertEqual(sRGB.curves[0].inverse(0.2140), 0.5, accuracy: 0.0005)
+        XCTAssertEqual(ICCToneCurve.table([0, 16384, 65535]).inverse(0.125), 0.25, accuracy: 1e-6)
+
+        let gray = try ICCMatrixProfile(data: makeICCProfile(colorants: [], curve: gammaCurve(2.2)))
+        XCTAssertEqual(gray.colorSpace, .gray)
+
+        XCTAssertThrowsError(try ICCMatrixProfile(data: linearRGBProfile.prefix(100))) { error in
+            XCTAssertEqual(error as? ICCProfileError, .invalidHeader)
+        }
+        XCTAssertThrowsError(try ICCMatrixProfile(data: makeICCProfile(curve: sRGBCurve, connectionSpace: "Lab "))) { error in
+            XCTAssertEqual(error as? ICCProfileError, .unsupportedColorSpace(FourCharacterCode("Lab ")))
+        }
+        var noCurves = makeICCProfile(curve: sRGBCurve)
+        noCurves.replaceSubrange(132 + 3 * 12 ..< 132 + 3 * 12 + 4, with: Data("xTRC".utf8))
+        XCTAssertThrowsError(try ICCMatrixProfile(data: noCurves)) { error in
+            XCTAssertEqual(error as? ICCProfileError, .missingTag(FourCharacterCode("rTRC")))
+        }
+    }
+
+    func testICCTransform() throws {
+        let sRGB = try ICCMatrixProfile(data: makeICCProfile(curve: sRGBCurve))
+        let linear = try ICCMatrixProfile(data: makeICCProfile(curve: gammaCurve(1)))
+        let gray = try ICCMatrixProfile(data: makeICCProfile(colorants: [], curve: gammaCurve(2.2)))
+        let rgb8 = ICCPixelFormat(depth: .uint8)
+
+        // Identity, over every 8-bit gray level.
+        let levels = (0 ..< 256).flatMap { [UInt8($0), UInt8($0), UInt8(255 - $0)] }
+        let identity = try ICCTransform(from: sRGB, to: sRGB)
+        let same = transformPixels(identity, levels, width: 256, from: rgb8, to: rgb8, destinationComponents: 3, as: UInt8.self)
+        for (result, expected) in zip(same, levels) {
+            XCTAssertLessThanOrEqual(abs(Int(result) - Int(expected)), 1)
+        }
+
+        // sRGB 128 is 21.6% linear light.
+        let toLinear = try ICCTransform(from: sRGB, to: linear)
+        XCTAssertEqual(transformPixels(toLinear, [128, 128, 128], width: 1, from: rgb8, to: rgb8, destinationComponents: 3, as: UInt8.self), [55, 55, 55])
+        let floats = transformPixels(toLinear, [128, 128, 128] as [UInt8], width: 1, from: rgb8, to: ICCPixelFormat(depth: .float32, layout: .byteOrder32Little), destinationComponents: 3 * 4, as: UInt8.self)
+        let linearValue = floats.withUnsafeBytes { Float(bitPattern: UInt32(littleEndian: $0.loadUnaligned(as: UInt32.self))) }
+        XCTAssertEqual(linearValue, 0.2159, accuracy: 0.001)
+
+        // Layouts: premultiplied RGBA in, little-endian 32-bit (BGRA in memory) out.
+        var premultipliedLast = ICCPixelFormat.Layout()
+        premultipliedLast.alphaInfo = .premultipliedLast
+        var firstLittle = ICCPixelFormat.Layout.byteOrder32Little
+        firstLittle.alphaInfo = .first
+        let bgra = transformPixels(identity, [100, 50, 25, 128], width: 1, from: ICCPixelFormat(depth: .uint8, layout: premultipliedLast), to: ICCPixelFormat(depth: .uint8, layout: firstLittle), destinationComponents: 4, as: UInt8.self)
+        XCTAssertEqual(bgra[3], 128)
+        XCTAssertLessThanOrEqual(abs(Int(bgra[2]) - 199), 1)
+        XCTAssertLessThanOrEqual(abs(Int(bgra[1]) - 100), 1)
+        XCTAssertLessThanOrEqual(abs(Int(bgra[0]) - 50), 1)
+
+        // 16-bit little-endian with padding.
+        var skipLast = ICCPixelFormat.Layout.byteOrder16Little
+        skipLast.alphaInfo = .noneSkipLast
+        let wide = transformPixels(identity, [UInt16(1000).littleEndian, UInt16(30000).littleEndian, UInt16(65535).littleEndian, 0], width: 1, from: ICCPixelFormat(depth: .uint16, layout: skipLast), to: ICCPixelFormat(depth: .uint16, layout: skipLast), destinationComponents: 4, as: UInt16.self).map({ UInt16(littleEndian: $0) })
+        XCTAssertLessThanOrEqual(abs(Int(wide[0]) - 1000), 8)
+        XCTAssertLessThanOrEqual(abs(Int(wide[1]) - 30000), 8)
+        XCTAssertEqual(wide[2], 65535)
+        XCTAssertEqual(wide[3], 65535)
+
+        // Gray to and from RGB.
+        let toGray = try ICCTransform(from: sRGB, to: gray)
+        XCTAssertEqual(transformPixels(toGray, [255, 255, 255, 0, 0, 0], width: 2, from: rgb8, to: rgb8, destinationComponents: 1, as: UInt8.self), [255, 0])
+        let fromGray = try ICCTransform(from: gray, to: sRGB)
+        let white = transformPixels(fromGray, [255], width: 1, from: rgb8, to: rgb8, destinationComponents: 3, as: UInt8.self)
+        XCTAssertTrue(white.allSatisfy({ $0 >= 254 }), "\(white)")
+    }
+
+    func testICCTransformDefaultByteOrder() throws {
+        // Without a byte-order flag, 16-bit and float components are big-endian.
+        let sRGB = try ICCMatrixProfile(data: makeICCProfile(curve: sRGBCurve))
+        let linear = try ICCMatrixProfile(data: makeICCProfile(curve: gammaCurve(1)))
+        let rgb8 = ICCPixelFormat(depth: .uint8)
+
+        let identity = try ICCTransform(from: sRGB, to: sRGB)
+        let rgb16 = ICCPixelFormat(depth: .uint16)
+        let pixel = [UInt16(1000).bigEndian, UInt16(30000).bigEndian, UInt16(65535).bigEndian]
+        let wide = transformPixels(identity, pixel, width: 1, from: rgb16, to: rgb16, destinationComponents: 3, as: UInt16.self)
+        XCTAssertEqual(wide, transformPixels(identity, pixel, width: 1, from: ICCPixelFormat(depth: .uint16, layout: .byteOrder16Big), to: ICCPixelFormat(depth: .uint16, layout: .byteOrder16Big), destinationComponents: 3, as: UInt16.self))
+        let values = wide.map({ UInt16(bigEndian: $0) })
+        XCTAssertLessThanOrEqual(abs(Int(values[0]) - 1000), 8)
+        XCTAssertLessThanOrEqual(abs(Int(values[1]) - 30000), 8)
+        XCTAssertEqual(values[2], 65535)
+
+        let toLinear = try ICCTransform(from: sRGB, to: linear)
+        let floats = transformPixels(toLinear, [128, 128, 128] as [UInt8], width: 1, from: rgb8, to: ICCPixelFormat(depth: .float32), destinationComponents: 3 * 4, as: UInt8.self)
+        let linearValue = floats.withUnsafeBytes { Float(bitPattern: UInt32(bigEndian: $0.loadUnaligned(as: UInt32.self))) }
+        XCTAssertEqual(linearValue, 0.2159, accuracy: 0.001)
+
+        let fromLinear = try ICCTransform(from: linear, to: sRGB)
+        let floatPixel = withUnsafeBytes(of: Float(0.2159).bitPattern.bigEndian) { Array($0) }
+        let encoded = transformPixels(fromLinear, floatPixel + floatPixel + floatPixel, width: 1, from: ICCPixelFormat(depth: .float32), to: rgb8, destinationComponents: 3, as: UInt8.self)
+        XCTAssertTrue(encoded.allSatisfy({ abs(Int($0) - 128) <= 1 }), "\(encoded)")
+    }
+
+    func testICCTransformTiling() throws {
+        let transform = try ICCTransform(from: ICCMatrixProfile(data: makeICCProfile(curve: sRGBCurve)), to: ICCMatrixProfile(data: linearRGBProfile))
+        let format = ICCPixelFormat(depth: .uint8)
+        var generator = SystemRandomNumberGenerator()
+        let pixels = (0 ..< 3 * 1000).map { _ in UInt8.random(in: 0 ... 255, using: &generator) }
+        let serial = transformPixels(transform, pixels, width: 1000, from: format, to: format, destinationComponents: 3, as: UInt8.self, maximumConcurrency: 1)
+        XCTAssertEqual(transformPixels(transform, pixels, width: 1000, from: format, to: format, destinationComponents: 3, as: UInt8.self, rowsPerTile: 7, maximumConcurrency: 8), serial)
+        XCTAssertEqual(transformPixels(transform, pixels, width: 1000, from: format, to: format, destinationComponents: 3, as: UInt8.self, rowsPerTile: 1000), serial)
+    }
+
+    private func measureICCTransform(maximumConcurrency: Int) throws {
+        let transform = try ICCTransform(from: ICCMatrixProfile(data: makeICCProfile(curve: sRGBCurve)), to: ICCMatrixProfile(data: makeICCProfile(colorants: [(0.6097, 0.3111, 0.0195), (0.2053, 0.6257, 0.0609), (0.1492, 0.0632, 0.7446)], curve: gammaCurve(2.2))))
+        var layout = ICCPixelFormat.Layout()
+        layout.alphaInfo = .premultipliedLast
+        let format = ICCPixelFormat(depth: .uint8, layout: layout)
+        let (width, height) = (4096, 1024)
+        let source = [UInt8](repeating: 0x80, count: width * height * 4)
+        var destination = [UInt8](repeating: 0, count: width * height * 4)
+        measure {
+            source.withUnsafeBytes { (source) in
+                destination.withUnsafeMutableBytes { (destination) in
+                    transform.transform(width: width, height: height, destination: (destination.baseAddress!, format, width * 4), source: (source.baseAddress!, format, width * 4), maximumConcurrency: maximumConcurrency)
+                }
+            }
+        }
+    }
+
+    func testICCTransformPerformance() throws {
+        try measureICCTransform(maximumConcurrency: ProcessInfo.processInfo.activeProcessorCount)
+    }
+
+    func testICCTransformSingleThreadPerformance() throws {
+        try measureICCTransform(maximumConcurrency: 1)
+    }
+
+    // MARK: - Shared memory transport
+
+    func testRingAllocator() {
+        var allocator = RingAllocator(capacity: 4096)
+        XCTAssertEqual(allocator.reserve(1000), 0)
+        XCTAssertEqual(allocator.reserve(2000), 1024)
+        // Doesn't fit at the tail, and nothing is free at the start yet.
+        XCTAssertNil(allocator.reserve(2000))
+        XCTAssertTrue(allocator.release(through: 1000))
+        XCTAssertNil(allocator.reserve(2000))
+        XCTAssertTrue(allocator.release(through: 3072))
+        XCTAssertEqual(allocator.reserve(2000), 4096)
+        XCTAssertFalse(allocator.release(through: 100))
+
+        var tracker = RingReleaseTracker()
+        tracker.arrived(end: 100)
+        tracker.arrived(end: 200)
+        tracker.arrived(end: 300)
+        tracker.finished(end: 200)
+        XCTAssertEqual(tracker.released, 0)
+        tracker.finished(end: 100)
+        XCTAssertEqual(tracker.released, 200)
+        tracker.finished(end: 300)
+        XCTAssertEqual(tracker.released, 300)
+    }
+
+    /// Records what a transport handler was called with.
+    private final class MessageLog: @unchecked Sendable {
+        private let lock = NSLock()
+        private var ids = [Int32]()
+        private var byteCount = 0
+        private let expectedCount: Int
+        private let done: XCTestExpectation?
+
+        init(expectedCount: Int = 0, done: XCTestExpectation? = nil) {
+            self.expectedCount = expectedCount
+            self.done = done
+        }
+
+        func record(_ id: Int32, byteCount count: Int = 0) {
+            lock.lock()
+            ids.append(id)
+            byteCount += count
+            let finished = ids.count == expectedCount
+            lock.unlock()
+            if finished {
+                done?.fulfill()
+            }
+        }
+
+        var messageIDs: [Int32] {
+            lock.lock()
+            defer {
+                lock.unlock()
+            }
+            return ids
+        }
+    }
+
+    /// Replies with the payload reversed, or `nil` for message 0.
+    private static let reversingHandler: SharedMemoryTransport.Handler = { (messageID, payload) in
+        return messageID == 0 ? nil : Data(payload.reversed())
+    }
+
+    private func makeTransportPair(ringCapacity: Int = 1 << 20, inlineLimit: Int = 4096, handler: @escaping SharedMemoryTransport.Handler = reversingHandler) throws -> (client: SharedMemoryTransport, server: SharedMemoryTransport) {
+        let (clientChannel, serverChannel) = try UnixSocketChannel.makePair()
+        let server = try SharedMemoryTransport(channel: serverChannel, ringCapacity: ringCapacity, inlineLimit: inlineLimit, handler: handler)
+        server.setDispatchQueue(DispatchQueue(label: "server"))
+        let client = try SharedMemoryTransport(channel: clientChannel, ringCapacity: ringCapacity, inlineLimit: inlineLimit)
+        return (client, server)
+    }
+
+    private func makePattern(count: Int, seed: UInt8) -> Data {
+        return Data((0 ..< count).map { UInt8(truncatingIfNeeded: $0 &* 31) &+ seed })
+    }
+
+    func testSharedMemoryTransportRequests() throws {
+        let (client, server) = try makeTransportPair()
+        defer {
+            client.invalidate()
+            server.invalidate()
+        }
+
+        XCTAssertEqual(try client.sendRequest(messageID: 1, data: Data("hello".utf8), sendTimeout: 5, receiveTimeout: 5), Data("olleh".utf8))
+        XCTAssertNil(try client.sendRequest(messageID: 0, data: Data("hello".utf8), sendTimeout: 5, receiveTimeout: 5))
+        XCTAssertEqual(try client.sendRequest(messageID: 1, data: Data(), sendTimeout: 5, receiveTimeout: 5), Data())
+
+        // Enough 192KiB round trips to wrap both 1MiB rings several times.
+        for seed in 0 ..< 24 {
+            let payload = makePattern(count: 192 * 1024 + seed, seed: UInt8(seed))
+            XCTAssertEqual(try client.sendRequest(messageID: 2, data: payload, sendTimeout: 5, receiveTimeout: 5), Data(payload.reversed()))
+        }
+
+        let sum = try client.sendRequest(messageID: 3, byteCount: 65536, sendTimeout: 5, receiveTimeout: 5, fill: { (buffer) in
+            buffer.initializeMemory(as: UInt8.self, repeating: 2)
+        }, reply: { (buffer) in
+            return buffer?.reduce(0) { $0 + Int($1) }
+        })
+        XCTAssertEqual(sum, 131072)
+
+        let clientStatistics = client.statistics
+        let serverStatistics = server.statistics
+        XCTAssertEqual(clientStatistics.roundTrips, 28)
+        XCTAssertEqual(clientStatistics.ringMessagesSent, 25)
+        XCTAssertEqual(serverStatistics.ringMessagesSent, 25)
+        XCTAssertEqual(serverStatistics.messagesReceived, 28)
+        XCTAssertEqual(serverStatistics.replyFailures, 0)
+        XCTAssertGreaterThan(clientStatistics.averageRoundTripLatency, 0)
+        XCTAssertGreaterThanOrEqual(clientStatistics.maximumRoundTripLatency, clientStatistics.averageRoundTripLatency)
+    }
+
+    func testSharedMemoryTransportConcurrentRequests() throws {
+        let (client, server) = try makeTransportPair(ringCapacity: 512 * 1024)
+        defer {
+            client.invalidate()
+            server.invalidate()
+        }
+        let failures = MessageLog()
+        DispatchQueue.concurrentPerform(iterations: 8) { (worker) in
+            for round in 0 ..< 20 {
+                let payload = makePattern(count: (round % 3 == 0) ? 100 : 48 * 1024 + worker, seed: UInt8(worker * 20 + round))
+                let reply = try? client.sendRequest(messageID: 1, data: payload, sendTimeout: 10, receiveTimeout: 10)
+                if reply != Data(payload.reversed()) {
+                    failures.record(Int32(worker))
+                }
+            }
+        }
+        XCTAssertEqual(failures.messageIDs, [])
+        XCTAssertEqual(client.statistics.roundTrips, 160)
+    }
+
+    /// A channel that accepts smaller frames than the socket under it.
+    private final class LimitedChannel: SharedMemoryChannel, @unchecked Sendable {
+        let base: UnixSocketChannel
+        let maximumFrameSize: Int
+
+        init(_ base: UnixSocketChannel, maximumFrameSize: Int) {
+            self.base = base
+            self.maximumFrameSize = maximumFrameSize
+        }
+
+        func start(receiving frameHandler: @escaping @Sendable (UnsafeRawBufferPointer) -> Void, closed closeHandler: @escaping @Sendable () -> Void) throws {
+            try base.start(receiving: frameHandler, closed: closeHandler)
+        }
+
+        func send(_ frame: UnsafeRawBufferPointer) throws {
+            guard frame.count <= maximumFrameSize else {
+                throw SharedMemoryTransportError.payloadTooLarge
+            }
+            try base.send(frame)
+        }
+
+        func close() {
+            base.close()
+        }
+    }
+
+    func testSharedMemoryTransportPayloadTooLarge() throws {
+        let (clientChannel, serverChannel) = try UnixSocketChannel.makePair()
+        let server = try SharedMemoryTransport(channel: serverChannel, ringCapacity: 4096, handler: FoundationAdditionsTests.reversingHandler)
+        server.setDispatchQueue(DispatchQueue(label: "server"))
+        let client = try SharedMemoryTransport(channel: LimitedChannel(clientChannel, maximumFrameSize: 65536), ringCapacity: 4096, inlineLimit: 1024, batchLimit: 2048)
+        defer {
+            client.invalidate()
+            server.invalidate()
+        }
+
+        // Too large for the ring, so it would go inline, and too large for the channel.
+        let large = makePattern(count: 100_000, seed: 1)
+        XCTAssertThrowsError(try client.sendRequest(messageID: 1, data: large, sendTimeout: 5, receiveTimeout: 5)) { error in
+            XCTAssertEqual(error as? SharedMemoryTransportError, .payloadTooLarge)
+        }
+        XCTAssertThrowsError(try client.send(messageID: 1, data: large, sendTimeout: 5)) { error in
+            XCTAssertEqual(error as? SharedMemoryTransportError, .payloadTooLarge)
+        }
+        XCTAssertTrue(client.isValid)
+
+        // Larger than the batch limit, so it goes out on its own instead of in a batch.
+        let framesBefore = client.statistics.framesSent
+        try client.send(messageID: 1, data: makePattern(count: 8000, seed: 2), sendTimeout: 5)
+        XCTAssertEqual(client.statistics.framesSent, framesBefore + 1)
+
+        let small = makePattern(count: 300, seed: 3)
+        XCTAssertEqual(try client.sendRequest(messageID: 1, data: small, sendTimeout: 5, receiveTimeout: 5), Data(small.reversed()))
+    }
+
+    func testSharedMemoryTransportBatching() throws {
+        let done = expectation(description: "All messages handled")
+        let log = MessageLog(expectedCount: 2000, done: done)
+        let (client, server) = try makeTransportPair(handler: { (messageID, payload) in
+            log.record(messageID, byteCount: payload.count)
+            return nil
+        })
+        defer {
+            client.invalidate()
+            server.invalidate()
+        }
+        for id in 0 ..< 2000 {
+            try client.send(messageID: Int32(id), data: makePattern(count: 40, seed: UInt8(truncatingIfNeeded: id)), sendTimeout: 5)
+        }
+        try client.flush()
+        wait(for: [done], timeout: 10)
+        XCTAssertEqual(log.messageIDs, (0 ..< 2000).map { Int32($0) })
+        let statistics = client.statistics
+        XCTAssertEqual(statistics.messagesSent, 2000)
+        XCTAssertGreaterThan(statistics.batchesSent, 0)
+        XCTAssertLessThan(statistics.framesSent, 2000)
+    }
+
+    func testSharedMemoryTransportInvalidation() throws {
+        let (client, server) = try makeTransportPair()
+        server.invalidate()
+        let deadline = Date(timeIntervalSinceNow: 5)
+        while client.isValid && Date() < deadline {
+            Thread.sleep(forTimeInterval: 0.01)
+        }
+        XCTAssertFalse(client.isValid)
+        XCTAssertThrowsError(try client.sendRequest(messageID: 1, data: Data(count: 8), sendTimeout: 1, receiveTimeout: 1)) { (error) in
+            XCTAssertEqual(error as? SharedMemoryTransportError, .invalid)
+        }
+    }
+
+    /// Sends a hello frame from `channel` naming `path` as its ring.
+    private func sendHello(on channel: UnixSocketChannel, path: String, count: Int) throws {
+        var hello = TransportHeader(kind: .hello)
+        hello.length = UInt64(count)
+        var frame = Data(count: TransportHeader.size)
+        frame.withUnsafeMutableBytes { hello.write(to: $0) }
+        frame.append(Data(path.utf8))
+        try frame.withUnsafeBytes { try channel.send($0) }
+    }
+
+    private func waitForInvalidation(_ transport: SharedMemoryTransport) {
+        let deadline = Date(timeIntervalSinceNow: 5)
+        while transport.isValid && Date() < deadline {
+            Thread.sleep(forTimeInterval: 0.01)
         }
     }
 
+    func testSharedMemoryTransportRejectsForeignRings() throws {
+        // A file that isn't a ring must be left alone.
+        let bystander = FileManager.default.temporaryDirectory.appendingPathComponent("NotARing-\(UUID().uuidString)")
+        try Data(count: 4096).write(to: bystander)
+        defer {
+            try? FileManager.default.removeItem(at: bystander)
+        }
+        var (channel, peer) = try UnixSocketChannel.makePair()
+        try peer.start(receiving: { _ in }, closed: {})
+        var transport = try SharedMemoryTransport(channel: channel, ringCapacity: 4096)
+        try sendHello(on: peer, path: bystander.path, count: 4096)
+        waitForInvalidation(transport)
+        XCTAssertFalse(transport.isValid)
+        XCTAssertTrue(FileManager.default.fileExists(atPath: bystander.path))
+        peer.close()
+
+        // Only the first hello on a connection is accepted.
+        let first = try SharedMemoryRegion(creatingWithCount: 4096)
+        let second = try SharedMemoryRegion(creatingWithCount: 4096)
+        defer {
+            second.removeFile()
+        }
+        (channel, peer) = try UnixSocketChannel.makePair()
+        try peer.start(receiving: { _ in }, closed: {})
+        transport = try SharedMemoryTransport(channel: channel, ringCapacity: 4096)
+        try sendHello(on: peer, path: first.path, count: 4096)
+        try sendHello(on: peer, path: second.path, count: 4096)
+        waitForInvalidation(transport)
+        XCTAssertFalse(transport.isValid)
+        XCTAssertFalse(FileManager.default.fileExists(atPath: first.path))
+        XCTAssertTrue(FileManager.default.fileExists(atPath: second.path))
+        peer.close()
+    }
+
+    private static let transportPeerEnvironmentKey = "SHARED_MEMORY_TRANSPORT_PEER_SOCKET"
+
+    func testSharedMemoryTransportBetweenProcesses() throws {
+        let socketPath = "/tmp/transport-\(UUID().uuidString.prefix(8)).sock"
+        let listener = try UnixSocketListener(path: socketPath)
+        defer {
+            listener.close()
+        }
+        // Run this test bundle again, filtered to the peer test below.
+        let filter = "FoundationAdditionsTests.FoundationAdditionsTests/testSharedMemoryTransportPeer"
+        let peer = Process()
+        #if os(Linux)
+        peer.executableURL = URL(fileURLWithPath: CommandLine.arguments[0])
+        peer.arguments = [filter]
+        #else
+        peer.executableURL = try xctestToolURL()
+        peer.arguments = ["-XCTest", filter, Bundle(for: FoundationAdditionsTests.self).bundlePath]
+        #endif
+        peer.environment = ProcessInfo.processInfo.environment.merging([FoundationAdditionsTests.transportPeerEnvironmentKey: socketPath]) { $1 }
+        try peer.run()
+
+        let accepted = DispatchSemaphore(value: 0)
+        nonisolated(unsafe) var channel: UnixSocketChannel?
+        DispatchQueue.global().async {
+            channel = try? listener.accept()
+            accepted.signal()
+        }
+        guard accepted.wait(timeout: .now() + 30) == .success, let channel else {
+            peer.terminate()
+            XCTFail("The peer process never connected")
+            return
+        }
+        let transport = try SharedMemoryTransport(channel: channel, ringCapacity: 4 << 20)
+        for seed in 0 ..< 16 {
+            let payload = makePattern(count: (seed % 2 == 0) ? 1 << 20 : 300, seed: UInt8(seed))
+            XCTAssertEqual(try transport.sendRequest(messageID: 1, data: payload, sendTimeout: 10, receiveTimeout: 10), Data(payload.reversed()))
+        }
+        XCTAssertEqual(transport.statistics.ringMessagesSent, 8)
+        transport.invalidate()
+        peer.waitUntilExit()
+        XCTAssertEqual(peer.terminationStatus, 0)
+    }
+
+    #if !os(Linux)
+    /// The `xctest` tool running this bundle, or the one `xcrun` finds.
+    private func xctestToolURL() throws -> URL {
+        let runner = URL(fileURLWithPath: CommandLine.arguments[0])
+        if runner.lastPathComponent == "xctest" {
+            return runner
+        }
+        let xcrun = Process()
+        let output = Pipe()
+        xcrun.executableURL = URL(fileURLWithPath: "/usr/bin/xcrun")
+        xcrun.arguments = ["--find", "xctest"]
+        xcrun.standardOutput = output
+        try xcrun.run()
+        let path = String(decoding: output.fileHandleForReading.readDataToEndOfFile(), as: UTF8.self).trimmingCharacters(in: .whitespacesAndNewlines)
+        xcrun.waitUntilExit()
+        guard xcrun.terminationStatus == 0, !path.isEmpty else {
+            throw XCTSkip("Couldn't find the xctest tool to run the peer with")
+        }
+        return URL(fileURLWithPath: path)
+    }
+    #endif
+
+    /// The other process of ``testSharedMemoryTransportBetweenProcesses()``.
+    func testSharedMemoryTransportPeer() throws {
+        guard let socketPath = ProcessInfo.processInfo.environment[FoundationAdditionsTests.transportPeerEnvironmentKey] else {
+            throw XCTSkip("Only runs as the peer of testSharedMemoryTransportBetweenProcesses")
+        }
+        let transport = try SharedMemoryTransport(channel: UnixSocketChannel(connectingTo: socketPath), ringCapacity: 4 << 20, handler: FoundationAdditionsTests.reversingHandler)
+        transport.setDispatchQueue(DispatchQueue(label: "peer"))
+        // Serve until the other process closes the connection.
+        while transport.isValid {
+            Thread.sleep(forTimeInterval: 0.01)
+        }
+    }
+
+    private func measureTransportRoundTrips(inlineLimit: Int) throws {
+        let (client, server) = try makeTransportPair(ringCapacity: 8 << 20, inlineLimit: inlineLimit, handler: { (_, payload) in
+            return Data(count: 64)
+        })
+        defer {
+            client.invalidate()
+            server.invalidate()
+        }
+        measure {
+            for _ in 0 ..< 100 {
+                let count = try? client.sendRequest(messageID: 1, byteCount: 1 << 20, sendTimeout: 10, receiveTimeout: 10, fill: { (buffer) in
+                    buffer.initializeMemory(as: UInt8.self, repeating: 0x5A)
+                }, reply: { (buffer) in
+                    return buffer?.count
+                })
+                XCTAssertEqual(count, 64)
+            }
+        }
+    }
+
+    func testSharedMemoryTransportPerformance() throws {
+        try measureTransportRoundTrips(inlineLimit: 16384)
+    }
+
+    func testSharedMemoryTransportCopyingPerformance() throws {
+        // Every payload goes through the socket, the way a message port copies it.
+        try measureTransportRoundTrips(inlineLimit: .max)
+    }
+
+    func testSharedMemoryTransportBatchedMessagesPerformance() throws {
+        let (client, server) = try makeTransportPair(handler: { (_, _) in nil })
+        defer {
+            client.invalidate()
+            server.invalidate()
+        }
+        let payload = Data(count: 64)
+        measure {
+            for id in 0 ..< 100_000 {
+                try? client.send(messageID: Int32(id), data: payload, sendTimeout: 10)
+            }
+            try? client.flush()
+        }
+    }
 }
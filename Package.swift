@@ -26,6 +26,9 @@ let package = Package(
 		.library(
 		   name: "UTTypeOSTypes",
 		   targets: ["UTTypeOSTypes"]),
+		.library(
+		   name: "SIMDAdditions",
+		   targets: ["SIMDAdditions"]),
     ],
     dependencies: [
         // Dependencies declare other packages that this package depends on.
@@ -65,11 +68,17 @@ let package = Package(
             path: "CoreTextAdditionsTests"),
         .target(
             name: "FoundationAdditions",
-            dependencies: [],
+            dependencies: ["FoundationAdditionsAtomics"],
             path: "FoundationAdditions"),
+		.target(
+			name: "FoundationAdditionsAtomics",
+			path: "FoundationAdditionsAtomics"),
         .testTarget(
             name: "FoundationAdditionsTests",
-            dependencies: ["SwiftAdditions", "FoundationAdditions"],
+            dependencies: [
+				.target(name: "SwiftAdditions", condition: .when(platforms: [.macOS, .iOS, .tvOS, .watchOS, .macCatalyst, .visionOS])),
+				"FoundationAdditions",
+			],
             path: "FoundationAdditionsTests"),
 		.target(
 			name: "TISAdditions",
@@ -81,11 +90,33 @@ let package = Package(
 			path: "TISAdditionsTests"),
 		.target(
 			name: "UTTypeOSTypes",
-			dependencies: [],
+			dependencies: ["FoundationAdditions"],
 			path: "UTTypeOSTypes"),
 		.testTarget(
 			name: "UTTypeOSTypesTests",
 			dependencies: ["UTTypeOSTypes"],
 			path: "UTTypeOSTypesTests"),
+		.target(
+			name: "SIMDAdditions",
+			dependencies: [],
+			path: "SIMDAdditions"),
+		.testTarget(
+			name: "SIMDAdditionsTests",
+			dependencies: ["SIMDAdditions"],
+			path: "SIMDAdditionsTests"),
+		.executableTarget(
+			name: "SwiftAdditionsBenchmarks",
+			dependencies: [
+				"FoundationAdditions",
+				"UTTypeOSTypes",
+				"SIMDAdditions",
+				.target(name: "SwiftAdditions", condition: .when(platforms: [.macOS, .iOS, .tvOS, .watchOS, .macCatalyst, .visionOS])),
+				.target(name: "SwiftAudioAdditions", condition: .when(platforms: [.macOS, .iOS, .tvOS, .watchOS, .macCatalyst, .visionOS])),
+				"BenchmarkAllocationCounter",
+			],
+			path: "Benchmarks"),
+		.target(
+			name: "BenchmarkAllocationCounter",
+			path: "BenchmarkAllocationCounter"),
     ]
 )
@@ -7,19 +7,29 @@
 //
 
 import Foundation
+#if canImport(simd)
 import simd
+#endif
 
 public extension SIMD2 where Scalar: Numeric {
     @inlinable func allZero() -> Bool {
-        return x == 0 && y == 0
+        return all(self .== SIMD2<Scalar>())
     }
 	
+#if canImport(simd)
+    /// Lane-wise `==` in the `simd` module's mask representation: `-1` in lanes where
+    /// the comparison holds, `0` elsewhere. Use `.==` for a portable `SIMDMask`.
     @inlinable static func ==(left: SIMD2<Scalar>, right: SIMD2<Scalar>) -> simd_int2 {
-        return simd_int2(left.x == right.x ? -1: 0, left.y == right.y ? -1: 0)
+        let mask = left .== right
+        return simd_int2(mask[0] ? -1 : 0, mask[1] ? -1 : 0)
     }
 	
+    /// Lane-wise `!=` in the `simd` module's mask representation: `-1` in lanes where
+    /// the comparison holds, `0` elsewhere. Use `.!=` for a portable `SIMDMask`.
     @inlinable static func !=(left: SIMD2<Scalar>, right: SIMD2<Scalar>) -> simd_int2 {
-        return simd_int2(left.x != right.x ? -1: 0, left.y != right.y ? -1: 0)
+        let mask = left .!= right
+        return simd_int2(mask[0] ? -1 : 0, mask[1] ? -1 : 0)
     }
+#endif
 }
 
@@ -7,19 +7,29 @@
 //
 
 import Foundation
+#if canImport(simd)
 import simd
+#endif
 
 public extension SIMD3 where Scalar: Numeric {
     @inlinable func allZero() -> Bool {
-        return x == 0 && y == 0 && z == 0
+        return all(self .== SIMD3<Scalar>())
     }
     
+#if canImport(simd)
+    /// Lane-wise `==` in the `simd` module's mask representation: `-1` in lanes where
+    /// the comparison holds, `0` elsewhere. Use `.==` for a portable `SIMDMask`.
     @inlinable static func ==(left: SIMD3<Scalar>, right: SIMD3<Scalar>) -> simd_int3 {
-        return simd_int3(left.x == right.x ? -1: 0, left.y == right.y ? -1: 0, left.z == right.z ? -1: 0)
+        let mask = left .== right
+        return simd_int3(mask[0] ? -1 : 0, mask[1] ? -1 : 0, mask[2] ? -1 : 0)
     }
+    /// Lane-wise `!=` in the `simd` module's mask representation: `-1` in lanes where
+    /// the comparison holds, `0` elsewhere. Use `.!=` for a portable `SIMDMask`.
     @inlinable static func !=(left: SIMD3<Scalar>, right: SIMD3<Scalar>) -> simd_int3 {
-        return simd_int3(left.x != right.x ? -1: 0, left.y != right.y ? -1: 0, left.z != right.z ? -1: 0)
+        let mask = left .!= right
+        return simd_int3(mask[0] ? -1 : 0, mask[1] ? -1 : 0, mask[2] ? -1 : 0)
     }
+#endif
 }
 
 public extension SIMD3 {
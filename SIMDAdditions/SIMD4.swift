@@ -7,20 +7,30 @@
 //
 
 import Foundation
+#if canImport(simd)
 import simd
+#endif
 
 public extension SIMD4 where Scalar: Numeric {
     @inlinable func allZero() -> Bool {
-        return x == 0 && y == 0 && z == 0 && w == 0
+        return all(self .== SIMD4<Scalar>())
     }
 
+#if canImport(simd)
+    /// Lane-wise `==` in the `simd` module's mask representation: `-1` in lanes where
+    /// the comparison holds, `0` elsewhere. Use `.==` for a portable `SIMDMask`.
     @inlinable static func ==(left: SIMD4<Scalar>, right: SIMD4<Scalar>) -> simd_int4 {
-        return simd_int4(left.x == right.x ? -1: 0, left.y == right.y ? -1: 0, left.z == right.z ? -1: 0, left.w == right.w ? -1: 0)
+        let mask = left .== right
+        return simd_int4(mask[0] ? -1 : 0, mask[1] ? -1 : 0, mask[2] ? -1 : 0, mask[3] ? -1 : 0)
     }
 	
+    /// Lane-wise `!=` in the `simd` module's mask representation: `-1` in lanes where
+    /// the comparison holds, `0` elsewhere. Use `.!=` for a portable `SIMDMask`.
     @inlinable static func !=(left: SIMD4<Scalar>, right: SIMD4<Scalar>) -> simd_int4 {
-        return simd_int4(left.x != right.x ? -1: 0, left.y != right.y ? -1: 0, left.z != right.z ? -1: 0, left.w != right.w ? -1: 0)
+        let mask = left .!= right
+        return simd_int4(mask[0] ? -1 : 0, mask[1] ? -1 : 0, mask[2] ? -1 : 0, mask[3] ? -1 : 0)
     }
+#endif
 }
 
 public extension SIMD4 {
@@ -0,0 +1,211 @@
+//
+//  SIMDBufferKernels.swift
+//  SIMDAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// Inputs shorter than this stay on the calling thread; it is also the smallest slice
+/// a worker thread gets.
+@usableFromInline
+internal let simdMinimumChunk = 32768
+
+/// Splits `0..<count` into at most `maximumConcurrency` contiguous slices of at least
+/// `simdMinimumChunk` elements and calls `body` with each slice and its worker index.
+/// Runs on the calling thread when there is only one slice.
+@usableFromInline
+internal func simdForEachChunk(count: Int, maximumConcurrency: Int, _ body: (_ worker: Int, _ range: Range<Int>) -> Void) {
+	let workers = simdWorkerCount(count: count, maximumConcurrency: maximumConcurrency)
+	guard workers > 1 else {
+		if count > 0 {
+			body(0, 0 ..< count)
+		}
+		return
+	}
+	let perWorker = (count + workers - 1) / workers
+	DispatchQueue.concurrentPerform(iterations: workers) { worker in
+		let start = worker * perWorker
+		let end = Swift.min(start + perWorker, count)
+		if start < end {
+			body(worker, start ..< end)
+		}
+	}
+}
+
+/// The number of workers ``simdForEachChunk(count:maximumConcurrency:_:)`` uses.
+@usableFromInline
+internal func simdWorkerCount(count: Int, maximumConcurrency: Int) -> Int {
+	let chunks = (count + simdMinimumChunk - 1) / simdMinimumChunk
+	return Swift.max(Swift.min(maximumConcurrency, chunks), 1)
+}
+
+// MARK: - Array of structures ↔ structure of arrays
+
+public extension UnsafeBufferPointer where Element: SIMD {
+	/// Copies the vectors into planar storage: every `x` lane, then every `y` lane, and so on.
+	/// - parameter planes: Storage for `count * Element.scalarCount` scalars. Plane `n`
+	/// starts at `n * count`.
+	/// - parameter maximumConcurrency: The most threads to use. Pass `1` to copy on the
+	/// calling thread.
+	@inlinable func deinterleave(into planes: UnsafeMutableBufferPointer<Element.Scalar>, maximumConcurrency: Int = 1) {
+		precondition(planes.count >= count * Element.scalarCount, "Planar buffer is too short")
+		guard let source = baseAddress, let destination = planes.baseAddress else {
+			return
+		}
+		let count = self.count
+		simdForEachChunk(count: count, maximumConcurrency: maximumConcurrency) { _, range in
+			for lane in 0 ..< Element.scalarCount {
+				let plane = destination + lane * count
+				for i in range {
+					plane[i] = source[i][lane]
+				}
+			}
+		}
+	}
+}
+
+public extension UnsafeMutableBufferPointer where Element: SIMD {
+	/// Fills the buffer with vectors gathered from planar storage, the reverse of
+	/// ``Swift/UnsafeBufferPointer/deinterleave(into:maximumConcurrency:)``.
+	/// - parameter planes: `count * Element.scalarCount` scalars. Plane `n` starts at
+	/// `n * count`.
+	/// - parameter maximumConcurrency: The most threads to use. Pass `1` to copy on the
+	/// calling thread.
+	@inlinable func interleave(from planes: UnsafeBufferPointer<Element.Scalar>, maximumConcurrency: Int = 1) {
+		precondition(planes.count >= count * Element.scalarCount, "Planar buffer is too short")
+		guard let destination = baseAddress, let source = planes.baseAddress else {
+			return
+		}
+		let count = self.count
+		simdForEachChunk(count: count, maximumConcurrency: maximumConcurrency) { _, range in
+			for i in range {
+				var vector = Element()
+				for lane in 0 ..< Element.scalarCount {
+					vector[lane] = source[lane * count + i]
+				}
+				destination[i] = vector
+			}
+		}
+	}
+}
+
+// MARK: - Bounding box
+
+public extension UnsafeBufferPointer where Element: SIMD, Element.Scalar: FloatingPoint {
+	/// The smallest box that contains every vector in the buffer.
+	///
+	/// NaN lanes are ignored. A lane that is NaN in every vector comes back as
+	/// `minimum` of `+infinity` and `maximum` of `-infinity`.
+	/// - parameter maximumConcurrency: The most threads to use. Pass `1` to reduce on the
+	/// calling thread.
+	/// - returns: The lane-wise minimum and maximum, or `nil` if the buffer is empty.
+	@inlinable func boundingBox(maximumConcurrency: Int = 1) -> (minimum: Element, maximum: Element)? {
+		guard let base = baseAddress, count > 0 else {
+			return nil
+		}
+		let workers = simdWorkerCount(count: count, maximumConcurrency: maximumConcurrency)
+		let partials = UnsafeMutableBufferPointer<(minimum: Element, maximum: Element)>.allocate(capacity: workers)
+		defer {
+			partials.deallocate()
+		}
+		partials.initialize(repeating: (Element(repeating: .infinity), Element(repeating: -.infinity)))
+		simdForEachChunk(count: count, maximumConcurrency: workers) { worker, range in
+			var lower = Element(repeating: .infinity)
+			var upper = Element(repeating: -.infinity)
+			for i in range {
+				let vector = base[i]
+				// Comparisons against NaN are false, so NaN lanes never replace a bound.
+				lower.replace(with: vector, where: vector .< lower)
+				upper.replace(with: vector, where: vector .> upper)
+			}
+			partials[worker] = (lower, upper)
+		}
+		var result = partials[0]
+		for partial in partials.dropFirst() {
+			result.minimum.replace(with: partial.minimum, where: partial.minimum .< result.minimum)
+			result.maximum.replace(with: partial.maximum, where: partial.maximum .> result.maximum)
+		}
+		return result
+	}
+}
+
+// MARK: - Clamping
+
+public extension UnsafeMutableBufferPointer where Element: SIMD, Element.Scalar: Comparable {
+	/// Clamps every vector in the buffer, lane by lane, between `minimum` and `maximum`.
+	///
+	/// NaN lanes are left as they are, like FoundationAdditions' `clamp(_:minimum:maximum:)`.
+	/// - parameter minimum: The lower bound of each lane.
+	/// - parameter maximum: The upper bound of each lane.
+	/// - parameter maximumConcurrency: The most threads to use. Pass `1` to clamp on the
+	/// calling thread.
+	///
+	/// If any lane of `minimum` is greater than the matching lane of `maximum`, a fatal error occurs.
+	@inlinable func clamp(minimum: Element, maximum: Element, maximumConcurrency: Int = 1) {
+		precondition(all(minimum .<= maximum), "Minimum (\(minimum)) is greater than maximum (\(maximum))!")
+		guard let base = baseAddress else {
+			return
+		}
+		simdForEachChunk(count: count, maximumConcurrency: maximumConcurrency) { _, range in
+			for i in range {
+				var vector = base[i]
+				vector.replace(with: maximum, where: vector .> maximum)
+				vector.replace(with: minimum, where: vector .< minimum)
+				base[i] = vector
+			}
+		}
+	}
+}
+
+// MARK: - Array conveniences
+
+public extension Array where Element: SIMD, Element.Scalar: FloatingPoint {
+	/// The smallest box that contains every vector in the array.
+	/// - parameter maximumConcurrency: The most threads to use.
+	/// - returns: The lane-wise minimum and maximum, or `nil` if the array is empty.
+	@inlinable func boundingBox(maximumConcurrency: Int = 1) -> (minimum: Element, maximum: Element)? {
+		return withUnsafeBufferPointer { $0.boundingBox(maximumConcurrency: maximumConcurrency) }
+	}
+}
+
+public extension Array where Element: SIMD {
+	/// The vectors in planar form: every `x` lane, then every `y` lane, and so on.
+	/// - parameter maximumConcurrency: The most threads to use.
+	@inlinable func deinterleaved(maximumConcurrency: Int = 1) -> [Element.Scalar] {
+		let total = count * Element.scalarCount
+		return withUnsafeBufferPointer { source in
+			[Element.Scalar](unsafeUninitializedCapacity: total) { planes, initializedCount in
+				source.deinterleave(into: planes, maximumConcurrency: maximumConcurrency)
+				initializedCount = total
+			}
+		}
+	}
+
+	/// Creates an array of vectors from planar storage.
+	/// - parameter planes: Every `x` lane, then every `y` lane, and so on. The count must be
+	/// a multiple of `Element.scalarCount`.
+	/// - parameter maximumConcurrency: The most threads to use.
+	@inlinable init(interleaving planes: [Element.Scalar], maximumConcurrency: Int = 1) {
+		precondition(planes.count % Element.scalarCount == 0, "Plane count doesn't divide evenly into vectors")
+		let count = planes.count / Element.scalarCount
+		self.init(unsafeUninitializedCapacity: count) { vectors, initializedCount in
+			planes.withUnsafeBufferPointer { planes in
+				UnsafeMutableBufferPointer(rebasing: vectors[0 ..< count]).interleave(from: planes, maximumConcurrency: maximumConcurrency)
+			}
+			initializedCount = count
+		}
+	}
+}
+
+public extension Array where Element: SIMD, Element.Scalar: Comparable {
+	/// Clamps every vector in the array, lane by lane, between `minimum` and `maximum`.
+	/// - parameter minimum: The lower bound of each lane.
+	/// - parameter maximum: The upper bound of each lane.
+	/// - parameter maximumConcurrency: The most threads to use.
+	@inlinable mutating func clamp(minimum: Element, maximum: Element, maximumConcurrency: Int = 1) {
+		withUnsafeMutableBufferPointer { $0.clamp(minimum: minimum, maximum: maximum, maximumConcurrency: maximumConcurrency) }
+	}
+}
@@ -0,0 +1,43 @@
+//
+//  SIMDComparisons.swift
+//  SIMDAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+public extension SIMD where Scalar: Comparable {
+	/// The lanes that lie in the closed range between the matching lanes of `minimum`
+	/// and `maximum`.
+	/// - parameter minimum: The lower bound of each lane.
+	/// - parameter maximum: The upper bound of each lane.
+	/// - returns: A mask that is set where `minimum <= self <= maximum`.
+	@inlinable func isWithin(minimum: Self, maximum: Self) -> SIMDMask<MaskStorage> {
+		return (self .>= minimum) .& (self .<= maximum)
+	}
+}
+
+public extension SIMD where Scalar: FloatingPoint {
+	/// The lanes that differ from the matching lanes of `other` by no more than
+	/// `tolerance`.
+	/// - parameter other: The vector to compare against.
+	/// - parameter tolerance: The largest difference still considered equal.
+	/// - returns: A mask that is set where `|self - other| <= tolerance`. Lanes where
+	/// either side is NaN are never set.
+	@inlinable func isApproximatelyEqual(to other: Self, tolerance: Scalar) -> SIMDMask<MaskStorage> {
+		let difference = self - other
+		return (difference .<= tolerance) .& (difference .>= -tolerance)
+	}
+
+	/// The lanes that are NaN.
+	@inlinable var isNaNMask: SIMDMask<MaskStorage> {
+		return self .!= self
+	}
+
+	/// The lanes that are neither infinite nor NaN.
+	@inlinable var isFiniteMask: SIMDMask<MaskStorage> {
+		return (self - self) .== Self()
+	}
+}
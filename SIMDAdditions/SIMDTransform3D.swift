@@ -0,0 +1,220 @@
+//
+//  SIMDTransform3D.swift
+//  SIMDAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+#if canImport(QuartzCore)
+import QuartzCore.CATransform3D
+#endif
+
+/// A 4×4 homogeneous transform laid out like `CATransform3D`.
+///
+/// Points are row vectors multiplied on the left, so a point `(x, y, z, w)` maps to
+/// `x * row1 + y * row2 + z * row3 + w * row4`, and the translation lives in `row4`.
+/// ``concatenating(_:)`` has the same order as `CATransform3DConcat`.
+public struct SIMDTransform3D<Scalar: SIMDScalar & BinaryFloatingPoint>: Hashable {
+	/// `m11`, `m12`, `m13`, `m14`.
+	public var row1: SIMD4<Scalar>
+	/// `m21`, `m22`, `m23`, `m24`.
+	public var row2: SIMD4<Scalar>
+	/// `m31`, `m32`, `m33`, `m34`.
+	public var row3: SIMD4<Scalar>
+	/// `m41`, `m42`, `m43`, `m44`.
+	public var row4: SIMD4<Scalar>
+
+	/// Creates a transform from its four rows.
+	@inlinable public init(_ row1: SIMD4<Scalar>, _ row2: SIMD4<Scalar>, _ row3: SIMD4<Scalar>, _ row4: SIMD4<Scalar>) {
+		self.row1 = row1
+		self.row2 = row2
+		self.row3 = row3
+		self.row4 = row4
+	}
+
+	/// The identity transform: `[1 0 0 0; 0 1 0 0; 0 0 1 0; 0 0 0 1]`.
+	@inlinable public static var identity: SIMDTransform3D {
+		return SIMDTransform3D(SIMD4(1, 0, 0, 0), SIMD4(0, 1, 0, 0), SIMD4(0, 0, 1, 0), SIMD4(0, 0, 0, 1))
+	}
+
+	/// Creates a transform that translates by `translation`.
+	@inlinable public init(translation: SIMD3<Scalar>) {
+		self = .identity
+		row4 = SIMD4(translation.x, translation.y, translation.z, 1)
+	}
+
+	/// Creates a transform that scales each axis by the matching lane of `scale`.
+	@inlinable public init(scale: SIMD3<Scalar>) {
+		self.init(SIMD4(scale.x, 0, 0, 0), SIMD4(0, scale.y, 0, 0), SIMD4(0, 0, scale.z, 0), SIMD4(0, 0, 0, 1))
+	}
+
+	/// Is `true` if the last column isn't `(0, 0, 0, 1)`, so transformed points need a
+	/// divide by `w`.
+	@inlinable public var hasPerspective: Bool {
+		return any(SIMD4(row1.w, row2.w, row3.w, row4.w) .!= SIMD4(0, 0, 0, 1))
+	}
+
+	/// Returns the transform that applies `self`, then `other`.
+	///
+	/// Matches `CATransform3DConcat(self, other)`.
+	@inlinable public func concatenating(_ other: SIMDTransform3D) -> SIMDTransform3D {
+		return SIMDTransform3D(other.multiplying(row1), other.multiplying(row2), other.multiplying(row3), other.multiplying(row4))
+	}
+
+	/// Multiplies the homogeneous row vector `vector` by this matrix.
+	@inlinable public func multiplying(_ vector: SIMD4<Scalar>) -> SIMD4<Scalar> {
+		var result = row1 * vector.x
+		result += row2 * vector.y
+		result += row3 * vector.z
+		result += row4 * vector.w
+		return result
+	}
+
+	/// Transforms the point `point`, dividing by `w` when the transform has perspective.
+	@inlinable public func transform(_ point: SIMD3<Scalar>) -> SIMD3<Scalar> {
+		let result = multiplying(SIMD4(point, 1))
+		return hasPerspective ? result.xyz / result.w : result.xyz
+	}
+
+	/// Transforms the point `point` on the `z = 0` plane, dividing by `w` when the
+	/// transform has perspective.
+	@inlinable public func transform(_ point: SIMD2<Scalar>) -> SIMD2<Scalar> {
+		let result = multiplying(SIMD4(point.x, point.y, 0, 1))
+		return hasPerspective ? result.xy / result.w : result.xy
+	}
+}
+
+extension SIMDTransform3D: Sendable where Scalar: Sendable {}
+
+// MARK: - Bulk transforms
+
+public extension SIMDTransform3D {
+	/// Multiplies every homogeneous vector in `source` by this matrix.
+	/// - parameter source: The vectors to transform.
+	/// - parameter destination: Storage for the results. It may be the same memory as
+	/// `source`, and must be at least as long.
+	/// - parameter maximumConcurrency: The most threads to use. Pass `1` to transform on the
+	/// calling thread.
+	@inlinable func transform(_ source: UnsafeBufferPointer<SIMD4<Scalar>>, into destination: UnsafeMutableBufferPointer<SIMD4<Scalar>>, maximumConcurrency: Int = 1) {
+		precondition(destination.count >= source.count, "Destination buffer is too short")
+		guard let input = source.baseAddress, let output = destination.baseAddress else {
+			return
+		}
+		simdForEachChunk(count: source.count, maximumConcurrency: maximumConcurrency) { _, range in
+			for i in range {
+				output[i] = multiplying(input[i])
+			}
+		}
+	}
+
+	/// Transforms every point in `source`, dividing by `w` when the transform has perspective.
+	/// - parameter source: The points to transform.
+	/// - parameter destination: Storage for the results. It may be the same memory as
+	/// `source`, and must be at least as long.
+	/// - parameter maximumConcurrency: The most threads to use. Pass `1` to transform on the
+	/// calling thread.
+	@inlinable func transform(_ source: UnsafeBufferPointer<SIMD3<Scalar>>, into destination: UnsafeMutableBufferPointer<SIMD3<Scalar>>, maximumConcurrency: Int = 1) {
+		precondition(destination.count >= source.count, "Destination buffer is too short")
+		guard let input = source.baseAddress, let output = destination.baseAddress else {
+			return
+		}
+		// Hoist the perspective test so the common affine loop is just three multiply-adds.
+		let perspective = hasPerspective
+		simdForEachChunk(count: source.count, maximumConcurrency: maximumConcurrency) { _, range in
+			if perspective {
+				for i in range {
+					let point = input[i]
+					let result = multiplying(SIMD4(point, 1))
+					output[i] = result.xyz / result.w
+				}
+			} else {
+				for i in range {
+					let point = input[i]
+					var result = row4
+					result += row1 * point.x
+					result += row2 * point.y
+					result += row3 * point.z
+					output[i] = result.xyz
+				}
+			}
+		}
+	}
+
+	/// Transforms every point on the `z = 0` plane in `source`, dividing by `w` when the
+	/// transform has perspective.
+	/// - parameter source: The points to transform.
+	/// - parameter destination: Storage for the results. It may be the same memory as
+	/// `source`, and must be at least as long.
+	/// - parameter maximumConcurrency: The most threads to use. Pass `1` to transform on the
+	/// calling thread.
+	@inlinable func transform(_ source: UnsafeBufferPointer<SIMD2<Scalar>>, into destination: UnsafeMutableBufferPointer<SIMD2<Scalar>>, maximumConcurrency: Int = 1) {
+		precondition(destination.count >= source.count, "Destination buffer is too short")
+		guard let input = source.baseAddress, let output = destination.baseAddress else {
+			return
+		}
+		let perspective = hasPerspective
+		let xAxis = row1.xy, yAxis = row2.xy, origin = row4.xy
+		simdForEachChunk(count: source.count, maximumConcurrency: maximumConcurrency) { _, range in
+			if perspective {
+				for i in range {
+					let point = input[i]
+					let result = multiplying(SIMD4(point.x, point.y, 0, 1))
+					output[i] = result.xy / result.w
+				}
+			} else {
+				for i in range {
+					let point = input[i]
+					output[i] = origin + xAxis * point.x + yAxis * point.y
+				}
+			}
+		}
+	}
+
+	/// Multiplies every vector in `vectors` by this matrix in place.
+	/// - parameter maximumConcurrency: The most threads to use.
+	@inlinable func apply(to vectors: inout [SIMD4<Scalar>], maximumConcurrency: Int = 1) {
+		vectors.withUnsafeMutableBufferPointer { buffer in
+			transform(UnsafeBufferPointer(buffer), into: buffer, maximumConcurrency: maximumConcurrency)
+		}
+	}
+
+	/// Transforms every point in `points` in place.
+	/// - parameter maximumConcurrency: The most threads to use.
+	@inlinable func apply(to points: inout [SIMD3<Scalar>], maximumConcurrency: Int = 1) {
+		points.withUnsafeMutableBufferPointer { buffer in
+			transform(UnsafeBufferPointer(buffer), into: buffer, maximumConcurrency: maximumConcurrency)
+		}
+	}
+
+	/// Transforms every point in `points` in place.
+	/// - parameter maximumConcurrency: The most threads to use.
+	@inlinable func apply(to points: inout [SIMD2<Scalar>], maximumConcurrency: Int = 1) {
+		points.withUnsafeMutableBufferPointer { buffer in
+			transform(UnsafeBufferPointer(buffer), into: buffer, maximumConcurrency: maximumConcurrency)
+		}
+	}
+}
+
+#if canImport(QuartzCore)
+public extension SIMDTransform3D {
+	/// Creates a transform with the same matrix as `transform`.
+	@inlinable init(_ transform: CATransform3D) {
+		self.init(SIMD4(Scalar(transform.m11), Scalar(transform.m12), Scalar(transform.m13), Scalar(transform.m14)),
+				  SIMD4(Scalar(transform.m21), Scalar(transform.m22), Scalar(transform.m23), Scalar(transform.m24)),
+				  SIMD4(Scalar(transform.m31), Scalar(transform.m32), Scalar(transform.m33), Scalar(transform.m34)),
+				  SIMD4(Scalar(transform.m41), Scalar(transform.m42), Scalar(transform.m43), Scalar(transform.m44)))
+	}
+}
+
+public extension CATransform3D {
+	/// Creates a transform with the same matrix as `transform`.
+	@inlinable init<Scalar>(_ transform: SIMDTransform3D<Scalar>) {
+		self.init(m11: CGFloat(transform.row1.x), m12: CGFloat(transform.row1.y), m13: CGFloat(transform.row1.z), m14: CGFloat(transform.row1.w),
+				  m21: CGFloat(transform.row2.x), m22: CGFloat(transform.row2.y), m23: CGFloat(transform.row2.z), m24: CGFloat(transform.row2.w),
+				  m31: CGFloat(transform.row3.x), m32: CGFloat(transform.row3.y), m33: CGFloat(transform.row3.z), m34: CGFloat(transform.row3.w),
+				  m41: CGFloat(transform.row4.x), m42: CGFloat(transform.row4.y), m43: CGFloat(transform.row4.z), m44: CGFloat(transform.row4.w))
+	}
+}
+#endif
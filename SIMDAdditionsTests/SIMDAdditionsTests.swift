@@ -8,27 +8,199 @@
 
 import XCTest
 @testable import SIMDAdditions
+#if canImport(simd)
+import simd
+#endif
+#if canImport(QuartzCore)
+import QuartzCore
+#endif
 
 class SIMDAdditionsTests: XCTestCase {
 
-    override func setUp() {
-        // Put setup code here. This method is called before the invocation of each test method in the class.
+    /// A deterministic cloud of `count` points spread over roughly ±1000.
+    private func makePoints(count: Int) -> [SIMD3<Float>] {
+        var state: UInt32 = 0x1234_5678
+        func next() -> Float {
+            state = state &* 1_664_525 &+ 1_013_904_223
+            return Float(state >> 8) / Float(1 << 24) * 2000 - 1000
+        }
+        return (0 ..< count).map { _ in SIMD3(next(), next(), next()) }
+    }
+
+    private let sampleTransform = SIMDTransform3D<Float>(scale: SIMD3(2, -0.5, 3))
+        .concatenating(SIMDTransform3D(SIMD4(0.8, 0.6, 0, 0), SIMD4(-0.6, 0.8, 0, 0), SIMD4(0, 0, 1, 0), SIMD4(0, 0, 0, 1)))
+        .concatenating(SIMDTransform3D(translation: SIMD3(10, -20, 5)))
+
+    private var perspectiveTransform: SIMDTransform3D<Float> {
+        var transform = sampleTransform
+        transform.row3.w = -1.0 / 500
+        return transform
+    }
+
+    func testComparisons() {
+        XCTAssertTrue(SIMD3<Float>(0, -0.0, 0).allZero())
+        XCTAssertFalse(SIMD4<Int32>(0, 0, 0, 1).allZero())
+
+        let a = SIMD4<Float>(1, 2, .nan, 4)
+        let b = SIMD4<Float>(1, 2.5, .nan, 3.9)
+        XCTAssertEqual(a.isApproximatelyEqual(to: b, tolerance: 0.2), [true, false, false, true] as SIMDMask<SIMD4<Int32>>)
+        XCTAssertEqual(a.isNaNMask, [false, false, true, false] as SIMDMask<SIMD4<Int32>>)
+        XCTAssertEqual(SIMD4<Float>(1, .infinity, .nan, -3).isFiniteMask, [true, false, false, true] as SIMDMask<SIMD4<Int32>>)
+        XCTAssertEqual(SIMD3<Int>(-1, 5, 10).isWithin(minimum: SIMD3(0, 0, 0), maximum: SIMD3(10, 10, 10)), [false, true, true] as SIMDMask<SIMD3<Int>>)
+
+        #if canImport(simd)
+        let equal: simd_int3 = SIMD3<Double>(1, 2, 3) == SIMD3<Double>(1, 0, 3)
+        XCTAssertEqual(equal, simd_int3(-1, 0, -1))
+        let notEqual: simd_int2 = SIMD2<Float>(1, 2) != SIMD2<Float>(1, 0)
+        XCTAssertEqual(notEqual, simd_int2(0, -1))
+        #endif
+    }
+
+    func testTransformConcatenation() {
+        let translate = SIMDTransform3D<Double>(translation: SIMD3(1, 2, 3))
+        let scale = SIMDTransform3D<Double>(scale: SIMD3(2, 3, 4))
+        // Translate first, then scale.
+        XCTAssertEqual(translate.concatenating(scale).transform(SIMD3<Double>(1, 1, 1)), SIMD3(4, 9, 16))
+        XCTAssertEqual(scale.concatenating(translate).transform(SIMD3<Double>(1, 1, 1)), SIMD3(3, 5, 7))
+        XCTAssertEqual(SIMDTransform3D<Double>.identity.concatenating(scale), scale)
+        XCTAssertFalse(scale.hasPerspective)
+
+        #if canImport(QuartzCore)
+        let rotation = CATransform3DMakeRotation(0.7, 0.2, 1, 0.3)
+        let moved = CATransform3DTranslate(CATransform3DMakeScale(2, 3, 4), 5, -6, 7)
+        let expected = SIMDTransform3D<Double>(CATransform3DConcat(rotation, moved))
+        let actual = SIMDTransform3D<Double>(rotation).concatenating(SIMDTransform3D(moved))
+        for (lhs, rhs) in [(actual.row1, expected.row1), (actual.row2, expected.row2), (actual.row3, expected.row3), (actual.row4, expected.row4)] {
+            XCTAssertTrue(all(lhs.isApproximatelyEqual(to: rhs, tolerance: 1e-12)), "\(lhs) != \(rhs)")
+        }
+        XCTAssertTrue(CATransform3DEqualToTransform(CATransform3D(SIMDTransform3D<Double>(moved)), moved))
+        #endif
+    }
+
+    func testTransformPoints() {
+        let points = makePoints(count: 100_000)
+        for transform in [sampleTransform, perspectiveTransform] {
+            let expected = points.map { (point) -> SIMD3<Float> in
+                let x = point.x * transform.row1 + point.y * transform.row2 + point.z * transform.row3 + transform.row4
+                return SIMD3(x.x, x.y, x.z) / x.w
+            }
+            for concurrency in [1, 4] {
+                var transformed = points
+                transform.apply(to: &transformed, maximumConcurrency: concurrency)
+                // The affine path adds the translation first, so allow a few ulps of the magnitude.
+                for (actual, expected) in zip(transformed, expected) where !all(actual.isApproximatelyEqual(to: expected, tolerance: 1e-5 * max(1, pointwiseMax(expected, -expected).max()))) {
+                    XCTFail("\(actual) != \(expected)")
+                    break
+                }
+            }
+
+            var flat = points.map { SIMD2($0.x, $0.y) }
+            transform.apply(to: &flat, maximumConcurrency: 4)
+            let expectedFlat = transform.transform(SIMD2(points[17].x, points[17].y))
+            XCTAssertTrue(all(flat[17].isApproximatelyEqual(to: expectedFlat, tolerance: 1e-5 * max(1, pointwiseMax(expectedFlat, -expectedFlat).max()))))
+
+            var homogeneous = points.map { SIMD4($0, 1) }
+            transform.apply(to: &homogeneous, maximumConcurrency: 4)
+            XCTAssertEqual(homogeneous[42], transform.multiplying(SIMD4(points[42], 1)))
+        }
     }
 
-    override func tearDown() {
-        // Put teardown code here. This method is called after the invocation of each test method in the class.
+    func testInterleaving() {
+        let points = makePoints(count: 70_001)
+        for concurrency in [1, 3] {
+            let planes = points.deinterleaved(maximumConcurrency: concurrency)
+            XCTAssertEqual(planes.count, points.count * 3)
+            XCTAssertEqual(planes[5], points[5].x)
+            XCTAssertEqual(planes[points.count + 5], points[5].y)
+            XCTAssertEqual(planes[points.count * 2 + 5], points[5].z)
+            XCTAssertEqual([SIMD3<Float>](interleaving: planes, maximumConcurrency: concurrency), points)
+        }
+        XCTAssertEqual([SIMD2<Int16>](interleaving: [1, 2, 3, 4, 5, 6]), [SIMD2(1, 4), SIMD2(2, 5), SIMD2(3, 6)])
+        XCTAssertEqual([SIMD4<Float>]().deinterleaved(), [])
     }
 
-    func testExample() {
-        // This is an example of a functional test case.
-        // Use XCTAssert and related functions to verify your tests produce the correct results.
+    func testBoundingBox() throws {
+        XCTAssertNil([SIMD3<Float>]().boundingBox())
+
+        var points = makePoints(count: 100_000)
+        points[3] = SIMD3(.nan, 0, 0)
+        points[70_000] = SIMD3(-5000, 5000, 0)
+        let expectedMinimum = points.reduce(SIMD3<Float>(repeating: .infinity)) { pointwiseMin($0, $1) }
+        let expectedMaximum = points.reduce(SIMD3<Float>(repeating: -.infinity)) { pointwiseMax($0, $1) }
+        for concurrency in [1, 4] {
+            let box = try XCTUnwrap(points.boundingBox(maximumConcurrency: concurrency))
+            XCTAssertEqual(box.minimum, expectedMinimum)
+            XCTAssertEqual(box.maximum, expectedMaximum)
+            XCTAssertEqual(box.minimum.x, -5000)
+            XCTAssertEqual(box.maximum.y, 5000)
+        }
     }
 
-    func testPerformanceExample() {
-        // This is an example of a performance test case.
-        self.measure {
-            // Put the code you want to measure the time of here.
+    func testClamp() {
+        let points = makePoints(count: 100_000) + [SIMD3(.nan, 2000, -2000)]
+        let minimum = SIMD3<Float>(-100, 0, -500)
+        let maximum = SIMD3<Float>(100, 250, 500)
+        for concurrency in [1, 4] {
+            var clamped = points
+            clamped.clamp(minimum: minimum, maximum: maximum, maximumConcurrency: concurrency)
+            XCTAssertTrue(clamped.dropLast().allSatisfy { all($0.isWithin(minimum: minimum, maximum: maximum)) })
+            XCTAssertEqual(clamped[10], points[10].clamped(lowerBound: minimum, upperBound: maximum))
+            XCTAssertTrue(clamped.last!.x.isNaN)
+            XCTAssertEqual(clamped.last!.yz, SIMD2(250, -500))
         }
     }
 
+    // MARK: - Performance
+
+    private func measureTransform(maximumConcurrency: Int) {
+        let points = makePoints(count: 2_000_000)
+        var transformed = points
+        let transform = sampleTransform
+        measure {
+            points.withUnsafeBufferPointer { (source) in
+                transformed.withUnsafeMutableBufferPointer { (destination) in
+                    transform.transform(source, into: destination, maximumConcurrency: maximumConcurrency)
+                }
+            }
+        }
+    }
+
+    func testTransformPerformance() {
+        measureTransform(maximumConcurrency: ProcessInfo.processInfo.activeProcessorCount)
+    }
+
+    func testTransformSingleThreadPerformance() {
+        measureTransform(maximumConcurrency: 1)
+    }
+
+    func testPerPointTransformPerformance() {
+        let points = makePoints(count: 2_000_000)
+        let transform = sampleTransform
+        measure {
+            let transformed = points.map { transform.transform($0) }
+            XCTAssertEqual(transformed.count, points.count)
+        }
+    }
+
+    func testBoundingBoxPerformance() {
+        let points = makePoints(count: 2_000_000)
+        measure {
+            XCTAssertNotNil(points.boundingBox(maximumConcurrency: ProcessInfo.processInfo.activeProcessorCount))
+        }
+    }
+
+    func testDeinterleavePerformance() {
+        let points = makePoints(count: 2_000_000)
+        measure {
+            XCTAssertEqual(points.deinterleaved(maximumConcurrency: ProcessInfo.processInfo.activeProcessorCount).count, points.count * 3)
+        }
+    }
+
+    func testClampPerformance() {
+        let points = makePoints(count: 2_000_000)
+        measure {
+            var clamped = points
+            clamped.clamp(minimum: SIMD3(repeating: -500), maximum: SIMD3(repeating: 500), maximumConcurrency: ProcessInfo.processInfo.activeProcessorCount)
+        }
+    }
 }
@@ -0,0 +1,120 @@
+//
+//  ASCIIString.swift
+//  SwiftAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+
+/// A string of ``ASCIICharacter``s stored contiguously, one byte per character.
+///
+/// Indexing is O(1), slices share storage with the original string, and converting
+/// to a `String` is done in one pass with one allocation.
+public struct ASCIIString: Hashable, Sendable {
+	@usableFromInline
+	internal var storage: ContiguousArray<ASCIICharacter>
+
+	/// Creates an empty ASCII string.
+	@inlinable public init() {
+		storage = []
+	}
+
+	/// Creates an ASCII string from a sequence of ``ASCIICharacter``s.
+	@inlinable public init<S: Sequence>(_ characters: S) where S.Element == ASCIICharacter {
+		storage = ContiguousArray(characters)
+	}
+
+	/// Creates an ASCII string from a `String`.
+	/// - parameter string: The string to convert.
+	/// - parameter encodeInvalid: If `true`, any character that can't be represented as
+	/// an ASCII character is replaced with ``ASCIICharacter/invalid``
+	/// instead of failing.
+	///
+	/// Returns `nil` if `string` has a non-ASCII character and `encodeInvalid` is `false`.
+	public init?(_ string: String, encodeInvalid: Bool) {
+		guard let chars = string.toASCIICharacters(encodeInvalid: encodeInvalid) else {
+			return nil
+		}
+		storage = ContiguousArray(chars)
+	}
+
+	/// The ASCII string as a Swift `String`.
+	///
+	/// ``ASCIICharacter/invalid`` characters are replaced with the replacement character (**0xFFFD**).
+	public var stringValue: String {
+		return storage.withUnsafeBufferPointer { (buffer) -> String in
+			return String(asciiBuffer: buffer)
+		}
+	}
+
+	/// `true` if none of the characters are ``ASCIICharacter/invalid``.
+	public var isValid: Bool {
+		return !storage.contains(.invalid)
+	}
+
+	/// Calls `body` with a buffer over the characters.
+	@inlinable public func withUnsafeBufferPointer<R>(_ body: (UnsafeBufferPointer<ASCIICharacter>) throws -> R) rethrows -> R {
+		return try storage.withUnsafeBufferPointer(body)
+	}
+}
+
+extension ASCIIString: RandomAccessCollection, MutableCollection, RangeReplaceableCollection {
+	public typealias Element = ASCIICharacter
+	public typealias Index = Int
+	public typealias SubSequence = Slice<ASCIIString>
+
+	@inlinable public var startIndex: Int {
+		return storage.startIndex
+	}
+
+	@inlinable public var endIndex: Int {
+		return storage.endIndex
+	}
+
+	@inlinable public subscript(position: Int) -> ASCIICharacter {
+		get {
+			return storage[position]
+		}
+		set {
+			storage[position] = newValue
+		}
+	}
+
+	@inlinable public mutating func replaceSubrange<C: Collection>(_ subrange: Range<Int>, with newElements: C) where C.Element == ASCIICharacter {
+		storage.replaceSubrange(subrange, with: newElements)
+	}
+
+	@inlinable public mutating func reserveCapacity(_ n: Int) {
+		storage.reserveCapacity(n)
+	}
+
+	@inlinable public func withContiguousStorageIfAvailable<R>(_ body: (UnsafeBufferPointer<ASCIICharacter>) throws -> R) rethrows -> R? {
+		return try storage.withUnsafeBufferPointer(body)
+	}
+}
+
+extension ASCIIString: CustomStringConvertible, LosslessStringConvertible {
+	public var description: String {
+		return stringValue
+	}
+
+	public init?(_ description: String) {
+		self.init(description, encodeInvalid: false)
+	}
+}
+
+public extension String {
+	/// Creates a string from an ``ASCIIString``.
+	@inlinable init(_ asciiString: ASCIIString) {
+		self = asciiString.stringValue
+	}
+
+	/// Creates a string from a slice of an ``ASCIIString``, without copying the slice first.
+	init(_ asciiSlice: Slice<ASCIIString>) {
+		self = asciiSlice.base.storage.withUnsafeBufferPointer { (buffer) -> String in
+			return String(asciiBuffer: UnsafeBufferPointer(rebasing: buffer[asciiSlice.startIndex ..< asciiSlice.endIndex]))
+		}
+	}
+}
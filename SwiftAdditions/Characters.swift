@@ -7,6 +7,7 @@
 //
 
 import Foundation
+import FoundationAdditions
 
 /// Based off of the ASCII code tables
 public enum ASCIICharacter: Int8, Comparable, Hashable, Sendable {
@@ -202,13 +203,127 @@ public extension ASCIICharacter {
 	}
 }
 
+// MARK: - Bulk conversion
+
+extension ASCIICharacter {
+	/// `true` if the in-memory representation of the valid ASCII cases is the same as
+	/// their raw value, so ASCII bytes can be copied straight into an ``ASCIICharacter`` buffer.
+	static let storageMatchesRawValue: Bool = {
+		guard MemoryLayout<ASCIICharacter>.size == 1 else {
+			return false
+		}
+		return (0 ..< 128).allSatisfy { (value) -> Bool in
+			return unsafeBitCast(ASCIICharacter(rawValue: Int8(value))!, to: UInt8.self) == UInt8(value)
+		}
+	}()
+	
+	/// The in-memory representation of ``invalid``.
+	static let invalidStorage = unsafeBitCast(ASCIICharacter.invalid, to: UInt8.self)
+	
+	/// Returns the offset of the first byte in `bytes` that isn't ASCII, checking
+	/// thirty-two bytes at a time.
+	static func firstNonASCIIOffset(in bytes: UnsafeBufferPointer<UInt8>, from start: Int = 0) -> Int? {
+		guard let base = bytes.baseAddress else {
+			return nil
+		}
+		let lanes = SIMD32<UInt8>.scalarCount
+		let highBit = SIMD32<UInt8>(repeating: 0x80)
+		var i = start
+		while i + lanes <= bytes.count {
+			let vector = UnsafeRawPointer(base + i).loadUnaligned(as: SIMD32<UInt8>.self)
+			if any(vector & highBit .!= 0) {
+				break
+			}
+			i += lanes
+		}
+		while i < bytes.count {
+			if bytes[i] >= 0x80 {
+				return i
+			}
+			i += 1
+		}
+		return nil
+	}
+	
+	/// Copies ASCII bytes to `output` as ``ASCIICharacter``s.
+	///
+	/// If `mergeCRLF` is `true`, a carriage return followed by a line feed is written as a single
+	/// ``invalid``, as Swift treats the pair as one `Character`.
+	/// - returns: The number of characters written.
+	static func copyASCII(_ bytes: UnsafeBufferPointer<UInt8>, to output: UnsafeMutablePointer<ASCIICharacter>, mergeCRLF: Bool) -> Int {
+		guard let base = bytes.baseAddress, bytes.count > 0 else {
+			return 0
+		}
+		let hasCR = mergeCRLF && memchr(base, 0x0D, bytes.count) != nil
+		if !hasCR && storageMatchesRawValue {
+			UnsafeMutableRawPointer(output).copyMemory(from: base, byteCount: bytes.count)
+			return bytes.count
+		}
+		var written = 0
+		var i = 0
+		while i < bytes.count {
+			let byte = bytes[i]
+			if hasCR && byte == 0x0D && i + 1 < bytes.count && bytes[i + 1] == 0x0A {
+				output[written] = .invalid
+				i += 2
+			} else {
+				output[written] = ASCIICharacter(rawValue: Int8(bitPattern: byte))!
+				i += 1
+			}
+			written += 1
+		}
+		return written
+	}
+}
+
 public extension String {
 	/// Creates a string from a sequence of ``ASCIICharacter``s.
+	///
+	/// The string's UTF-8 storage is written directly, so there is only one allocation
+	/// if `asciiCharacters` has contiguous storage.
 	@inlinable init<A: Sequence>(asciiCharacters: A) where A.Element == ASCIICharacter {
-		let asciiCharMap = asciiCharacters.map { (cha) -> Character in
-			return cha.characterValue
+		if let str = asciiCharacters.withContiguousStorageIfAvailable({ String(asciiBuffer: $0) }) {
+			self = str
+		} else {
+			self = ContiguousArray(asciiCharacters).withUnsafeBufferPointer({ String(asciiBuffer: $0) })
+		}
+	}
+	
+	/// Creates a string from a buffer of ``ASCIICharacter``s, replacing ``ASCIICharacter/invalid``
+	/// with the replacement character (**0xFFFD**).
+	@usableFromInline
+	internal init(asciiBuffer chars: UnsafeBufferPointer<ASCIICharacter>) {
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+		let signpost = HotPathCounters.begin()
+		defer {
+			HotPathCounters.Slot.stringFromASCIIBuffer.end(since: signpost, items: chars.count)
+		}
+#endif
+		var invalidCount = 0
+		for char in chars where char == .invalid {
+			invalidCount += 1
+		}
+		// U+FFFD is three bytes long in UTF-8.
+		let capacity = chars.count + invalidCount * 2
+		self = String(unsafeUninitializedCapacity: capacity) { (buffer) -> Int in
+			if invalidCount == 0 && ASCIICharacter.storageMatchesRawValue, let base = chars.baseAddress {
+				UnsafeMutableRawPointer(buffer.baseAddress!).copyMemory(from: base, byteCount: chars.count)
+				return chars.count
+			}
+			var written = 0
+			for char in chars {
+				if char == .invalid {
+					buffer[written] = 0xEF
+					buffer[written + 1] = 0xBF
+					buffer[written + 2] = 0xBD
+					written += 3
+				} else {
+					buffer[written] = UInt8(bitPattern: char.rawValue)
+					written += 1
+				}
+			}
+			return written
 		}
-		self = String(asciiCharMap)
 	}
 	
 	/// Converts the string to an array of ``ASCIICharacter``s.
@@ -217,20 +332,87 @@ public extension String {
 	/// instead of stopping and returning `nil`.
 	/// - returns: An array of ``ASCIICharacter``s, or `nil` if there is a non-ASCII
 	/// character and `encodeInvalid` is `false`.
+	///
+	/// Works directly on the string's UTF-8, checking thirty-two bytes at a time.
+	/// Only runs of non-ASCII text are walked one `Character` at a time.
 	func toASCIICharacters(encodeInvalid: Bool = false) -> [ASCIICharacter]? {
-		if encodeInvalid {
-			return self.map({ (aChar) -> ASCIICharacter in
-				return ASCIICharacter(swiftCharacter: aChar) ?? .invalid
-			})
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+		let signpost = HotPathCounters.begin()
+		defer {
+			HotPathCounters.Slot.toASCIICharacters.end(since: signpost, items: utf8.count)
 		}
-		guard var asciis = self.cString(using: String.Encoding.ascii) else {
-			return nil
+#endif
+		let native: String = {
+			var native = self
+			native.makeContiguousUTF8()
+			return native
+		}()
+		return native.utf8.withContiguousStorageIfAvailable { (bytes) -> [ASCIICharacter]? in
+			if !encodeInvalid {
+				guard ASCIICharacter.firstNonASCIIOffset(in: bytes) == nil else {
+					return nil
+				}
+				return [ASCIICharacter](unsafeUninitializedCapacity: bytes.count) { (buffer, initializedCount) in
+					initializedCount = ASCIICharacter.copyASCII(bytes, to: buffer.baseAddress!, mergeCRLF: false)
+				}
+			}
+			return [ASCIICharacter](unsafeUninitializedCapacity: bytes.count) { (buffer, initializedCount) in
+				initializedCount = native.encodeASCIICharacters(bytes, to: buffer.baseAddress!)
+			}
+		}!
+	}
+	
+	/// Converts the UTF-8 `bytes` of the current string, substituting ``ASCIICharacter/invalid``
+	/// for every `Character` that isn't a single ASCII scalar.
+	private func encodeASCIICharacters(_ bytes: UnsafeBufferPointer<UInt8>, to output: UnsafeMutablePointer<ASCIICharacter>) -> Int {
+		let utf8View = self.utf8
+		var written = 0
+		var i = 0
+		while i < bytes.count {
+			guard let j = ASCIICharacter.firstNonASCIIOffset(in: bytes, from: i) else {
+				written += ASCIICharacter.copyASCII(UnsafeBufferPointer(rebasing: bytes[i...]), to: output + written, mergeCRLF: true)
+				break
+			}
+			// The ASCII byte right before a non-ASCII scalar might be combined with it,
+			// so it gets handled with the rest of the non-ASCII text.
+			var start = j
+			if j > i {
+				start = j - 1
+				if start > i && bytes[start] == 0x0A && bytes[start - 1] == 0x0D {
+					start -= 1
+				}
+			}
+			written += ASCIICharacter.copyASCII(UnsafeBufferPointer(rebasing: bytes[i ..< start]), to: output + written, mergeCRLF: true)
+			
+			// Walk by Character until the text is back to plain ASCII.
+			var idx = utf8View.index(utf8View.startIndex, offsetBy: start)
+			i = bytes.count
+			while idx < endIndex {
+				let next = index(after: idx)
+				let charLen = utf8View.distance(from: idx, to: next)
+				let charStart = utf8View.distance(from: utf8View.startIndex, to: idx)
+				if charLen == 1 {
+					output[written] = ASCIICharacter(rawValue: Int8(bitPattern: bytes[charStart]))!
+				} else {
+					output[written] = .invalid
+				}
+				written += 1
+				let nextOffset = charStart + charLen
+				if nextOffset < bytes.count && bytes[nextOffset] < 0x80 &&
+					(nextOffset + 1 == bytes.count || bytes[nextOffset + 1] < 0x80) {
+					i = nextOffset
+					break
+				}
+				idx = next
+			}
 		}
-		
-		// Remove null termination.
-		asciis.removeLast()
-		return asciis.map({ (aChar) -> ASCIICharacter in
-			return ASCIICharacter(cCharacter: aChar)!
-		})
+		return written
 	}
 }
+
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+private extension HotPathCounters.Slot {
+	static let stringFromASCIIBuffer = HotPathCounters.Slot("String.init(asciiBuffer:)")
+	static let toASCIICharacters = HotPathCounters.Slot("String.toASCIICharacters(encodeInvalid:)")
+}
+#endif
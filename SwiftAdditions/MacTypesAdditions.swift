@@ -22,22 +22,7 @@ import FoundationAdditions
 /// - parameter theType: The `OSType` to convert to a string representation.
 /// - returns: A string representation of `theType`, or `nil` if it can't be converted.
 public func OSTypeToString(_ theType: OSType) -> String? {
-	func OSType2Ptr(type: OSType) -> [UInt8] {
-		var ourOSType = [UInt8](repeating: 0, count: 4)
-		var intType = type.bigEndian
-		memcpy(&ourOSType, &intType, 4)
-		
-		return ourOSType
-	}
-	
-	let ourOSType = OSType2Ptr(type: theType)
-	for char in ourOSType[0..<4] {
-		if (UInt8(0)..<0x20).contains(char) {
-			return nil
-		}
-	}
-	let ourData = Data(ourOSType)
-	return String(data: ourData, encoding: .macOSRoman)
+	return FourCharacterCode(rawValue: theType).stringValue
 }
 
 /// Converts an `OSType` to a `String` value. May return a hexadecimal representation.
@@ -46,11 +31,7 @@ public func OSTypeToString(_ theType: OSType) -> String? {
 /// be decoded as a Mac OS Roman.
 /// - returns: A string representation of `theType`, or the hexadecimal representation of `theType` if it can't be converted.
 public func OSTypeToString(_ theType: OSType, useHexIfInvalid: ()) -> String {
-	if let ourStr = OSTypeToString(theType), ourStr.count == 4 {
-		return ourStr
-	} else {
-		return String(format: "0x%08X", theType)
-	}
+	return FourCharacterCode(rawValue: theType).description
 }
 
 @available(swift, introduced: 2.0, deprecated: 5.0, obsoleted: 6.0, renamed: "toOSType(_:detectHex:)")
@@ -61,46 +42,12 @@ public func toOSType(string theString: String, detectHex: Bool = false) -> OSTyp
 /// Converts a `String` value to an `OSType`, truncating to the first four characters.
 ///
 /// If `theString` is longer than four characters, only the first four characters are used.
-/// If `theString` is shorter than four characters, the missing character spots are filled in with spaces (*0x20*).
+/// If `theString` is shorter than four characters, the missing character spots are filled in with zeros.
 /// - parameter theString: The `String` to get the OSType value from
 /// - parameter detectHex: If `true`, attempts to detect if the string is formatted as  a hexadecimal value.
 /// - returns: `theString` converted to an OSType, or *0* if the string can't be represented in the Mac OS Roman string encoding.
 public func toOSType(_ theString: String, detectHex: Bool = false) -> OSType {
-	if detectHex && theString.count > 4 {
-		let aScann = Scanner(string: theString)
-		var tmpnum: UInt64 = 0
-		if aScann.scanHexInt64(&tmpnum) && tmpnum != UInt64.max {
-			return OSType(tmpnum)
-		}
-	}
-	func Ptr2OSType(str: [CChar]) -> OSType {
-		var type: OSType = 0x20202020 // four spaces. Can't really be represented the same way as in C
-		var i = str.count - 1
-		if i > 4 {
-			i = 4
-		}
-		memcpy(&type, str, i)
-		type = type.bigEndian
-		
-		return type
-	}
-	var ourOSType = [Int8](repeating: 0, count: 5)
-	var ourLen = theString.lengthOfBytes(using: .macOSRoman)
-	if ourLen > 4 {
-		ourLen = 4
-	} else if ourLen == 0 {
-		return 0
-	}
-	
-	guard let aData = theString.cString(using: .macOSRoman) else {
-		return 0
-	}
-	
-	for i in 0 ..< ourLen {
-		ourOSType[i] = aData[i]
-	}
-	
-	return Ptr2OSType(str: ourOSType)
+	return FourCharacterCode(theString, detectHex: detectHex).rawValue
 }
 
 /// The current system encoding as a `CFStringEncoding` that is 
@@ -561,17 +508,26 @@ public extension String {
 	/// Gets passed a `CFStringEncoding` because the underlying function used to generate
 	/// the string uses that.
 	/// - parameter pStr: a pointer to the Pascal string in question. You may need
-	/// to use `arrayFromObject(reflecting:)` if the value is a tuple.
+	/// to use `withUnsafeElements(of:as:_:)` if the value is a tuple.
 	/// - parameter encoding: The encoding of the Pascal string, as a
 	/// `CFStringEncoding`.
 	/// - parameter maximumLength: The maximum length of the Pascal string.
 	/// If the first byte contains a value higher than this, the constructor returns
 	/// `nil`. The default is *255*, the largest value a `UInt8` can hold.
+	///
+	/// Encodings that ``ClassicMacEncoding`` can handle are decoded in place without
+	/// going through CoreFoundation.
 	init?(pascalString pStr: UnsafePointer<UInt8>, encoding: CFStringEncoding, maximumLength: UInt8 = 255) {
 		if pStr.pointee > maximumLength {
 			return nil
 		}
-		if let theStr = CFStringCreateWithPascalString(kCFAllocatorDefault, pStr, encoding) {
+		if let classic = ClassicMacEncoding(cfStringEncoding: encoding) {
+			let bytes = UnsafeRawBufferPointer(start: pStr, count: Int(pStr.pointee) + 1)
+			guard let theStr = PascalString.decode(bytes, encoding: classic, maximumLength: maximumLength) else {
+				return nil
+			}
+			self = theStr
+		} else if let theStr = CFStringCreateWithPascalString(kCFAllocatorDefault, pStr, encoding) {
 			self = String(theStr)
 		} else {
 			return nil
@@ -581,7 +537,7 @@ public extension String {
 	/// Converts a pointer to a Pascal string into a Swift string.
 	///
 	/// - parameter pStr: a pointer to the Pascal string in question. You may need 
-	/// to use `arrayFromObject(reflecting:)` if the value is a tuple.
+	/// to use `withUnsafeElements(of:as:_:)` if the value is a tuple.
 	/// - parameter encoding: The encoding of the Pascal string.
 	/// The default is `String.Encoding.macOSRoman`.
 	/// - parameter maximumLength: The maximum length of the Pascal string. 
@@ -598,50 +554,23 @@ public extension String {
 		self.init(pascalString: pStr, encoding: CFEncoding, maximumLength: maximumLength)
 	}
 	
+	/// Reads the Pascal string tuple in place instead of copying it to an array first.
+	private static func decodePascalTuple<T>(_ pStr: T, encoding: String.Encoding, maximumLength: UInt8) -> String? {
+		return withUnsafeElements(of: pStr, as: UInt8.self) { (bytes) -> String? in
+			return String(pascalString: bytes.baseAddress!, encoding: encoding, maximumLength: maximumLength)
+		}
+	}
+	
 	/// Converts a tuple of a Pascal string into a Swift string.
 	///
 	/// - parameter pStr: a tuple of the Pascal string in question.
 	/// - parameter encoding: The encoding of the Pascal string.
 	/// The default is `String.Encoding.macOSRoman`.
 	init?(pascalString pStr: PStr255, encoding: String.Encoding = .macOSRoman) {
-		let unwrapped: [UInt8] = [pStr.0, pStr.1, pStr.2, pStr.3, pStr.4, pStr.5, pStr.6, pStr.7, pStr.8,
-								  pStr.9, pStr.10, pStr.11, pStr.12, pStr.13, pStr.14, pStr.15, pStr.16,
-								  pStr.17, pStr.18, pStr.19, pStr.20, pStr.21, pStr.22, pStr.23, pStr.24,
-								  pStr.25, pStr.26, pStr.27, pStr.28, pStr.29, pStr.30, pStr.31, pStr.32,
-								  pStr.33, pStr.34, pStr.35, pStr.36, pStr.37, pStr.38, pStr.39, pStr.40,
-								  pStr.41, pStr.42, pStr.43, pStr.44, pStr.45, pStr.46, pStr.47, pStr.48,
-								  pStr.49, pStr.50, pStr.51, pStr.52, pStr.53, pStr.54, pStr.55, pStr.56,
-								  pStr.57, pStr.58, pStr.59, pStr.60, pStr.61, pStr.62, pStr.63, pStr.64,
-								  pStr.65, pStr.66, pStr.67, pStr.68, pStr.69, pStr.70, pStr.71, pStr.72,
-								  pStr.73, pStr.74, pStr.75, pStr.76, pStr.77, pStr.78, pStr.79, pStr.80,
-								  pStr.81, pStr.82, pStr.83, pStr.84, pStr.85, pStr.86, pStr.87, pStr.88,
-								  pStr.89, pStr.90, pStr.91, pStr.92, pStr.93, pStr.94, pStr.95, pStr.96,
-								  pStr.97, pStr.98, pStr.99, pStr.100, pStr.101, pStr.102, pStr.103,
-								  pStr.104, pStr.105, pStr.106, pStr.107, pStr.108, pStr.109, pStr.110,
-								  pStr.111, pStr.112, pStr.113, pStr.114, pStr.115, pStr.116, pStr.117,
-								  pStr.118, pStr.119, pStr.120, pStr.121, pStr.122, pStr.123, pStr.124,
-								  pStr.125, pStr.126, pStr.127, pStr.128, pStr.129, pStr.130, pStr.131,
-								  pStr.132, pStr.133, pStr.134, pStr.135, pStr.136, pStr.137, pStr.138,
-								  pStr.139, pStr.140, pStr.141, pStr.142, pStr.143, pStr.144, pStr.145,
-								  pStr.146, pStr.147, pStr.148, pStr.149, pStr.150, pStr.151, pStr.152,
-								  pStr.153, pStr.154, pStr.155, pStr.156, pStr.157, pStr.158, pStr.159,
-								  pStr.160, pStr.161, pStr.162, pStr.163, pStr.164, pStr.165, pStr.166,
-								  pStr.167, pStr.168, pStr.169, pStr.170, pStr.171, pStr.172, pStr.173,
-								  pStr.174, pStr.175, pStr.176, pStr.177, pStr.178, pStr.179, pStr.180,
-								  pStr.181, pStr.182, pStr.183, pStr.184, pStr.185, pStr.186, pStr.187,
-								  pStr.188, pStr.189, pStr.190, pStr.191, pStr.192, pStr.193, pStr.194,
-								  pStr.195, pStr.196, pStr.197, pStr.198, pStr.199, pStr.200, pStr.201,
-								  pStr.202, pStr.203, pStr.204, pStr.205, pStr.206, pStr.207, pStr.208,
-								  pStr.209, pStr.210, pStr.211, pStr.212, pStr.213, pStr.214, pStr.215,
-								  pStr.216, pStr.217, pStr.218, pStr.219, pStr.220, pStr.221, pStr.222,
-								  pStr.223, pStr.224, pStr.225, pStr.226, pStr.227, pStr.228, pStr.229,
-								  pStr.230, pStr.231, pStr.232, pStr.233, pStr.234, pStr.235, pStr.236,
-								  pStr.237, pStr.238, pStr.239, pStr.240, pStr.241, pStr.242, pStr.243,
-								  pStr.244, pStr.245, pStr.246, pStr.247, pStr.248, pStr.249, pStr.250,
-								  pStr.251, pStr.252, pStr.253, pStr.254, pStr.255]
-		// a UInt8 can't reference any number greater than 255,
-		// so we just pass it to the main initializer
-		self.init(pascalString: unwrapped, encoding: encoding)
+		guard let theStr = String.decodePascalTuple(pStr, encoding: encoding, maximumLength: 255) else {
+			return nil
+		}
+		self = theStr
 	}
 	
 	/// Converts a tuple of a Pascal string into a Swift string.
@@ -650,17 +579,10 @@ public extension String {
 	/// - parameter encoding: The encoding of the Pascal string.
 	/// The default is `String.Encoding.macOSRoman`.
 	init?(pascalString pStr: PStr63, encoding: String.Encoding = .macOSRoman) {
-		let unwrapped: [UInt8] = [pStr.0, pStr.1, pStr.2, pStr.3, pStr.4, pStr.5, pStr.6, pStr.7,
-								  pStr.8, pStr.9, pStr.10, pStr.11, pStr.12, pStr.13, pStr.14,
-								  pStr.15, pStr.16, pStr.17, pStr.18, pStr.19, pStr.20, pStr.21,
-								  pStr.22, pStr.23, pStr.24, pStr.25, pStr.26, pStr.27, pStr.28,
-								  pStr.29, pStr.30, pStr.31, pStr.32, pStr.33, pStr.34, pStr.35,
-								  pStr.36, pStr.37, pStr.38, pStr.39, pStr.40, pStr.41, pStr.42,
-								  pStr.43, pStr.44, pStr.45, pStr.46, pStr.47, pStr.48, pStr.49,
-								  pStr.50, pStr.51, pStr.52, pStr.53, pStr.54, pStr.55, pStr.56,
-								  pStr.57, pStr.58, pStr.59, pStr.60, pStr.61, pStr.62, pStr.63]
-		
-		self.init(pascalString: unwrapped, encoding: encoding, maximumLength: 63)
+		guard let theStr = String.decodePascalTuple(pStr, encoding: encoding, maximumLength: 63) else {
+			return nil
+		}
+		self = theStr
 	}
 	
 	/// Converts a tuple of a Pascal string into a Swift string.
@@ -669,13 +591,10 @@ public extension String {
 	/// - parameter encoding: The encoding of the Pascal string.
 	/// The default is `String.Encoding.macOSRoman`.
 	init?(pascalString pStr: PStr32, encoding: String.Encoding = .macOSRoman) {
-		let unwrapped: [UInt8] = [pStr.0, pStr.1, pStr.2, pStr.3, pStr.4, pStr.5, pStr.6, pStr.7,
-								  pStr.8, pStr.9, pStr.10, pStr.11, pStr.12, pStr.13, pStr.14,
-								  pStr.15, pStr.16, pStr.17, pStr.18, pStr.19, pStr.20, pStr.21,
-								  pStr.22, pStr.23, pStr.24, pStr.25, pStr.26, pStr.27, pStr.28,
-								  pStr.29, pStr.30, pStr.31, pStr.32]
-		
-		self.init(pascalString: unwrapped, encoding: encoding, maximumLength: 32)
+		guard let theStr = String.decodePascalTuple(pStr, encoding: encoding, maximumLength: 32) else {
+			return nil
+		}
+		self = theStr
 	}
 	
 	/// Converts a tuple of a Pascal string into a Swift string.
@@ -684,13 +603,10 @@ public extension String {
 	/// - parameter encoding: The encoding of the Pascal string.
 	/// The default is `String.Encoding.macOSRoman`.
 	init?(pascalString pStr: PStr31, encoding: String.Encoding = .macOSRoman) {
-		let unwrapped: [UInt8] = [pStr.0, pStr.1, pStr.2, pStr.3, pStr.4, pStr.5, pStr.6, pStr.7,
-								  pStr.8, pStr.9, pStr.10, pStr.11, pStr.12, pStr.13, pStr.14,
-								  pStr.15, pStr.16, pStr.17, pStr.18, pStr.19, pStr.20, pStr.21,
-								  pStr.22, pStr.23, pStr.24, pStr.25, pStr.26, pStr.27, pStr.28,
-								  pStr.29, pStr.30, pStr.31]
-		
-		self.init(pascalString: unwrapped, encoding: encoding, maximumLength: 31)
+		guard let theStr = String.decodePascalTuple(pStr, encoding: encoding, maximumLength: 31) else {
+			return nil
+		}
+		self = theStr
 	}
 	
 	/// Converts a tuple of a Pascal string into a Swift string.
@@ -699,12 +615,10 @@ public extension String {
 	/// - parameter encoding: The encoding of the Pascal string.
 	/// The default is `String.Encoding.macOSRoman`.
 	init?(pascalString pStr: PStr27, encoding: String.Encoding = .macOSRoman) {
-		let unwrapped: [UInt8] = [pStr.0, pStr.1, pStr.2, pStr.3, pStr.4, pStr.5, pStr.6, pStr.7,
-								  pStr.8, pStr.9, pStr.10, pStr.11, pStr.12, pStr.13, pStr.14,
-								  pStr.15, pStr.16, pStr.17, pStr.18, pStr.19, pStr.20, pStr.21,
-								  pStr.22, pStr.23, pStr.24, pStr.25, pStr.26, pStr.27]
-		
-		self.init(pascalString: unwrapped, encoding: encoding, maximumLength: 27)
+		guard let theStr = String.decodePascalTuple(pStr, encoding: encoding, maximumLength: 27) else {
+			return nil
+		}
+		self = theStr
 	}
 	
 	/// Converts a tuple of a Pascal string into a Swift string.
@@ -713,11 +627,10 @@ public extension String {
 	/// - parameter encoding: The encoding of the Pascal string.
 	/// The default is `String.Encoding.macOSRoman`.
 	init?(pascalString pStr: PStr15, encoding: String.Encoding = .macOSRoman) {
-		let unwrapped: [UInt8] = [pStr.0, pStr.1, pStr.2, pStr.3, pStr.4, pStr.5, pStr.6, pStr.7,
-								  pStr.8, pStr.9, pStr.10, pStr.11, pStr.12, pStr.13, pStr.14,
-								  pStr.15]
-		
-		self.init(pascalString: unwrapped, encoding: encoding, maximumLength: 15)
+		guard let theStr = String.decodePascalTuple(pStr, encoding: encoding, maximumLength: 15) else {
+			return nil
+		}
+		self = theStr
 	}
 	
 	/// Converts a tuple of a Pascal string into a Swift string.
@@ -729,13 +642,10 @@ public extension String {
 	/// The last byte in a `Str32Field` is unused,
 	/// so the last byte isn't read.
 	init?(pascalString pStr: PStr32Field, encoding: String.Encoding = .macOSRoman) {
-		let unwrapped: [UInt8] = [pStr.0, pStr.1, pStr.2, pStr.3, pStr.4, pStr.5, pStr.6, pStr.7,
-								  pStr.8, pStr.9, pStr.10, pStr.11, pStr.12, pStr.13, pStr.14,
-								  pStr.15, pStr.16, pStr.17, pStr.18, pStr.19, pStr.20, pStr.21,
-								  pStr.22, pStr.23, pStr.24, pStr.25, pStr.26, pStr.27, pStr.28,
-								  pStr.29, pStr.30, pStr.31, pStr.32, pStr.33]
-		
-		self.init(pascalString: unwrapped, encoding: encoding, maximumLength: 32)
+		guard let theStr = String.decodePascalTuple(pStr, encoding: encoding, maximumLength: 32) else {
+			return nil
+		}
+		self = theStr
 	}
 }
 
@@ -792,10 +702,8 @@ extension String {
 		guard HFSUniStr.length < 256 else {
 			return nil
 		}
-		let uniChars: [UInt16] = try! arrayFromObject(reflecting: HFSUniStr.unicode)
-		let uniStr = uniChars[0 ..< Int(HFSUniStr.length)]
-		let dat = uniStr.withUnsafeBufferPointer { (buf) -> Data in
-			return Data(buffer: buf)
+		let dat = withUnsafeElements(of: HFSUniStr.unicode, as: UInt16.self) { (buf) -> Data in
+			return Data(buffer: UnsafeBufferPointer(rebasing: buf[0 ..< Int(HFSUniStr.length)]))
 		}
 		guard let toRet = String(data: dat, encoding: .macOSHFS) else {
 			return nil
@@ -60,4 +60,34 @@ class CharacterAdditionsTests: XCTestCase {
 		let hi2 = String(asciiCharacters: hi)
 		XCTAssertEqual("\"H\u{FFFD}llo\u{FFFD}\u{FFFD}\"", hi2)
 	}
+	
+	func testInvalidASCIIGraphemes() {
+		// Each non-ASCII grapheme, including ones made up of an ASCII scalar and a
+		// combining mark, becomes a single invalid character.
+		let str = "ab\r\ncde\u{301}f 🇺🇸 g" + String(repeating: "x", count: 40) + "\u{301}"
+		let expected: [ASCIICharacter?] = str.map({ ASCIICharacter(swiftCharacter: $0) })
+		XCTAssertEqual(str.toASCIICharacters(encodeInvalid: true), expected.map({ $0 ?? .invalid }))
+		XCTAssertNil(str.toASCIICharacters())
+		XCTAssertEqual("a\r\nb".toASCIICharacters(), [.letterLowercaseA, .carriageReturn, .lineFeed, .letterLowercaseB])
+	}
+	
+	func testASCIIString() {
+		let str = ASCIIString("Hello, world!")!
+		XCTAssertEqual(str.count, 13)
+		XCTAssertEqual(str.stringValue, "Hello, world!")
+		XCTAssertEqual(String(str[7...]), "world!")
+		XCTAssertTrue(str.isValid)
+		XCTAssertNil(ASCIIString("Héllo"))
+		let invalid = ASCIIString("Héllo", encodeInvalid: true)!
+		XCTAssertFalse(invalid.isValid)
+		XCTAssertEqual(invalid.description, "H\u{FFFD}llo")
+	}
+	
+	func testASCIIConversionPerformance() {
+		let str = String(repeating: "The quick brown fox jumps over the lazy dog. ", count: 20_000)
+		measure {
+			let chars = str.toASCIICharacters()!
+			XCTAssertEqual(String(asciiCharacters: chars), str)
+		}
+	}
 }
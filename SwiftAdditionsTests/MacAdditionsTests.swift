@@ -113,6 +113,100 @@ class MacAdditionsTests: XCTestCase {
 		XCTAssertNil(aStr)
 	}
 	
+	func testPascalStringsMatchCoreFoundation() {
+		let encodings: [CFStringEncoding] = [CFStringEncoding(CFStringBuiltInEncodings.macRoman.rawValue), CFStringEncoding(CFStringEncodings.macIcelandic.rawValue)]
+		var bytes = [UInt8](repeating: 0, count: 256)
+		for encoding in encodings {
+			for start in stride(from: 0, to: 256, by: 32) {
+				bytes[0] = 32
+				for i in 0 ..< 32 {
+					bytes[i + 1] = UInt8(start + i)
+				}
+				let ours = String(pascalString: bytes, encoding: encoding)
+				let cf = CFStringCreateWithPascalString(kCFAllocatorDefault, bytes, encoding) as String?
+				XCTAssertEqual(ours, cf, "encoding \(encoding), bytes starting at \(start)")
+			}
+		}
+	}
+	
+	func testPascalStringPerformance() {
+		var pStr255 = [UInt8](repeating: 0x8E, count: 256)
+		pStr255[0] = 255
+		var pStr31 = [UInt8](repeating: 0x61, count: 32)
+		pStr31[0] = 31
+		measure {
+			for _ in 0 ..< 20_000 {
+				_ = String(pascalString: pStr255)
+				_ = String(pascalString: pStr31, maximumLength: 31)
+			}
+		}
+	}
+	
+	/// The Foundation-based implementation `OSTypeToString(_:)` used to have,
+	/// kept as a reference.
+	private func referenceOSTypeToString(_ theType: OSType) -> String? {
+		var bytes = [UInt8](repeating: 0, count: 4)
+		var intType = theType.bigEndian
+		memcpy(&bytes, &intType, 4)
+		for char in bytes where char < 0x20 {
+			return nil
+		}
+		return String(data: Data(bytes), encoding: .macOSRoman)
+	}
+	
+	func testOSTypeToStringMatchesFoundation() {
+		var generator = SystemRandomNumberGenerator()
+		let fixed: [OSType] = [0, 0x20202020, 0x74657874, 0x3F3F3F3F, 0xF0F0F0F0, 0xC4686C70, 0x7F7F7F7F, 0x8E8F9091, 0xDBDBDBDB, 0x1F414243]
+		let randoms = (0 ..< 10_000).map { _ in OSType.random(in: 0 ... .max, using: &generator) }
+		for theType in fixed + randoms {
+			XCTAssertEqual(OSTypeToString(theType), referenceOSTypeToString(theType), String(format: "0x%08X", theType))
+		}
+		XCTAssertEqual(OSTypeToString(0x0000_0001, useHexIfInvalid: ()), "0x00000001")
+		XCTAssertEqual(OSTypeToString(0xDEAD_BEEF, useHexIfInvalid: ()), String(format: "0x%08X", 0xDEAD_BEEF))
+	}
+	
+	func testToOSType() {
+		XCTAssertEqual(toOSType("text"), 0x74657874)
+		XCTAssertEqual(toOSType("textual"), 0x74657874)
+		XCTAssertEqual(toOSType("ab"), 0x61620000)
+		XCTAssertEqual(toOSType(""), 0)
+		XCTAssertEqual(toOSType("ab😀"), 0)
+		XCTAssertEqual(toOSType("Ä™ƒ"), 0x80AAC400)
+		XCTAssertEqual(toOSType("e\u{301}tc"), 0x8E746300)
+		XCTAssertEqual(toOSType("0x74657874", detectHex: true), 0x74657874)
+		XCTAssertEqual(toOSType("  1234abcd", detectHex: true), 0x1234ABCD)
+		XCTAssertEqual(toOSType("0x12", detectHex: true), 0x30783132)
+		for theType: OSType in [0x74657874, 0x8E8F9091, 0xF0202020] {
+			XCTAssertEqual(toOSType(OSTypeToString(theType)!), theType)
+		}
+	}
+	
+	/// Codes whose four bytes are all printable ASCII, 0x20...0x7E.
+	private func printableOSTypes(count: Int) -> [OSType] {
+		return (0 ..< count).map { _ in
+			(0 ..< 4).reduce(OSType(0)) { (code, _) in (code << 8) | OSType.random(in: 0x20 ... 0x7E) }
+		}
+	}
+	
+	func testOSTypeCodecPerformance() {
+		let codes = printableOSTypes(count: 100_000)
+		measure {
+			for code in codes {
+				_ = toOSType(OSTypeToString(code)!)
+			}
+		}
+	}
+	
+	func testReferenceOSTypeCodecPerformance() {
+		let codes = printableOSTypes(count: 100_000)
+		measure {
+			for code in codes {
+				let str = referenceOSTypeToString(code)!
+				_ = str.cString(using: .macOSRoman)
+			}
+		}
+	}
+	
 	/*
 	TODO: Test encodings that Cocoa can decode:
 	0
@@ -76,6 +76,54 @@ class SwiftAdditionsTests: XCTestCase {
 		XCTAssertEqual("", subString2)
 	}
 	
+	func testTruncationGraphemeBoundaries() {
+		// Flags are two scalars, and "é" here is decomposed.
+		let testString = "ab🇺🇸e\u{301}\r\nz"
+		XCTAssertEqual(testString.substringWithLength(utf8: 5), "ab")
+		XCTAssertEqual(testString.substringWithLength(utf8: 10), "ab🇺🇸")
+		XCTAssertEqual(testString.substringWithLength(utf8: 13), "ab🇺🇸e\u{301}")
+		XCTAssertEqual(testString.substringWithLength(utf8: 14), "ab🇺🇸e\u{301}")
+		XCTAssertEqual(testString.substringWithLength(utf8: 15), "ab🇺🇸e\u{301}\r\n")
+		XCTAssertEqual(testString.substringWithLength(utf16: 4), "ab")
+		XCTAssertEqual(testString.substringWithLength(utf16: 7), "ab🇺🇸")
+		XCTAssertEqual(testString.substringWithLength(utf16: 8), "ab🇺🇸e\u{301}")
+	}
+	
+	func testBatchTruncation() {
+		let names = ["Résumé", "hi 🙃🐱", "Ω≈ç√", "plain"]
+		var buffer = [UInt8](repeating: 0xFF, count: 6 * names.count)
+		var lengths = [Int](repeating: 0, count: names.count)
+		let written = buffer.withUnsafeMutableBytes { (bytes) in
+			lengths.withUnsafeMutableBufferPointer { (lens) in
+				String.writeTruncated(names, fieldWidth: 6, encoding: .utf8, into: bytes, lengths: lens)
+			}
+		}
+		XCTAssertEqual(written, 4)
+		XCTAssertEqual(lengths, [6, 3, 5, 5])
+		XCTAssertEqual(String(decoding: buffer[0 ..< 6], as: UTF8.self), "Résum")
+		XCTAssertEqual(Array(buffer[9 ..< 12]), [0, 0, 0])
+		XCTAssertEqual(String(decoding: buffer[12 ..< 17], as: UTF8.self), "Ω≈")
+		
+		_ = buffer.withUnsafeMutableBytes { (bytes) in
+			lengths.withUnsafeMutableBufferPointer { (lens) in
+				String.writeTruncated(names, fieldWidth: 6, encoding: .macOSRoman, into: bytes, lengths: lens)
+			}
+		}
+		XCTAssertEqual(lengths, [6, 5, 4, 5])
+		XCTAssertEqual(Array(buffer[0 ..< 6]), [0x52, 0x8E, 0x73, 0x75, 0x6D, 0x8E])
+		XCTAssertEqual(Array(buffer[6 ..< 12]), [0x68, 0x69, 0x20, 0x3F, 0x3F, 0x00])
+		XCTAssertEqual(Array(buffer[12 ..< 16]), [0xBD, 0xC5, 0x8D, 0xC3])
+	}
+	
+	func testTruncationPerformance() {
+		let longString = String(repeating: "naïve café 🙃 ", count: 10_000)
+		measure {
+			for budget in stride(from: 1, to: 4096, by: 7) {
+				_ = longString.substringWithLength(utf8: budget)
+			}
+		}
+	}
+	
 	func testNSNumberCocoaComparable() {
 		let num1 = NSNumber(value: 9)
 		let num2 = NSNumber(value: 9.0)
@@ -7,6 +7,7 @@
 
 import Foundation
 import AudioToolbox
+import FoundationAdditions
 
 /// Simple Buffer List wrapper targetted to use with retrieving AU output.
 ///
@@ -16,9 +17,16 @@ import AudioToolbox
 ///
 /// Before using this with any call to `AudioUnitRender`, it needs to be Prepared
 /// as some calls to `AudioUnitRender` can reset the ABL.
+///
+/// Allocated memory comes from a ``BufferArena``, with each channel's buffer aligned to
+/// and padded to a cache line.
 public class AUOutputBL {
 	public private(set) var format: AudioStreamBasicDescription
-	private var bufferMemory: UnsafeMutableRawPointer? = nil
+	private let arena: BufferArena
+	private var allocation: BufferArena.Allocation? = nil
+	private var bufferMemory: UnsafeMutableRawPointer? {
+		return allocation?.baseAddress
+	}
 	private var bufferList: UnsafeMutableAudioBufferListPointer
 	private var bufferCount: Int
 	private var bufferSize: Int
@@ -26,8 +34,10 @@ public class AUOutputBL {
 	
 	/// This is the constructor that you use.
 	/// It can't be reset once you've constructed it.
-	public init(streamDescription inDesc: AudioStreamBasicDescription, frameCount inDefaultNumFrames: UInt32 = 512) {
+	/// - parameter arena: The arena to take buffer memory from. Default is ``BufferArena/shared``.
+	public init(streamDescription inDesc: AudioStreamBasicDescription, frameCount inDefaultNumFrames: UInt32 = 512, arena: BufferArena = .shared) {
 		format = inDesc
+		self.arena = arena
 		bufferSize = 0
 		bufferCount = format.isInterleaved ? 1 : Int(format.mChannelsPerFrame)
 		frames = inDefaultNumFrames
@@ -39,35 +49,30 @@ public class AUOutputBL {
 	/// If you want to dispose previously allocted memory, pass in `0`,
 	/// then you either have an empty buffer list, or you can re-allocate.
 	/// Memory is kept around if an allocation request is less than what is currently allocated.
+	///
+	/// Growing reuses a pooled block from the arena if one is available, and the old block
+	/// is returned to the arena without taking a lock.
 	public func allocate(frames inNumFrames: UInt32) {
 		if inNumFrames != 0 {
-			var nBytes = format.framesToBytes(inNumFrames)
+			let nBytes = Int(format.framesToBytes(inNumFrames))
 			
-			guard nBytes > allocatedBytes else {
+			guard nBytes > bufferSize else {
 				return
 			}
 			
-			// align successive buffers for Altivec and to take alternating
-			// cache line hits by spacing them by odd multiples of 16
-			if bufferCount > 1 {
-				nBytes = (nBytes + (0x10 - (nBytes & 0xF))) | 0x10
+			let layout = BufferListLayout(bufferCount: bufferCount, bytesPerBuffer: nBytes)
+			let newAllocation = arena.checkOut(layout, zeroed: true)
+			if let oldAllocation = allocation {
+				arena.checkIn(oldAllocation)
 			}
-			
-			bufferSize = Int(nBytes)
-			
-			let memorySize = bufferSize * bufferCount
-			let newMemory = malloc(memorySize)
-			memset(newMemory, 0, memorySize)	// make buffer "hot"
-			
-			let oldMemory = bufferMemory
-			bufferMemory = newMemory
-			free(oldMemory)
+			allocation = newAllocation
+			bufferSize = layout.bufferStride
 			
 			frames = inNumFrames
 		} else {
-			if let mBufferMemory = bufferMemory {
-				free(mBufferMemory)
-				self.bufferMemory = nil
+			if let oldAllocation = allocation {
+				arena.checkIn(oldAllocation)
+				allocation = nil
 			}
 			bufferSize = 0
 			frames = 0
@@ -118,8 +123,8 @@ public class AUOutputBL {
 	
 	deinit {
 		bufferList.unsafeMutablePointer.deallocate()
-		if let bufferMemory = bufferMemory {
-			free(bufferMemory)
+		if let allocation {
+			arena.checkIn(allocation)
 		}
 	}
 }
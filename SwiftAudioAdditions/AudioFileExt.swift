@@ -10,6 +10,7 @@ import Foundation
 import AudioToolbox
 import CoreAudio
 import SwiftAdditions
+import FoundationAdditions
 
 // MARK: Audio File
 
@@ -509,6 +510,12 @@ public extension AudioStreamBasicDescription {
 	///
 	/// Format for PCM is *[-][BE|LE]{F|I|UI}{bitdepth}*; else a 4-char format code (e.g. `aac`, `alac`).
 	init(fromText: String) throws(ASBDError) {
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+		let signpost = HotPathCounters.begin()
+		defer {
+			HotPathCounters.Slot.audioStreamBasicDescriptionFromText.end(since: signpost, items: fromText.utf8.count)
+		}
+#endif
 		var charIterator = fromText.startIndex
 		
 		func numFromCurrentChar() -> Int? {
@@ -1013,3 +1020,97 @@ extension AudioStreamBasicDescription: @retroactive Comparable {
 		return theAnswer
 	}
 }
+
+// MARK: PCM conversion
+
+public extension PCMFormat {
+	/// Creates a PCM format from a stream description.
+	///
+	/// Returns `nil` if `asbd` isn't packed linear PCM with 16-, 24-, or 32-bit signed integer
+	/// samples, or 32- or 64-bit float samples.
+	init?(_ asbd: AudioStreamBasicDescription) {
+		// Fixed-point samples keep their fractional bit count in the flags.
+		guard asbd.isPCM, asbd.mChannelsPerFrame > 0, asbd.sampleWordSize > 0, !asbd.isPackednessSignificant,
+			  (asbd.mFormatFlags & kLinearPCMFormatFlagsSampleFractionMask) == 0 else {
+			return nil
+		}
+		let sampleType: SampleType
+		switch (asbd.isFloat, asbd.isSignedInteger, asbd.mBitsPerChannel) {
+		case (true, _, 32):
+			sampleType = .float32
+		case (true, _, 64):
+			sampleType = .float64
+		case (false, true, 16):
+			sampleType = .int16
+		case (false, true, 24):
+			sampleType = .int24
+		case (false, true, 32):
+			sampleType = .int32
+		default:
+			return nil
+		}
+		self.init(sampleType: sampleType, channelCount: Int(asbd.mChannelsPerFrame), isInterleaved: asbd.isInterleaved, isBigEndian: asbd.formatFlags.contains(.bigEndian))
+	}
+}
+
+public extension AudioStreamBasicDescription {
+	/// Creates a packed linear PCM stream description.
+	/// - parameter format: The sample layout.
+	/// - parameter sampleRate: The number of frames per second.
+	init(_ format: PCMFormat, sampleRate: Float64) {
+		var flags: AudioFormatFlag = [.packed]
+		switch format.sampleType {
+		case .float32, .float64:
+			flags.insert(.float)
+		case .int16, .int24, .int32:
+			flags.insert(.signedInteger)
+		}
+		if format.isBigEndian {
+			flags.insert(.bigEndian)
+		}
+		if !format.isInterleaved {
+			flags.insert(.nonInterleaved)
+		}
+		let bytesPerFrame = UInt32(format.bytesPerFrame)
+		self.init(mSampleRate: sampleRate, mFormatID: kAudioFormatLinearPCM, mFormatFlags: flags.rawValue, mBytesPerPacket: bytesPerFrame, mFramesPerPacket: 1, mBytesPerFrame: bytesPerFrame, mChannelsPerFrame: UInt32(format.channelCount), mBitsPerChannel: UInt32(format.sampleType.bytesPerSample * 8), mReserved: 0)
+	}
+}
+
+public extension PCMConverter {
+	/// Creates a converter between two linear PCM stream descriptions.
+	///
+	/// Sample rates are ignored; the converter only changes the sample layout and channels.
+	/// Returns `nil` if either description isn't a layout ``PCMFormat`` supports.
+	/// - parameter source: The format of the samples to convert.
+	/// - parameter destination: The format to convert the samples to.
+	/// - parameter mixMatrix: The gain of each source channel in each destination channel, in
+	/// row-major order with a row for each destination channel. Default is `nil`.
+	convenience init?(from source: AudioStreamBasicDescription, to destination: AudioStreamBasicDescription, mixMatrix: [Float]? = nil) {
+		guard let sourceFormat = PCMFormat(source), let destinationFormat = PCMFormat(destination) else {
+			return nil
+		}
+		self.init(from: sourceFormat, to: destinationFormat, mixMatrix: mixMatrix)
+	}
+
+	/// Converts frames between audio buffer lists.
+	/// - parameter frameCount: The number of frames to convert.
+	/// - parameter source: The source buffers, laid out as `sourceFormat`.
+	/// - parameter destination: The destination buffers, laid out as `destinationFormat`.
+	/// Their `mDataByteSize` fields are set to the number of bytes converted.
+	func convert(frameCount: Int, from source: UnsafePointer<AudioBufferList>, to destination: UnsafeMutablePointer<AudioBufferList>) {
+		let sourceBuffers = UnsafeMutableAudioBufferListPointer(UnsafeMutablePointer(mutating: source))
+		let destinationBuffers = UnsafeMutableAudioBufferListPointer(destination)
+		precondition(sourceBuffers.count >= sourceFormat.bufferCount && destinationBuffers.count >= destinationFormat.bufferCount, "Not enough buffers")
+		convert(frameCount: frameCount, source: { UnsafeRawPointer(sourceBuffers[$0].mData!) }, destination: { destinationBuffers[$0].mData! })
+		let byteSize = UInt32(frameCount * destinationFormat.bytesPerFrame)
+		for i in 0 ..< destinationFormat.bufferCount {
+			destinationBuffers[i].mDataByteSize = byteSize
+		}
+	}
+}
+
+#if SWIFTADDITIONS_HOT_PATH_COUNTERS
+private extension HotPathCounters.Slot {
+	static let audioStreamBasicDescriptionFromText = HotPathCounters.Slot("AudioStreamBasicDescription.init(fromText:)")
+}
+#endif
@@ -8,6 +8,7 @@
 import Foundation
 import AudioToolbox
 import SwiftAdditions
+import FoundationAdditions
 
 private func OSTypeToStr(_ val: OSType) -> String {
 	var toRet = ""
@@ -41,7 +42,137 @@ extension AudioStreamBasicDescription: @retroactive Hashable {
 	}
 }
 
-public final class AudioFileFormats {
+/// Queries AudioToolbox for the writable file types and the data formats they can contain.
+public struct AudioToolboxFileFormatProvider: FileFormatProvider {
+	public init() {}
+	
+	public func fileTypes() -> [FileTypeRecord] {
+		var size: UInt32 = 0
+		var err = AudioFileGetGlobalInfoSize(kAudioFileGlobalInfo_WritableTypes, 0, nil, &size);
+		guard err == noErr else {
+			return []
+		}
+		let mNumFileFormats = Int(size) / MemoryLayout<UInt32>.size
+		var fileTypes = [UInt32](repeating: 0, count: mNumFileFormats)
+		err = AudioFileGetGlobalInfo(kAudioFileGlobalInfo_WritableTypes, 0, nil, &size, &fileTypes);
+		guard err == noErr else {
+			return []
+		}
+		var records = [FileTypeRecord]()
+		records.reserveCapacity(fileTypes.count)
+		for fileType in fileTypes {
+			var record = FileTypeRecord(fileTypeID: fileType, name: "", extensions: [])
+			var filetype = fileType
+			
+			// file type name
+			do {
+				size = UInt32(MemoryLayout<CFString>.size)
+				var fileName: UnsafeMutableRawPointer? = nil
+				err = AudioFileGetGlobalInfo(kAudioFileGlobalInfo_FileTypeName, UInt32(MemoryLayout<UInt32>.size), &filetype, &size, &fileName)
+				
+				if let fileName {
+					let fileName2 = Unmanaged<CFString>.fromOpaque(fileName)
+					record.name = fileName2.takeUnretainedValue() as String
+				}
+			}
+			
+			// file extensions
+			do {
+				size = UInt32(MemoryLayout<CFArray>.size)
+				var extensions: UnsafeMutableRawPointer? = nil
+				err = AudioFileGetGlobalInfo(kAudioFileGlobalInfo_ExtensionsForType, UInt32(MemoryLayout<UInt32>.size), &filetype, &size, &extensions)
+				if let extensions {
+					let ext2 = Unmanaged<CFArray>.fromOpaque(extensions).takeUnretainedValue()
+					if let ext3 = ext2 as? [String] {
+						record.extensions = ext3
+					}
+				}
+			}
+			records.append(record)
+		}
+		return records
+	}
+	
+	public func dataFormats(forFileType fileTypeID: AudioFileTypeID) -> [DataFormatRecord<AudioStreamBasicDescription>] {
+		var fileTypeID = fileTypeID
+		var size: UInt32 = 0
+		// get all writable formats
+		var err = AudioFormatGetPropertyInfo(kAudioFormatProperty_EncodeFormatIDs, 0, nil, &size)
+		guard err == noErr else {
+			return []
+		}
+		var writableFormats = [UInt32](repeating: 0, count: Int(size) / MemoryLayout<UInt32>.size)
+		err = AudioFormatGetProperty(kAudioFormatProperty_EncodeFormatIDs, 0, nil, &size, &writableFormats)
+		guard err == noErr else {
+			return []
+		}
+		
+		// get all readable formats
+		err = AudioFormatGetPropertyInfo(kAudioFormatProperty_DecodeFormatIDs, 0, nil, &size);
+		guard err == noErr else {
+			return []
+		}
+
+		var readableFormats = [UInt32](repeating: 0, count: Int(size) / MemoryLayout<UInt32>.size)
+		err = AudioFormatGetProperty(kAudioFormatProperty_DecodeFormatIDs, 0, nil, &size, &readableFormats)
+		guard err == noErr else {
+			return []
+		}
+		
+		err = AudioFileGetGlobalInfoSize(kAudioFileGlobalInfo_AvailableFormatIDs, UInt32(MemoryLayout<UInt32>.size), &fileTypeID, &size);
+		guard err == noErr else {
+			return []
+		}
+
+		let numDataFormats = Int(size) / MemoryLayout<OSType>.size
+		var formatIDs = [OSType](repeating: 0, count: numDataFormats)
+		err = AudioFileGetGlobalInfo(kAudioFileGlobalInfo_AvailableFormatIDs,
+									 UInt32(MemoryLayout<UInt32>.size), &fileTypeID, &size, &formatIDs)
+		guard err == noErr else {
+			return []
+		}
+
+		var dataFormats = [DataFormatRecord<AudioStreamBasicDescription>]()
+		for fid in formatIDs {
+			var anyBigEndian = false, anyLittleEndian = false;
+			var dfi = DataFormatRecord<AudioStreamBasicDescription>(formatID: fid)
+			dfi.readable = fid == kAudioFormatLinearPCM || readableFormats.contains(fid)
+			dfi.writable = fid == kAudioFormatLinearPCM || writableFormats.contains(fid)
+			
+			var tf = AudioFileTypeAndFormatID(mFileType: fileTypeID, mFormatID: fid)
+			err = AudioFileGetGlobalInfoSize(kAudioFileGlobalInfo_AvailableStreamDescriptionsForFormat,
+											 UInt32(MemoryLayout<AudioFileTypeAndFormatID>.size), &tf, &size);
+			if err == noErr {
+				let variantsCount = Int(size) / MemoryLayout<AudioStreamBasicDescription>.size
+				var variants = [AudioStreamBasicDescription](repeating: AudioStreamBasicDescription(), count: variantsCount)
+				err = AudioFileGetGlobalInfo(kAudioFileGlobalInfo_AvailableStreamDescriptionsForFormat,
+											 UInt32(MemoryLayout<AudioFileTypeAndFormatID>.size), &tf, &size, &variants);
+				if err == noErr {
+					dfi.variants = variants
+					for desc in variants {
+						if desc.mBitsPerChannel > 8 {
+							if (desc.mFormatFlags & kAudioFormatFlagIsBigEndian) == kAudioFormatFlagIsBigEndian {
+								anyBigEndian = true
+							} else {
+								anyLittleEndian = true
+							}
+						}
+					}
+				}
+				
+				dfi.eitherEndianPCM = (anyBigEndian && anyLittleEndian);
+				dataFormats.append(dfi)
+			}
+		}
+		return dataFormats
+	}
+}
+
+/// The file types AudioToolbox can write and the data formats they can contain.
+///
+/// Lookups go through the hash indexes of a ``FileFormatRegistry``, so the data formats of each
+/// file type are only queried once.
+public final class AudioFileFormats: Sendable {
 	@MainActor public static let shared = AudioFileFormats()
 	
 	public struct DataFormatInfo: CustomDebugStringConvertible, Hashable, Sendable {
@@ -51,6 +182,16 @@ public final class AudioFileFormats {
 		public internal(set) var writable = false
 		public internal(set) var eitherEndianPCM = false
 		
+		init() {}
+		
+		init(_ record: DataFormatRecord<AudioStreamBasicDescription>) {
+			formatID = record.formatID
+			variants = record.variants
+			readable = record.readable
+			writable = record.writable
+			eitherEndianPCM = record.eitherEndianPCM
+		}
+		
 		public var debugDescription: String {
 			func ny(_ val: Bool) -> String {
 				if val {
@@ -74,6 +215,13 @@ public final class AudioFileFormats {
 		public var extensions = [String]()
 		public var dataFormats = [DataFormatInfo]()
 		
+		init(_ record: FileTypeRecord, dataFormats: [DataFormatRecord<AudioStreamBasicDescription>]) {
+			fileTypeID = record.fileTypeID
+			fileTypeName = record.name
+			extensions = record.extensions
+			self.dataFormats = dataFormats.map(DataFormatInfo.init)
+		}
+		
 		public func `extension`(at index: Int) -> String {
 			return extensions[index]
 		}
@@ -101,91 +249,7 @@ public final class AudioFileFormats {
 			guard dataFormats.isEmpty else {
 				return
 			}
-			
-			var size: UInt32 = 0
-			// get all writable formats
-			var err = AudioFormatGetPropertyInfo(kAudioFormatProperty_EncodeFormatIDs, 0, nil, &size)
-			guard err == noErr else {
-				return
-			}
-			var writableFormats = [UInt32](repeating: 0, count: Int(size) / MemoryLayout<UInt32>.size)
-			err = AudioFormatGetProperty(kAudioFormatProperty_EncodeFormatIDs, 0, nil, &size, &writableFormats)
-			guard err == noErr else {
-				return
-			}
-			
-			// get all readable formats
-			err = AudioFormatGetPropertyInfo(kAudioFormatProperty_DecodeFormatIDs, 0, nil, &size);
-			guard err == noErr else {
-				return
-			}
-
-			var readableFormats = [UInt32](repeating: 0, count: Int(size) / MemoryLayout<UInt32>.size)
-			err = AudioFormatGetProperty(kAudioFormatProperty_DecodeFormatIDs, 0, nil, &size, &readableFormats)
-			guard err == noErr else {
-				return
-			}
-			
-			err = AudioFileGetGlobalInfoSize(kAudioFileGlobalInfo_AvailableFormatIDs, UInt32(MemoryLayout<UInt32>.size), &fileTypeID, &size);
-			guard err == noErr else {
-				return
-			}
-
-			let numDataFormats = Int(size) / MemoryLayout<OSType>.size
-			var formatIDs = [OSType](repeating: 0, count: numDataFormats)
-			err = AudioFileGetGlobalInfo(kAudioFileGlobalInfo_AvailableFormatIDs,
-										 UInt32(MemoryLayout<UInt32>.size), &fileTypeID, &size, &formatIDs)
-			guard err == noErr else {
-				return
-			}
-
-			for fid in formatIDs {
-				var anyBigEndian = false, anyLittleEndian = false;
-				var dfi = DataFormatInfo()
-				dfi.formatID = fid
-				dfi.readable = fid == kAudioFormatLinearPCM
-				dfi.writable = fid == kAudioFormatLinearPCM
-				
-				for readFor in readableFormats {
-					if readFor == fid {
-						dfi.readable = true
-						break
-					}
-				}
-				
-				for writeFor in writableFormats {
-					if writeFor == fid {
-						dfi.writable = true
-						break
-					}
-				}
-				
-				
-				var tf = AudioFileTypeAndFormatID(mFileType: fileTypeID, mFormatID: fid)
-				err = AudioFileGetGlobalInfoSize(kAudioFileGlobalInfo_AvailableStreamDescriptionsForFormat,
-												 UInt32(MemoryLayout<AudioFileTypeAndFormatID>.size), &tf, &size);
-				if err == noErr {
-					let variantsCount = Int(size) / MemoryLayout<AudioStreamBasicDescription>.size
-					var variants = [AudioStreamBasicDescription](repeating: AudioStreamBasicDescription(), count: variantsCount)
-					err = AudioFileGetGlobalInfo(kAudioFileGlobalInfo_AvailableStreamDescriptionsForFormat,
-												 UInt32(MemoryLayout<AudioFileTypeAndFormatID>.size), &tf, &size, &variants);
-					if err == noErr {
-						dfi.variants = variants
-						for desc in variants {
-							if desc.mBitsPerChannel > 8 {
-								if (desc.mFormatFlags & kAudioFormatFlagIsBigEndian) == kAudioFormatFlagIsBigEndian {
-									anyBigEndian = true
-								} else {
-									anyLittleEndian = true
-								}
-							}
-						}
-					}
-					
-					dfi.eitherEndianPCM = (anyBigEndian && anyLittleEndian);
-					dataFormats.append(dfi)
-				}
-			}
+			dataFormats = AudioToolboxFileFormatProvider().dataFormats(forFileType: fileTypeID).map(DataFormatInfo.init)
 		}
 		
 		public var debugDescription: String {
@@ -197,7 +261,7 @@ public final class AudioFileFormats {
 			var tmp = self
 			tmp.loadDataFormats()
 			toRet += "\n  Formats:\n"
-			for df in dataFormats {
+			for df in tmp.dataFormats {
 				toRet += df.debugDescription
 				toRet += "\n"
 			}
@@ -206,99 +270,90 @@ public final class AudioFileFormats {
 		}
 	}
 	
-	public private(set) var fileFormats = [FileFormatInfo]()
+	/// The file type and data format indexes.
+	public let registry: FileFormatRegistry<AudioStreamBasicDescription>
 	
-	private init(loadFormats: Bool = true) {
-		var size: UInt32 = 0
-		var err = AudioFileGetGlobalInfoSize(kAudioFileGlobalInfo_WritableTypes, 0, nil, &size);
-		guard err == noErr else {
-			return
-		}
-		let mNumFileFormats = Int(size) / MemoryLayout<UInt32>.size
-		var fileTypes = [UInt32](repeating: 0, count: mNumFileFormats)
-		err = AudioFileGetGlobalInfo(kAudioFileGlobalInfo_WritableTypes, 0, nil, &size, &fileTypes);
-		guard err == noErr else {
-			return
-		}
-		for fileType in fileTypes {
-			var ffi = FileFormatInfo()
-			var filetype = fileType
-			
-			ffi.fileTypeID = fileType
-			
-			// file type name
-			do {
-				size = UInt32(MemoryLayout<CFString>.size)
-				var fileName: UnsafeMutableRawPointer? = nil
-				err = AudioFileGetGlobalInfo(kAudioFileGlobalInfo_FileTypeName, UInt32(MemoryLayout<UInt32>.size), &filetype, &size, &fileName)
-				
-				if let fileName {
-					let fileName2 = Unmanaged<CFString>.fromOpaque(fileName)
-					ffi.fileTypeName = fileName2.takeUnretainedValue() as String
-				}
-			}
-			
-			// file extensions
-			do {
-				size = UInt32(MemoryLayout<CFArray>.size)
-				var extensions: UnsafeMutableRawPointer? = nil
-				err = AudioFileGetGlobalInfo(kAudioFileGlobalInfo_ExtensionsForType, UInt32(MemoryLayout<UInt32>.size), &filetype, &size, &extensions)
-				if let extensions {
-					let ext2 = Unmanaged<CFArray>.fromOpaque(extensions).takeUnretainedValue()
-					if let ext3 = ext2 as? [String] {
-						ffi.extensions = ext3
-					}
-				}
-			}
-			
-			if loadFormats {
-				ffi.loadDataFormats()
-			}
-			fileFormats.append(ffi)
+	private let fileFormatsLock = NSLock()
+	/// Guarded by `fileFormatsLock`.
+	nonisolated(unsafe) private var cachedFileFormats: [FileFormatInfo]?
+	
+	/// All of the file types, sorted by name, with their data formats.
+	///
+	/// This loads the data formats of every file type the first time it is used, and
+	/// returns the same array after that.
+	public var fileFormats: [FileFormatInfo] {
+		fileFormatsLock.lock()
+		defer {
+			fileFormatsLock.unlock()
 		}
-		
-		fileFormats.sort { (a, b) -> Bool in
-			return a.fileTypeName.localizedCaseInsensitiveCompare(b.fileTypeName) == .orderedAscending
+		if let cachedFileFormats {
+			return cachedFileFormats
 		}
+		let formats = registry.fileTypes.map { FileFormatInfo($0, dataFormats: registry.dataFormats(forFileType: $0.fileTypeID) ?? []) }
+		cachedFileFormats = formats
+		return formats
+	}
+	
+	private convenience init() {
+		self.init(provider: AudioToolboxFileFormatProvider())
+	}
+	
+	/// Creates the file formats from a provider other than AudioToolbox.
+	/// - parameter provider: The source of the file types and their data formats.
+	public init<Provider: FileFormatProvider>(provider: Provider) where Provider.Variant == AudioStreamBasicDescription {
+		registry = FileFormatRegistry(provider: provider)
+	}
+	
+	/// Creates the file formats from a snapshot made by ``snapshot()``, so AudioToolbox only
+	/// needs to be queried for data formats that weren't loaded when the snapshot was made.
+	/// - parameter snapshot: The snapshot data.
+	/// - parameter provider: The source of data formats missing from the snapshot.
+	public init<Provider: FileFormatProvider>(snapshot: Data, provider: Provider) throws where Provider.Variant == AudioStreamBasicDescription {
+		registry = try FileFormatRegistry(provider: provider, snapshot: snapshot)
+	}
+	
+	/// Creates the file formats from a snapshot made by ``snapshot()``.
+	/// - parameter snapshot: The snapshot data.
+	public convenience init(snapshot: Data) throws {
+		try self.init(snapshot: snapshot, provider: AudioToolboxFileFormatProvider())
+	}
+	
+	/// A compact snapshot of the file types and every data format loaded so far.
+	public func snapshot() -> Data {
+		return registry.snapshot()
 	}
 	
 	/// Note that the returning format will have zero for the sample rate, channels per frame, bytesPerPacket, bytesPerFrame
 	public func inferDataFormat(fromFileFormat filetype: AudioFileTypeID) -> AudioStreamBasicDescription? {
-		var fmt = AudioStreamBasicDescription()
-		// if the file format only supports one data format
-		for var ffi in fileFormats {
-			ffi.loadDataFormats()
-			if ffi.fileTypeID == filetype && ffi.dataFormats.count > 0 {
-				var dfi = ffi.dataFormats[0]
-				if ffi.dataFormats.count > 1 {
-					// file can contain multiple data formats. Take PCM if it's there.
-					for datForm in ffi.dataFormats  {
-						if datForm.formatID == kAudioFormatLinearPCM {
-							dfi = datForm
-							break
-						}
-					}
+		guard let dataFormats = registry.dataFormats(forFileType: filetype), var dfi = dataFormats.first else {
+			return nil
+		}
+		if dataFormats.count > 1 {
+			// file can contain multiple data formats. Take PCM if it's there.
+			for datForm in dataFormats {
+				if datForm.formatID == kAudioFormatLinearPCM {
+					dfi = datForm
+					break
 				}
-				
-				memset(&fmt, 0, MemoryLayout<AudioStreamBasicDescription>.size);
-				fmt.mFormatID = dfi.formatID
-				if dfi.variants.count > 0 {
-					// take the first variant as a default
-					fmt = dfi.variants[0]
-					if dfi.variants.count > 1 && dfi.formatID == kAudioFormatLinearPCM {
-						// look for a 16-bit variant as a better default
-						for desc in dfi.variants  {
-							if (desc.mBitsPerChannel == 16) {
-								fmt = desc
-								break
-							}
-						}
+			}
+		}
+		
+		var fmt = AudioStreamBasicDescription()
+		fmt.mFormatID = dfi.formatID
+		if dfi.variants.count > 0 {
+			// take the first variant as a default
+			fmt = dfi.variants[0]
+			if dfi.variants.count > 1 && dfi.formatID == kAudioFormatLinearPCM {
+				// look for a 16-bit variant as a better default
+				for desc in dfi.variants  {
+					if (desc.mBitsPerChannel == 16) {
+						fmt = desc
+						break
 					}
 				}
-				return fmt
 			}
 		}
-		return nil
+		return fmt
 	}
 	
 	public func inferFileFormat(from url: URL) -> AudioFileTypeID? {
@@ -306,52 +361,25 @@ public final class AudioFileFormats {
 		guard ext.count > 0 else {
 			return nil
 		}
-		for ffi in fileFormats {
-			if ffi.matchExtension(ext) {
-				return ffi.fileTypeID
-			}
-		}
-		return nil
+		return registry.fileTypeID(forExtension: ext)
 	}
 	
 	public func inferFileFormat(from fmt: AudioStreamBasicDescription) -> AudioFileTypeID? {
-		var theFileFormat: FileFormatInfo? = nil
-		for var ffi in fileFormats {
-			ffi.loadDataFormats()
-			for dfi in ffi.dataFormats {
-				if dfi.formatID == fmt.mFormatID {
-					if theFileFormat != nil {
-						return nil	// ambiguous
-					}
-					theFileFormat = ffi	// got a candidate
-				}
-			}
+		let fileTypes = registry.fileTypeIDs(forDataFormat: fmt.mFormatID)
+		guard fileTypes.count == 1 else {
+			return nil	// unknown or ambiguous
 		}
-		if let theFileFormat {
-			return theFileFormat.fileTypeID
-		}
-		return nil
+		return fileTypes[0]
 	}
 	
 	public func isKnownDataFormat(_ dataFormat: OSType) -> Bool {
-		for var ffi in fileFormats {
-			ffi.loadDataFormats()
-			for dfi in ffi.dataFormats {
-				if dfi.formatID == dataFormat {
-					return true
-				}
-			}
-		}
-		
-		return false
+		return !registry.fileTypeIDs(forDataFormat: dataFormat).isEmpty
 	}
 	
 	public func findFileFormat(_ formatID: UInt32) -> FileFormatInfo? {
-		for ffi in fileFormats {
-			if ffi.fileTypeID == formatID {
-				return ffi
-			}
+		guard let record = registry.fileType(formatID) else {
+			return nil
 		}
-		return nil
+		return FileFormatInfo(record, dataFormats: registry.dataFormats(forFileType: formatID) ?? [])
 	}
 }
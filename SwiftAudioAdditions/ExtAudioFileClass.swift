@@ -10,6 +10,7 @@ import Foundation
 import AudioToolbox
 import CoreAudio
 import SwiftAdditions
+import FoundationAdditions
 
 final public class ExtAudioFile {
 	var internalPtr: ExtAudioFileRef
@@ -126,6 +127,32 @@ final public class ExtAudioFile {
 		}
 	}
 	
+	/// Seeks to a specified frame in a file.
+	///
+	/// Sets the file’s read position to the specified sample frame number. The next call
+	/// to `read(frames:data:)` will return samples from precisely this location.
+	/// - parameter frame: The desired seek position, in sample frames, relative to the
+	/// beginning of the file. This is specified in the sample rate and frame count of the
+	/// file's format (not the client format).
+	public func seek(toFrame frame: Int64) throws {
+		let iErr = ExtAudioFileSeek(internalPtr, frame)
+		
+		guard iErr == noErr else {
+			throw errorFromOSStatus(iErr)
+		}
+	}
+	
+	/// The file's read/write position, in sample frames of the file's format.
+	public func tell() throws -> Int64 {
+		var frame: Int64 = 0
+		let iErr = ExtAudioFileTell(internalPtr, &frame)
+		
+		guard iErr == noErr else {
+			throw errorFromOSStatus(iErr)
+		}
+		return frame
+	}
+	
 	deinit {
 		ExtAudioFileDispose(internalPtr)
 	}
@@ -355,3 +382,45 @@ extension ExtAudioFile {
 		try writeAsync(frames: frames, data: data?.unsafePointer)
 	}
 }
+
+extension ExtAudioFile: FrameSource, FrameSink {
+	/// The client data format as a ``PCMFormat``.
+	///
+	/// Throws `SAACoreAudioError.formatNotSupported` if the client data format isn't a linear
+	/// PCM layout ``PCMFormat`` supports.
+	public var frameFormat: PCMFormat {
+		get throws {
+			guard let format = PCMFormat(clientDataFormat) else {
+				throw SAACoreAudioError(.formatNotSupported)
+			}
+			return format
+		}
+	}
+	
+	/// Points an audio buffer list at the buffers of `frames` frames.
+	private func withBufferList<R>(frames: Int, buffers: (Int) -> UnsafeMutableRawPointer, _ body: (UnsafeMutableAudioBufferListPointer) throws -> R) throws -> R {
+		let format = try frameFormat
+		let bufferList = AudioBufferList.allocate(maximumBuffers: format.bufferCount)
+		defer {
+			free(bufferList.unsafeMutablePointer)
+		}
+		for i in 0 ..< format.bufferCount {
+			bufferList[i] = AudioBuffer(mNumberChannels: format.isInterleaved ? UInt32(format.channelCount) : 1, mDataByteSize: UInt32(frames * format.bytesPerFrame), mData: buffers(i))
+		}
+		return try body(bufferList)
+	}
+	
+	public func read(frames: inout Int, into buffers: (Int) -> UnsafeMutableRawPointer) throws {
+		var count = UInt32(frames)
+		try withBufferList(frames: frames, buffers: buffers) { (bufferList) in
+			try read(frames: &count, data: bufferList)
+		}
+		frames = Int(count)
+	}
+	
+	public func write(frames: Int, from buffers: (Int) -> UnsafeRawPointer) throws {
+		try withBufferList(frames: frames, buffers: { UnsafeMutableRawPointer(mutating: buffers($0)) }) { (bufferList) in
+			try write(frames: UInt32(frames), data: bufferList)
+		}
+	}
+}
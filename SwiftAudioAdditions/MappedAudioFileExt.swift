@@ -0,0 +1,73 @@
+//
+//  MappedAudioFileExt.swift
+//  SwiftAudioAdditions
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+import AudioToolbox
+import FoundationAdditions
+
+public extension MappedAudioFile {
+	/// The format of the samples in the file.
+	var fileDataFormat: AudioStreamBasicDescription {
+		return AudioStreamBasicDescription(fileFormat, sampleRate: sampleRate)
+	}
+	
+	/// The format that `read(frames:data:)` produces.
+	///
+	/// Only the sample layout and channel count can differ from ``fileDataFormat``; the
+	/// sample rate is ignored. Setting a format that ``PCMFormat`` doesn't support is a
+	/// programmer error.
+	var clientDataFormat: AudioStreamBasicDescription {
+		get {
+			return AudioStreamBasicDescription(clientFormat, sampleRate: sampleRate)
+		}
+		set {
+			guard let format = PCMFormat(newValue) else {
+				preconditionFailure("Unsupported client data format: \(newValue)")
+			}
+			clientFormat = format
+		}
+	}
+	
+	/// Reads frames into an audio buffer list, like `ExtAudioFile.read(frames:data:)`.
+	///
+	/// If the client format is the file format, there is one buffer, and its `mData` is
+	/// `nil`, `mData` is pointed at the mapped samples instead of copying them. That pointer
+	/// is valid as long as the file is.
+	/// - parameter frames: On input, the number of frames to read. On output, the number of
+	/// frames actually read. If `0` frames are returned, end-of-file was reached.
+	/// - parameter data: One or more buffers into which the audio data is read. Their
+	/// `mDataByteSize` fields are set to the number of bytes read.
+	func read(frames: inout UInt32, data: UnsafeMutablePointer<AudioBufferList>) throws {
+		let buffers = UnsafeMutableAudioBufferListPointer(data)
+		guard buffers.count >= clientFormat.bufferCount else {
+			throw SAACoreAudioError(.invalidParameter)
+		}
+		var count = Int(frames)
+		if canReadMapped && buffers.count == 1 && buffers[0].mData == nil {
+			buffers[0].mData = UnsafeMutableRawPointer(mutating: readMapped(frames: &count))
+		} else {
+			// Don't overrun the buffers.
+			for i in 0 ..< clientFormat.bufferCount {
+				guard buffers[i].mData != nil else {
+					throw SAACoreAudioError(.invalidParameter)
+				}
+				count = Swift.min(count, Int(buffers[i].mDataByteSize) / clientFormat.bytesPerFrame)
+			}
+			read(frames: &count, into: { buffers[$0].mData! })
+		}
+		frames = UInt32(count)
+		let byteSize = UInt32(count * clientFormat.bytesPerFrame)
+		for i in 0 ..< clientFormat.bufferCount {
+			buffers[i].mDataByteSize = byteSize
+		}
+	}
+	
+	func read(frames: inout UInt32, data: UnsafeMutableAudioBufferListPointer) throws {
+		try read(frames: &frames, data: data.unsafeMutablePointer)
+	}
+}
@@ -9,6 +9,7 @@
 import Foundation
 import AudioToolbox
 import SwiftAdditions
+import FoundationAdditions
 
 /// Keys for dictionaries returned by `instrumentInfoFromSoundBank(at:)`
 public enum InstrumentInfoKey: RawRepresentable, LosslessStringConvertible, CaseIterable {
@@ -67,6 +68,9 @@ public enum InstrumentInfoKey: RawRepresentable, LosslessStringConvertible, Case
 }
 
 /// This will return the name of a sound bank from a DLS or SF2 bank.
+///
+/// `SoundBankInfo(contentsOf:)` reads the name without AudioToolbox, and is much faster
+/// on large banks.
 /// - parameter inURL: The URL for the sound bank.
 /// - returns: The name of a sound bank.
 public func nameFromSoundBank(at inURL: URL) throws -> String {
@@ -86,6 +90,9 @@ public func nameFromSoundBank(at inURL: URL) throws -> String {
 ///
 /// Using these MSB, LSB, and Program values will guarantee that the correct instrument is loaded by the DLS synth
 /// or Sampler Audio Unit.
+///
+/// `SoundBankInfo(contentsOf:)` returns the same values as `SoundBankInstrument`s, without parsing
+/// the whole bank.
 func instrumentInfoFromSoundBank(at inURL: URL) throws -> [[InstrumentInfoKey: Any]] {
 	var tmpArr: Unmanaged<CFArray>?
 	let status = CopyInstrumentInfoFromSoundBank(inURL as NSURL, &tmpArr)
@@ -104,3 +111,10 @@ func instrumentInfoFromSoundBank(at inURL: URL) throws -> [[InstrumentInfoKey: A
 	}
 	return toRet
 }
+
+extension SoundBankInstrument {
+	/// The instrument as a dictionary in the form `instrumentInfoFromSoundBank(at:)` returns.
+	public var instrumentInfo: [InstrumentInfoKey: Any] {
+		return [.name: name, .msb: Int(msb), .lsb: Int(lsb), .program: Int(program)]
+	}
+}
@@ -10,6 +10,7 @@ import Foundation
 import AudioToolbox
 import CoreAudio
 @testable import SwiftAudioAdditions
+import FoundationAdditions
 import XCTest
 
 class SwiftAudioAdditionsTests: XCTestCase {
@@ -71,6 +72,129 @@ class SwiftAudioAdditionsTests: XCTestCase {
 		XCTAssertThrowsError(bankName = try nameFromSoundBank(at: URL(fileURLWithPath:"/System/Library/Components/CoreAudio.component/Contents/MacOS/CoreAudio")))
 	}
 	
+	/// The General MIDI bank that ships with CoreAudio.
+	/// - throws: `XCTSkip` if it isn't installed.
+	private func installedDLSBank() throws -> URL {
+		let caInstruments = URL(fileURLWithPath: "/System/Library/Components/CoreAudio.component/Contents/Resources/gs_instruments.dls")
+		guard FileManager.default.fileExists(atPath: caInstruments.path) else {
+			throw XCTSkip("gs_instruments.dls isn't installed")
+		}
+		return caInstruments
+	}
+	
+	/// Checks that `SoundBankInfo` reads the same name and instruments as AudioToolbox.
+	private func assertSoundBankInfoMatchesAudioToolbox(_ url: URL, kind: SoundBankInfo.Kind, file: StaticString = #filePath, line: UInt = #line) throws {
+		let info = try SoundBankInfo(contentsOf: url)
+		XCTAssertEqual(info.kind, kind, file: file, line: line)
+		XCTAssertEqual(info.name, try nameFromSoundBank(at: url), file: file, line: line)
+		// Compare in bank order, in case AudioToolbox doesn't list them in file order.
+		let sortKey = { (instrument: [InstrumentInfoKey: Any]) -> [Int] in
+			return [instrument[.msb] as? Int ?? -1, instrument[.lsb] as? Int ?? -1, instrument[.program] as? Int ?? -1]
+		}
+		let ordered = { (lhs: [InstrumentInfoKey: Any], rhs: [InstrumentInfoKey: Any]) -> Bool in
+			return sortKey(lhs).lexicographicallyPrecedes(sortKey(rhs))
+		}
+		let expected = try instrumentInfoFromSoundBank(at: url).sorted(by: ordered)
+		let actual = info.instruments.map(\.instrumentInfo).sorted(by: ordered)
+		XCTAssertEqual(actual.count, expected.count, file: file, line: line)
+		for (instrument, dictionary) in zip(actual, expected) {
+			XCTAssertEqual(instrument[.name] as? String, dictionary[.name] as? String, file: file, line: line)
+			XCTAssertEqual(sortKey(instrument), sortKey(dictionary), file: file, line: line)
+		}
+	}
+	
+	func testSoundBankInfoMatchesAudioToolbox() throws {
+		try assertSoundBankInfoMatchesAudioToolbox(installedDLSBank(), kind: .dls)
+	}
+	
+	/// Writes a small SoundFont 2 bank with one sine instrument, used by every preset.
+	private func makeSoundFont(presets: [(name: String, program: UInt16, bank: UInt16)]) -> Data {
+		func chunk(_ id: String, _ body: Data) -> Data {
+			var data = Data(id.utf8)
+			withUnsafeBytes(of: UInt32(body.count).littleEndian) { data.append(contentsOf: $0) }
+			data.append(body)
+			if body.count & 1 != 0 {
+				data.append(0)
+			}
+			return data
+		}
+		func list(_ type: String, _ chunks: Data...) -> Data {
+			return chunk("LIST", chunks.reduce(Data(type.utf8), +))
+		}
+		func name(_ string: String, length: Int = 20) -> Data {
+			var data = Data(string.utf8.prefix(length - 1))
+			data.count = length
+			return data
+		}
+		func append<T: FixedWidthInteger>(_ value: T, to data: inout Data) {
+			withUnsafeBytes(of: value.littleEndian) { data.append(contentsOf: $0) }
+		}
+		func words(_ values: any FixedWidthInteger...) -> Data {
+			var data = Data()
+			for value in values {
+				append(value, to: &data)
+			}
+			return data
+		}
+		
+		// A sample needs 46 zero samples after it.
+		let sampleCount = 32
+		var samples = Data()
+		for i in 0 ..< sampleCount {
+			samples += words(Int16(sin(Double(i) / Double(sampleCount) * 2 * .pi) * 16000))
+		}
+		samples.count += 46 * 2
+		
+		var presetHeaders = Data()
+		var presetBags = Data()
+		var presetGenerators = Data()
+		for (index, preset) in presets.enumerated() {
+			presetHeaders += name(preset.name) + words(preset.program, preset.bank, UInt16(index), UInt32(0), UInt32(0), UInt32(0))
+			presetBags += words(UInt16(index), UInt16(0))
+			// instrument = 0
+			presetGenerators += words(UInt16(41), UInt16(0))
+		}
+		presetHeaders += name("EOP") + words(UInt16(0), UInt16(0), UInt16(presets.count), UInt32(0), UInt32(0), UInt32(0))
+		presetBags += words(UInt16(presets.count), UInt16(0))
+		presetGenerators += words(UInt16(0), UInt16(0))
+		
+		let terminalModulator = Data(count: 10)
+		let instruments = name("Sine") + words(UInt16(0)) + name("EOI") + words(UInt16(1))
+		let instrumentBags = words(UInt16(0), UInt16(0), UInt16(1), UInt16(0))
+		// sampleID = 0
+		let instrumentGenerators = words(UInt16(53), UInt16(0), UInt16(0), UInt16(0))
+		let sampleHeaders = name("Sine") + words(UInt32(0), UInt32(sampleCount), UInt32(0), UInt32(sampleCount), UInt32(44100), UInt8(60), Int8(0), UInt16(0), UInt16(1)) + Data(count: 46)
+		
+		let info = list("INFO", chunk("ifil", words(UInt16(2), UInt16(1))), chunk("isng", name("EMU8000", length: 8)), chunk("INAM", name("Fixture Bank", length: 14)))
+		let sampleData = list("sdta", chunk("smpl", samples))
+		let hydra = list("pdta", chunk("phdr", presetHeaders), chunk("pbag", presetBags), chunk("pmod", terminalModulator), chunk("pgen", presetGenerators), chunk("inst", instruments), chunk("ibag", instrumentBags), chunk("imod", terminalModulator), chunk("igen", instrumentGenerators), chunk("shdr", sampleHeaders))
+		return chunk("RIFF", Data("sfbk".utf8) + info + sampleData + hydra)
+	}
+	
+	func testSoundFontInfoMatchesAudioToolbox() throws {
+		let url = FileManager.default.temporaryDirectory.appendingPathComponent("SoundFontFixture-\(UUID().uuidString).sf2")
+		// Includes banks above 127, to check how they map onto MSB and LSB.
+		try makeSoundFont(presets: [("Piano", 0, 0), ("Strings", 48, 8), ("Variation", 5, 127), ("Drums", 0, 128), ("High Bank", 3, 129), ("Higher Bank", 7, 300)]).write(to: url)
+		defer {
+			try? FileManager.default.removeItem(at: url)
+		}
+		try assertSoundBankInfoMatchesAudioToolbox(url, kind: .soundFont2)
+	}
+	
+	func testSoundBankInfoPerformance() throws {
+		let caInstruments = try installedDLSBank()
+		measure {
+			_ = try? SoundBankInfo(contentsOf: caInstruments)
+		}
+	}
+	
+	func testInstrumentInfoFromSoundBankPerformance() throws {
+		let caInstruments = try installedDLSBank()
+		measure {
+			_ = try? instrumentInfoFromSoundBank(at: caInstruments)
+		}
+	}
+	
 	func testSwiftErrorCatch() {
 		var bankName = ""
 		do {
@@ -81,4 +205,52 @@ class SwiftAudioAdditionsTests: XCTestCase {
 		}
 		_=bankName
 	}
+	
+	func testOutputBufferListArena() throws {
+		let arena = BufferArena()
+		let format = try AudioStreamBasicDescription(fromText: "LEF32@44100,2D")
+		let bufferList = AUOutputBL(streamDescription: format, frameCount: 512, arena: arena)
+		bufferList.allocate(frames: 1000)
+		try bufferList.prepare(frames: 1000)
+		let abl = UnsafeMutableAudioBufferListPointer(bufferList.ABL)
+		XCTAssertEqual(abl.count, 2)
+		for buffer in abl {
+			XCTAssertEqual(buffer.mDataByteSize, 4000)
+			XCTAssertEqual(Int(bitPattern: buffer.mData) % BufferListLayout.alignment, 0)
+		}
+		XCTAssertThrowsError(try bufferList.prepare(frames: 2000))
+		XCTAssertEqual(arena.statistics.first?.checkedOut, 1)
+		for buffer in abl {
+			buffer.mData!.initializeMemory(as: UInt8.self, repeating: 0xA5, count: Int(buffer.mDataByteSize))
+		}
+		
+		bufferList.allocate(frames: 0)
+		XCTAssertEqual(arena.statistics.first?.checkedOut, 0)
+		XCTAssertEqual(arena.statistics.first?.pooled, 1)
+		
+		// Re-allocating reuses the pooled block.
+		bufferList.allocate(frames: 1000)
+		XCTAssertEqual(arena.statistics.first?.blockCount, 1)
+		XCTAssertEqual(arena.statistics.first?.highWaterMark, 1)
+		// A reused block doesn't hand back the last render's samples.
+		try bufferList.prepare(frames: 1000)
+		for buffer in UnsafeMutableAudioBufferListPointer(bufferList.ABL) {
+			let bytes = UnsafeRawBufferPointer(start: buffer.mData, count: Int(buffer.mDataByteSize))
+			XCTAssertFalse(bytes.contains { $0 != 0 })
+		}
+	}
+	
+	func testOutputBufferListAllocationPerformance() throws {
+		let format = try AudioStreamBasicDescription(fromText: "LEF32@48000,8D")
+		let bufferLists = (0 ..< 200).map { _ in AUOutputBL(streamDescription: format) }
+		self.measure {
+			for bufferList in bufferLists {
+				bufferList.allocate(frames: 4096)
+				bufferList.prepare()
+			}
+			for bufferList in bufferLists {
+				bufferList.allocate(frames: 0)
+			}
+		}
+	}
 }
@@ -0,0 +1,339 @@
+//
+//  OSTypeTable.swift
+//  UTTypeOSTypes
+//
+//  Created by C.W. Betts on 10/16/26.
+//  Copyright © 2026 C.W. Betts. All rights reserved.
+//
+
+import Foundation
+import FoundationAdditions
+
+/// A fixed table of legacy Mac file type codes and the uniform type identifiers and
+/// filename extensions they correspond to.
+///
+/// Each kind of key (type code, identifier and extension) has its own perfect hash, so
+/// a lookup is one hash, two array reads and one comparison, with no allocation and no trip
+/// through the type database. ``standard`` holds the codes the system declares; anything not
+/// in it should go on to `UTType(tag:tagClass:conformingTo:)`, which is what
+/// `UTType(osType:conformingTo:)` and `UTType.preferredOSType` do.
+///
+/// Identifier and extension lookups ignore ASCII case, like the type database does.
+/// Type code lookups are exact.
+public final class OSTypeTable: Sendable {
+	/// One type code and what it maps to.
+	public struct Entry: Hashable, Sendable {
+		/// The type code, with the first character in the most-significant byte.
+		public let osType: UInt32
+		/// The type code as the four-character tag string, such as `"TEXT"`.
+		public let osTypeString: String
+		/// The uniform type identifier, such as `"public.plain-text"`.
+		public let identifier: String
+		/// The filename extensions of the type, preferred first. May be empty.
+		public let filenameExtensions: [String]
+
+		/// The extension the type database prefers, if the type has any.
+		@inlinable public var preferredFilenameExtension: String? {
+			return filenameExtensions.first
+		}
+
+		/// Creates an entry.
+		/// - parameter osTypeString: The four-character type code. Must be four ASCII characters.
+		/// - parameter identifier: The uniform type identifier.
+		/// - parameter filenameExtensions: The filename extensions of the type, preferred first.
+		public init(_ osTypeString: String, identifier: String, filenameExtensions: [String] = []) {
+			guard let code = OSTypeTable.code(osTypeString) else {
+				preconditionFailure("\"\(osTypeString)\" isn't a four-character ASCII type code")
+			}
+			osType = code
+			self.osTypeString = osTypeString
+			self.identifier = identifier
+			self.filenameExtensions = filenameExtensions
+		}
+	}
+
+	/// How many lookups found an entry and how many didn't.
+	public struct Statistics: Hashable, Sendable {
+		public var hits: Int
+		public var misses: Int
+
+		/// The fraction of lookups that found an entry, or *0* if there haven't been any.
+		public var hitRate: Double {
+			let total = hits + misses
+			return total == 0 ? 0 : Double(hits) / Double(total)
+		}
+	}
+
+	/// The type codes declared by the system's core types.
+	public static let standard = OSTypeTable(entries: OSTypeTable.standardEntries)
+
+	/// Every entry, in the order the table was created with.
+	public let entries: [Entry]
+
+	private let osTypeIndex: PerfectHashIndex
+	/// The first entry with each identifier, so its type code is the preferred one.
+	private let identifierIndex: PerfectHashIndex
+	/// The first entry with each extension.
+	private let extensionIndex: PerfectHashIndex
+	private let identifierEntries: [Int]
+	private let extensionEntries: [(extension: String, entry: Int)]
+	private let hits = makeSharedCounter()
+	private let misses = makeSharedCounter()
+
+	/// Builds the hash indexes for `entries`.
+	///
+	/// A type code may only appear once. Where several entries share an identifier or an
+	/// extension, the first one wins the reverse lookup.
+	public init(entries: [Entry]) {
+		self.entries = entries
+		osTypeIndex = PerfectHashIndex(hashes: entries.map { OSTypeTable.hash($0.osType) })
+
+		var identifierEntries = [Int]()
+		var extensionEntries = [(extension: String, entry: Int)]()
+		var seenIdentifiers = Set<String>()
+		var seenExtensions = Set<String>()
+		for (index, entry) in entries.enumerated() {
+			if seenIdentifiers.insert(entry.identifier.lowercased()).inserted {
+				identifierEntries.append(index)
+			}
+			for filenameExtension in entry.filenameExtensions where seenExtensions.insert(filenameExtension.lowercased()).inserted {
+				extensionEntries.append((filenameExtension, index))
+			}
+		}
+		identifierIndex = PerfectHashIndex(hashes: identifierEntries.map { OSTypeTable.hash(entries[$0].identifier) })
+		extensionIndex = PerfectHashIndex(hashes: extensionEntries.map { OSTypeTable.hash($0.extension) })
+		self.identifierEntries = identifierEntries
+		self.extensionEntries = extensionEntries
+	}
+
+	// MARK: Lookups
+
+	/// Returns the entry for a type code.
+	public func entry(forOSType osType: UInt32) -> Entry? {
+		return index(forOSType: osType).map { entries[$0] }
+	}
+
+	/// Returns the entry for a four-character type code string, such as `"TEXT"`.
+	public func entry(forOSTypeString osTypeString: String) -> Entry? {
+		return index(forOSTypeString: osTypeString).map { entries[$0] }
+	}
+
+	/// Returns the entry whose type code the type database prefers for `identifier`.
+	public func entry(forIdentifier identifier: String) -> Entry? {
+		return index(forIdentifier: identifier).map { entries[$0] }
+	}
+
+	/// Returns the entry of the type the type database picks for `filenameExtension`.
+	public func entry(forFilenameExtension filenameExtension: String) -> Entry? {
+		let hash = OSTypeTable.hash(filenameExtension)
+		guard let candidate = extensionIndex.candidate(for: hash),
+			  OSTypeTable.caseInsensitiveEquals(extensionEntries[candidate].extension, filenameExtension) else {
+			misses.add(1)
+			return nil
+		}
+		hits.add(1)
+		return entries[extensionEntries[candidate].entry]
+	}
+
+	func index(forOSType osType: UInt32) -> Int? {
+		guard let candidate = osTypeIndex.candidate(for: OSTypeTable.hash(osType)), entries[candidate].osType == osType else {
+			misses.add(1)
+			return nil
+		}
+		hits.add(1)
+		return candidate
+	}
+
+	func index(forOSTypeString osTypeString: String) -> Int? {
+		guard let code = OSTypeTable.code(osTypeString) else {
+			misses.add(1)
+			return nil
+		}
+		return index(forOSType: code)
+	}
+
+	func index(forIdentifier identifier: String) -> Int? {
+		guard let candidate = identifierIndex.candidate(for: OSTypeTable.hash(identifier)),
+			  OSTypeTable.caseInsensitiveEquals(entries[identifierEntries[candidate]].identifier, identifier) else {
+			misses.add(1)
+			return nil
+		}
+		hits.add(1)
+		return identifierEntries[candidate]
+	}
+
+	// MARK: Statistics
+
+	/// The hits and misses of every lookup since the table was created or last reset.
+	public var statistics: Statistics {
+		return Statistics(hits: hits.load(), misses: misses.load())
+	}
+
+	/// Sets ``statistics`` back to zero.
+	public func resetStatistics() {
+		hits.store(0)
+		misses.store(0)
+	}
+
+	// MARK: Hashing
+
+	/// The type code of a four-character ASCII string, without allocating.
+	static func code(_ string: String) -> UInt32? {
+		var code: UInt32 = 0
+		var count = 0
+		for byte in string.utf8 {
+			guard byte < 0x80, count < 4 else {
+				return nil
+			}
+			code = code << 8 | UInt32(byte)
+			count += 1
+		}
+		return count == 4 ? code : nil
+	}
+
+	static func hash(_ osType: UInt32) -> UInt64 {
+		return mix(UInt64(osType))
+	}
+
+	/// FNV-1a over the ASCII-lowercased UTF-8 of `string`, then mixed.
+	static func hash(_ string: String) -> UInt64 {
+		var hash: UInt64 = 0xcbf29ce484222325
+		for byte in string.utf8 {
+			hash = (hash ^ UInt64(asciiLowercase(byte))) &* 0x100000001b3
+		}
+		return mix(hash)
+	}
+
+	/// The SplitMix64 finalizer: a bijection that spreads every input bit over the output.
+	@inline(__always)
+	static func mix(_ value: UInt64) -> UInt64 {
+		var z = value
+		z = (z ^ (z >> 30)) &* 0xbf58476d1ce4e5b9
+		z = (z ^ (z >> 27)) &* 0x94d049bb133111eb
+		return z ^ (z >> 31)
+	}
+
+	@inline(__always)
+	private static func asciiLowercase(_ byte: UInt8) -> UInt8 {
+		return byte &- 0x41 < 26 ? byte | 0x20 : byte
+	}
+
+	private static func caseInsensitiveEquals(_ lhs: String, _ rhs: String) -> Bool {
+		return lhs.utf8.elementsEqual(rhs.utf8) { asciiLowercase($0) == asciiLowercase($1) }
+	}
+}
+
+// MARK: - Perfect hashing
+
+/// A hash-and-displace perfect hash over a fixed set of 64-bit key hashes.
+///
+/// The high half of a hash picks a bucket, and the bucket's seed remixes the hash into a slot
+/// no other key uses. The builder tries seeds for the largest buckets first, while the most
+/// slots are free.
+struct PerfectHashIndex: Sendable {
+	/// A seed for every bucket. *0* means the bucket is empty.
+	private let seeds: [UInt32]
+	/// The position of the key that hashes to each slot, or *-1*.
+	private let slots: [Int32]
+	private let bucketMask: UInt64
+	private let slotMask: UInt64
+
+	/// - parameter hashes: The hashes of the keys. They must all be different.
+	init(hashes: [UInt64]) {
+		let bucketCount = PerfectHashIndex.powerOfTwo(atLeast: Swift.max(1, hashes.count / 2))
+		// Half-full slots keep the seed search short.
+		let slotCount = PerfectHashIndex.powerOfTwo(atLeast: Swift.max(1, hashes.count * 2))
+		bucketMask = UInt64(bucketCount - 1)
+		slotMask = UInt64(slotCount - 1)
+
+		var buckets = [[Int]](repeating: [], count: bucketCount)
+		for (position, hash) in hashes.enumerated() {
+			buckets[PerfectHashIndex.bucket(of: hash, mask: bucketMask)].append(position)
+		}
+		var seeds = [UInt32](repeating: 0, count: bucketCount)
+		var slots = [Int32](repeating: -1, count: slotCount)
+		var placed = [Int]()
+		for bucket in buckets.indices.sorted(by: { buckets[$0].count > buckets[$1].count }) where !buckets[bucket].isEmpty {
+			var seed: UInt32 = 1
+			search: while true {
+				precondition(seed < 1 << 24, "Couldn't place the keys; two of them have the same hash")
+				placed.removeAll(keepingCapacity: true)
+				for position in buckets[bucket] {
+					let slot = PerfectHashIndex.slot(of: hashes[position], seed: seed, mask: slotMask)
+					if slots[slot] >= 0 || placed.contains(slot) {
+						seed += 1
+						continue search
+					}
+					placed.append(slot)
+				}
+				break
+			}
+			seeds[bucket] = seed
+			for (position, slot) in zip(buckets[bucket], placed) {
+				slots[slot] = Int32(position)
+			}
+		}
+		self.seeds = seeds
+		self.slots = slots
+	}
+
+	/// The only key position that can have `hash`. The caller still has to compare keys.
+	@inline(__always)
+	func candidate(for hash: UInt64) -> Int? {
+		let seed = seeds[PerfectHashIndex.bucket(of: hash, mask: bucketMask)]
+		guard seed != 0 else {
+			return nil
+		}
+		let position = slots[PerfectHashIndex.slot(of: hash, seed: seed, mask: slotMask)]
+		return position < 0 ? nil : Int(position)
+	}
+
+	@inline(__always)
+	private static func bucket(of hash: UInt64, mask: UInt64) -> Int {
+		return Int(truncatingIfNeeded: (hash >> 32) & mask)
+	}
+
+	@inline(__always)
+	private static func slot(of hash: UInt64, seed: UInt32, mask: UInt64) -> Int {
+		return Int(truncatingIfNeeded: OSTypeTable.mix(hash ^ (UInt64(seed) &* 0x9e3779b97f4a7c15)) & mask)
+	}
+
+	private static func powerOfTwo(atLeast value: Int) -> Int {
+		var result = 1
+		while result < value {
+			result <<= 1
+		}
+		return result
+	}
+}
+
+// MARK: - Standard entries
+
+extension OSTypeTable {
+	/// Type codes from the system's core type declarations, with each identifier's preferred
+	/// code first. `testStandardTableMatchesTypeDatabase` checks every row against the type
+	/// database on systems that have one.
+	static let standardEntries: [Entry] = [
+		Entry("TEXT", identifier: "public.plain-text", filenameExtensions: ["txt", "text"]),
+		Entry("utxt", identifier: "public.utf16-plain-text"),
+		Entry("RTF ", identifier: "public.rtf", filenameExtensions: ["rtf"]),
+		Entry("HTML", identifier: "public.html", filenameExtensions: ["html", "htm"]),
+		Entry("PDF ", identifier: "com.adobe.pdf", filenameExtensions: ["pdf"]),
+		Entry("JPEG", identifier: "public.jpeg", filenameExtensions: ["jpeg", "jpg", "jpe"]),
+		Entry("PNGf", identifier: "public.png", filenameExtensions: ["png"]),
+		Entry("GIFf", identifier: "com.compuserve.gif", filenameExtensions: ["gif"]),
+		Entry("TIFF", identifier: "public.tiff", filenameExtensions: ["tiff", "tif"]),
+		Entry("PICT", identifier: "com.apple.pict", filenameExtensions: ["pict", "pct", "pic"]),
+		Entry("icns", identifier: "com.apple.icns", filenameExtensions: ["icns"]),
+		Entry("MooV", identifier: "com.apple.quicktime-movie", filenameExtensions: ["mov", "qt"]),
+		Entry("AIFF", identifier: "public.aiff-audio", filenameExtensions: ["aiff", "aif"]),
+		Entry("AIFC", identifier: "public.aifc-audio", filenameExtensions: ["aifc"]),
+		Entry("WAVE", identifier: "com.microsoft.waveform-audio", filenameExtensions: ["wav", "wave"]),
+		Entry("Midi", identifier: "public.midi-audio", filenameExtensions: ["midi", "mid"]),
+		Entry("ULAW", identifier: "public.au-audio", filenameExtensions: ["au", "snd"]),
+		Entry("caff", identifier: "com.apple.coreaudio-format", filenameExtensions: ["caf"]),
+		Entry("ZIP ", identifier: "public.zip-archive", filenameExtensions: ["zip"]),
+		Entry("osas", identifier: "com.apple.applescript.script", filenameExtensions: ["scpt"]),
+		Entry("vCrd", identifier: "public.vcard", filenameExtensions: ["vcf", "vcard"]),
+	]
+}
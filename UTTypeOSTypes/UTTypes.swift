@@ -6,6 +6,8 @@
 //  Copyright © 2021 C.W. Betts. All rights reserved.
 //
 
+#if canImport(UniformTypeIdentifiers)
+
 import Foundation
 import UniformTypeIdentifiers
 
@@ -32,9 +34,15 @@ public extension UTType {
 	 ```
 	 type.tags[.osType]?.first
 	 ```
+	 
+	 Types in `OSTypeTable.standard` are answered from the table without
+	 going through the type database.
 	 */
 	var preferredOSType: String? {
-		tags[.osType]?.first
+		if let entry = OSTypeTable.standard.entry(forIdentifier: identifier) {
+			return entry.osTypeString
+		}
+		return tags[.osType]?.first
 	}
 	
 	/**
@@ -60,8 +68,26 @@ public extension UTType {
 			To get the type of a file on disk, use `URLResourceValues.contentType`.
 			You should not attempt to derive the type of a file system object based
 			solely on its OSType file type.
+	
+			OSTypes in `OSTypeTable.standard` are answered from the table when the
+			type conforms to `supertype`; anything else goes to the type database.
 		*/
 	init?(osType: String, conformingTo supertype: UTType = .data) {
+		if let index = OSTypeTable.standard.index(forOSTypeString: osType) {
+			let standard = UTType.standardOSTypeTypes[index]
+			if let type = standard.type, supertype == .data ? standard.conformsToData : type.conforms(to: supertype) {
+				self = type
+				return
+			}
+		}
 		self.init(tag: osType, tagClass: .osType, conformingTo: supertype)
 	}
+	
+	/// The types of the rows of `OSTypeTable.standard`, made once.
+	private static let standardOSTypeTypes: [(type: UTType?, conformsToData: Bool)] = OSTypeTable.standard.entries.map { (entry) in
+		let type = UTType(entry.identifier)
+		return (type, type?.conforms(to: .data) ?? false)
+	}
 }
+
+#endif
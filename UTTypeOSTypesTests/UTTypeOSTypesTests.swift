@@ -8,27 +8,148 @@
 
 import XCTest
 @testable import UTTypeOSTypes
+#if canImport(UniformTypeIdentifiers)
+import UniformTypeIdentifiers
+#endif
 
 class UTTypeOSTypesTests: XCTestCase {
 
-    override func setUpWithError() throws {
-        // Put setup code here. This method is called before the invocation of each test method in the class.
+    func testStandardTableLookups() throws {
+        let table = OSTypeTable(entries: OSTypeTable.standardEntries)
+
+        let text = try XCTUnwrap(table.entry(forOSType: 0x54455854))
+        XCTAssertEqual(text.identifier, "public.plain-text")
+        XCTAssertEqual(text.osTypeString, "TEXT")
+        XCTAssertEqual(text.preferredFilenameExtension, "txt")
+        XCTAssertEqual(table.entry(forOSTypeString: "PDF ")?.identifier, "com.adobe.pdf")
+        XCTAssertEqual(table.entry(forIdentifier: "Public.JPEG")?.osTypeString, "JPEG")
+        XCTAssertEqual(table.entry(forFilenameExtension: "JPG")?.identifier, "public.jpeg")
+        XCTAssertEqual(table.entry(forFilenameExtension: "aif")?.osTypeString, "AIFF")
+        XCTAssertNil(table.entry(forOSType: 0x74657874))
+        XCTAssertNil(table.entry(forOSTypeString: "TEX"))
+        XCTAssertNil(table.entry(forOSTypeString: "TEXTT"))
+        XCTAssertNil(table.entry(forOSTypeString: "TÉXT"))
+        XCTAssertNil(table.entry(forIdentifier: "public.plain-tex"))
+        XCTAssertNil(table.entry(forFilenameExtension: ""))
+        XCTAssertNil(table.entry(forFilenameExtension: "docx"))
+
+        XCTAssertEqual(table.statistics, OSTypeTable.Statistics(hits: 5, misses: 7))
+        XCTAssertEqual(table.statistics.hitRate, 5.0 / 12.0)
+        table.resetStatistics()
+        XCTAssertEqual(table.statistics, OSTypeTable.Statistics(hits: 0, misses: 0))
+    }
+
+    func testEveryKeyFindsItsEntry() {
+        let table = OSTypeTable.standard
+        for (index, entry) in table.entries.enumerated() {
+            XCTAssertEqual(table.index(forOSType: entry.osType), index)
+            XCTAssertEqual(table.index(forOSTypeString: entry.osTypeString), index)
+            XCTAssertEqual(table.entry(forIdentifier: entry.identifier.uppercased())?.identifier, entry.identifier)
+            for filenameExtension in entry.filenameExtensions {
+                XCTAssertEqual(table.entry(forFilenameExtension: filenameExtension)?.identifier, entry.identifier)
+            }
+        }
+    }
+
+    func testFirstEntryWinsReverseLookups() {
+        let table = OSTypeTable(entries: [
+            .init("BMPf", identifier: "com.example.bitmap", filenameExtensions: ["bmp"]),
+            .init("BMP ", identifier: "com.example.bitmap", filenameExtensions: ["bmp", "dib"]),
+            .init("DIB ", identifier: "com.example.dib", filenameExtensions: ["DIB"]),
+        ])
+        XCTAssertEqual(table.entry(forOSTypeString: "BMP ")?.identifier, "com.example.bitmap")
+        XCTAssertEqual(table.entry(forIdentifier: "com.example.bitmap")?.osTypeString, "BMPf")
+        XCTAssertEqual(table.entry(forFilenameExtension: "dib")?.osTypeString, "BMP ")
+        XCTAssertEqual(table.entry(forIdentifier: "com.example.dib")?.osTypeString, "DIB ")
+        XCTAssertTrue(OSTypeTable(entries: []).entry(forIdentifier: "public.data") == nil)
+    }
+
+    func testLargeGeneratedTable() {
+        // About 2,500 codes, so the builder has to search seeds for many crowded buckets.
+        let letters = Array("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789")
+        var entries = [OSTypeTable.Entry]()
+        for first in letters {
+            for second in letters.prefix(40) {
+                let code = "x\(first)\(second)_"
+                entries.append(.init(code, identifier: "com.example.\(first)\(second).\(entries.count)", filenameExtensions: ["e\(entries.count)"]))
+            }
+        }
+        let table = OSTypeTable(entries: entries)
+        for (index, entry) in entries.enumerated() {
+            XCTAssertEqual(table.index(forOSType: entry.osType), index)
+            XCTAssertEqual(table.index(forIdentifier: entry.identifier), index)
+            XCTAssertEqual(table.entry(forFilenameExtension: "E\(index)")?.osType, entry.osType)
+        }
+        XCTAssertNil(table.entry(forOSTypeString: "yaa_"))
+        XCTAssertEqual(table.statistics.hits, entries.count * 3)
+        XCTAssertEqual(table.statistics.misses, 1)
+    }
+
+    #if canImport(UniformTypeIdentifiers)
+    func testStandardTableMatchesTypeDatabase() throws {
+        for entry in OSTypeTable.standard.entries {
+            let dynamic = try XCTUnwrap(UTType(tag: entry.osTypeString, tagClass: .osType, conformingTo: .data), entry.osTypeString)
+            XCTAssertEqual(dynamic.identifier, entry.identifier)
+            XCTAssertEqual(dynamic.tags[.osType]?.first, entry.osTypeString)
+            XCTAssertEqual(dynamic.preferredFilenameExtension, entry.preferredFilenameExtension, entry.identifier)
+            for filenameExtension in entry.filenameExtensions {
+                XCTAssertEqual(UTType(filenameExtension: filenameExtension)?.identifier, entry.identifier, filenameExtension)
+            }
+
+            XCTAssertEqual(UTType(osType: entry.osTypeString), dynamic)
+            XCTAssertEqual(dynamic.preferredOSType, entry.osTypeString)
+        }
     }
 
-    override func tearDownWithError() throws {
-        // Put teardown code here. This method is called after the invocation of each test method in the class.
+    func testTableFallsBackToTypeDatabase() {
+        XCTAssertEqual(UTType(osType: "TEXT", conformingTo: .text), .plainText)
+        // A hit that doesn't conform has to get the type database's answer.
+        XCTAssertEqual(UTType(osType: "TEXT", conformingTo: .image), UTType(tag: "TEXT", tagClass: .osType, conformingTo: .image))
+        XCTAssertEqual(UTType(osType: "zzzz"), UTType(tag: "zzzz", tagClass: .osType, conformingTo: .data))
+        XCTAssertEqual(UTType.folder.preferredOSType, UTType.folder.tags[.osType]?.first)
     }
+    #endif
 
-    func testExample() throws {
-        // This is an example of a functional test case.
-        // Use XCTAssert and related functions to verify your tests produce the correct results.
+    // MARK: - Performance
+
+    /// A mix of type codes a file scan might see, about three quarters of them in the table.
+    private let scannedTypeCodes: [String] = {
+        let known = OSTypeTable.standardEntries.map { $0.osTypeString }
+        let unknown = ["ttro", "8BPS", "XLS8", "W8BN"]
+        return (0 ..< 4096).map { $0 % 4 == 3 ? unknown[($0 / 4) % unknown.count] : known[$0 % known.count] }
+    }()
+
+    func testTableLookupPerformance() {
+        let table = OSTypeTable.standard
+        let codes = scannedTypeCodes
+        measure {
+            var found = 0
+            for _ in 0 ..< 50 {
+                for code in codes where table.entry(forOSTypeString: code) != nil {
+                    found += 1
+                }
+            }
+            XCTAssertEqual(found, 50 * 3072)
+        }
     }
 
-    func testPerformanceExample() throws {
-        // This is an example of a performance test case.
-        self.measure {
-            // Put the code you want to measure the time of here.
+    #if canImport(UniformTypeIdentifiers)
+    func testTableBackedUTTypePerformance() {
+        let codes = scannedTypeCodes
+        measure {
+            for code in codes {
+                _ = UTType(osType: code)
+            }
         }
     }
 
+    func testTypeDatabasePerformance() {
+        let codes = scannedTypeCodes
+        measure {
+            for code in codes {
+                _ = UTType(tag: code, tagClass: .osType, conformingTo: .data)
+            }
+        }
+    }
+    #endif
 }